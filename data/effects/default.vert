@@ -6,9 +6,9 @@ layout(set = 0, binding = 0) uniform SceneUBO {
     mat4 proj;
 } scene;
 
-layout(set = 1, binding = 0) uniform MaterialUBO {
+layout(push_constant) uniform DrawConstants {
     mat4 modl;
-} material;
+} draw;
 
 layout(location = 0) in vec3 iPosition;
 layout(location = 1) in vec2 iTexCoord;
@@ -21,7 +21,7 @@ layout(location = 0) out vec4 fragColor;
 layout(location = 1) out vec2 uv;
 
 void main() {
-    gl_Position = scene.proj * scene.view * material.modl * vec4(iPosition, 1.0);
+    gl_Position = scene.proj * scene.view * draw.modl * vec4(iPosition, 1.0);
     uv = iTexCoord;
     fragColor = iColor;
 }
\ No newline at end of file
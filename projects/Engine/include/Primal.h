@@ -35,6 +35,8 @@
 // Core
 #include "core/Log.h"
 #include "core/PrimalAssert.h"
+#include "core/Profiler.h"
+#include "core/Time.h"
 #include "core/Timer.h"
 #include "core/Window.h"
 
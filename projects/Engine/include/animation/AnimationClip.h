@@ -0,0 +1,58 @@
+#ifndef animationclip_h__
+#define animationclip_h__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Pose;
+
+enum EAnimationChannel : uint32_t
+{
+	ANIMATION_CHANNEL_TRANSLATION = 0,
+	ANIMATION_CHANNEL_ROTATION = 1,
+	ANIMATION_CHANNEL_SCALE = 2
+};
+
+enum EAnimationInterpolation : uint32_t
+{
+	ANIMATION_INTERPOLATION_LINEAR = 0,
+	ANIMATION_INTERPOLATION_STEP = 1
+};
+
+struct AnimationTrack
+{
+	uint32_t joint;
+	EAnimationChannel channel;
+	EAnimationInterpolation interpolation;
+
+	// Ascending key times in seconds, and 3 values per key, or 4 for rotations as x, y, z, w
+	std::vector<float> times;
+	std::vector<float> values;
+
+	static uint32_t getComponentCount(const EAnimationChannel aChannel);
+};
+
+class AnimationClip
+{
+	public:
+		AnimationClip() = default;
+
+		// The duration is the time of the last key of any track
+		AnimationClip(std::string aName, std::vector<AnimationTrack> aTracks);
+
+		const std::string& getName() const;
+		float getDuration() const;
+		const std::vector<AnimationTrack>& getTracks() const;
+
+		// Overwrites the channels the clip animates with their value at aTime, clamped to the keys. Channels
+		// without a track keep what aPose holds, usually the rest pose.
+		void sample(const float aTime, Pose& aPose) const;
+
+	private:
+		std::string mName;
+		float mDuration = 0.0f;
+		std::vector<AnimationTrack> mTracks;
+};
+
+#endif // animationclip_h__
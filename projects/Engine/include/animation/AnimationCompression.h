@@ -0,0 +1,46 @@
+#ifndef animationcompression_h__
+#define animationcompression_h__
+
+#include <cstddef>
+
+#include "animation/AnimationClip.h"
+#include "animation/CompressedClip.h"
+
+class Pose;
+
+struct AnimationCompressionSettings
+{
+	// Largest amount a sampled translation or scale component may be off from the source
+	float translationTolerance = 0.0001f;
+	float scaleTolerance = 0.0001f;
+
+	// Largest angle in radians a sampled rotation may be off from the source
+	float rotationTolerance = 0.0002f;
+};
+
+// Largest difference between a clip and its compressed version, per channel in the units of the settings
+struct AnimationCompressionError
+{
+	float translation = 0.0f;
+	float rotation = 0.0f;
+	float scale = 0.0f;
+};
+
+class AnimationCompression
+{
+	public:
+		// Quantizes every track with the fewest bits the tolerances allow, then drops every key the keys
+		// around it interpolate to within them. Tracks that hold aRestPose's value throughout are left out,
+		// since sampling starts from the rest pose anyway.
+		static CompressedClip compress(const AnimationClip& aClip, const Pose& aRestPose, const AnimationCompressionSettings& aSettings);
+
+		// Bytes the float keys of aClip take
+		static size_t getRawBytes(const AnimationClip& aClip);
+
+		// Samples both clips on top of aRestPose aSampleRate times per second over the duration and returns
+		// the largest differences
+		static AnimationCompressionError measure(const AnimationClip& aSource, const CompressedClip& aCompressed, const Pose& aRestPose,
+			const float aSampleRate = 60.0f);
+};
+
+#endif // animationcompression_h__
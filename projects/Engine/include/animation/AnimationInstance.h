@@ -0,0 +1,78 @@
+#ifndef animationinstance_h__
+#define animationinstance_h__
+
+#include <vector>
+
+#include "animation/CompressedClip.h"
+#include "animation/Pose.h"
+#include "animation/Skinning.h"
+#include "math/Vector3.h"
+
+class Skeleton;
+
+struct AnimationLayer
+{
+	const CompressedClip* clip = nullptr;
+	float time = 0.0f;
+	float speed = 1.0f;
+
+	// Relative to the other layers, a layer at 0 is neither sampled nor advanced
+	float weight = 1.0f;
+	bool loop = true;
+};
+
+// Animation state of one character: the clips it plays, its pose and its skinned vertices when it has a
+// skin binding. update() only touches the instance itself, so any number of them can update in parallel.
+class AnimationInstance
+{
+	public:
+		// Without aBinding only the joints are evaluated, which is all hitboxes need
+		explicit AnimationInstance(const Skeleton* aSkeleton, const SkinBinding* aBinding = nullptr);
+
+		// Adds a layer and returns its index
+		size_t play(const CompressedClip* aClip, const float aWeight = 1.0f, const bool aLoop = true, const float aSpeed = 1.0f);
+		void stopAll();
+
+		size_t getLayerCount() const;
+		AnimationLayer& getLayer(const size_t aLayer);
+
+		void setSkinningMethod(const ESkinningMethod aMethod);
+		ESkinningMethod getSkinningMethod() const;
+
+		// Advances every layer by aDeltaTime, then samples and blends them into the pose and computes the
+		// model transforms and the skinned vertices from it
+		void update(const float aDeltaTime);
+
+		const Skeleton* getSkeleton() const;
+		const Pose& getPose() const;
+		const std::vector<JointMatrix>& getModelTransforms() const;
+
+		// Empty without a binding
+		const std::vector<Vertex>& getSkinnedVertices() const;
+
+		// Around the skinned vertices, or around the joints without a binding
+		const Vector3f& getBoundsMin() const;
+		const Vector3f& getBoundsMax() const;
+
+	private:
+		void _skin();
+		void _computeBounds();
+
+		const Skeleton* mSkeleton;
+		const SkinBinding* mBinding;
+		ESkinningMethod mSkinningMethod;
+
+		std::vector<AnimationLayer> mLayers;
+		std::vector<Pose> mLayerPoses;
+
+		Pose mPose;
+		std::vector<JointMatrix> mModel;
+		std::vector<JointMatrix> mPalette;
+		std::vector<DualQuaternion> mDualQuaternions;
+		std::vector<Vertex> mSkinnedVertices;
+
+		Vector3f mBoundsMin;
+		Vector3f mBoundsMax;
+};
+
+#endif // animationinstance_h__
@@ -0,0 +1,16 @@
+#ifndef animationsystem_h__
+#define animationsystem_h__
+
+#include "ecs/System.h"
+
+// Updates every Animator, one job per character
+class AnimationSystem final : public System
+{
+	public:
+		AnimationSystem() = default;
+		~AnimationSystem() = default;
+
+		void update(const float aDeltaTime) override;
+};
+
+#endif // animationsystem_h__
@@ -0,0 +1,92 @@
+#ifndef compressedclip_h__
+#define compressedclip_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "animation/AnimationClip.h"
+
+class Pose;
+
+// Track of a compressed clip. Every key holds three components of bits bits each, packed back to back in
+// the clip's key stream. A component decodes to minimum + extent * value / (2^bits - 1), and a track with 0
+// bits holds its minimum throughout.
+//
+// Rotations are smallest three quaternions of 48 bits instead: the three smallest components in 15 bits
+// each, followed by 2 bits for the index of the largest one, which is rebuilt as positive. Same layout as
+// the cooked PMeshTrack.
+struct CompressedTrack
+{
+	uint32_t joint;
+
+	// EAnimationChannel and EAnimationInterpolation
+	uint8_t channel;
+	uint8_t interpolation;
+	uint8_t bits;
+	uint8_t reserved;
+
+	uint32_t keyCount;
+
+	// First key time of the track in the clip's time table, and bit of its first key in the key stream
+	uint32_t firstTime;
+	uint32_t firstBit;
+
+	float minimum[3];
+	float extent[3];
+};
+
+static_assert(sizeof(CompressedTrack) == 44, "CompressedTrack layout is part of the cooked mesh format");
+
+// Clip whose tracks went through AnimationCompression. Keys are quantized and only the ones needed to
+// stay within the compression's error bounds are kept, every track with its own bit rate.
+class CompressedClip
+{
+	public:
+		static constexpr uint32_t sRotationBits = 16;
+		static constexpr uint32_t sMaxBits = 16;
+
+		// Key times are stored in ticks of getTimeStep() seconds, a clip is at most this many ticks long
+		static constexpr uint32_t sMaxTicks = 65535;
+
+		CompressedClip() = default;
+
+		// aTracks are ordered by channel, see isValid
+		CompressedClip(std::string aName, const float aDuration, const float aTimeStep, std::vector<CompressedTrack> aTracks,
+			std::vector<uint16_t> aTimes, std::vector<uint8_t> aKeys);
+
+		const std::string& getName() const;
+		float getDuration() const;
+		float getTimeStep() const;
+		const std::vector<CompressedTrack>& getTracks() const;
+		const std::vector<uint16_t>& getTimes() const;
+
+		// Packed keys, without the padding the decoder reads past the last one
+		const uint8_t* getKeyData() const;
+		size_t getKeyBytes() const;
+
+		size_t getMemoryUsage() const;
+
+		// False when the time step is not positive or a track is out of order, animates a joint past
+		// aJointCount or reaches past the time table or the key stream. Clips read from files are checked with
+		// this before they are sampled.
+		bool isValid(const size_t aJointCount) const;
+
+		// Same as AnimationClip::sample. The tracks of a channel are decoded in blocks: the keys around aTime
+		// are gathered for every track of the block, then dequantized and interpolated across the block at
+		// once.
+		void sample(const float aTime, Pose& aPose) const;
+
+	private:
+		std::string mName;
+		float mDuration = 0.0f;
+		float mTimeStep = 1.0f;
+
+		std::vector<CompressedTrack> mTracks;
+		std::vector<uint16_t> mTimes;
+		std::vector<uint8_t> mKeys;
+		size_t mKeyBytes = 0;
+};
+
+#endif // compressedclip_h__
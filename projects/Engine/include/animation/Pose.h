@@ -0,0 +1,64 @@
+#ifndef pose_h__
+#define pose_h__
+
+#include <cstddef>
+#include <vector>
+
+#include "animation/AnimationClip.h"
+
+class Skeleton;
+
+// Affine transform stored as the upper three rows of a 4x4 matrix, row by row. The translation is in
+// m[3], m[7] and m[11].
+struct JointMatrix
+{
+	float m[12];
+
+	static JointMatrix identity();
+
+	// Scale first, then rotation, then translation. aRotation is x, y, z, w and expected to be unit length.
+	static JointMatrix fromTrs(const float* aTranslation, const float* aRotation, const float* aScale);
+
+	// aLeft applied after aRight
+	static JointMatrix multiply(const JointMatrix& aLeft, const JointMatrix& aRight);
+};
+
+// Local transforms of every joint of a skeleton, one array per component so that sampling, blending and
+// the conversion to matrices run over contiguous floats
+class Pose
+{
+	public:
+		// Every joint at the identity
+		void resize(const size_t aJointCount);
+		size_t getJointCount() const;
+
+		// Arrays of a channel as x, y, z and w, the last one is null for translation and scale
+		void getChannel(const EAnimationChannel aChannel, float* aArrays[4]);
+		void getChannel(const EAnimationChannel aChannel, const float* aArrays[4]) const;
+
+		// aOut = aFrom blended towards aTo by aWeight, rotations normalized along the shorter arc. aOut may
+		// be either input.
+		static void blend(const Pose& aFrom, const Pose& aTo, const float aWeight, Pose& aOut);
+
+		// Weighted average of aCount poses, weights are normalized first. aOut may not be one of aPoses.
+		static void blend(const Pose* const* aPoses, const float* aWeights, const size_t aCount, Pose& aOut);
+
+		// Model space transforms of every joint. Joints are converted to matrices all at once and then
+		// concatenated with their parents in the skeleton's order, root joints with its root transform.
+		void toModel(const Skeleton& aSkeleton, std::vector<JointMatrix>& aModel) const;
+
+		std::vector<float> translationX;
+		std::vector<float> translationY;
+		std::vector<float> translationZ;
+
+		std::vector<float> rotationX;
+		std::vector<float> rotationY;
+		std::vector<float> rotationZ;
+		std::vector<float> rotationW;
+
+		std::vector<float> scaleX;
+		std::vector<float> scaleY;
+		std::vector<float> scaleZ;
+};
+
+#endif // pose_h__
@@ -0,0 +1,50 @@
+#ifndef skeleton_h__
+#define skeleton_h__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "animation/Pose.h"
+
+// Joint hierarchy of a skinned mesh. Parents always come before their children, so a single pass in
+// order visits every parent first.
+class Skeleton
+{
+	public:
+		static constexpr int32_t sNoParent = -1;
+
+		// Joints skin vertices can reference, limited by the 16 bit joint indices
+		static constexpr size_t sMaxJoints = 65536;
+
+		Skeleton();
+
+		// Every array has one entry per joint. Returns false and stays empty when a parent does not come
+		// before its child.
+		bool build(std::vector<int32_t> aParents, std::vector<std::string> aNames, Pose aRestPose,
+			std::vector<JointMatrix> aInverseBinds, const JointMatrix& aRootTransform);
+
+		size_t getJointCount() const;
+		int32_t getParent(const size_t aJoint) const;
+		const std::string& getName(const size_t aJoint) const;
+
+		// sNoParent when there is no joint called aName
+		int32_t findJoint(const std::string& aName) const;
+
+		const Pose& getRestPose() const;
+
+		// Take the mesh from bind space into each joint's space
+		const std::vector<JointMatrix>& getInverseBinds() const;
+
+		// Transform of whatever sits above the root joints in the source scene
+		const JointMatrix& getRootTransform() const;
+
+	private:
+		std::vector<int32_t> mParents;
+		std::vector<std::string> mNames;
+		Pose mRestPose;
+		std::vector<JointMatrix> mInverseBinds;
+		JointMatrix mRootTransform;
+};
+
+#endif // skeleton_h__
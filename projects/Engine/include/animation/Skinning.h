@@ -0,0 +1,98 @@
+#ifndef skinning_h__
+#define skinning_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "animation/Pose.h"
+#include "graphics/VertexFormat.h"
+
+class Mesh;
+class Skeleton;
+
+// Up to four influences, weights summing to one. Same layout as the cooked PMeshSkinVertex.
+struct SkinVertex
+{
+	uint16_t joints[4];
+	float weights[4];
+};
+
+static_assert(sizeof(SkinVertex) == 24, "SkinVertex layout is part of the cooked mesh format");
+
+enum ESkinningMethod : uint32_t
+{
+	SKINNING_METHOD_LINEAR_BLEND = 0,
+
+	// Keeps the volume around twisting joints, ignores any scale in the joint transforms
+	SKINNING_METHOD_DUAL_QUATERNION = 1
+};
+
+// Rigid transform as a unit rotation (x, y, z, w) and a dual part holding half the translation times the
+// rotation
+struct DualQuaternion
+{
+	float real[4];
+	float dual[4];
+};
+
+// Bind pose and influences of a skinned mesh split into SoA streams. Decoded once from the mesh and shared
+// by every character that uses it.
+class SkinBinding
+{
+	public:
+		// Decodes aMesh in any vertex format, false when the mesh has no skin
+		bool build(const Mesh& aMesh);
+
+		size_t getVertexCount() const;
+
+		// The output skinning starts from, with every attribute skinning does not touch in place
+		const std::vector<Vertex>& getBindVertices() const;
+
+		std::vector<float> positionX;
+		std::vector<float> positionY;
+		std::vector<float> positionZ;
+
+		std::vector<float> normalX;
+		std::vector<float> normalY;
+		std::vector<float> normalZ;
+
+		std::vector<float> tangentX;
+		std::vector<float> tangentY;
+		std::vector<float> tangentZ;
+
+		// Sign of the binormal relative to cross(normal, tangent)
+		std::vector<float> handedness;
+
+		std::vector<uint16_t> joints[4];
+		std::vector<float> weights[4];
+
+	private:
+		std::vector<Vertex> mBindVertices;
+};
+
+// CPU skinning kernels. Vertices are processed in blocks of sBlockSize: the blended transform of every
+// vertex of a block is gathered into SoA arrays first, so the transform itself is a straight loop over
+// floats the compiler vectorizes.
+class Skinning
+{
+	public:
+		static constexpr size_t sBlockSize = 64;
+
+		// aPalette[i] = aModel[i] * inverse bind of joint i
+		static void computePalette(const Skeleton& aSkeleton, const std::vector<JointMatrix>& aModel,
+			std::vector<JointMatrix>& aPalette);
+
+		// Rigid part of every palette entry, scale is dropped
+		static void computeDualQuaternions(const std::vector<JointMatrix>& aPalette, std::vector<DualQuaternion>& aDualQuaternions);
+
+		// Skin the vertices [aBegin, aEnd) of aBinding into the same vertices of aOut. Only positions,
+		// normals, tangents and binormals are written. Normals take the blended transform like positions,
+		// which is exact as long as joints scale uniformly.
+		static void skinLinearBlend(const SkinBinding& aBinding, const JointMatrix* aPalette, const size_t aBegin,
+			const size_t aEnd, Vertex* aOut);
+		static void skinDualQuaternion(const SkinBinding& aBinding, const DualQuaternion* aDualQuaternions, const size_t aBegin,
+			const size_t aEnd, Vertex* aOut);
+};
+
+#endif // skinning_h__
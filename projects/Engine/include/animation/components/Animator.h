@@ -0,0 +1,27 @@
+#ifndef animator_h__
+#define animator_h__
+
+#include "animation/AnimationInstance.h"
+#include "ecs/Component.h"
+
+// Gives an entity an AnimationInstance that the AnimationSystem updates every frame
+class Animator final : public Component
+{
+	public:
+		explicit Animator(const Skeleton* aSkeleton, const SkinBinding* aBinding = nullptr);
+		Animator(const Animator&) = delete;
+		Animator(Animator&&) noexcept = delete;
+		~Animator();
+
+		Animator& operator=(const Animator&) = delete;
+		Animator& operator=(Animator&&) noexcept = delete;
+
+		AnimationInstance& getInstance();
+		const AnimationInstance& getInstance() const;
+
+	private:
+		// Kept out of the component itself, which has to fit a component pool block
+		AnimationInstance* mInstance;
+};
+
+#endif // animator_h__
@@ -1,6 +1,12 @@
 #ifndef application_h__
 #define application_h__
 
+#include <string>
+#include <vector>
+
+#include <tbb/task_group.h>
+
+#include "core/Timer.h"
 #include "core/Window.h"
 
 #include "events/Event.h"
@@ -9,14 +15,32 @@
 
 #include "application/ApplicationLayerStack.h"
 #include "events/MouseEvent.h"
+#include "graphics/FramePacket.h"
+
+struct ApplicationCreateInfo
+{
+	WindowProperties window;
+
+	// Runs without a window or GPU: rendering goes through the null graphics backend and input is
+	// never polled. Intended for CPU benchmarks on build machines.
+	bool headless = false;
+
+	// Number of frames run() executes before returning, 0 to run until close() is called
+	uint64_t frameLimit = 0;
+
+	// Rebuilds assets whose files change on disk while running, see AssetManager::setHotReload
+	bool hotReload = false;
+};
 
 class Application
 {
 	public:
 		Application();
+		explicit Application(const ApplicationCreateInfo& aCreateInfo);
 		virtual ~Application();
 
-		void run() const;
+		void run();
+		void close();
 
 		void onEvent(Event& aEvent);
 
@@ -26,19 +50,57 @@ class Application
 		void pushOverlay(ApplicationLayer* aOverlay);
 		void popOverlay(ApplicationLayer* aOverlay);
 
+		void setFixedTimeStep(const float aTimeStep);
+		void setMaxFixedSteps(const uint32_t aMaxSteps);
+
+		float getFixedTimeStep() const { return mFixedTimeStep; }
+		uint32_t getMaxFixedSteps() const { return mMaxFixedSteps; }
+
+		void setPipelined(const bool aPipelined);
+		bool isPipelined() const { return mPipelined; }
+
+		bool isHeadless() const { return mWindow == nullptr; }
+		uint64_t getFrameCount() const { return mFrameIndex; }
+
 		Window& getWindow() const { return *mWindow; }
 		static Application& get() { return *sInstance; }
 
+		// Arguments the executable was started with, without its own path. Set by the entry point before
+		// the application is created.
+		static void setArguments(const int aArgc, char** aArgv);
+		static const std::vector<std::string>& getArguments() { return sArguments; }
+		static bool hasArgument(const std::string& aArgument);
+
 	private:
 		static Application* sInstance;
+		static std::vector<std::string> sArguments;
 		bool mRunning = true;
 
-		Window* mWindow;
+		Window* mWindow = nullptr;
+		uint64_t mFrameLimit = 0;
 
 		ApplicationLayerStack mLayerStack;
 
+		Timer mFrameTimer;
+		float mFixedTimeStep = 1.0f / 60.0f;
+		float mAccumulator = 0.0f;
+		uint32_t mMaxFixedSteps = 8;
+
+		bool mPipelined = false;
+		uint64_t mFrameIndex = 0;
+		FramePacket mFramePackets[2];
+		tbb::task_group mRenderTaskGroup;
+
+		void _step(const float aFrameTime);
+		void _render(const float aFrameTime);
+
+		// Streams the textures the packet's draws need. Runs on the main thread while nothing renders,
+		// since replacing an image rebinds it in every material using it.
+		void _streamTextures(const FramePacket& aPacket);
+
 		// Events
 		bool _onWindowClose(WindowCloseEvent& aEvent);
+		bool _onWindowResize(WindowResizeEvent& aEvent);
 		bool _onKeyPressed(KeyPressedEvent& aEvent) const;
 		bool _onKeyReleased(KeyReleasedEvent& aEvent) const;
 		bool _onMouseMoved(MouseMovedEvent& aEvent) const;
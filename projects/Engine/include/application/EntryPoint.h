@@ -7,6 +7,8 @@ extern Application* createApplication();
 
 int main(int aArgc, char** aArgv)
 {
+	Application::setArguments(aArgc, aArgv);
+
 	const auto app = createApplication();
 	app->run();
 
@@ -1,21 +1,74 @@
 #ifndef asset_h__
 #define asset_h__
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
+#include <tuple>
+#include <typeinfo>
+#include <vector>
+
+#include "filesystem/FileView.h"
+
+class Asset;
+
+// A named asset another asset needs before it can finish loading. The manager only invokes create when
+// no asset with that name exists yet, so dependencies shared between assets are loaded once.
+struct AssetDependency
+{
+	std::string name;
+	std::function<std::shared_ptr<Asset>()> create;
+
+	template<typename T, typename ... Arguments>
+	static AssetDependency of(const std::string& aName, Arguments&& ... aArgs)
+	{
+		return { aName, [arguments = std::make_tuple(std::forward<Arguments>(aArgs)...)]() -> std::shared_ptr<Asset>
+		{
+			return std::apply([](const auto& ... aValues) { return std::make_shared<T>(aValues...); }, arguments);
+		} };
+	}
+};
+
+// A file the asset needs in memory before _load() runs. The manager fills target, or leaves it invalid
+// if the file could not be read.
+struct AssetFileRead
+{
+	std::string path;
+	FileView* target;
+};
 
 class Asset
 {
 	friend class AssetManager;
 	public:
 		Asset() = default;
-		virtual ~Asset() = default;
+		virtual ~Asset();
 
 		bool isLoaded() const { return mLoaded; }
 
+		// Approximate bytes the loaded asset keeps resident, counted against its type's budget
+		virtual size_t getMemoryUsage() const { return 0; }
+
 	protected:
-		bool mLoaded = false;
+		std::atomic<bool> mLoaded{ false };
 		std::string mName = "Asset";
 
+		// getMemoryUsage() and the type as recorded when loading finished, so the bytes added to the
+		// residency stats are exactly the ones removed again when the asset is destroyed
+		size_t mResidentBytes = 0;
+		const std::type_info* mResidentType = nullptr;
+
+		// Reads whatever descriptor the asset needs to name its dependencies. Every returned dependency is
+		// loaded before _load() runs, so _load() can fetch them with AssetManager::get.
+		virtual std::vector<AssetDependency> _gatherDependencies() { return {}; }
+
+		// Called after _gatherDependencies(). Async loads read these files without holding a worker.
+		virtual std::vector<AssetFileRead> _gatherReads() { return {}; }
+
+		// Files the asset reads itself, in addition to the ones from _gatherReads(). Hot reload rebuilds
+		// the asset when any of them changes.
+		virtual std::vector<std::string> _gatherSources() const { return {}; }
 		virtual void _load() {}
 };
 
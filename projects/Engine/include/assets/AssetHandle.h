@@ -0,0 +1,145 @@
+#ifndef assethandle_h__
+#define assethandle_h__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class AssetLoadState
+{
+	friend class AssetManager;
+	public:
+		AssetLoadState() = default;
+		AssetLoadState(const AssetLoadState&) = delete;
+		AssetLoadState(AssetLoadState&&) noexcept = delete;
+		~AssetLoadState() = default;
+
+		AssetLoadState& operator=(const AssetLoadState&) = delete;
+		AssetLoadState& operator=(AssetLoadState&&) noexcept = delete;
+
+		bool isReady() const
+		{
+			return mReady.load(std::memory_order_acquire);
+		}
+
+		// Set once ready when the asset's descriptor or data could not be loaded
+		bool hasFailed() const
+		{
+			return mFailed.load(std::memory_order_acquire);
+		}
+
+		void wait()
+		{
+			if (isReady())
+			{
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCv.wait(lock, [this] { return isReady(); });
+		}
+
+		// Runs aCallback on the thread that finishes the load, or immediately if it already finished
+		void onComplete(std::function<void()> aCallback)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				if (!isReady())
+				{
+					mCallbacks.push_back(std::move(aCallback));
+					return;
+				}
+			}
+
+			aCallback();
+		}
+
+	private:
+		std::atomic<bool> mReady{ false };
+		std::atomic<bool> mFailed{ false };
+		std::atomic<bool> mClaimed{ false };
+		std::mutex mMutex;
+		std::condition_variable mCv;
+		std::vector<std::function<void()>> mCallbacks;
+
+		bool _claim()
+		{
+			return !mClaimed.exchange(true, std::memory_order_acq_rel);
+		}
+
+		void _complete(const bool aFailed)
+		{
+			std::vector<std::function<void()>> callbacks;
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mFailed.store(aFailed, std::memory_order_release);
+				mReady.store(true, std::memory_order_release);
+				callbacks.swap(mCallbacks);
+			}
+
+			mCv.notify_all();
+
+			for (auto& callback : callbacks)
+			{
+				callback();
+			}
+		}
+};
+
+template<typename T>
+class AssetHandle
+{
+	public:
+		AssetHandle() = default;
+		AssetHandle(std::shared_ptr<T> aAsset, std::shared_ptr<AssetLoadState> aState)
+			: mAsset(std::move(aAsset)), mState(std::move(aState))
+		{
+		}
+
+		bool isValid() const { return mAsset != nullptr; }
+		bool isReady() const { return mState == nullptr || mState->isReady(); }
+
+		// Blocks until the asset finished loading. Calling this from inside another asset's load can
+		// starve the loader pool, prefer then() there.
+		const std::shared_ptr<T>& wait() const
+		{
+			if (mState != nullptr)
+			{
+				mState->wait();
+			}
+
+			return mAsset;
+		}
+
+		const AssetHandle& then(std::function<void(const std::shared_ptr<T>&)> aCallback) const
+		{
+			if (mState == nullptr)
+			{
+				aCallback(mAsset);
+				return *this;
+			}
+
+			std::shared_ptr<T> asset = mAsset;
+			mState->onComplete([asset, callback = std::move(aCallback)]
+			{
+				callback(asset);
+			});
+
+			return *this;
+		}
+
+		// The asset object exists immediately, but must not be used before isReady() returns true
+		const std::shared_ptr<T>& get() const { return mAsset; }
+		T* operator->() const { return mAsset.get(); }
+
+		operator std::shared_ptr<T>() const { return mAsset; }
+
+	private:
+		std::shared_ptr<T> mAsset;
+		std::shared_ptr<AssetLoadState> mState;
+};
+
+#endif // assethandle_h__
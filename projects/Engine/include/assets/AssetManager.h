@@ -1,25 +1,45 @@
 #ifndef assetmanager_h__
 #define assetmanager_h__
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
-#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <type_traits>
 #include <typeindex>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
-#include <tbb/task_group.h>
+#include <tbb/concurrent_queue.h>
+#include <tbb/task_arena.h>
 
 #include "assets/Asset.h"
+#include "assets/AssetHandle.h"
 
 constexpr uint8_t assetLoadLowPrio = 0;
 constexpr uint8_t assetLoadMedPrio = 1;
 constexpr uint8_t assetLoadHighPrio = 2;
 
+struct AssetResidencyStats
+{
+	// 0 when the type has no budget
+	size_t budget = 0;
+
+	size_t residentBytes = 0;
+	uint32_t residentCount = 0;
+
+	// Totals since startup
+	size_t evictedBytes = 0;
+	uint32_t evictedCount = 0;
+	uint32_t restreamCount = 0;
+};
+
+using AssetReloadCallback = std::function<void(const std::string&, const std::shared_ptr<Asset>&)>;
+
 class AssetManager
 {
 	public:
@@ -30,7 +50,7 @@ class AssetManager
 			Arguments&& ... aArgs);
 
 		template<typename T, typename ... Arguments>
-		std::shared_ptr<T> loadAsync(const std::string& aName,
+		AssetHandle<T> loadAsync(const std::string& aName,
 			const uint8_t aPrio,
 			Arguments&& ... aArgs);
 
@@ -38,29 +58,156 @@ class AssetManager
 		std::shared_ptr<T> add(const std::string& aName,
 			Arguments&& ... aArgs);
 
+		// Returns nullptr for assets that were never loaded or are evicted, without streaming them in
 		template<typename T>
 		std::shared_ptr<T> get(const std::string& aName);
 
 		bool unload(const std::string& aName);
 		void unloadAll();
 
-	private:
-		void _loadAssetAsync(std::list<std::string>::iterator& aIter, const uint8_t aPrio);
+		// Blocks until every queued and running asynchronous load has finished
+		void waitAll();
+
+		// Upper bound on loads of a given priority that may run at the same time. Higher priorities are
+		// always dispatched first; the bounds keep low priority streaming from occupying every worker.
+		void setMaxConcurrency(const uint8_t aPrio, const uint32_t aCount);
+		uint32_t getMaxConcurrency(const uint8_t aPrio) const;
+
+		size_t getPendingCount() const;
+
+		// Watches the mounted directories and rebuilds assets whose source files change
+		void setHotReload(const bool aEnabled);
+		bool isHotReloadEnabled() const;
+
+		// Rebuilds aName and everything depending on it, as if one of its sources had changed. Call it from
+		// the thread that runs update().
+		void reload(const std::string& aName);
+
+		// Must be called once per frame while nothing is reading assets. Picks up changed files, starts
+		// rebuilding the affected assets on the loader workers and swaps finished rebuilds in. Assets that
+		// depend on a rebuilt asset are rebuilt in a later update, after their dependency was swapped.
+		void update();
+
+		// Called from update() with the replacement for every swapped asset. Anything still holding the
+		// previous object keeps it alive and has to fetch the new one itself.
+		size_t addReloadListener(AssetReloadCallback aCallback);
+		void removeReloadListener(const size_t aListener);
+
+		// Caps the bytes assets of type T keep resident, 0 removes the cap. update() evicts the least recently
+		// used assets of an over budget type, skipping any that are referenced outside the manager or that a
+		// resident asset depends on. An evicted asset streams back in the next time it is loaded.
+		template<typename T>
+		void setBudget(const size_t aBytes);
+		void setBudget(const std::type_index& aType, const size_t aBytes);
 
-		tbb::task_group mAsyncTaskGroup;
+		template<typename T>
+		AssetResidencyStats getResidencyStats() const;
+		AssetResidencyStats getResidencyStats(const std::type_index& aType) const;
+
+		// Summed over every asset type
+		AssetResidencyStats getResidencyStats() const;
+
+		bool isResident(const std::string& aName);
+
+		void _release(const std::type_info& aType, const size_t aBytes);
 
-		std::list<std::string> mAsyncAssetQueueHigh;
-		std::list<std::string> mAsyncAssetQueueMedium;
-		std::list<std::string> mAsyncAssetQueueLow;
+	private:
+		static constexpr size_t sShardCount = 16;
+		static constexpr uint8_t sPriorityCount = assetLoadHighPrio + 1;
+
+		struct AssetEntry
+		{
+			std::shared_ptr<Asset> asset;
+			std::shared_ptr<AssetLoadState> state;
+
+			// Creates a fresh unloaded instance for hot reload and re-streaming, empty for assets registered
+			// with add(). An evicted entry keeps only this.
+			std::function<std::shared_ptr<Asset>()> create;
+
+			uint64_t lastUse = 0;
+			bool evicted = false;
+		};
+
+		struct Shard
+		{
+			mutable std::mutex mutex;
+			std::unordered_map<std::string, AssetEntry> assets;
+		};
+
+		struct PendingLoad
+		{
+			std::shared_ptr<Asset> asset;
+			std::shared_ptr<AssetLoadState> state;
+		};
+
+		struct AssetLinks
+		{
+			std::vector<std::string> sources;
+			std::vector<std::string> dependencies;
+		};
 
 		AssetManager();
 
-		std::unordered_map<std::string, std::shared_ptr<Asset>> mAssets;
+		Shard& _getShard(const std::string& aName);
+
+		// Returns the entry registered under the dependency's name, creating it if needed. aCreated tells
+		// the caller it now owns scheduling the new entry.
+		AssetEntry _acquire(const AssetDependency& aDependency, bool& aCreated);
+
+		void _schedule();
+		void _execute(uint8_t aPrio, PendingLoad aLoad);
+		void _finishPending();
+
+		// Collects what aAsset loads from, false if its descriptor could not be read
+		bool _gather(Asset* aAsset, std::vector<AssetDependency>& aDependencies, std::vector<AssetFileRead>& aReads);
+
+		// Loads on the calling thread, finalizing later on whichever thread completes a dependency another
+		// loader owns, so no worker waits for it
+		void _loadNow(const PendingLoad& aLoad);
+		void _finalize(Asset* aAsset, AssetLoadState* aState);
+
+		void _addResident(Asset* aAsset);
+		void _touch(AssetEntry& aEntry);
+
+		// Creates the entry's asset, for the first time or again after it was evicted
+		void _instantiate(AssetEntry& aEntry, const std::string& aName);
+		void _evict();
+
+		// Records which files and assets aAsset was built from, replacing what a previous load recorded.
+		// False when its dependencies lead back to aAsset, which could never finish loading.
+		bool _track(const Asset* aAsset, const std::vector<AssetDependency>& aDependencies, const std::vector<AssetFileRead>& aReads);
+
+		void _queueReload(const std::string& aName);
+		void _startReloads();
+		bool _swapReloads();
+
+		Shard mShards[sShardCount];
+
+		tbb::task_arena mArena;
+		tbb::concurrent_queue<PendingLoad> mQueues[sPriorityCount];
+		std::atomic<uint32_t> mInFlight[sPriorityCount];
+		std::atomic<uint32_t> mMaxInFlight[sPriorityCount];
 
-		uint32_t mWaitingAssets = 0;
-		std::condition_variable mCv;
-		std::mutex mCvMutex;
-		std::mutex mQueueMutex;
+		std::atomic<size_t> mPending;
+		std::mutex mIdleMutex;
+		std::condition_variable mIdleCv;
+
+		mutable std::mutex mLinksMutex;
+		std::unordered_map<std::string, AssetLinks> mLinks;
+		std::unordered_map<std::string, std::unordered_set<std::string>> mSourceUsers;
+		std::unordered_map<std::string, std::unordered_set<std::string>> mDependents;
+
+		// Reload state below is only touched from the thread calling update()
+		bool mHotReload = false;
+		std::unordered_set<std::string> mReloadQueue;
+		std::vector<std::pair<std::string, PendingLoad>> mReloading;
+
+		mutable std::mutex mResidencyMutex;
+		std::unordered_map<std::type_index, AssetResidencyStats> mResidency;
+		std::atomic<uint64_t> mUseClock;
+
+		size_t mNextReloadListener = 0;
+		std::vector<std::pair<size_t, AssetReloadCallback>> mReloadListeners;
 };
 
 template<typename T, typename ... Arguments>
@@ -69,62 +216,90 @@ std::shared_ptr<T> AssetManager::load(const std::string& aName,
 {
 	static_assert(std::is_base_of<Asset, T>::value, "T is not derived from Asset");
 
-	if(get<T>(aName) != nullptr)
+	Shard& shard = _getShard(aName);
+	std::shared_ptr<T> asset;
+	std::shared_ptr<AssetLoadState> state;
+
 	{
-		return get<T>(aName);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		auto element = shard.assets.find(aName);
+		if (element == shard.assets.end())
+		{
+			AssetDependency factory = AssetDependency::of<T>(aName, std::forward<Arguments>(aArgs)...);
+			element = shard.assets.emplace(aName, AssetEntry{ nullptr, nullptr, std::move(factory.create) }).first;
+		}
+
+		if (element->second.asset == nullptr)
+		{
+			_instantiate(element->second, aName);
+		}
+
+		_touch(element->second);
+
+		asset = std::static_pointer_cast<T>(element->second.asset);
+		state = element->second.state;
 	}
 
-	std::shared_ptr<T> asset = std::make_shared<T>(std::forward<Arguments>(aArgs)...);
-	asset->mName = aName;
+	if (state == nullptr)
+	{
+		return asset;
+	}
 
-	asset->_load();
+	// Whoever claims the state performs the load. This also pulls an asset that is still sitting in
+	// an async queue forward onto the calling thread instead of waiting for its turn. Dependencies
+	// owned by other loaders may finish it on their thread, so the caller waits either way.
+	if (state->_claim())
+	{
+		_loadNow({ asset, state });
+	}
 
-	mAssets[aName] = asset;
+	state->wait();
 
 	return asset;
 }
 
 template <typename T, typename ... Arguments>
-std::shared_ptr<T> AssetManager::loadAsync(const std::string& aName,
+AssetHandle<T> AssetManager::loadAsync(const std::string& aName,
 										   const uint8_t aPrio,
 										   Arguments&&... aArgs)
 {
 	static_assert(std::is_base_of<Asset, T>::value, "T is not derived from Asset");
 
-	std::shared_ptr<T> asset = std::make_shared<T>(std::forward<Arguments>(aArgs)...);
-	asset->mName = aName;
+	Shard& shard = _getShard(aName);
+	std::shared_ptr<T> asset;
+	std::shared_ptr<AssetLoadState> state;
 
-	switch (aPrio)
 	{
-		case assetLoadHighPrio:
-			mQueueMutex.lock();
-			mAsyncAssetQueueHigh.push_back(aName);
-			mQueueMutex.unlock();
-			break;
-
-		case assetLoadMedPrio:
-			mQueueMutex.lock();
-			mAsyncAssetQueueMedium.push_back(aName);
-			mQueueMutex.unlock();
-			break;
-
-		case assetLoadLowPrio:
-			mQueueMutex.lock();
-			mAsyncAssetQueueLow.push_back(aName);
-			mQueueMutex.unlock();
-			break;
-
-		default:
-			break;
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		auto element = shard.assets.find(aName);
+		if (element != shard.assets.end() && element->second.asset != nullptr)
+		{
+			_touch(element->second);
+			return AssetHandle<T>(std::static_pointer_cast<T>(element->second.asset), element->second.state);
+		}
+
+		if (element == shard.assets.end())
+		{
+			AssetDependency factory = AssetDependency::of<T>(aName, std::forward<Arguments>(aArgs)...);
+			element = shard.assets.emplace(aName, AssetEntry{ nullptr, nullptr, std::move(factory.create) }).first;
+		}
+
+		_instantiate(element->second, aName);
+		_touch(element->second);
+
+		asset = std::static_pointer_cast<T>(element->second.asset);
+		state = element->second.state;
 	}
 
-	mAssets[aName] = asset;
+	const uint8_t prio = aPrio < sPriorityCount ? aPrio : assetLoadHighPrio;
 
-	std::lock_guard<std::mutex> lock(mCvMutex);
-	++mWaitingAssets;
-	mCv.notify_one();
+	mPending.fetch_add(1, std::memory_order_relaxed);
+	mQueues[prio].push({ asset, state });
+	_schedule();
 
-	return asset;
+	return AssetHandle<T>(asset, state);
 }
 
 template<typename T, typename ... Arguments>
@@ -136,8 +311,12 @@ std::shared_ptr<T> AssetManager::add(const std::string& aName,
 	std::shared_ptr<T> asset = std::make_shared<T>(std::forward<Arguments>(aArgs)...);
 	asset->mName = aName;
 	asset->mLoaded = true;
+	_addResident(asset.get());
 
-	mAssets[aName] = asset;
+	Shard& shard = _getShard(aName);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	shard.assets[aName] = { asset, nullptr, nullptr };
+	_touch(shard.assets[aName]);
 
 	return asset;
 }
@@ -147,11 +326,29 @@ std::shared_ptr<T> AssetManager::get(const std::string& aName)
 {
 	static_assert(std::is_base_of<Asset, T>::value, "T is not derived from Asset");
 
-	const auto element = mAssets.find(aName);
-	if (element != mAssets.end())
-		return std::static_pointer_cast<T>(element->second);
+	Shard& shard = _getShard(aName);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	const auto element = shard.assets.find(aName);
+	if (element != shard.assets.end())
+	{
+		_touch(element->second);
+		return std::static_pointer_cast<T>(element->second.asset);
+	}
 
 	return nullptr;
 }
 
+template<typename T>
+void AssetManager::setBudget(const size_t aBytes)
+{
+	setBudget(std::type_index(typeid(T)), aBytes);
+}
+
+template<typename T>
+AssetResidencyStats AssetManager::getResidencyStats() const
+{
+	return getResidencyStats(std::type_index(typeid(T)));
+}
+
 #endif // assetmanager_h__
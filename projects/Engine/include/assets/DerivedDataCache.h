@@ -0,0 +1,64 @@
+#ifndef deriveddatacache_h__
+#define deriveddatacache_h__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "core/Types.h"
+#include "filesystem/FileView.h"
+
+// Identifies a derived result by everything that produced it. Importers start from their kind and a
+// version they bump whenever their output changes, then add the source bytes and every setting.
+class DerivedDataKey
+{
+	public:
+		DerivedDataKey(const char* aKind, const uint32_t aVersion);
+
+		DerivedDataKey& add(const void* aData, const size_t aSize);
+		DerivedDataKey& add(const FileView& aFile);
+		DerivedDataKey& add(const std::string& aValue);
+		DerivedDataKey& add(const uint32_t aValue);
+
+		// 128 bit key as hex
+		std::string str() const;
+
+	private:
+		uint64_t mHash[2];
+};
+
+// Local on-disk cache of importer output, looked up before importing. Entries are written with
+// FileSystem::replace, so a reader only ever sees complete entries and concurrent writers of the same
+// key are harmless.
+class DerivedDataCache
+{
+	public:
+		static DerivedDataCache& instance();
+
+		// Set before anything is loaded, lookups do not synchronize with it
+		void setDirectory(const Path& aDirectory);
+		Path getDirectory() const;
+
+		void setEnabled(const bool aEnabled);
+		bool isEnabled() const;
+
+		// Maps the cached entry, the view stays valid after the cache moves on
+		bool get(const DerivedDataKey& aKey, FileView& aData);
+		bool put(const DerivedDataKey& aKey, const void* aData, const size_t aSize);
+
+		uint64_t getHitCount() const;
+		uint64_t getMissCount() const;
+
+	private:
+		DerivedDataCache();
+
+		Path _getPath(const std::string& aKey) const;
+
+		Path mDirectory;
+		std::atomic<bool> mEnabled;
+
+		std::atomic<uint64_t> mHits;
+		std::atomic<uint64_t> mMisses;
+};
+
+#endif // deriveddatacache_h__
@@ -1,24 +1,80 @@
 #ifndef meshasset_h__
 #define meshasset_h__
 
+#include <string>
+#include <vector>
+
+#include "animation/AnimationCompression.h"
 #include "assets/Asset.h"
+#include "filesystem/FileView.h"
 #include "graphics/Mesh.h"
 
+class Skeleton;
+
+struct MeshImportSettings
+{
+	// Quantized formats leave color out when the source has none
+	EVertexFormat vertexFormat = VERTEX_FORMAT_FLOAT;
+
+	// Weld duplicate vertices and reorder for the vertex cache and vertex fetch
+	bool optimize = true;
+
+	// Simplified levels generated below the full mesh, each aiming for lodReduction times the triangles of
+	// the previous one. lodMaxError caps how far a single level may move the surface, relative to the
+	// largest extent of the submesh. Simplification works best on welded meshes.
+	uint32_t lodCount = 0;
+	float lodReduction = 0.5f;
+	float lodMaxError = 0.02f;
+
+	// Split every LOD into clusters of at most MeshClusters::sMaxVertices vertices and sMaxTriangles
+	// triangles, with bounds for culling them one by one
+	bool clusters = false;
+
+	// Error bounds the clips are compressed within
+	AnimationCompressionSettings animation;
+};
+
 class MeshAsset final : public Asset
 {
 	friend class AssetManager;
 	public:
-		explicit MeshAsset(const std::string& aPath);
+		// aSettings only applies to imported files, cooked meshes keep what they were cooked with
+		explicit MeshAsset(const std::string& aPath, const MeshImportSettings& aSettings = {});
 		~MeshAsset();
 
 		Mesh* getMesh(const size_t aIndex = 0);
 
+		// Skeleton of the first skin of the source, which every mesh with a skin is bound to. Null for
+		// static meshes.
+		const Skeleton* getSkeleton() const;
+
+		// Clips animating the skeleton
+		size_t getClipCount() const;
+		const CompressedClip* getClip(const size_t aIndex) const;
+		const CompressedClip* findClip(const std::string& aName) const;
+
+		size_t getMemoryUsage() const override;
+
+		// Imports a glTF/GLB file and writes it as a .pmesh: one submesh per primitive, vertices already
+		// interleaved, ready to be mapped and uploaded without any parsing, plus the skeleton and clips.
+		static bool cook(const std::string& aSource, const std::string& aDestination, const MeshImportSettings& aSettings = {});
+
 	private:
+		std::vector<std::string> _gatherSources() const override;
 		void _load() override;
+		// Builds the meshes from mCooked, aPath only names the asset in errors
+		void _loadCooked(const std::string& aPath);
 
 		std::vector<Mesh*> mMeshes;
 
+		Skeleton* mSkeleton;
+		std::vector<CompressedClip> mClips;
+
+		// Cooked meshes point straight into the file data, so it lives as long as the meshes
+		FileView mCooked;
+
 		std::string mPath;
+		MeshImportSettings mSettings;
 };
 
 #endif // meshasset_h__
\ No newline at end of file
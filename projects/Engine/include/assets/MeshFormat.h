@@ -0,0 +1,189 @@
+#ifndef meshformat_h__
+#define meshformat_h__
+
+#include <cstdint>
+
+// Layout of a cooked .pmesh file:
+//
+//   PMeshHeader
+//   PMeshSubmesh[submeshCount]
+//   PMeshLod[lodCount]
+//   PMeshCluster[clusterCount]
+//   vertex blob, vertexStride bytes per vertex in vertexFormat (EVertexFormat), starting at vertexOffset
+//   index blob, indexSize bytes (2 or 4) per index, starting at indexOffset
+//   skin blob, one PMeshSkinVertex per vertex when skinStride is not 0, starting at skinOffset
+//   animation section, animationBytes long, starting at animationOffset
+//
+// Every blob starts on a pmeshBlobAlignment boundary so they can be read in place from a mapped file.
+// Submesh vertex and index ranges are relative to the start of their blob. Quantized vertex formats
+// store positions relative to their submesh bounds.
+//
+// Every submesh owns lodCount consecutive entries of the LOD table, finest first, and at least one. LOD 0
+// is the full mesh. The index range of a submesh holds the indices of all its LODs back to back, and all
+// of them index the same vertices.
+//
+// Clusters are optional. A LOD that has them owns clusterCount consecutive entries of its submesh's
+// cluster range, which together cover the LOD's indices exactly.
+//
+// Skinned meshes carry the skeleton and the compressed clips of the source in the animation section:
+//
+//   PMeshAnimationHeader
+//   PMeshJoint[jointCount], parents before their children
+//   PMeshClip[clipCount]
+//   PMeshTrack[trackCount]
+//   uint16_t times[timeCount]
+//   key stream, keyBytes long
+//
+// Every clip owns trackCount consecutive tracks, timeCount consecutive times and keyBytes of the key stream.
+// Track key times and bits are relative to the clip's and times count ticks of the clip's timeStep seconds,
+// see CompressedTrack for how keys are packed. Skin vertex joints index the joint table.
+
+constexpr uint32_t pmeshMagic = 0x48534D50; // "PMSH"
+constexpr uint32_t pmeshVersion = 5;
+constexpr uint32_t pmeshBlobAlignment = 16;
+
+struct PMeshHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vertexStride;
+	uint32_t indexSize;
+	uint32_t submeshCount;
+	uint32_t vertexFormat;
+
+	uint64_t vertexOffset;
+	uint64_t vertexBytes;
+	uint64_t indexOffset;
+	uint64_t indexBytes;
+
+	float boundsMin[3];
+	float boundsMax[3];
+
+	uint32_t lodCount;
+	uint32_t clusterCount;
+
+	uint32_t skinStride;
+	uint32_t reserved;
+
+	uint64_t skinOffset;
+	uint64_t skinBytes;
+	uint64_t animationOffset;
+	uint64_t animationBytes;
+};
+
+struct PMeshSubmesh
+{
+	uint32_t firstVertex;
+	uint32_t vertexCount;
+	uint32_t firstIndex;
+	uint32_t indexCount;
+
+	float boundsMin[3];
+	float boundsMax[3];
+
+	uint32_t firstLod;
+	uint32_t lodCount;
+	uint32_t firstCluster;
+	uint32_t clusterCount;
+};
+
+struct PMeshLod
+{
+	// Relative to the first index of the submesh
+	uint32_t firstIndex;
+	uint32_t indexCount;
+
+	// Relative to the first cluster of the submesh
+	uint32_t firstCluster;
+	uint32_t clusterCount;
+
+	// Object space distance the surface may be off from LOD 0
+	float error;
+	uint32_t reserved;
+};
+
+struct PMeshCluster
+{
+	// Relative to the first index of the submesh
+	uint32_t firstIndex;
+	uint32_t indexCount;
+
+	float center[3];
+	float radius;
+
+	float coneAxis[3];
+	float coneCutoff;
+};
+
+// Up to four influences, weights summing to one
+struct PMeshSkinVertex
+{
+	uint16_t joints[4];
+	float weights[4];
+};
+
+struct PMeshAnimationHeader
+{
+	uint32_t jointCount;
+	uint32_t clipCount;
+	uint32_t trackCount;
+	uint32_t timeCount;
+	uint32_t keyBytes;
+	uint32_t reserved[3];
+
+	// Transform of the nodes above the root joints, row major 3x4
+	float rootTransform[12];
+};
+
+struct PMeshJoint
+{
+	char name[32];
+	int32_t parent;
+
+	float translation[3];
+	float rotation[4];
+	float scale[3];
+
+	// Row major 3x4
+	float inverseBind[12];
+};
+
+struct PMeshClip
+{
+	char name[32];
+	float duration;
+	float timeStep;
+	uint32_t firstTrack;
+	uint32_t trackCount;
+	uint32_t firstTime;
+	uint32_t timeCount;
+	uint32_t firstKeyByte;
+	uint32_t keyBytes;
+};
+
+// channel and interpolation hold an EAnimationChannel and an EAnimationInterpolation
+struct PMeshTrack
+{
+	uint32_t joint;
+	uint8_t channel;
+	uint8_t interpolation;
+	uint8_t bits;
+	uint8_t reserved;
+	uint32_t keyCount;
+	uint32_t firstTime;
+	uint32_t firstBit;
+	float minimum[3];
+	float extent[3];
+};
+
+static_assert(sizeof(PMeshHeader) == 128, "PMeshHeader layout is part of the file format");
+static_assert(sizeof(PMeshSubmesh) == 56, "PMeshSubmesh layout is part of the file format");
+static_assert(sizeof(PMeshLod) == 24, "PMeshLod layout is part of the file format");
+static_assert(sizeof(PMeshCluster) == 40, "PMeshCluster layout is part of the file format");
+static_assert(sizeof(PMeshSkinVertex) == 24, "PMeshSkinVertex layout is part of the file format");
+static_assert(sizeof(PMeshAnimationHeader) == 80, "PMeshAnimationHeader layout is part of the file format");
+static_assert(sizeof(PMeshJoint) == 124, "PMeshJoint layout is part of the file format");
+static_assert(sizeof(PMeshClip) == 64, "PMeshClip layout is part of the file format");
+static_assert(sizeof(PMeshTrack) == 44, "PMeshTrack layout is part of the file format");
+
+#endif // meshformat_h__
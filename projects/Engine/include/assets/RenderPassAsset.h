@@ -18,6 +18,7 @@ public:
 
 	[[nodiscard]] IRenderPass* getRenderPass() const;
 protected:
+	std::vector<std::string> _gatherSources() const override;
 	void _load() override;
 	AttachmentReference _process(const void* aData) const;
 
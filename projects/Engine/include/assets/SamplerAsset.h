@@ -18,6 +18,7 @@ private:
 	ISampler* mSampler = nullptr;
 
 	std::string mFileName;
+	std::vector<std::string> _gatherSources() const override;
 	void _load() override;
 };
 
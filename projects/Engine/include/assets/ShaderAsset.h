@@ -1,6 +1,10 @@
 #ifndef shaderasset_h__
 #define shaderasset_h__
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "assets/Asset.h"
 #include "graphics/api/IGraphicsPipeline.h"
 
@@ -14,11 +18,16 @@ class ShaderAsset final : public Asset
 		[[nodiscard]] IGraphicsPipeline* getPipeline() const;
 		[[nodiscard]] IPipelineLayout* getLayout() const;
 	private:
+		std::vector<AssetDependency> _gatherDependencies() override;
+		std::vector<std::string> _gatherSources() const override;
 		void _load() override;
 
 		GraphicsPipelineCreateInfo mGraphicsPipelineCreateInfo;
 		IGraphicsPipeline* mPipeline;
 		std::string mPath;
+
+		std::string mDescriptor;
+		std::vector<std::pair<EShaderStageFlagBits, std::string>> mStages;
 };
 
 #endif // shaderasset_h__
\ No newline at end of file
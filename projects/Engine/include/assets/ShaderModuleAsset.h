@@ -0,0 +1,32 @@
+#ifndef shadermoduleasset_h__
+#define shadermoduleasset_h__
+
+#include <string>
+
+#include "assets/Asset.h"
+#include "graphics/api/IShaderModule.h"
+
+class ShaderModuleAsset final : public Asset
+{
+	friend class AssetManager;
+	public:
+		explicit ShaderModuleAsset(const std::string& aPath);
+		ShaderModuleAsset(const ShaderModuleAsset&) = delete;
+		ShaderModuleAsset(ShaderModuleAsset&&) noexcept = delete;
+		~ShaderModuleAsset() override;
+
+		ShaderModuleAsset& operator=(const ShaderModuleAsset&) = delete;
+		ShaderModuleAsset& operator=(ShaderModuleAsset&&) noexcept = delete;
+
+		[[nodiscard]] IShaderModule* getModule() const;
+
+	private:
+		std::vector<AssetFileRead> _gatherReads() override;
+		void _load() override;
+
+		std::string mPath;
+		FileView mCode;
+		IShaderModule* mModule = nullptr;
+};
+
+#endif // shadermoduleasset_h__
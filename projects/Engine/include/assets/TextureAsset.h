@@ -1,43 +1,111 @@
 #ifndef textureasset_h__
 #define textureasset_h__
 
+#include <atomic>
 #include <vector>
 
 #include "assets/Asset.h"
+#include "assets/TextureFormat.h"
+#include "assets/TextureStreamer.h"
+#include "filesystem/FileView.h"
+#include "graphics/DataFormat.h"
+#include "graphics/TextureCompressor.h"
 #include "graphics/api/ISampler.h"
 #include "graphics/api/ITexture.h"
 
+struct TextureImportSettings
+{
+	ETextureCompression compression = ETextureCompression::NONE;
+
+	// The source holds sRGB encoded color: mips are filtered in linear space and the texture is sampled
+	// through an sRGB format. Ignored for BC5.
+	bool srgb = false;
+
+	// Generate the full chain down to 1x1
+	bool mips = true;
+	EMipFilter mipFilter = EMipFilter::BOX;
+};
+
+// Resident levels of a cooked texture in upload order, pointing into the cooked data the asset keeps
+// mapped. width and height are those of the finest resident level.
 struct ImageFile
 {
-	std::vector<unsigned char> payload;
+	const uint8_t* payload;
+	size_t size;
+
+	// Start of every level relative to payload, largest first
+	std::vector<uint64_t> levelOffsets;
+
+	EDataFormat format;
 	uint32_t width;
 	uint32_t height;
-	uint32_t channels;
-	uint32_t bitsPerPixel;
 };
 
-class TextureAsset final : public Asset
+// Textures with "streamed" set in their description (the default) load only their levels of
+// TextureStreamer::sMinResidentSize and below, and leave the rest to the TextureStreamer
+class TextureAsset final : public Asset, public IStreamableTexture
 {
 	friend class AssetManager;
 	public:
+		// Only 4 channel textures can be uploaded, aDesiredChannels is checked against that
 		explicit TextureAsset(const std::string& aPath, const uint32_t aDesiredChannels);
 		~TextureAsset();
 
-		ImageFile getData() const;
+		const ImageFile& getData() const;
 
 		ITexture* getTexture() const;
 		ISampler* getSampler() const;
 
+		size_t getMemoryUsage() const override;
+
+		uint32_t getLevelCount() const override;
+		uint32_t getLevelWidth(const uint32_t aLevel) const override;
+		uint32_t getLevelHeight(const uint32_t aLevel) const override;
+		size_t getLevelSize(const uint32_t aLevel) const override;
+
+		uint32_t getResidentLevel() const override;
+		// Recreates the texture with the new levels, uploading only those that were not resident. Materials
+		// using it rebind it on their next use.
+		bool setResidentLevel(const uint32_t aLevel) override;
+
+		// Decodes a PNG/JPG file and writes it as a .ptex with its mip chain generated and compressed as
+		// aSettings asks, ready to be mapped and uploaded without decoding.
+		static bool cook(const std::string& aSource, const std::string& aDestination, const TextureImportSettings& aSettings = {});
+
 	private:
+		std::vector<AssetDependency> _gatherDependencies() override;
+		std::vector<AssetFileRead> _gatherReads() override;
+		std::vector<std::string> _gatherSources() const override;
 		void _load() override;
+		// Validates mCooked and reads its level table
+		bool _loadCooked();
+		// Points mFile at aFirstLevel and everything coarser
+		void _selectLevels(const uint32_t aFirstLevel);
+		TextureCreateInfo _getCreateInfo();
 
 		std::string mPath;
 		uint32_t mDesiredChannels;
 
+		std::string mSamplerName;
+		std::string mTextureFile;
+		uint32_t mBindingPoint = 0;
+		uint32_t mShaderStage = 0;
+		TextureImportSettings mSettings;
+		bool mStreamed = true;
+
+		FileView mEncoded;
+		FileView mCooked;
+
+		const PTexHeader* mHeader = nullptr;
+		const PTexLevel* mLevels = nullptr;
+		uint32_t mResidentLevel = 0;
+
 		ImageFile mFile;
+		// mFile.size once uploaded, read by getMemoryUsage while the streamer may change it
+		std::atomic<size_t> mUploadedBytes;
 
 		ITexture* mTexture;
 		ISampler* mSampler;
 };
 
-#endif // textureasset_h__
\ No newline at end of file
+#endif // textureasset_h__
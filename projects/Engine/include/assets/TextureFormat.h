@@ -0,0 +1,41 @@
+#ifndef textureformat_h__
+#define textureformat_h__
+
+#include <cstdint>
+
+// Layout of a cooked .ptex file, modelled on KTX2:
+//
+//   PTexHeader
+//   PTexLevel[levelCount], largest level first
+//   level data
+//
+// Every level starts on a ptexLevelAlignment boundary and holds its texels in format (EDataFormat) without
+// any row padding, rows of 4x4 blocks for block compressed formats. Levels can be copied to the GPU straight
+// from a mapped file. A texture with fewer levels than a full chain stops before 1x1.
+
+constexpr uint32_t ptexMagic = 0x58455450; // "PTEX"
+constexpr uint32_t ptexVersion = 1;
+constexpr uint32_t ptexLevelAlignment = 16;
+
+struct PTexHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t levelCount;
+	uint32_t reserved[2];
+};
+
+struct PTexLevel
+{
+	// Relative to the start of the file
+	uint64_t offset;
+	uint64_t bytes;
+};
+
+static_assert(sizeof(PTexHeader) == 32, "PTexHeader layout is part of the file format");
+static_assert(sizeof(PTexLevel) == 16, "PTexLevel layout is part of the file format");
+
+#endif // textureformat_h__
@@ -0,0 +1,132 @@
+#ifndef texturestreamer_h__
+#define texturestreamer_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class ITexture;
+
+// A texture whose finer levels can be made resident and dropped one level range at a time
+class IStreamableTexture
+{
+	public:
+		virtual ~IStreamableTexture() = default;
+
+		// Levels of the full chain, largest first
+		virtual uint32_t getLevelCount() const = 0;
+		virtual uint32_t getLevelWidth(const uint32_t aLevel) const = 0;
+		virtual uint32_t getLevelHeight(const uint32_t aLevel) const = 0;
+		virtual size_t getLevelSize(const uint32_t aLevel) const = 0;
+
+		// Finest resident level, every coarser level is resident as well
+		virtual uint32_t getResidentLevel() const = 0;
+
+		// Makes aLevel and everything coarser resident and drops anything finer
+		virtual bool setResidentLevel(const uint32_t aLevel) = 0;
+};
+
+struct TextureStreamingStats
+{
+	// 0 when streaming is not capped
+	size_t budget = 0;
+
+	size_t residentBytes = 0;
+
+	// What would be resident if every request were met
+	size_t requestedBytes = 0;
+
+	uint32_t textureCount = 0;
+
+	// Levels still to be streamed in to reach the current targets
+	uint32_t pendingLevels = 0;
+
+	// Totals since startup
+	size_t streamedBytes = 0;
+	size_t droppedBytes = 0;
+};
+
+// Decides how many levels of every registered texture are resident. Renderers report the size the
+// textures of each draw cover on screen, update() turns those into a target level per texture, fitted
+// into the budget by always granting the next level to the texture that is most undersampled, then
+// drops levels above the targets and streams missing ones in.
+class TextureStreamer
+{
+	public:
+		static TextureStreamer& instance();
+
+		TextureStreamer() = default;
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		// Levels no larger than this are never dropped, and are all a streamed texture loads up front
+		static constexpr uint32_t sMinResidentSize = 64;
+
+		// Updates the largest requested size is held before a smaller one replaces it, so levels are not
+		// dropped and streamed back in while an object hovers around a level boundary
+		static constexpr uint32_t sRequestLifetime = 30;
+
+		void add(IStreamableTexture* aTexture, const ITexture* aHandle = nullptr);
+		void remove(IStreamableTexture* aTexture);
+
+		// Caps the bytes of all streamed levels, 0 removes the cap. Levels of sMinResidentSize and below
+		// always stay, even over budget.
+		void setBudget(const size_t aBytes);
+		size_t getBudget() const;
+
+		// Caps the bytes uploaded per update so a camera cut does not stall a frame, 0 removes the cap.
+		// The texture most in need is always streamed, even past the cap.
+		void setMaxUploadPerUpdate(const size_t aBytes);
+		size_t getMaxUploadPerUpdate() const;
+
+		// aScreenSize is how many pixels the texture spans along its larger side, assuming it is mapped
+		// once across the surface. Requests within one update keep the largest size.
+		void request(IStreamableTexture* aTexture, const float aScreenSize);
+		void request(const ITexture* aHandle, const float aScreenSize);
+
+		void update();
+
+		TextureStreamingStats getStats() const;
+
+		// The level the streamer aims for, see IStreamableTexture::getResidentLevel
+		uint32_t getTargetLevel(IStreamableTexture* aTexture) const;
+
+		// The coarsest level of aTexture that covers aScreenSize texels
+		static uint32_t getWantedLevel(const IStreamableTexture& aTexture, const float aScreenSize);
+
+		// The finest level that is never dropped
+		static uint32_t getMinResidentLevel(const IStreamableTexture& aTexture);
+
+	private:
+		struct Entry
+		{
+			IStreamableTexture* texture = nullptr;
+			const ITexture* handle = nullptr;
+
+			// Largest request since the last update, and the size currently held
+			float pendingSize = 0.0f;
+			float screenSize = 0.0f;
+			uint32_t requestAge = 0;
+
+			uint32_t targetLevel = 0;
+		};
+
+		static size_t _getBytesFrom(const IStreamableTexture& aTexture, const uint32_t aLevel);
+
+		// Picks every target level, returns what the targets add up to
+		size_t _assignTargets(const std::vector<Entry*>& aEntries, size_t& aRequestedBytes) const;
+
+		mutable std::mutex mMutex;
+
+		std::unordered_map<IStreamableTexture*, Entry> mEntries;
+		std::unordered_map<const ITexture*, IStreamableTexture*> mHandles;
+
+		size_t mBudget = 0;
+		size_t mMaxUpload = 0;
+
+		TextureStreamingStats mStats;
+};
+
+#endif // texturestreamer_h__
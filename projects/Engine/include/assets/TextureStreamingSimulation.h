@@ -0,0 +1,100 @@
+#ifndef texturestreamingsimulation_h__
+#define texturestreamingsimulation_h__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "assets/TextureStreamer.h"
+#include "graphics/DataFormat.h"
+#include "math/Vector3.h"
+
+struct TextureStreamingSimulationInfo
+{
+	// Objects are spheres scattered over a square of sceneExtent, each with its own texture
+	uint32_t objectCount = 256;
+	float sceneExtent = 400.0f;
+	float minObjectRadius = 1.0f;
+	float maxObjectRadius = 8.0f;
+	uint32_t seed = 1;
+
+	uint32_t textureSize = 2048;
+	EDataFormat textureFormat = EDataFormat::BC7_UNORM_BLOCK;
+
+	float viewportHeight = 1080.0f;
+	float verticalFieldOfView = 1.0471976f;
+	float aspectRatio = 16.0f / 9.0f;
+
+	float timeStep = 1.0f / 60.0f;
+
+	// See TextureStreamer::setBudget and TextureStreamer::setMaxUploadPerUpdate
+	size_t budget = 0;
+	size_t maxUploadPerUpdate = 0;
+};
+
+struct TextureStreamingSample
+{
+	float time;
+	size_t budget;
+	size_t residentBytes;
+	size_t requestedBytes;
+	uint32_t visibleObjects;
+	uint32_t pendingLevels;
+	size_t streamedBytes;
+	size_t droppedBytes;
+};
+
+// Runs a TextureStreamer of its own against a scene of simulated textures, without a GPU, while a
+// camera follows a scripted path, and records how the resident bytes follow the requested ones.
+class TextureStreamingSimulation
+{
+	public:
+		explicit TextureStreamingSimulation(const TextureStreamingSimulationInfo& aInfo = {});
+		~TextureStreamingSimulation();
+
+		TextureStreamingSimulation(const TextureStreamingSimulation&) = delete;
+		TextureStreamingSimulation& operator=(const TextureStreamingSimulation&) = delete;
+
+		// The camera moves linearly between keyframes, which must be added in time order. Without any the
+		// camera flies low across the scene and back up to an overview.
+		void addKeyframe(const float aTime, const Vector3f& aPosition, const Vector3f& aTarget);
+
+		// Simulates the whole path, logs a summary and returns one sample per step
+		const std::vector<TextureStreamingSample>& run();
+
+		const std::vector<TextureStreamingSample>& getSamples() const;
+
+		bool writeCsv(const std::string& aPath) const;
+
+	private:
+		class SimulatedTexture;
+
+		struct Object
+		{
+			Vector3f center;
+			float radius;
+			SimulatedTexture* texture;
+		};
+
+		struct Keyframe
+		{
+			float time;
+			Vector3f position;
+			Vector3f target;
+		};
+
+		void _addDefaultPath();
+		void _sampleCamera(const float aTime, Vector3f& aPosition, Vector3f& aForward) const;
+		uint32_t _requestVisible(const Vector3f& aPosition, const Vector3f& aForward);
+
+		TextureStreamingSimulationInfo mInfo;
+		TextureStreamer mStreamer;
+
+		std::vector<std::unique_ptr<SimulatedTexture>> mTextures;
+		std::vector<Object> mObjects;
+		std::vector<Keyframe> mKeyframes;
+
+		std::vector<TextureStreamingSample> mSamples;
+};
+
+#endif // texturestreamingsimulation_h__
@@ -0,0 +1,162 @@
+#ifndef profiler_h__
+#define profiler_h__
+
+#if !defined(PRIMAL_DIST) && !defined(PRIMAL_DISABLE_PROFILING)
+#define PRIMAL_ENABLE_PROFILING
+#endif
+
+#ifdef PRIMAL_ENABLE_PROFILING
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ProfileEvent
+{
+	const char* name;
+	uint64_t start;
+	uint64_t end;
+	uint32_t depth;
+};
+
+struct ProfileScopeStats
+{
+	const char* name;
+	uint64_t totalNs;
+	uint64_t selfNs;
+	uint32_t calls;
+};
+
+struct ProfileFrameSummary
+{
+	uint64_t frame;
+	uint64_t start;
+	uint64_t durationNs;
+	std::vector<ProfileScopeStats> scopes;
+};
+
+// Scope timings are written by the owning thread into a single-producer ring and drained on the thread
+// that calls frameMark(), so recording a scope never takes a lock. Scope names must outlive the profiler
+// (string literals or __FUNCTION__); only the pointer is stored.
+class Profiler
+{
+	public:
+		static Profiler& instance();
+
+		Profiler(const Profiler&) = delete;
+		Profiler(Profiler&&) noexcept = delete;
+
+		Profiler& operator=(const Profiler&) = delete;
+		Profiler& operator=(Profiler&&) noexcept = delete;
+
+		static uint64_t now();
+
+		void frameMark();
+		void setThreadName(const char* aName);
+
+		void beginCapture();
+		void endCapture();
+		bool isCapturing() const;
+
+		// Writes everything recorded between beginCapture() and endCapture() in the Chrome trace event
+		// format, which chrome://tracing and ui.perfetto.dev both load
+		bool writeChromeTrace(const std::string& aPath) const;
+
+		void setHistorySize(const size_t aFrames);
+		size_t getHistorySize() const;
+
+		ProfileFrameSummary getLastFrame() const;
+
+		// Scopes sorted by self time, averaged over the frames currently held in the history
+		std::vector<ProfileScopeStats> getTopScopes(const size_t aCount) const;
+		void logSummary(const size_t aCount) const;
+
+		uint64_t getDroppedEvents() const;
+
+		void _record(const char* aName, const uint64_t aStart, const uint64_t aEnd, const uint32_t aDepth);
+
+	private:
+		static constexpr uint32_t sRingSize = 1u << 14;
+		static constexpr uint32_t sMaxDepth = 64;
+
+		struct ThreadBuffer
+		{
+			ProfileEvent events[sRingSize];
+			std::atomic<uint64_t> head{ 0 };
+			std::atomic<uint64_t> tail{ 0 };
+			std::atomic<uint64_t> dropped{ 0 };
+
+			uint32_t id = 0;
+			std::string name;
+
+			// Only touched by the draining thread
+			uint64_t childTime[sMaxDepth + 1] = {};
+		};
+
+		struct CapturedEvent
+		{
+			const char* name;
+			uint64_t start;
+			uint64_t end;
+			uint32_t thread;
+		};
+
+		Profiler();
+
+		ThreadBuffer* _getThreadBuffer();
+		void _drain(ProfileFrameSummary& aSummary);
+
+		mutable std::mutex mThreadsMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> mThreads;
+
+		mutable std::mutex mFrameMutex;
+		std::deque<ProfileFrameSummary> mHistory;
+		size_t mHistorySize = 120;
+		uint64_t mFrameIndex = 0;
+		uint64_t mFrameStart;
+
+		std::atomic<bool> mCapturing;
+		std::vector<CapturedEvent> mCapture;
+		std::vector<uint64_t> mCapturedFrames;
+};
+
+class ProfileScope
+{
+	public:
+		explicit ProfileScope(const char* aName);
+		~ProfileScope();
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* mName;
+		uint64_t mStart;
+};
+
+#define PRIMAL_PROFILE_CONCAT_INNER(a, b) a##b
+#define PRIMAL_PROFILE_CONCAT(a, b) PRIMAL_PROFILE_CONCAT_INNER(a, b)
+
+#define PRIMAL_PROFILE_SCOPE(name) ProfileScope PRIMAL_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PRIMAL_PROFILE_FUNCTION() PRIMAL_PROFILE_SCOPE(__FUNCTION__)
+#define PRIMAL_PROFILE_FRAME() Profiler::instance().frameMark()
+#define PRIMAL_PROFILE_THREAD(name) Profiler::instance().setThreadName(name)
+#define PRIMAL_PROFILE_BEGIN_CAPTURE() Profiler::instance().beginCapture()
+#define PRIMAL_PROFILE_END_CAPTURE(path) { Profiler::instance().endCapture(); Profiler::instance().writeChromeTrace(path); }
+
+#else
+
+#define PRIMAL_PROFILE_SCOPE(name)
+#define PRIMAL_PROFILE_FUNCTION()
+#define PRIMAL_PROFILE_FRAME()
+#define PRIMAL_PROFILE_THREAD(name)
+#define PRIMAL_PROFILE_BEGIN_CAPTURE()
+#define PRIMAL_PROFILE_END_CAPTURE(path)
+
+#endif
+
+#endif // profiler_h__
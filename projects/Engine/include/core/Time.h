@@ -0,0 +1,31 @@
+#ifndef time_h__
+#define time_h__
+
+#include <cstdint>
+
+class Time
+{
+	friend class Application;
+
+	public:
+		static float deltaTime();
+		static float fixedDeltaTime();
+		static float interpolationAlpha();
+
+		static double elapsed();
+		static uint64_t frameCount();
+
+	private:
+		static float sDeltaTime;
+		static float sFixedDeltaTime;
+		static float sInterpolationAlpha;
+
+		static double sElapsed;
+		static uint64_t sFrameCount;
+
+		static void _advance(const float aDeltaTime);
+		static void _setFixedDeltaTime(const float aFixedDeltaTime);
+		static void _setInterpolationAlpha(const float aAlpha);
+};
+
+#endif // time_h__
@@ -1,16 +1,29 @@
 #ifndef componentview_h__
 #define componentview_h__
 
+#include <cstddef>
+#include <iterator>
+#include <utility>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
 #include "ecs/Component.h"
 
 template<typename T>
 class ComponentIterator
 {
 	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T*;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T**;
+		using reference = T*;
+
 		ComponentIterator(std::vector<Component*>& aData, const size_t aIndex)
-			: mData(aData)
+			: mData(&aData)
 		{
 			mIndex = aIndex;
 		}
@@ -32,7 +45,7 @@ class ComponentIterator
 
 		ComponentIterator& operator-- ()
 		{
-			++mIndex;
+			--mIndex;
 
 			return *this;
 		}
@@ -45,31 +58,97 @@ class ComponentIterator
 			return copy;
 		}
 
+		ComponentIterator& operator+= (const difference_type aOffset)
+		{
+			mIndex += aOffset;
+
+			return *this;
+		}
+
+		ComponentIterator& operator-= (const difference_type aOffset)
+		{
+			mIndex -= aOffset;
+
+			return *this;
+		}
+
+		ComponentIterator operator+ (const difference_type aOffset) const
+		{
+			ComponentIterator<T> copy = *this;
+			copy += aOffset;
+
+			return copy;
+		}
+
+		ComponentIterator operator- (const difference_type aOffset) const
+		{
+			ComponentIterator<T> copy = *this;
+			copy -= aOffset;
+
+			return copy;
+		}
+
+		difference_type operator- (const ComponentIterator& aOther) const
+		{
+			return static_cast<difference_type>(mIndex) - static_cast<difference_type>(aOther.mIndex);
+		}
+
 		T* operator* ()
 		{
-			return reinterpret_cast<T*>(mData[mIndex]);
+			return reinterpret_cast<T*>((*mData)[mIndex]);
 		}
 
 		const T* operator* () const
 		{
-			return reinterpret_cast<T*>(mData[mIndex]);
+			return reinterpret_cast<T*>((*mData)[mIndex]);
+		}
+
+		T* operator[] (const difference_type aOffset) const
+		{
+			return reinterpret_cast<T*>((*mData)[mIndex + aOffset]);
 		}
 
 		bool operator== (const ComponentIterator& aOther) const noexcept
 		{
-			return mData.data() == aOther.mData.data() && mIndex == aOther.mIndex;
+			return mData->data() == aOther.mData->data() && mIndex == aOther.mIndex;
 		}
 
 		bool operator != (const ComponentIterator& aOther) const noexcept
 		{
-			return mIndex != aOther.mIndex || mData.data() != aOther.mData.data();
+			return mIndex != aOther.mIndex || mData->data() != aOther.mData->data();
+		}
+
+		bool operator< (const ComponentIterator& aOther) const noexcept
+		{
+			return mIndex < aOther.mIndex;
+		}
+
+		bool operator> (const ComponentIterator& aOther) const noexcept
+		{
+			return mIndex > aOther.mIndex;
+		}
+
+		bool operator<= (const ComponentIterator& aOther) const noexcept
+		{
+			return mIndex <= aOther.mIndex;
+		}
+
+		bool operator>= (const ComponentIterator& aOther) const noexcept
+		{
+			return mIndex >= aOther.mIndex;
 		}
 
 	private:
-		std::vector<Component*>& mData;
+		std::vector<Component*>* mData;
 		size_t mIndex;
 };
 
+template<typename T>
+ComponentIterator<T> operator+ (const typename ComponentIterator<T>::difference_type aOffset, const ComponentIterator<T>& aIterator)
+{
+	return aIterator + aOffset;
+}
+
 template<typename T>
 class ComponentView
 {
@@ -119,4 +198,40 @@ class ComponentView
 		std::vector<Component*>& mData;
 };
 
-#endif // componentview_h__
\ No newline at end of file
+// Runs aFunction(T*) for every component in the view, split into ranges of at least aGrainSize
+// components on the TBB scheduler. Components must not be added or removed while this runs.
+template<typename T, typename Function>
+void parallel_for_each(ComponentView<T> aView, Function&& aFunction, const size_t aGrainSize = 64)
+{
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aView.size(), aGrainSize > 0 ? aGrainSize : 1),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t i = aRange.begin(); i != aRange.end(); ++i)
+			{
+				aFunction(aView[i]);
+			}
+		});
+}
+
+// Folds every component into a per-range accumulator with aFunction(Value&, T*), then combines
+// the partial results with aReduction(const Value&, const Value&) -> Value.
+template<typename T, typename Value, typename Function, typename Reduction>
+Value parallel_reduce(ComponentView<T> aView, const Value& aIdentity, Function&& aFunction, Reduction&& aReduction, const size_t aGrainSize = 64)
+{
+	return tbb::parallel_reduce(tbb::blocked_range<size_t>(0, aView.size(), aGrainSize > 0 ? aGrainSize : 1), aIdentity,
+		[&](const tbb::blocked_range<size_t>& aRange, Value aAccumulator) -> Value
+		{
+			for (size_t i = aRange.begin(); i != aRange.end(); ++i)
+			{
+				aFunction(aAccumulator, aView[i]);
+			}
+
+			return aAccumulator;
+		},
+		[&](const Value& aLeft, const Value& aRight) -> Value
+		{
+			return aReduction(aLeft, aRight);
+		});
+}
+
+#endif // componentview_h__
@@ -2,6 +2,7 @@
 #define system_h__
 
 #include "events/Event.h"
+#include "graphics/FramePacket.h"
 
 class System
 {
@@ -11,15 +12,17 @@ class System
 
 		virtual void initialize() {}
 
-		virtual void update() {}
-		virtual void lateUpdate() {}
-		virtual void fixedUpdate() {}
+		virtual void update(const float aDeltaTime) {}
+		virtual void lateUpdate(const float aDeltaTime) {}
+		virtual void fixedUpdate(const float aFixedDeltaTime) {}
 
 		virtual void onEvent(Event& aEvent) {}
 
-		virtual void preRender() {}
-		virtual void render() {}
-		virtual void postRender() {}
+		virtual void extract(FramePacket& aPacket) {}
+
+		virtual void preRender(const FramePacket& aPacket) {}
+		virtual void render(const FramePacket& aPacket) {}
+		virtual void postRender(const FramePacket& aPacket) {}
 
 		virtual void dispose() {}
 
@@ -24,10 +24,11 @@ class SystemManager
 		template<typename T>
 		void removeSystem();
 
-		void update();
-		void fixedUpdate();
+		void update(const float aDeltaTime);
+		void fixedUpdate(const float aFixedDeltaTime);
 
-		void render();
+		void extract(FramePacket& aPacket);
+		void render(const FramePacket& aPacket);
 
 		void dispatchEvent(Event& aEvent);
 
@@ -0,0 +1,108 @@
+#ifndef asyncfilereader_h__
+#define asyncfilereader_h__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/Types.h"
+#include "filesystem/FileView.h"
+#include "filesystem/IoUring.h"
+#include "filesystem/ReadBufferPool.h"
+
+// Invalid view on failure. Runs on the reader's completion thread, so anything heavier than handing the
+// data on should be pushed to a task.
+using AsyncReadCallback = std::function<void(FileView aData)>;
+
+struct AsyncReadRequest
+{
+	Path path;
+	AsyncReadCallback callback;
+
+	// Optional destination. Without one the data lands in a pooled buffer owned by the view.
+	uint8_t* buffer = nullptr;
+	size_t capacity = 0;
+};
+
+// Reads whole files without blocking the caller. On Linux reads are queued on an io_uring and completed
+// by a single thread, so many files are in flight at once. Elsewhere, or if io_uring is unavailable, a
+// small pool of blocking reader threads is used instead, which keeps the TBB workers free either way.
+class AsyncFileReader
+{
+	public:
+		static AsyncFileReader& instance();
+
+		AsyncFileReader(const AsyncFileReader&) = delete;
+		AsyncFileReader(AsyncFileReader&&) noexcept = delete;
+
+		AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+		AsyncFileReader& operator=(AsyncFileReader&&) noexcept = delete;
+
+		void read(const Path& aPath, AsyncReadCallback aCallback);
+		void read(const Path& aPath, uint8_t* aBuffer, const size_t aCapacity, AsyncReadCallback aCallback);
+
+		// Queues every request before entering the kernel once
+		void read(std::vector<AsyncReadRequest> aRequests);
+
+		void waitIdle();
+		size_t getPendingCount() const;
+
+		bool isUsingIoUring() const;
+
+	private:
+		struct PendingRead
+		{
+			AsyncReadRequest request;
+
+			int file;
+			uint8_t* data;
+			size_t size;
+			size_t offset;
+			std::shared_ptr<const void> owner;
+		};
+
+		static constexpr uint32_t sQueueDepth = 64;
+		static constexpr uint32_t sFallbackThreads = 4;
+
+		AsyncFileReader();
+
+		std::shared_ptr<const void> _allocate(const AsyncReadRequest& aRequest, const size_t aSize, uint8_t*& aData);
+		void _finish(AsyncReadRequest& aRequest, FileView aData);
+
+		void _readBlocking(AsyncReadRequest& aRequest);
+		void _workerLoop();
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+		PendingRead* _open(AsyncReadRequest& aRequest);
+		void _prepare(PendingRead* aRead);
+		void _completionLoop();
+
+		// Hands a read that was opened for the ring over to the reader threads
+		void _fallBack(PendingRead* aRead);
+
+		IoUring mRing;
+		std::mutex mSubmitMutex;
+		std::deque<PendingRead*> mBacklog;
+		uint32_t mInFlight = 0;
+#endif
+
+		// Cleared when the kernel turns out not to support reads on the ring
+		std::atomic<bool> mUseIoUring{ false };
+
+		ReadBufferPool mBuffers;
+
+		std::mutex mWorkMutex;
+		std::condition_variable mWorkCv;
+		std::deque<AsyncReadRequest> mWork;
+		std::vector<std::thread> mThreads;
+
+		std::atomic<size_t> mPending;
+		std::mutex mIdleMutex;
+		std::condition_variable mIdleCv;
+};
+
+#endif // asyncfilereader_h__
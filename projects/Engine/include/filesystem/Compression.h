@@ -0,0 +1,21 @@
+#ifndef compression_h__
+#define compression_h__
+
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 block format (no frame header). Decompression needs the exact decompressed size, which the
+// caller is expected to store next to the block.
+class Compression
+{
+	public:
+		static size_t lz4CompressBound(const size_t aSize);
+
+		// Returns the compressed size, or 0 if aCapacity is smaller than lz4CompressBound(aSize)
+		static size_t lz4Compress(const uint8_t* aSource, const size_t aSize, uint8_t* aDestination, const size_t aCapacity);
+
+		// Fails on malformed input instead of reading or writing out of bounds
+		static bool lz4Decompress(const uint8_t* aSource, const size_t aSize, uint8_t* aDestination, const size_t aDecompressedSize);
+};
+
+#endif // compression_h__
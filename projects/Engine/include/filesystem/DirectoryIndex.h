@@ -0,0 +1,46 @@
+#ifndef directoryindex_h__
+#define directoryindex_h__
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// In-memory tree of mount relative paths. Files are looked up by hash, and every directory keeps the
+// names of its direct children so listings never touch the disk. Not synchronized, owners lock.
+class DirectoryIndex
+{
+	public:
+		DirectoryIndex();
+
+		void addFile(const std::string& aPath);
+		void addDirectory(const std::string& aPath);
+
+		bool removeFile(const std::string& aPath);
+		bool removeDirectory(const std::string& aPath);
+
+		void clear();
+
+		bool hasFile(const std::string& aPath) const;
+		bool hasDirectory(const std::string& aPath) const;
+
+		// Appends the paths of the files in aDirectory, and of its subdirectories when aRecursive is set
+		void list(const std::string& aDirectory, const bool aRecursive, std::vector<std::string>& aFiles) const;
+
+		size_t getFileCount() const;
+		size_t getDirectoryCount() const;
+
+	private:
+		struct Node
+		{
+			std::vector<std::string> files;
+			std::vector<std::string> directories;
+		};
+
+		void _eraseTree(const std::string& aPath);
+
+		std::unordered_set<std::string> mFiles;
+		std::unordered_map<std::string, Node> mDirectories;
+};
+
+#endif // directoryindex_h__
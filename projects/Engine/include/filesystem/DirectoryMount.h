@@ -0,0 +1,48 @@
+#ifndef directorymount_h__
+#define directorymount_h__
+
+#include <shared_mutex>
+
+#include "core/Types.h"
+#include "filesystem/DirectoryIndex.h"
+#include "filesystem/IMount.h"
+
+class DirectoryMount final : public IMount
+{
+	public:
+		// An indexed mount scans its tree once and answers existence checks and listings from memory.
+		// Changes made behind its back are only seen after refresh().
+		explicit DirectoryMount(const Path& aRoot, const bool aIndexed = true);
+
+		const Path& getRoot() const;
+		bool isIndexed() const;
+		size_t getFileCount() const;
+
+		// Brings the index entry for a file or directory back in sync with the disk. A directory is
+		// rescanned with everything below it, an empty path rescans the whole mount.
+		void refresh(const std::string& aPath);
+
+		bool exists(const std::string& aPath) const override;
+		bool isDirectory(const std::string& aPath) const override;
+
+		void list(const std::string& aDirectory, const bool aRecursive, std::vector<std::string>& aFiles) const override;
+
+		bool read(const std::string& aPath, std::vector<char>& aData) const override;
+		FileView view(const std::string& aPath) const override;
+
+		bool getNativePath(const std::string& aPath, Path& aNativePath) const override;
+
+	private:
+		Path _resolve(const std::string& aPath) const;
+
+		// Adds aDirectory and its contents to aIndex. Callers scanning into mIndex hold the index lock.
+		void _scan(DirectoryIndex& aIndex, const std::string& aDirectory, const bool aRecursive) const;
+
+		Path mRoot;
+		bool mIndexed;
+
+		mutable std::shared_mutex mIndexMutex;
+		DirectoryIndex mIndex;
+};
+
+#endif // directorymount_h__
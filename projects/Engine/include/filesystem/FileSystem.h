@@ -3,10 +3,18 @@
 
 #include <cstdint>
 
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <string>
 
+#include "filesystem/AsyncFileReader.h"
+#include "filesystem/DirectoryMount.h"
 #include "filesystem/File.h"
+#include "filesystem/FileView.h"
+#include "filesystem/FileWatcher.h"
+#include "filesystem/IMount.h"
 #include "core/Types.h"
 
 struct FileInfo
@@ -24,29 +32,74 @@ class FileSystem
 	public:
 		static FileSystem& instance();
 
-		void mount(const Path& aPath);
+		// Mounts a directory or a .ppak archive. Reads try mounts from the highest priority down, and the
+		// most recently mounted first among equal priorities. Paths no mount provides are read relative
+		// to the working directory.
+		bool mount(const Path& aPath, const int32_t aPriority = 0);
+		void unmount(const Path& aPath);
 		void unmount();
 
+		// Root of the highest priority directory mount, for APIs that need a real path on disk
 		Path getMountedDirectory() const;
 
 		File* load(const Path& aPath) const;
 		std::string loadToString(const Path& aPath) const;
 		std::vector<char> getBytes(const Path& aPath) const;
+		bool getBytes(const Path& aPath, std::vector<char>& aData) const;
+
+		// Maps the file instead of copying it where possible, see FileView
+		FileView view(const Path& aPath) const;
+
+		// Loose files are read through AsyncFileReader; pack entries are already mapped and complete
+		// on the calling thread
+		void readAsync(const Path& aPath, AsyncReadCallback aCallback) const;
 
 		bool exists(const Path& aPath) const;
 
 		bool isFile(const Path& aPath) const;
 		bool isDirectory(const Path& aPath) const;
 
+		// Directory mounts keep an index of their tree that is built at mount time. Files written
+		// outside of File::save() and createDirectory() must be refreshed before queries see them.
+		void refresh(const Path& aPath) const;
+
+		// Watches directory mounts for changes. pollChanges() brings their indices up to date and
+		// appends every changed path, both relative to its mount and prefixed with the mount root.
+		void setWatching(const bool aWatching);
+		bool isWatching() const;
+		void pollChanges(std::vector<std::string>& aChanged);
+
 		File* create(const std::string& aPath) const;
 		void createDirectory(const Path& aPath) const;
 
+		// Writes aData to a temporary file next to aPath and renames it over aPath. Views that mapped the
+		// previous file keep reading its contents instead of faulting on a truncated mapping. aPath resolves
+		// through the mounts like a read, absolute paths are written as they are.
+		bool replace(const Path& aPath, const void* aData, const size_t aSize) const;
+
 		std::vector<FileInfo> getFilesInPath(const Path& aPath, const bool aRecursive = false) const;
 
 	private:
+		struct MountPoint
+		{
+			Path path;
+			int32_t priority;
+			bool directory;
+			std::unique_ptr<IMount> mount;
+		};
+
 		FileSystem();
 
-		Path mMountedPath;
+		template<typename Function>
+		bool _findInMounts(const Path& aPath, Function&& aFunction) const;
+
+		mutable std::shared_mutex mMountMutex;
+		std::vector<MountPoint> mMounts;
+
+		DirectoryMount mWorkingDirectory;
+
+		mutable std::mutex mWatcherMutex;
+		std::unique_ptr<FileWatcher> mWatcher;
 };
 
-#endif // filesystem_h__
\ No newline at end of file
+#endif // filesystem_h__
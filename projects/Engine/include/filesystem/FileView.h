@@ -0,0 +1,33 @@
+#ifndef fileview_h__
+#define fileview_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Read-only bytes of a file. The view keeps whatever backs the data alive (a mapping or a decompressed
+// buffer), so it stays valid after the mount it came from is unmounted.
+class FileView
+{
+	public:
+		FileView() = default;
+		FileView(const uint8_t* aData, const size_t aSize, std::shared_ptr<const void> aOwner)
+			: mData(aData), mSize(aSize), mOwner(std::move(aOwner))
+		{
+		}
+
+		bool isValid() const { return mOwner != nullptr; }
+
+		const uint8_t* data() const { return mData; }
+		size_t size() const { return mSize; }
+
+		std::string str() const { return std::string(reinterpret_cast<const char*>(mData), mSize); }
+
+	private:
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+		std::shared_ptr<const void> mOwner;
+};
+
+#endif // fileview_h__
@@ -0,0 +1,57 @@
+#ifndef filewatcher_h__
+#define filewatcher_h__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/Types.h"
+
+struct FileChange
+{
+	Path root;
+
+	// Relative to root with forward slashes, empty when the whole root has to be rescanned
+	std::string path;
+};
+
+// Reports files below watched directories that were written, moved or deleted. There is no thread
+// involved: poll() drains whatever the OS queued since the previous call. Only implemented on Linux
+// (inotify), elsewhere watch() fails and nothing is ever reported.
+class FileWatcher
+{
+	public:
+		FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher(FileWatcher&&) noexcept = delete;
+		~FileWatcher();
+
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		FileWatcher& operator=(FileWatcher&&) noexcept = delete;
+
+		bool isValid() const;
+
+		// Watches aRoot and every directory below it, including ones created later
+		bool watch(const Path& aRoot);
+		void unwatch(const Path& aRoot);
+
+		// Appends every path that changed since the last poll, each reported once
+		void poll(std::vector<FileChange>& aChanges);
+
+	private:
+		struct Watch
+		{
+			size_t root;
+			std::string path;
+		};
+
+		void _addWatches(const size_t aRoot, const std::string& aDirectory);
+
+		int mDescriptor = -1;
+
+		// Unwatched roots are left empty so the indices held by watches stay stable
+		std::vector<Path> mRoots;
+		std::unordered_map<int, Watch> mWatches;
+};
+
+#endif // filewatcher_h__
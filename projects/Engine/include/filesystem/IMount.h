@@ -0,0 +1,35 @@
+#ifndef imount_h__
+#define imount_h__
+
+#include <string>
+#include <vector>
+
+#include "core/Types.h"
+#include "filesystem/FileView.h"
+
+// Paths handed to a mount are relative to its root and use forward slashes
+class IMount
+{
+	public:
+		IMount() = default;
+		IMount(const IMount&) = delete;
+		IMount(IMount&&) noexcept = delete;
+		virtual ~IMount() = default;
+
+		IMount& operator=(const IMount&) = delete;
+		IMount& operator=(IMount&&) noexcept = delete;
+
+		virtual bool exists(const std::string& aPath) const = 0;
+		virtual bool isDirectory(const std::string& aPath) const = 0;
+
+		// Appends the mount relative paths of the files in aDirectory
+		virtual void list(const std::string& aDirectory, const bool aRecursive, std::vector<std::string>& aFiles) const = 0;
+
+		virtual bool read(const std::string& aPath, std::vector<char>& aData) const = 0;
+		virtual FileView view(const std::string& aPath) const = 0;
+
+		// Path on disk for mounts backed by loose files, so they can be read asynchronously
+		virtual bool getNativePath(const std::string& aPath, Path& aNativePath) const = 0;
+};
+
+#endif // imount_h__
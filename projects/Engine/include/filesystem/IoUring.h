@@ -0,0 +1,75 @@
+#ifndef iouring_h__
+#define iouring_h__
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+struct IoCompletion
+{
+	uint64_t userData;
+	int32_t result;
+};
+
+// Minimal io_uring driven through the raw syscalls, only covering what AsyncFileReader needs. Submission
+// is single producer, callers serialize prepareRead/submit themselves. waitCompletions may run on
+// another thread concurrently with submission.
+class IoUring
+{
+	public:
+		IoUring() = default;
+		IoUring(const IoUring&) = delete;
+		IoUring(IoUring&&) noexcept = delete;
+		~IoUring();
+
+		IoUring& operator=(const IoUring&) = delete;
+		IoUring& operator=(IoUring&&) noexcept = delete;
+
+		// Fails on kernels without io_uring or where it has been disabled
+		bool init(const uint32_t aEntries);
+		bool isValid() const { return mRing >= 0; }
+
+		uint32_t getEntries() const { return mSqEntries; }
+
+		bool prepareRead(const int aFile, void* aBuffer, const uint32_t aSize, const uint64_t aOffset, const uint64_t aUserData);
+		// Hands the prepared entries to the kernel. When it has no room, waits for the completion thread to
+		// reap if aWaitForRoom is set, otherwise returns false and leaves the rest for waitCompletions. The
+		// completion thread itself must not wait, it is the one that makes room.
+		bool submit(const bool aWaitForRoom);
+
+		// Blocks until at least one completion is available and appends every available one to aCompletions.
+		// Submits whatever entries are still queued before blocking.
+		void waitCompletions(std::vector<IoCompletion>& aCompletions);
+
+	private:
+		int mRing = -1;
+
+		void* mSqMapping = nullptr;
+		void* mCqMapping = nullptr;
+		size_t mSqMappingSize = 0;
+		size_t mCqMappingSize = 0;
+
+		io_uring_sqe* mSqes = nullptr;
+		size_t mSqesSize = 0;
+
+		uint32_t* mSqHead = nullptr;
+		uint32_t* mSqTail = nullptr;
+		uint32_t* mSqArray = nullptr;
+		uint32_t mSqMask = 0;
+		uint32_t mSqEntries = 0;
+		uint32_t mSqLocalTail = 0;
+
+		uint32_t* mCqHead = nullptr;
+		uint32_t* mCqTail = nullptr;
+		uint32_t mCqMask = 0;
+		io_uring_cqe* mCqes = nullptr;
+};
+
+#endif
+
+#endif // iouring_h__
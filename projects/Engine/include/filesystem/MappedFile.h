@@ -0,0 +1,42 @@
+#ifndef mappedfile_h__
+#define mappedfile_h__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/Types.h"
+
+// Read-only view of a whole file mapped into the address space. Pages are faulted in by the OS on first
+// access, so opening is cheap and nothing is copied until the data is actually touched.
+class MappedFile
+{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) noexcept = delete;
+		~MappedFile();
+
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) noexcept = delete;
+
+		bool open(const Path& aPath);
+		void close();
+
+		bool isOpen() const { return mData != nullptr; }
+
+		const uint8_t* data() const { return mData; }
+		size_t size() const { return mSize; }
+
+	private:
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+
+#if defined(PRIMAL_PLATFORM_WINDOWS)
+		void* mFile = nullptr;
+		void* mMapping = nullptr;
+#else
+		int mFile = -1;
+#endif
+};
+
+#endif // mappedfile_h__
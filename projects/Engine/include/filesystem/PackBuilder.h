@@ -0,0 +1,36 @@
+#ifndef packbuilder_h__
+#define packbuilder_h__
+
+#include <string>
+#include <vector>
+
+#include "core/Types.h"
+#include "filesystem/PackFormat.h"
+
+class PackBuilder
+{
+	public:
+		// Entry data starts on this boundary, 16 keeps cooked blobs readable in place with SIMD loads
+		void setAlignment(const uint32_t aAlignment);
+		void setCompression(const EPackCompression aCompression);
+
+		void addFile(const std::string& aPackPath, const Path& aSource);
+
+		// Adds every file below aRoot, named by its path relative to aRoot
+		void addDirectory(const Path& aRoot);
+
+		bool write(const Path& aDestination) const;
+
+	private:
+		struct Source
+		{
+			std::string packPath;
+			Path file;
+		};
+
+		std::vector<Source> mSources;
+		uint32_t mAlignment = 16;
+		EPackCompression mCompression = PACK_COMPRESSION_LZ4;
+};
+
+#endif // packbuilder_h__
@@ -0,0 +1,65 @@
+#ifndef packformat_h__
+#define packformat_h__
+
+#include <cstdint>
+
+// Layout of a .ppak archive:
+//
+//   PackHeader
+//   entry data, each entry starting on a PackHeader::alignment boundary
+//   PackEntry[entryCount], sorted by hash, at tocOffset
+//   path string table at stringsOffset
+//
+// Hashes are FNV-1a 64 of the entry path relative to the packed directory, with forward slashes. The
+// path itself is kept in the string table so hash collisions can be told apart.
+
+constexpr uint32_t packMagic = 0x4B415050; // "PPAK"
+constexpr uint32_t packVersion = 1;
+
+enum EPackCompression : uint32_t
+{
+	PACK_COMPRESSION_NONE = 0,
+	PACK_COMPRESSION_LZ4 = 1,
+};
+
+struct PackHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t alignment;
+
+	uint64_t tocOffset;
+	uint64_t stringsOffset;
+	uint64_t stringsSize;
+};
+
+struct PackEntry
+{
+	uint64_t hash;
+	uint64_t offset;
+	uint64_t size;
+	uint64_t storedSize;
+
+	uint32_t pathOffset;
+	uint32_t pathLength;
+	uint32_t compression;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 40, "PackHeader layout is part of the file format");
+static_assert(sizeof(PackEntry) == 48, "PackEntry layout is part of the file format");
+
+inline uint64_t packHashPath(const char* aPath, const size_t aLength)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < aLength; ++i)
+	{
+		hash ^= static_cast<uint8_t>(aPath[i]);
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+#endif // packformat_h__
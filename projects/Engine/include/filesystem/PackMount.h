@@ -0,0 +1,46 @@
+#ifndef packmount_h__
+#define packmount_h__
+
+#include <memory>
+
+#include "core/Types.h"
+#include "filesystem/DirectoryIndex.h"
+#include "filesystem/IMount.h"
+#include "filesystem/MappedFile.h"
+#include "filesystem/PackFormat.h"
+
+class PackMount final : public IMount
+{
+	public:
+		explicit PackMount(const Path& aPath);
+
+		bool isOpen() const;
+		uint32_t getEntryCount() const;
+
+		bool exists(const std::string& aPath) const override;
+		bool isDirectory(const std::string& aPath) const override;
+
+		void list(const std::string& aDirectory, const bool aRecursive, std::vector<std::string>& aFiles) const override;
+
+		bool read(const std::string& aPath, std::vector<char>& aData) const override;
+
+		// Uncompressed entries are returned as a span of the mapped archive, compressed ones are
+		// decompressed into a buffer owned by the view
+		FileView view(const std::string& aPath) const override;
+
+		bool getNativePath(const std::string& aPath, Path& aNativePath) const override;
+
+	private:
+		const PackEntry* _find(const std::string& aPath) const;
+
+		std::shared_ptr<MappedFile> mFile;
+
+		const PackEntry* mEntries = nullptr;
+		const char* mStrings = nullptr;
+		uint32_t mEntryCount = 0;
+
+		// Only used for directory queries, file lookups go through the sorted table of contents
+		DirectoryIndex mIndex;
+};
+
+#endif // packmount_h__
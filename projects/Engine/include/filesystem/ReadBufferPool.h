@@ -0,0 +1,39 @@
+#ifndef readbufferpool_h__
+#define readbufferpool_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Recycles read buffers in power of two size classes, so streaming many files does not hit the heap
+// for every read. Buffers return to the pool when the last shared_ptr to them is released.
+class ReadBufferPool
+{
+	public:
+		ReadBufferPool() = default;
+		ReadBufferPool(const ReadBufferPool&) = delete;
+		ReadBufferPool(ReadBufferPool&&) noexcept = delete;
+		~ReadBufferPool();
+
+		ReadBufferPool& operator=(const ReadBufferPool&) = delete;
+		ReadBufferPool& operator=(ReadBufferPool&&) noexcept = delete;
+
+		std::shared_ptr<uint8_t> acquire(const size_t aSize);
+
+		void trim();
+
+	private:
+		static constexpr uint32_t sMinClass = 12;
+		static constexpr uint32_t sMaxClass = 26;
+		static constexpr size_t sBuffersPerClass = 4;
+		static constexpr size_t sAlignment = 4096;
+
+		void _release(const uint32_t aClass, uint8_t* aBuffer);
+
+		std::mutex mMutex;
+		std::vector<uint8_t*> mFree[sMaxClass - sMinClass + 1];
+};
+
+#endif // readbufferpool_h__
@@ -7,6 +7,7 @@
 
 #include "core/PrimalAssert.h"
 
+#include "math/Half.h"
 #include "math/Vector2.h"
 #include "math/Vector3.h"
 #include "math/Vector4.h"
@@ -32,7 +33,8 @@ enum class EBufferLayoutElementTypes : uint32_t
 	VEC4,
 	MAT2,
 	MAT3,
-	MAT4
+	MAT4,
+	HALF
 };
 
 struct BufferLayoutElement
@@ -118,6 +120,12 @@ inline void BufferLayout::push<int64_t>(const std::string& aName, const uint32_t
 	_push(aName, EBufferLayoutElementTypes::LONG, sizeof(int64_t), aCount, aNormalized);
 }
 
+template<>
+inline void BufferLayout::push<Half>(const std::string& aName, const uint32_t aCount, const bool aNormalized)
+{
+	_push(aName, EBufferLayoutElementTypes::HALF, sizeof(Half), aCount, aNormalized);
+}
+
 template<>
 inline void BufferLayout::push<float>(const std::string& aName, const uint32_t aCount, const bool aNormalized)
 {
@@ -88,6 +88,29 @@ enum class EDataFormat : uint32_t
 	R32G32B32A32_UINT,
 	R32G32B32A32_SINT,
 	R32G32B32A32_SFLOAT,
+	D16_UNORM = 124,
+	X8_D24_UNORM_PACK32,
+	D32_SFLOAT,
+	S8_UINT,
+	D16_UNORM_S8_UINT,
+	D24_UNORM_S8_UINT,
+	D32_SFLOAT_S8_UINT,
+	BC1_RGB_UNORM_BLOCK,
+	BC1_RGB_SRGB_BLOCK,
+	BC1_RGBA_UNORM_BLOCK,
+	BC1_RGBA_SRGB_BLOCK,
+	BC2_UNORM_BLOCK,
+	BC2_SRGB_BLOCK,
+	BC3_UNORM_BLOCK,
+	BC3_SRGB_BLOCK,
+	BC4_UNORM_BLOCK,
+	BC4_SNORM_BLOCK,
+	BC5_UNORM_BLOCK,
+	BC5_SNORM_BLOCK,
+	BC6H_UFLOAT_BLOCK,
+	BC6H_SFLOAT_BLOCK,
+	BC7_UNORM_BLOCK,
+	BC7_SRGB_BLOCK,
 };
 
 #endif // dataformat_h__
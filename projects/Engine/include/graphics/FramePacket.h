@@ -0,0 +1,48 @@
+#ifndef framepacket_h__
+#define framepacket_h__
+
+#include <cstdint>
+#include <vector>
+
+#include "math/Matrix4.h"
+
+class Mesh;
+class MaterialInstance;
+
+struct DrawItem
+{
+	Mesh* mesh;
+	MaterialInstance* material;
+	Matrix4f model;
+
+	// Detail level of the mesh to draw, see Mesh::selectLod
+	uint32_t lod = 0;
+
+	// Pixels the mesh spans on screen, see Mesh::getScreenSize. Drives texture streaming.
+	float screenSize = 0.0f;
+};
+
+// Snapshot of everything the renderers need for one frame. Filled by System::extract on the
+// simulation side, consumed read-only by System::render, so both can run concurrently.
+struct FramePacket
+{
+	uint64_t frameIndex = 0;
+	float deltaTime = 0.0f;
+	float interpolationAlpha = 0.0f;
+
+	// Extent of the render target, captured so rendering never reads the window
+	uint32_t width = 0;
+	uint32_t height = 0;
+
+	Matrix4f view;
+	Matrix4f projection;
+
+	std::vector<DrawItem> draws;
+
+	void reset()
+	{
+		draws.clear();
+	}
+};
+
+#endif // framepacket_h__
@@ -22,15 +22,18 @@ struct MaterialGraphNode;
 namespace detail {
 	void PruneNode(MaterialGraphNode* aNode);
 	void ResetNode(MaterialGraphNode* aNode);
+	void MarkTextureUsersDirty(MaterialGraphNode* aNode, const ITexture* aTexture);
 }
 
 class Material
 {
 	friend void detail::PruneNode(MaterialGraphNode* aNode);
+	friend void detail::MarkTextureUsersDirty(MaterialGraphNode* aNode, const ITexture* aTexture);
 
 	friend struct MaterialGraphNode;
 	friend class MaterialInstance;
 	friend class MaterialManager;
+	friend class NullCommandBuffer;
 	friend class VulkanCommandBuffer;
 
 	struct BackingBufferInfo
@@ -56,6 +59,9 @@ class Material
 		void setDirtyFlag(bool aIsDirty);
 
 		void setTexture(const std::string& aName, ITexture* aTexture);
+
+		// Textures bound by this material, including those inherited from its ancestors
+		std::vector<ITexture*> getTextures() const;
 	private:
 		MaterialCreateInfo mCreateInfo;
 		IGraphicsPipeline* mPipeline;
@@ -85,6 +91,7 @@ class Material
 class MaterialInstance
 {
 	friend class Material;
+	friend class NullCommandBuffer;
 	friend class VulkanCommandBuffer;
 
 	Material* mParent;
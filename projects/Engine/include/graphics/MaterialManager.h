@@ -20,6 +20,9 @@ public:
 	void reset();
 
 	Material* createMaterial(const MaterialCreateInfo& aInfo);
+
+	// Makes every material using aTexture rewrite its descriptors, after the texture replaced its image
+	void markTextureDirty(const ITexture* aTexture);
 private:
 	static MaterialManager sManager;
 
@@ -3,18 +3,26 @@
 
 #include <vector>
 
+#include "math/Matrix4.h"
 #include "math/Vector3.h"
+#include "graphics/MeshClusters.h"
+#include "graphics/VertexFormat.h"
 #include "graphics/api/IIndexBuffer.h"
 #include "graphics/api/IVertexBuffer.h"
 
-struct Vertex
+struct SkinVertex;
+
+struct MeshLod
 {
-	Vector3f position;
-	Vector2f uv;
-	Vector3f normal;
-	Vector3f tangent;
-	Vector3f binormal;
-	Vector4f color;
+	uint32_t firstIndex;
+	uint32_t indexCount;
+
+	// Object space distance the surface may be off from the full mesh
+	float error;
+
+	// Range of the mesh's clusters covering this level, empty when it was not clustered
+	uint32_t firstCluster;
+	uint32_t clusterCount;
 };
 
 class Mesh
@@ -23,11 +31,28 @@ class Mesh
 		Mesh();
 		~Mesh();
 
+		// Format interleave() encodes the attribute arrays in
+		void setVertexFormat(const EVertexFormat aFormat);
+
+		// Interleaves the attribute arrays into vertices and computes the bounds, without touching the GPU
+		void interleave();
 		void build();
-		void recalculateTangents();
+
+		// Uses vertex and index data owned by someone else, e.g. a mapped cooked mesh. The memory has to
+		// stay valid for as long as the mesh may be uploaded.
+		void build(const void* aVertices, const size_t aVertexCount, const EVertexFormat aVertexFormat,
+			const void* aIndices, const size_t aIndexCount, const EIndexType aIndexType,
+			const Vector3f& aBoundsMin, const Vector3f& aBoundsMax);
+		// Smooth normals over the triangles, weighted by area
 		void recalculateNormals();
 
+		// Tangents and binormals from the uvs, recalculating the normals first if there are none
+		void recalculateTangents();
+
+		// binormal = normal x tangent, flipped where the binormal's x held a negative handedness before
 		void calculateBinormals();
+
+		// Makes triangles a valid triangle list for positions, a soup when it was empty
 		void triangulate();
 
 		std::vector<Vector3f> positions;
@@ -37,7 +62,7 @@ class Mesh
 		std::vector<Vector3f> binormals;
 		std::vector<Vector4f> colors;
 
-		std::vector<uint16_t> triangles;
+		std::vector<uint32_t> triangles;
 
 		IVertexBuffer* getVBO() const;
 		IIndexBuffer* getIBO() const;
@@ -47,11 +72,75 @@ class Mesh
 		size_t getIndicesSize() const;
 		size_t getSize() const;
 
+		size_t getVertexCount() const;
+		size_t getIndexCount() const;
+		EIndexType getIndexType() const;
+		EVertexFormat getVertexFormat() const;
+
+		// Turns stored positions back into object space: position * scale + offset. Identity unless the
+		// vertex format quantizes positions to the bounds.
+		Vector3f getPositionScale() const;
+		Vector3f getPositionOffset() const;
+
+		// Bytes held by the attribute arrays, the interleaved copy and the GPU buffers
+		size_t getMemoryUsage() const;
+
+		const Vector3f& getBoundsMin() const;
+		const Vector3f& getBoundsMax() const;
+
+		// Index ranges of the detail levels, finest first. A mesh without any has a single level covering
+		// every index.
+		void setLods(std::vector<MeshLod> aLods);
+		size_t getLodCount() const;
+		MeshLod getLod(const size_t aLod) const;
+
+		// Coarsest level whose error stays below aMaxPixelError pixels on screen, measured at the point of
+		// the bounds closest to the camera. aViewportHeight is in pixels and aProjection a perspective one.
+		size_t selectLod(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection,
+			const float aViewportHeight, const float aMaxPixelError = 1.0f) const;
+
+		// Pixels the bounding sphere spans on screen, measured like selectLod. Unbounded when the camera is
+		// inside the bounds.
+		float getScreenSize(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection,
+			const float aViewportHeight) const;
+
+		// One SkinVertex per vertex, owned by someone else like the data of build(). Null for static meshes.
+		void setSkin(const SkinVertex* aSkin);
+		const SkinVertex* getSkin() const;
+
+		// Clusters of every level, their index ranges relative to the start of the mesh's indices
+		void setClusters(std::vector<MeshCluster> aClusters);
+		const std::vector<MeshCluster>& getClusters() const;
+
+		// Appends the indices of the clusters of aLod that pass aView, returns how many clusters passed.
+		// A level without clusters is appended whole and counts as one.
+		size_t cullClusters(const size_t aLod, const ClusterCullView& aView, std::vector<uint32_t>& aIndices) const;
+
 	private:
+		void _createBuffers();
+		// Bounding sphere scale and radius in world space and pixels per world unit at its nearest point,
+		// false when the camera is inside it
+		bool _project(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection, const float aViewportHeight,
+			float& aScale, float& aRadius, float& aPixelsPerUnit) const;
+
 		IVertexBuffer* mVertexBuffer;
 		IIndexBuffer* mIndexBuffer;
 
-		std::vector<Vertex> mVertices;
+		std::vector<uint8_t> mVertices;
+
+		const void* mVertexData;
+		size_t mVertexCount;
+		EVertexFormat mVertexFormat;
+		const void* mIndexData;
+		size_t mIndexCount;
+		EIndexType mIndexType;
+		const SkinVertex* mSkin;
+
+		Vector3f mBoundsMin;
+		Vector3f mBoundsMax;
+
+		std::vector<MeshLod> mLods;
+		std::vector<MeshCluster> mClusters;
 };
 
 #endif // mesh_h__
\ No newline at end of file
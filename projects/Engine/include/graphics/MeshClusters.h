@@ -0,0 +1,56 @@
+#ifndef meshclusters_h__
+#define meshclusters_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "math/Matrix4.h"
+#include "math/Vector3.h"
+#include "math/Vector4.h"
+#include "graphics/VertexFormat.h"
+
+struct MeshCluster
+{
+	// Relative to the index range the clusters were built from
+	uint32_t firstIndex;
+	uint32_t indexCount;
+
+	Vector3f center;
+	float radius;
+
+	// Every triangle normal lies within the cone around coneAxis, coneCutoff is the sine of its half angle.
+	// A cutoff of 1 or more means the normals spread too far for the cone to ever cull.
+	Vector3f coneAxis;
+	float coneCutoff;
+};
+
+// Frustum planes and camera position in the object space of one draw, so cluster bounds never have to
+// be transformed
+struct ClusterCullView
+{
+	Vector4f planes[6];
+	Vector3f cameraPosition;
+
+	// Backface cones are only tested for perspective projections
+	bool perspective = false;
+
+	static ClusterCullView create(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection);
+};
+
+// Splits triangle lists into small clusters with bounds tight enough to cull parts of a mesh, sized for
+// mesh shaders so the same data can feed GPU driven paths
+class MeshClusters
+{
+	public:
+		static constexpr uint32_t sMaxVertices = 64;
+		static constexpr uint32_t sMaxTriangles = 124;
+
+		// Reorders the triangles of aIndices so every cluster is a contiguous index range. Clusters grow
+		// over adjacent triangles, keeping the original triangle order inside each one.
+		static std::vector<MeshCluster> build(const std::vector<Vertex>& aVertices, uint32_t* aIndices, const size_t aIndexCount);
+
+		static bool isVisible(const MeshCluster& aCluster, const ClusterCullView& aView);
+};
+
+#endif // meshclusters_h__
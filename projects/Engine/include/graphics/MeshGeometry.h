@@ -0,0 +1,30 @@
+#ifndef meshgeometry_h__
+#define meshgeometry_h__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "math/Vector2.h"
+#include "math/Vector3.h"
+
+// Vertex attribute generation over separate attribute arrays, for procedural meshes and imports that lack
+// the attributes. Each kernel runs one parallel pass over triangle ranges writing per triangle results,
+// then one over vertex ranges gathering them through a vertex to triangle table, so no two tasks ever
+// write the same vertex.
+class MeshGeometry
+{
+	public:
+		// Sum of the adjacent face normals weighted by triangle area, normalized
+		static void computeNormals(const Vector3f* aPositions, const size_t aVertexCount,
+			const uint32_t* aIndices, const size_t aIndexCount, Vector3f* aNormals);
+
+		// Tangent space following MikkTSpace: per triangle directions from the uv gradients, projected
+		// onto each vertex normal's plane, normalized and weighted by the corner angle. aBinormals gets
+		// normal x tangent, flipped for mirrored uvs. Vertices are never split, so a vertex shared across
+		// a uv mirror seam ends up with the handedness of the larger side.
+		static void computeTangents(const Vector3f* aPositions, const Vector2f* aUvs, const Vector3f* aNormals,
+			const size_t aVertexCount, const uint32_t* aIndices, const size_t aIndexCount,
+			Vector3f* aTangents, Vector3f* aBinormals);
+};
+
+#endif // meshgeometry_h__
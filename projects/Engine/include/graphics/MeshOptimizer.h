@@ -0,0 +1,76 @@
+#ifndef meshoptimizer_h__
+#define meshoptimizer_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graphics/VertexFormat.h"
+
+struct VertexCacheStats
+{
+	size_t triangles = 0;
+	size_t vertices = 0;
+	size_t misses = 0;
+
+	// Average cache miss ratio, transformed vertices per triangle. 0.5 is the best a regular grid gets.
+	float getAcmr() const { return triangles > 0 ? static_cast<float>(misses) / static_cast<float>(triangles) : 0.0f; }
+
+	// Average transform to vertex ratio, 1.0 means every vertex is shaded exactly once
+	float getAtvr() const { return vertices > 0 ? static_cast<float>(misses) / static_cast<float>(vertices) : 0.0f; }
+
+	VertexCacheStats& operator += (const VertexCacheStats& aOther)
+	{
+		triangles += aOther.triangles;
+		vertices += aOther.vertices;
+		misses += aOther.misses;
+
+		return *this;
+	}
+};
+
+struct MeshOptimizeResult
+{
+	VertexCacheStats before;
+	VertexCacheStats after;
+
+	size_t verticesBefore = 0;
+	size_t verticesAfter = 0;
+
+	// Index every output vertex had in the input
+	std::vector<uint32_t> remap;
+};
+
+// Offline processing for triangle lists, meant to run while cooking. Every function takes 32 bit indices
+// into aVertices and leaves the triangles themselves unchanged.
+class MeshOptimizer
+{
+	public:
+		static constexpr uint32_t sDefaultCacheSize = 16;
+
+		// Merges vertices that are bit for bit identical and shrinks aVertices to the unique ones. aAttributes
+		// holds aAttributeSize more bytes per vertex that have to match as well, such as skin influences.
+		// Returns the index every remaining vertex had before.
+		static std::vector<uint32_t> weldVertices(std::vector<Vertex>& aVertices, std::vector<uint32_t>& aIndices,
+			const void* aAttributes = nullptr, const size_t aAttributeSize = 0);
+
+		// Reorders triangles for the post transform cache with Tipsify (Sander et al. 2007), linear in the
+		// triangle count
+		static void optimizeVertexCache(std::vector<uint32_t>& aIndices, const size_t aVertexCount,
+			const uint32_t aCacheSize = sDefaultCacheSize);
+
+		// Orders vertices by first use in aIndices and drops the ones no triangle references. Returns the
+		// index every remaining vertex had before.
+		static std::vector<uint32_t> optimizeVertexFetch(std::vector<Vertex>& aVertices, std::vector<uint32_t>& aIndices);
+
+		// Simulates a FIFO post transform cache of aCacheSize entries
+		static VertexCacheStats analyzeVertexCache(const uint32_t* aIndices, const size_t aIndexCount, const size_t aVertexCount,
+			const uint32_t aCacheSize = sDefaultCacheSize);
+
+		// Welds, then reorders for the vertex cache and then for vertex fetch. aAttributes are passed on to
+		// weldVertices().
+		static MeshOptimizeResult optimize(std::vector<Vertex>& aVertices, std::vector<uint32_t>& aIndices,
+			const void* aAttributes = nullptr, const size_t aAttributeSize = 0);
+};
+
+#endif // meshoptimizer_h__
@@ -0,0 +1,35 @@
+#ifndef meshsimplifier_h__
+#define meshsimplifier_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graphics/VertexFormat.h"
+
+struct SimplifiedLod
+{
+	std::vector<uint32_t> indices;
+
+	// Object space distance the surface may have moved, attribute deviation included
+	float error = 0.0f;
+};
+
+// Quadric error metric simplification (Garland and Heckbert) on position, uv and normal. Edges are collapsed
+// into one of their vertices, so a simplified mesh only references a subset of the original vertices and
+// every LOD can share one vertex buffer. Vertices on open borders or on attribute seams never move.
+class MeshSimplifier
+{
+	public:
+		// Collapses edges until at most aTargetIndexCount indices remain or the next collapse would move the
+		// surface by more than aTargetError, relative to the largest extent of the mesh
+		static std::vector<uint32_t> simplify(const std::vector<Vertex>& aVertices, const std::vector<uint32_t>& aIndices,
+			const size_t aTargetIndexCount, const float aTargetError, float* aResultError = nullptr);
+
+		// Each level targets aReduction times the triangles of the previous one and is simplified from it, so its
+		// error adds to the previous level's. Stops early once a level no longer gets meaningfully smaller.
+		static std::vector<SimplifiedLod> generateLods(const std::vector<Vertex>& aVertices, const std::vector<uint32_t>& aIndices,
+			const uint32_t aLodCount, const float aReduction, const float aMaxError);
+};
+
+#endif // meshsimplifier_h__
@@ -13,6 +13,7 @@ struct SceneDataCreateInfo
 
 class SceneData
 {
+		friend class NullCommandBuffer;
 		friend class VulkanCommandBuffer;
 	public:
 		explicit SceneData(const SceneDataCreateInfo& aInfo);
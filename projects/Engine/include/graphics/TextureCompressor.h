@@ -0,0 +1,54 @@
+#ifndef texturecompressor_h__
+#define texturecompressor_h__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "graphics/DataFormat.h"
+
+enum class ETextureCompression : uint32_t
+{
+	NONE = 0,
+	// RGB with 1 bit alpha, 4 bits per texel
+	BC1,
+	// RGBA, 8 bits per texel
+	BC3,
+	// Two independent channels such as normal map xy, 8 bits per texel
+	BC5,
+	// RGBA at higher quality than BC3, 8 bits per texel
+	BC7
+};
+
+enum class EMipFilter : uint32_t
+{
+	BOX = 0,
+	// Kaiser windowed sinc, sharper than a box without visible ringing
+	KAISER
+};
+
+// Offline processing of RGBA8 images into texture levels: mip chain generation and CPU block compression.
+// Every function runs in parallel over rows of texels or blocks.
+class TextureCompressor
+{
+	public:
+		// Levels of a full chain down to 1x1
+		static uint32_t getLevelCount(const uint32_t aWidth, const uint32_t aHeight);
+
+		// The format levels of aCompression are stored in. BC5 has no sRGB variant.
+		static EDataFormat getFormat(const ETextureCompression aCompression, const bool aSrgb);
+
+		// Bytes of one aWidth x aHeight level, 0 for formats textures are never stored in
+		static size_t getLevelSize(const EDataFormat aFormat, const uint32_t aWidth, const uint32_t aHeight);
+
+		// Halves an RGBA8 image in both dimensions, never below 1, into aDestination. With aSrgb the color
+		// channels are converted to linear before filtering and back after it, alpha is always linear.
+		static void downsample(const uint8_t* aSource, const uint32_t aWidth, const uint32_t aHeight,
+			const bool aSrgb, const EMipFilter aFilter, uint8_t* aDestination);
+
+		// Encodes an RGBA8 image into getLevelSize(getFormat(aCompression, ...), aWidth, aHeight) bytes.
+		// Blocks reaching past the image edge repeat its last row and column. BC5 encodes red and green.
+		static void compress(const uint8_t* aSource, const uint32_t aWidth, const uint32_t aHeight,
+			const ETextureCompression aCompression, uint8_t* aDestination);
+};
+
+#endif // texturecompressor_h__
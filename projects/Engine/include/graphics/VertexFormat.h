@@ -0,0 +1,68 @@
+#ifndef vertexformat_h__
+#define vertexformat_h__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "graphics/BufferLayout.h"
+#include "math/Half.h"
+#include "math/Vector2.h"
+#include "math/Vector3.h"
+#include "math/Vector4.h"
+
+struct Vertex
+{
+	Vector3f position;
+	Vector2f uv;
+	Vector3f normal;
+	Vector3f tangent;
+	Vector3f binormal;
+	Vector4f color;
+};
+
+// Every format except VERTEX_FORMAT_FLOAT stores a CompactVertex: the position's w holds the binormal
+// sign, normal and tangent are octahedral encoded and the binormal is cross(normal, tangent) * sign.
+// UNORM16 positions are relative to the mesh bounds, see Mesh::getPositionScale and getPositionOffset.
+enum EVertexFormat : uint32_t
+{
+	VERTEX_FORMAT_FLOAT = 0,
+	VERTEX_FORMAT_UNORM16 = 1,
+	VERTEX_FORMAT_UNORM16_COLOR = 2,
+	VERTEX_FORMAT_HALF = 3,
+	VERTEX_FORMAT_HALF_COLOR = 4
+};
+
+struct CompactVertex
+{
+	uint16_t position[4];
+	int16_t normal[2];
+	int16_t tangent[2];
+	Half uv[2];
+
+	// Left out of the stride by formats without color
+	uint8_t color[4];
+};
+
+static_assert(sizeof(Vertex) == 72, "Vertex layout is part of the cooked mesh format");
+static_assert(sizeof(CompactVertex) == 24, "CompactVertex layout is part of the cooked mesh format");
+
+class VertexFormat
+{
+	public:
+		static size_t getStride(const EVertexFormat aFormat);
+		static BufferLayout getLayout(const EVertexFormat aFormat);
+
+		static bool isValid(const uint32_t aFormat);
+		static bool hasColor(const EVertexFormat aFormat);
+
+		// The variant of aFormat that does or does not store color
+		static EVertexFormat withColor(const EVertexFormat aFormat, const bool aColor);
+
+		// aBoundsMin and aBoundsMax have to enclose every position, UNORM16 quantizes positions within them
+		static void encode(const Vertex* aVertices, const size_t aCount, const EVertexFormat aFormat,
+			const Vector3f& aBoundsMin, const Vector3f& aBoundsMax, void* aOut);
+		static void decode(const void* aData, const size_t aCount, const EVertexFormat aFormat,
+			const Vector3f& aBoundsMin, const Vector3f& aBoundsMax, Vertex* aOut);
+};
+
+#endif // vertexformat_h__
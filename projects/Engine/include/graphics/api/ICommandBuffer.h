@@ -4,6 +4,7 @@
 #include "graphics/ClearValue.h"
 #include "graphics/Material.h"
 #include "graphics/SceneData.h"
+#include "graphics/ShaderStageFlags.h"
 #include "graphics/api/ICommandPool.h"
 #include "graphics/api/IFramebuffer.h"
 #include "graphics/api/IGraphicsContext.h"
@@ -113,6 +114,9 @@ class ICommandBuffer
 		virtual void bindMaterialInstance(MaterialInstance* aInstance, uint32_t aFrame) = 0;
 		virtual void bindSceneData(SceneData* aData, uint32_t aFrame) = 0;
 
+		// Copies aSize bytes of aData into the push constant range of aPipeline's layout at aOffset
+		virtual void pushConstants(IGraphicsPipeline* aPipeline, ShaderStageFlags aStages, uint32_t aOffset, uint32_t aSize, const void* aData) = 0;
+
 		virtual void draw(uint32_t aVertexCount, uint32_t aInstanceCount = 1, uint32_t aFirstVertex = 0, uint32_t aFirstInstance = 0) = 0;
 		virtual void drawIndexed(uint32_t aIndexCount, uint32_t aInstanceCount = 1, uint32_t aFirstIndex = 0, int32_t aVertexOffset = 0, uint32_t aFirstInstance = 0) = 0;
 };
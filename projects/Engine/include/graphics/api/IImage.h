@@ -141,6 +141,10 @@ struct ImageCreateInfo
 	MemoryPropertyFlags memoryRequiredFlags;
 	MemoryPropertyFlags memoryPreferredFlags;
 	AllocationCreationFlags memoryAllocationFlags;
+
+	// Where each level from baseMipLevel on starts in the data passed to setData. Empty uploads a single
+	// level from the start of the data.
+	std::vector<uint64_t> levelOffsets;
 };
 
 class IImage
@@ -28,6 +28,10 @@ class ITexture
 		ITexture& operator=(ITexture&&) noexcept = delete;
 
 		virtual void construct(const TextureCreateInfo&) = 0;
+		// Replaces the image with one built from the levels the asset describes now. Levels the previous image
+		// holds are copied from it on the GPU and only the others are uploaded. The previous image is released
+		// once the frames that may sample it are done, so descriptors referencing it have to be rewritten.
+		virtual void reconstruct(const TextureCreateInfo&) = 0;
 		virtual ShaderStageFlags getStageFlags() const = 0;
 		virtual uint32_t getBindingPoint() const = 0;
 	protected:
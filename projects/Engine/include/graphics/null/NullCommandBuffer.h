@@ -0,0 +1,90 @@
+#ifndef nullcommandbuffer_h__
+#define nullcommandbuffer_h__
+
+#include "graphics/api/ICommandBuffer.h"
+
+#include <vector>
+
+enum class ENullCommandType : uint32_t
+{
+	BEGIN_RENDER_PASS,
+	END_RENDER_PASS,
+	COPY_BUFFER,
+	BIND_PIPELINE,
+	BIND_VERTEX_BUFFERS,
+	BIND_INDEX_BUFFER,
+	BIND_DESCRIPTOR_SETS,
+	PUSH_CONSTANTS,
+	DRAW,
+	DRAW_INDEXED
+};
+
+struct NullCommand
+{
+	ENullCommandType type;
+	const void* object;
+	uint32_t arguments[5];
+};
+
+class NullCommandBuffer final : public ICommandBuffer
+{
+	public:
+		explicit NullCommandBuffer(IGraphicsContext* aContext);
+		NullCommandBuffer(const NullCommandBuffer&) = delete;
+		NullCommandBuffer(NullCommandBuffer&&) noexcept = delete;
+		~NullCommandBuffer() override = default;
+
+		NullCommandBuffer& operator=(const NullCommandBuffer&) = delete;
+		NullCommandBuffer& operator=(NullCommandBuffer&&) noexcept = delete;
+
+		void addDependency(ICommandBuffer* aDependsOn) override;
+		void removeDependency(ICommandBuffer* aDependsOn) override;
+
+		void construct(const CommandBufferCreateInfo& aInfo) override;
+		void reconstruct(const CommandBufferCreateInfo& aInfo) override;
+		void destroy() override;
+
+		void record(const CommandBufferRecordInfo& aInfo) override;
+		void end() override;
+
+		void recordRenderPass(const RenderPassRecordInfo& aInfo) override;
+		void endRenderPass() override;
+
+		void copyBuffers(ISwapChain* aSwapchain, IVertexBuffer* aBuffer, void* aData, const size_t aSize) override;
+		void copyBuffers(ISwapChain* aSwapchain, IIndexBuffer* aBuffer, void* aData, const size_t aSize) override;
+		void bindGraphicsPipeline(IGraphicsPipeline* aPipeline) override;
+		void bindVertexBuffers(uint32_t aFirstBinding, uint32_t aBindingCount, std::vector<IVertexBuffer*> aBuffers, std::vector<uint64_t> aOffsets) override;
+		void bindIndexBuffer(IIndexBuffer* aBuffer, uint64_t aOffset, EIndexType aType) override;
+		void bindMaterial(Material* aMaterial, uint32_t aFrame) override;
+		void bindMaterialInstance(MaterialInstance* aInstance, uint32_t aFrame) override;
+		void bindSceneData(SceneData* aData, uint32_t aFrame) override;
+		void pushConstants(IGraphicsPipeline* aPipeline, ShaderStageFlags aStages, uint32_t aOffset, uint32_t aSize, const void* aData) override;
+
+		void draw(uint32_t aVertexCount, uint32_t aInstanceCount, uint32_t aFirstVertex, uint32_t aFirstInstance) override;
+		void drawIndexed(uint32_t aIndexCount, uint32_t aInstanceCount, uint32_t aFirstIndex, int32_t aVertexOffset, uint32_t aFirstInstance) override;
+
+		const std::vector<NullCommand>& getCommands() const;
+
+		// Bytes of every push constant command, indexed by its last argument
+		const std::vector<uint8_t>& getConstants() const;
+		const std::vector<ICommandBuffer*>& getDependencies() const;
+		bool isRecording() const;
+		bool isPrimary() const;
+
+	private:
+		void _push(ENullCommandType aType, const void* aObject, uint32_t aArg0 = 0, uint32_t aArg1 = 0,
+			uint32_t aArg2 = 0, uint32_t aArg3 = 0, uint32_t aArg4 = 0);
+
+		IGraphicsContext* mContext;
+		bool mPrimary = true;
+		bool mRecording = false;
+
+		std::vector<NullCommand> mCommands;
+		std::vector<uint8_t> mConstants;
+		std::vector<ICommandBuffer*> mThisDependsOn;
+
+		SceneData* mData = nullptr;
+		std::vector<uint32_t> mDynamicOffsets;
+};
+
+#endif // nullcommandbuffer_h__
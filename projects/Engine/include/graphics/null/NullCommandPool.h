@@ -0,0 +1,24 @@
+#ifndef nullcommandpool_h__
+#define nullcommandpool_h__
+
+#include "graphics/api/ICommandPool.h"
+
+class NullCommandPool final : public ICommandPool
+{
+	public:
+		explicit NullCommandPool(IGraphicsContext* aContext);
+		NullCommandPool(const NullCommandPool&) = delete;
+		NullCommandPool(NullCommandPool&&) noexcept = delete;
+		~NullCommandPool() override = default;
+
+		NullCommandPool& operator=(const NullCommandPool&) = delete;
+		NullCommandPool& operator=(NullCommandPool&&) noexcept = delete;
+
+		void construct(const CommandPoolCreateInfo& aInfo) override;
+
+		const CommandPoolCreateInfo& getCreateInfo() const;
+	private:
+		CommandPoolCreateInfo mInfo{};
+};
+
+#endif // nullcommandpool_h__
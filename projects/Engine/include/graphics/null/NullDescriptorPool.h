@@ -0,0 +1,24 @@
+#ifndef nulldescriptorpool_h__
+#define nulldescriptorpool_h__
+
+#include "graphics/api/IDescriptorPool.h"
+
+class NullDescriptorPool final : public IDescriptorPool
+{
+	public:
+		explicit NullDescriptorPool(IGraphicsContext* aContext);
+		NullDescriptorPool(const NullDescriptorPool&) = delete;
+		NullDescriptorPool(NullDescriptorPool&&) noexcept = delete;
+		~NullDescriptorPool() override = default;
+
+		NullDescriptorPool& operator=(const NullDescriptorPool&) = delete;
+		NullDescriptorPool& operator=(NullDescriptorPool&&) noexcept = delete;
+
+		void construct(const DescriptorPoolCreateInfo& aInfo) override;
+
+		const DescriptorPoolCreateInfo& getCreateInfo() const;
+	private:
+		DescriptorPoolCreateInfo mInfo{};
+};
+
+#endif // nulldescriptorpool_h__
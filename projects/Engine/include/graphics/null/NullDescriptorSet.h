@@ -0,0 +1,25 @@
+#ifndef nulldescriptorset_h__
+#define nulldescriptorset_h__
+
+#include "graphics/api/IDescriptorSet.h"
+
+class NullDescriptorSet final : public IDescriptorSet
+{
+	public:
+		explicit NullDescriptorSet(IGraphicsContext* aContext);
+		NullDescriptorSet(const NullDescriptorSet&) = delete;
+		NullDescriptorSet(NullDescriptorSet&&) noexcept = delete;
+		~NullDescriptorSet() override = default;
+
+		NullDescriptorSet& operator=(const NullDescriptorSet&) = delete;
+		NullDescriptorSet& operator=(NullDescriptorSet&&) noexcept = delete;
+
+		void construct(const DescriptorSetCreateInfo& aInfo) override;
+
+		IDescriptorPool* getPool() const;
+		const std::vector<IDescriptorSetLayout*>& getLayouts() const;
+	private:
+		DescriptorSetCreateInfo mInfo{};
+};
+
+#endif // nulldescriptorset_h__
@@ -0,0 +1,25 @@
+#ifndef nulldescriptorsetlayout_h__
+#define nulldescriptorsetlayout_h__
+
+#include "graphics/api/IDescriptorSetLayout.h"
+
+class NullDescriptorSetLayout final : public IDescriptorSetLayout
+{
+	public:
+		explicit NullDescriptorSetLayout(IGraphicsContext* aContext);
+		NullDescriptorSetLayout(const NullDescriptorSetLayout&) = delete;
+		NullDescriptorSetLayout(NullDescriptorSetLayout&&) noexcept = delete;
+		~NullDescriptorSetLayout() override = default;
+
+		NullDescriptorSetLayout& operator=(const NullDescriptorSetLayout&) = delete;
+		NullDescriptorSetLayout& operator=(NullDescriptorSetLayout&&) noexcept = delete;
+
+		void construct(const DescriptorSetLayoutCreateInfo& aInfo) override;
+		void reconstruct(const DescriptorSetLayoutCreateInfo& aInfo) override;
+
+		const std::vector<DescriptorSetLayoutBinding>& getBindings() const;
+	private:
+		DescriptorSetLayoutCreateInfo mInfo{};
+};
+
+#endif // nulldescriptorsetlayout_h__
@@ -0,0 +1,26 @@
+#ifndef nullframebuffer_h__
+#define nullframebuffer_h__
+
+#include "graphics/api/IFramebuffer.h"
+
+class NullFramebuffer final : public IFramebuffer
+{
+	public:
+		explicit NullFramebuffer(IGraphicsContext* aContext);
+		NullFramebuffer(const NullFramebuffer&) = delete;
+		NullFramebuffer(NullFramebuffer&&) noexcept = delete;
+		~NullFramebuffer() override = default;
+
+		NullFramebuffer& operator=(const NullFramebuffer&) = delete;
+		NullFramebuffer& operator=(NullFramebuffer&&) noexcept = delete;
+
+		void construct(const FramebufferCreateInfo& aInfo) override;
+		void reconstruct(const FramebufferCreateInfo& aInfo) override;
+		void destroy() override;
+
+		const FramebufferCreateInfo& getCreateInfo() const;
+	private:
+		FramebufferCreateInfo mInfo{};
+};
+
+#endif // nullframebuffer_h__
@@ -0,0 +1,63 @@
+#ifndef nullgraphicscontext_h__
+#define nullgraphicscontext_h__
+
+#include "graphics/api/IGraphicsContext.h"
+
+#include <atomic>
+#include <cstdint>
+
+class NullCommandBuffer;
+class NullCommandPool;
+
+struct NullFrameStatistics
+{
+	uint64_t submissions = 0;
+	uint64_t commands = 0;
+	uint64_t renderPasses = 0;
+	uint64_t pipelineBinds = 0;
+	uint64_t descriptorBinds = 0;
+	uint64_t drawCalls = 0;
+	uint64_t vertices = 0;
+	uint64_t indices = 0;
+	uint64_t uploadedBytes = 0;
+};
+
+// Graphics context that owns no device. Every resource created through the GraphicsFactory while
+// this context is active records into CPU-side storage, so frames can be driven without a GPU.
+class NullGraphicsContext final : public IGraphicsContext
+{
+	public:
+		explicit NullGraphicsContext(const GraphicsContextCreateInfo& aCreateInfo);
+		NullGraphicsContext(const NullGraphicsContext&) = delete;
+		NullGraphicsContext(NullGraphicsContext&&) noexcept = delete;
+		~NullGraphicsContext() override;
+
+		NullGraphicsContext& operator=(const NullGraphicsContext&) = delete;
+		NullGraphicsContext& operator=(NullGraphicsContext&&) noexcept = delete;
+
+		void idle() const override;
+
+		void submit(const NullCommandBuffer* aBuffer);
+
+		NullCommandPool* getCommandPool() const;
+		NullCommandPool* getTransferCommandPool() const;
+
+		NullFrameStatistics getStatistics() const;
+		void resetStatistics();
+
+	private:
+		NullCommandPool* mCommandPool;
+		NullCommandPool* mTransferCommandPool;
+
+		std::atomic<uint64_t> mSubmissions;
+		std::atomic<uint64_t> mCommands;
+		std::atomic<uint64_t> mRenderPasses;
+		std::atomic<uint64_t> mPipelineBinds;
+		std::atomic<uint64_t> mDescriptorBinds;
+		std::atomic<uint64_t> mDrawCalls;
+		std::atomic<uint64_t> mVertices;
+		std::atomic<uint64_t> mIndices;
+		std::atomic<uint64_t> mUploadedBytes;
+};
+
+#endif // nullgraphicscontext_h__
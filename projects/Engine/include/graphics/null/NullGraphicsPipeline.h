@@ -0,0 +1,27 @@
+#ifndef nullgraphicspipeline_h__
+#define nullgraphicspipeline_h__
+
+#include "graphics/api/IGraphicsPipeline.h"
+
+class NullGraphicsPipeline final : public IGraphicsPipeline
+{
+	public:
+		explicit NullGraphicsPipeline(IGraphicsContext* aContext);
+		NullGraphicsPipeline(const NullGraphicsPipeline&) = delete;
+		NullGraphicsPipeline(NullGraphicsPipeline&&) noexcept = delete;
+		~NullGraphicsPipeline() override = default;
+
+		NullGraphicsPipeline& operator=(const NullGraphicsPipeline&) = delete;
+		NullGraphicsPipeline& operator=(NullGraphicsPipeline&&) noexcept = delete;
+
+		void construct(const GraphicsPipelineCreateInfo& aInfo) override;
+		void reconstruct(const GraphicsPipelineCreateInfo& aInfo) override;
+		void destroy() override;
+
+		GraphicsPipelineCreateInfo& getCreateInfo() override;
+		IPipelineLayout* getLayout() const;
+	private:
+		GraphicsPipelineCreateInfo mCreateInfo{};
+};
+
+#endif // nullgraphicspipeline_h__
@@ -0,0 +1,30 @@
+#ifndef nullimage_h__
+#define nullimage_h__
+
+#include "graphics/api/IImage.h"
+
+#include <vector>
+
+class NullImage final : public IImage
+{
+	public:
+		explicit NullImage(IGraphicsContext* aContext);
+		NullImage(const NullImage&) = delete;
+		NullImage(NullImage&&) noexcept = delete;
+		~NullImage() override = default;
+
+		NullImage& operator=(const NullImage&) = delete;
+		NullImage& operator=(NullImage&&) noexcept = delete;
+
+		void construct(const ImageCreateInfo& aInfo) override;
+		void reconstruct(const ImageCreateInfo& aInfo) override;
+		void setData(void* aData, const size_t aSize) override;
+
+		const ImageCreateInfo& getCreateInfo() const;
+		const std::vector<uint8_t>& getData() const;
+	private:
+		ImageCreateInfo mInfo{};
+		std::vector<uint8_t> mData;
+};
+
+#endif // nullimage_h__
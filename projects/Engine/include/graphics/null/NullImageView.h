@@ -0,0 +1,25 @@
+#ifndef nullimageview_h__
+#define nullimageview_h__
+
+#include "graphics/api/IImageView.h"
+
+class NullImageView final : public IImageView
+{
+	public:
+		explicit NullImageView(IGraphicsContext* aContext);
+		NullImageView(const NullImageView&) = delete;
+		NullImageView(NullImageView&&) noexcept = delete;
+		~NullImageView() override = default;
+
+		NullImageView& operator=(const NullImageView&) = delete;
+		NullImageView& operator=(NullImageView&&) noexcept = delete;
+
+		void construct(const ImageViewCreateInfo& aInfo) override;
+
+		IImage* getImage() const;
+		const ImageViewCreateInfo& getCreateInfo() const;
+	private:
+		ImageViewCreateInfo mInfo{};
+};
+
+#endif // nullimageview_h__
@@ -0,0 +1,30 @@
+#ifndef nullindexbuffer_h__
+#define nullindexbuffer_h__
+
+#include "graphics/api/IIndexBuffer.h"
+
+#include <vector>
+
+class NullIndexBuffer final : public IIndexBuffer
+{
+	public:
+		explicit NullIndexBuffer(IGraphicsContext* aContext);
+		NullIndexBuffer(const NullIndexBuffer&) = delete;
+		NullIndexBuffer(NullIndexBuffer&&) noexcept = delete;
+		~NullIndexBuffer() override = default;
+
+		NullIndexBuffer& operator=(const NullIndexBuffer&) = delete;
+		NullIndexBuffer& operator=(NullIndexBuffer&&) noexcept = delete;
+
+		void construct(const IndexBufferCreateInfo& aInfo) override;
+
+		[[nodiscard]] uint32_t getCount() const override;
+
+		void setData(const void* aData, const size_t aSize);
+		const std::vector<uint8_t>& getData() const;
+	private:
+		IndexBufferCreateInfo mInfo{};
+		std::vector<uint8_t> mData;
+};
+
+#endif // nullindexbuffer_h__
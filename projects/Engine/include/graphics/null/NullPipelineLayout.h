@@ -0,0 +1,26 @@
+#ifndef nullpipelinelayout_h__
+#define nullpipelinelayout_h__
+
+#include "graphics/api/IPipelineLayout.h"
+
+class NullPipelineLayout final : public IPipelineLayout
+{
+	public:
+		explicit NullPipelineLayout(IGraphicsContext* aContext);
+		NullPipelineLayout(const NullPipelineLayout&) = delete;
+		NullPipelineLayout(NullPipelineLayout&&) noexcept = delete;
+		~NullPipelineLayout() override = default;
+
+		NullPipelineLayout& operator=(const NullPipelineLayout&) = delete;
+		NullPipelineLayout& operator=(NullPipelineLayout&&) noexcept = delete;
+
+		void construct(const PipelineLayoutCreateInfo& aInfo) override;
+		void reconstruct(const PipelineLayoutCreateInfo& aInfo) override;
+		void destroy() override;
+
+		const PipelineLayoutCreateInfo& getCreateInfo() const;
+	private:
+		PipelineLayoutCreateInfo mInfo{};
+};
+
+#endif // nullpipelinelayout_h__
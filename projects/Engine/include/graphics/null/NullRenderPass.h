@@ -0,0 +1,26 @@
+#ifndef nullrenderpass_h__
+#define nullrenderpass_h__
+
+#include "graphics/api/IRenderPass.h"
+
+class NullRenderPass final : public IRenderPass
+{
+	public:
+		explicit NullRenderPass(IGraphicsContext* aContext);
+		NullRenderPass(const NullRenderPass&) = delete;
+		NullRenderPass(NullRenderPass&&) noexcept = delete;
+		~NullRenderPass() override = default;
+
+		NullRenderPass& operator=(const NullRenderPass&) = delete;
+		NullRenderPass& operator=(NullRenderPass&&) noexcept = delete;
+
+		void construct(const RenderPassCreateInfo& aInfo) override;
+		void reconstruct(const RenderPassCreateInfo& aInfo) override;
+		void destroy() override;
+
+		RenderPassCreateInfo& getCreateInfo() override;
+	private:
+		RenderPassCreateInfo mInfo;
+};
+
+#endif // nullrenderpass_h__
@@ -0,0 +1,24 @@
+#ifndef nullsampler_h__
+#define nullsampler_h__
+
+#include "graphics/api/ISampler.h"
+
+class NullSampler final : public ISampler
+{
+	public:
+		explicit NullSampler(IGraphicsContext* aContext);
+		NullSampler(const NullSampler&) = delete;
+		NullSampler(NullSampler&&) noexcept = delete;
+		~NullSampler() override = default;
+
+		NullSampler& operator=(const NullSampler&) = delete;
+		NullSampler& operator=(NullSampler&&) noexcept = delete;
+
+		void construct(const SamplerCreateInfo& aInfo) override;
+
+		const SamplerCreateInfo& getCreateInfo() const;
+	private:
+		SamplerCreateInfo mInfo{};
+};
+
+#endif // nullsampler_h__
@@ -0,0 +1,24 @@
+#ifndef nullshadermodule_h__
+#define nullshadermodule_h__
+
+#include "graphics/api/IShaderModule.h"
+
+class NullShaderModule final : public IShaderModule
+{
+	public:
+		explicit NullShaderModule(IGraphicsContext* aContext);
+		NullShaderModule(const NullShaderModule&) = delete;
+		NullShaderModule(NullShaderModule&&) noexcept = delete;
+		~NullShaderModule() override = default;
+
+		NullShaderModule& operator=(const NullShaderModule&) = delete;
+		NullShaderModule& operator=(NullShaderModule&&) noexcept = delete;
+
+		void construct(const ShaderModuleCreateInfo& aInfo) override;
+
+		const std::vector<char>& getCode() const;
+	private:
+		std::vector<char> mCode;
+};
+
+#endif // nullshadermodule_h__
@@ -0,0 +1,26 @@
+#ifndef nullshaderstage_h__
+#define nullshaderstage_h__
+
+#include "graphics/api/IShaderStage.h"
+
+class NullShaderStage final : public IShaderStage
+{
+	public:
+		explicit NullShaderStage(IGraphicsContext* aContext);
+		NullShaderStage(const NullShaderStage&) = delete;
+		NullShaderStage(NullShaderStage&&) noexcept = delete;
+		~NullShaderStage() override = default;
+
+		NullShaderStage& operator=(const NullShaderStage&) = delete;
+		NullShaderStage& operator=(NullShaderStage&&) noexcept = delete;
+
+		void construct(const ShaderStageCreateInfo& aInfo) override;
+
+		IShaderModule* getModule() const override;
+		EShaderStageFlagBits getStage() const;
+		const std::string& getEntryPoint() const;
+	private:
+		ShaderStageCreateInfo mInfo{};
+};
+
+#endif // nullshaderstage_h__
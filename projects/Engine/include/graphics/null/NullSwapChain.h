@@ -0,0 +1,49 @@
+#ifndef nullswapchain_h__
+#define nullswapchain_h__
+
+#include "graphics/api/ISwapChain.h"
+#include "graphics/null/NullImage.h"
+#include "graphics/null/NullImageView.h"
+
+#include <vector>
+
+class NullSwapChain final : public ISwapChain
+{
+	public:
+		explicit NullSwapChain(IGraphicsContext* aContext);
+		NullSwapChain(const NullSwapChain&) = delete;
+		NullSwapChain(NullSwapChain&&) noexcept = delete;
+		~NullSwapChain() override;
+
+		NullSwapChain& operator=(const NullSwapChain&) = delete;
+		NullSwapChain& operator=(NullSwapChain&&) noexcept = delete;
+
+		void construct(const SwapChainCreateInfo& aInfo) override;
+		void reconstruct(const SwapChainCreateInfo& aInfo) override;
+		void destroy() override;
+
+		uint32_t getImageCount() override;
+
+		void beginFrame();
+		void endFrame();
+
+		uint32_t getCurrentImage() const;
+		EDataFormat getSwapchainFormat() const;
+		std::vector<IImageView*> getImageViews() const;
+		IImageView* getDepthView() const;
+
+	private:
+		void _destroy();
+
+		IGraphicsContext* mContext;
+		SwapChainCreateInfo mInfo{};
+
+		std::vector<NullImage*> mImages;
+		std::vector<NullImageView*> mImageViews;
+		NullImage* mDepthImage = nullptr;
+		NullImageView* mDepthView = nullptr;
+
+		uint32_t mCurrentImage = 0;
+};
+
+#endif // nullswapchain_h__
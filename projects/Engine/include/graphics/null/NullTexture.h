@@ -0,0 +1,38 @@
+#ifndef nulltexture_h__
+#define nulltexture_h__
+
+#include "graphics/api/ITexture.h"
+#include "graphics/null/NullImage.h"
+#include "graphics/null/NullImageView.h"
+
+class NullTexture final : public ITexture
+{
+	public:
+		explicit NullTexture(IGraphicsContext* aContext);
+		NullTexture(const NullTexture&) = delete;
+		NullTexture(NullTexture&&) noexcept = delete;
+		~NullTexture() override;
+
+		NullTexture& operator=(const NullTexture&) = delete;
+		NullTexture& operator=(NullTexture&&) noexcept = delete;
+
+		void construct(const TextureCreateInfo& aInfo) override;
+		void reconstruct(const TextureCreateInfo& aInfo) override;
+
+		ShaderStageFlags getStageFlags() const override;
+		uint32_t getBindingPoint() const override;
+
+		ISampler* getSampler() const;
+		NullImage* getImage() const;
+		NullImageView* getImageView() const;
+
+	private:
+		NullImage* mImage = nullptr;
+		NullImageView* mImageView = nullptr;
+		ISampler* mSampler = nullptr;
+
+		ShaderStageFlags mStages = 0;
+		uint32_t mBindingPoint = 0;
+};
+
+#endif // nulltexture_h__
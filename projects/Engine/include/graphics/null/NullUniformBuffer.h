@@ -0,0 +1,30 @@
+#ifndef nulluniformbuffer_h__
+#define nulluniformbuffer_h__
+
+#include "graphics/api/IUniformBuffer.h"
+
+#include <vector>
+
+class NullUniformBuffer final : public IUniformBuffer
+{
+	public:
+		explicit NullUniformBuffer(IGraphicsContext* aContext);
+		NullUniformBuffer(const NullUniformBuffer&) = delete;
+		NullUniformBuffer(NullUniformBuffer&&) noexcept = delete;
+		~NullUniformBuffer() override = default;
+
+		NullUniformBuffer& operator=(const NullUniformBuffer&) = delete;
+		NullUniformBuffer& operator=(NullUniformBuffer&&) noexcept = delete;
+
+		void construct(const UniformBufferCreateInfo& aInfo) override;
+		void reconstruct(const UniformBufferCreateInfo& aInfo) override;
+
+		void setData(void* aData, const size_t aOffset, const size_t aSize) override;
+
+		const std::vector<uint8_t>& getData() const;
+	private:
+		UniformBufferCreateInfo mInfo{};
+		std::vector<uint8_t> mData;
+};
+
+#endif // nulluniformbuffer_h__
@@ -0,0 +1,31 @@
+#ifndef nullvertexbuffer_h__
+#define nullvertexbuffer_h__
+
+#include "graphics/api/IVertexBuffer.h"
+
+#include <vector>
+
+class NullVertexBuffer final : public IVertexBuffer
+{
+	public:
+		explicit NullVertexBuffer(IGraphicsContext* aContext);
+		NullVertexBuffer(const NullVertexBuffer&) = delete;
+		NullVertexBuffer(NullVertexBuffer&&) noexcept = delete;
+		~NullVertexBuffer() override = default;
+
+		NullVertexBuffer& operator=(const NullVertexBuffer&) = delete;
+		NullVertexBuffer& operator=(NullVertexBuffer&&) noexcept = delete;
+
+		void construct(const VertexBufferCreateInfo& aInfo) override;
+
+		void setLayout(const BufferLayout& aLayout) override;
+
+		void setData(const void* aData, const size_t aSize);
+		const std::vector<uint8_t>& getData() const;
+		const BufferLayout& getLayout() const;
+	private:
+		VertexBufferCreateInfo mInfo{};
+		std::vector<uint8_t> mStorage;
+};
+
+#endif // nullvertexbuffer_h__
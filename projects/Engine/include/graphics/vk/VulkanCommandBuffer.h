@@ -46,6 +46,7 @@ class VulkanCommandBuffer final : public ICommandBuffer
 		void bindMaterial(Material* aMaterial, uint32_t aFrame) override;
 		void bindMaterialInstance(MaterialInstance* aInstance, uint32_t aFrame) override;
 		void bindSceneData(SceneData* aData, uint32_t aFrame) override;
+		void pushConstants(IGraphicsPipeline* aPipeline, ShaderStageFlags aStages, uint32_t aOffset, uint32_t aSize, const void* aData) override;
 
 		void draw(uint32_t aVertexCount, uint32_t aInstanceCount, uint32_t aFirstVertex, uint32_t aFirstInstance) override;
 		void drawIndexed(uint32_t aIndexCount, uint32_t aInstanceCount, uint32_t aFirstIndex, int32_t aVertexOffset, uint32_t aFirstInstance) override;
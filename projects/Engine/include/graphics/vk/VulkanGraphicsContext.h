@@ -3,6 +3,8 @@
 
 #include "graphics/api/IGraphicsContext.h"
 
+#include <functional>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -11,6 +13,8 @@
 
 #include "graphics/vk/VulkanCommandPool.h"
 
+class VulkanUploadManager;
+
 struct DeviceQueueFamilyIndices
 {
 	std::optional<uint32_t> graphicsFamily;
@@ -44,7 +48,26 @@ class VulkanGraphicsContext final : public IGraphicsContext
 
 		VulkanCommandPool* getCommandPool() const;
 		VulkanCommandPool* getTransferCommandPool() const;
+
+		VulkanUploadManager* getUploadManager() const;
+
+		// Held around every submission and wait on the device's queues, which may come from any thread
+		std::mutex& getQueueMutex() const;
+
+		// Runs aDestroy once every frame recorded so far has completed on the GPU. Objects those frames may
+		// still use are handed over here instead of waiting for the device to idle.
+		void retire(std::function<void()> aDestroy);
+
+		// Called by the swap chain after presenting, once the fences of the first aCompletedFrames frames
+		// have signaled
+		void _advanceFrame(const uint64_t aCompletedFrames);
 	private:
+		struct RetiredObject
+		{
+			uint64_t frame;
+			std::function<void()> destroy;
+		};
+
 		void _initializeVulkan();
 		void _initializeDebugMessenger();
 		bool _checkValidationLayerSupport() const;
@@ -71,6 +94,13 @@ class VulkanGraphicsContext final : public IGraphicsContext
 
 		VulkanCommandPool* mPool;
 		VulkanCommandPool* mTransferPool;
+
+		VulkanUploadManager* mUploadManager;
+		mutable std::mutex mQueueMutex;
+
+		std::mutex mRetireMutex;
+		std::vector<RetiredObject> mRetired;
+		uint64_t mFrame = 0;
 };
 
 #endif // vulkangraphicscontext_h__
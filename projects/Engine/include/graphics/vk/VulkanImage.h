@@ -2,6 +2,7 @@
 #define vulkanimage_h__
 
 #include "graphics/api/IImage.h"
+#include "graphics/vk/VulkanUploadManager.h"
 
 #include <vulkan/vulkan.h>
 #include <vma/vk_mem_alloc.h>
@@ -23,12 +24,14 @@ public:
 
 	void setHandle(VkImage aImage);
 	void setData(void* aData, const size_t aSize) override;
+
+	// The levels of the next construct that setData does not cover are copied from aSource, starting at
+	// its level aLevel. aSource has to stay alive until the frames recorded so far have completed.
+	void setCopySource(const VulkanImage* aSource, const uint32_t aLevel);
 	
 	void transitionToLayout(const ImageCreateInfo& aInfo, EDataFormat aFormat, EImageLayout aOldLayout, EImageLayout aNewLayout) const;
 
 private:
-	void _copyBufferToImage(const ImageCreateInfo& aInfo) const;
-
 	void _destroy() const;
 
 	bool mOwning = true;
@@ -37,10 +40,11 @@ private:
 	VmaAllocator mAllocator{};
 	VmaAllocation mAllocation{};
 
-	VkBuffer mStagingBuffer = VK_NULL_HANDLE;
-	VmaAllocation mStagingAllocation{};
-	void* mStagingMemory = nullptr;
-	size_t mStagingSize{};
+	// Filled by setData, handed to the upload manager by construct
+	VulkanStagingAllocation mStaging;
+
+	VkImage mCopySource = VK_NULL_HANDLE;
+	uint32_t mCopyLevel = 0;
 };
 
 #endif // vulkanimage_h__
@@ -56,6 +56,7 @@ class VulkanSwapChain final : public ISwapChain
 		uint8_t mFlightSize = 2;
 		uint32_t mCurrentImage = 0;
 		uint32_t mImageCount = 0;
+		uint64_t mPresentedFrames = 0;
 		std::vector<IImageView*> mImageViews;
 
 		IImageView* mDepthView{};
@@ -24,6 +24,7 @@ class VulkanTexture final : public ITexture
 		VulkanTexture& operator=(VulkanTexture&&) noexcept = delete;
 
 		void construct(const TextureCreateInfo& aInfo) override;
+		void reconstruct(const TextureCreateInfo& aInfo) override;
 
 		static DescriptorSetLayoutBinding getDescriptorSetLayout(const uint32_t aBinding, const VkShaderStageFlags aStage, const uint32_t aCount);
 
@@ -31,12 +32,21 @@ class VulkanTexture final : public ITexture
 		ShaderStageFlags getStageFlags() const override;
 		uint32_t getBindingPoint() const override;
 	private:
+		// Levels aPrevious holds as well are copied from it instead of uploaded
+		void _construct(const TextureCreateInfo& aInfo, const VulkanImage* aPrevious);
+
 		VulkanImage* mImage;
 		VulkanImageView* mImageView;
 		VulkanSampler* mSampler;
 
 		ShaderStageFlags mStages;
 		uint32_t mBindingPoint;
+
+		// Of the image constructed last
+		EDataFormat mFormat = EDataFormat::UNDEFINED;
+		uint32_t mWidth = 0;
+		uint32_t mHeight = 0;
+		uint32_t mLevelCount = 0;
 };
 
 #endif // vulkantexture_h__
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef vulkanuploadmanager_h__
+#define vulkanuploadmanager_h__
+
+#include "graphics/api/IImage.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+class VulkanGraphicsContext;
+
+// Mapped staging memory reserved from a VulkanUploadManager, filled by the caller before it is uploaded
+struct VulkanStagingAllocation
+{
+	uint8_t* data = nullptr;
+	size_t size = 0;
+
+	uint32_t page = 0;
+	VkDeviceSize offset = 0;
+};
+
+struct VulkanUploadStats
+{
+	uint64_t batches = 0;
+	uint64_t images = 0;
+	uint64_t bytes = 0;
+
+	// Allocations that had to wait for the GPU to release a page
+	uint64_t stalls = 0;
+
+	uint32_t pages = 0;
+};
+
+// Uploads images without waiting for the GPU. Any thread reserves staging memory from a pool of
+// persistently mapped pages, writes its data there and queues the upload. Queued uploads are recorded
+// into one command buffer per batch and submitted together, and a page is reused once every batch
+// reading from it has completed. Images may be sampled by anything submitted to the graphics queue
+// after the flush that covered their upload.
+class VulkanUploadManager
+{
+	public:
+		explicit VulkanUploadManager(VulkanGraphicsContext* aContext);
+		VulkanUploadManager(const VulkanUploadManager&) = delete;
+		VulkanUploadManager(VulkanUploadManager&&) noexcept = delete;
+		~VulkanUploadManager();
+
+		VulkanUploadManager& operator=(const VulkanUploadManager&) = delete;
+		VulkanUploadManager& operator=(VulkanUploadManager&&) noexcept = delete;
+
+		// Pages are sized for a 2k BC7 chain with room to spare. Larger uploads get a page of their own.
+		static constexpr VkDeviceSize sPageSize = 16 * 1024 * 1024;
+
+		// Pages kept before allocations wait for batches in flight to complete
+		static constexpr uint32_t sMaxPages = 8;
+
+		// Queued bytes that submit a batch without waiting for the next flush, so copies start on the
+		// GPU while later images are still being decoded
+		static constexpr VkDeviceSize sBatchSize = sPageSize / 2;
+
+		VulkanStagingAllocation allocate(const size_t aSize);
+
+		// Returns an allocation that will not be uploaded
+		void release(const VulkanStagingAllocation& aAllocation);
+
+		// Queues copying aAllocation into the levels of aImage described by aInfo, followed by a transition
+		// to IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. aImage must have been created in IMAGE_LAYOUT_UNDEFINED.
+		void upload(VkImage aImage, const ImageCreateInfo& aInfo, const VulkanStagingAllocation& aAllocation);
+
+		// Like upload, but only the levels in aAllocation come from staging memory, the remaining levels of
+		// aInfo are copied from aSource starting at its level aSourceLevel. aAllocation may be empty.
+		// aSource must be in IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL and is left there.
+		void upload(VkImage aImage, const ImageCreateInfo& aInfo, const VulkanStagingAllocation& aAllocation,
+			VkImage aSource, const uint32_t aSourceLevel);
+
+		// Submits everything queued as one batch
+		void flush();
+
+		// Submits everything queued and waits until all of it has completed
+		void wait();
+
+		VulkanUploadStats getStats() const;
+
+	private:
+		static constexpr uint32_t sNoPage = UINT32_MAX;
+
+		// Keeps every offset a multiple of the largest texel block
+		static constexpr VkDeviceSize sAlignment = 16;
+
+		struct Page
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VmaAllocation allocation{};
+			uint8_t* mapped = nullptr;
+			VkDeviceSize size = 0;
+			VkDeviceSize cursor = 0;
+
+			// Allocations handed out that are not submitted yet
+			uint32_t uses = 0;
+			uint64_t lastBatch = 0;
+
+			bool dedicated = false;
+		};
+
+		struct PendingUpload
+		{
+			VkImage image;
+			VkImageSubresourceRange range;
+			std::vector<VkBufferImageCopy> regions;
+			uint32_t page;
+			VkDeviceSize bytes;
+
+			// Levels copied from another image instead of staging memory
+			VkImage source = VK_NULL_HANDLE;
+			VkImageSubresourceRange sourceRange;
+			std::vector<VkImageCopy> copies;
+		};
+
+		struct Batch
+		{
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+			uint64_t id = 0;
+		};
+
+		bool _createPage(const VkDeviceSize aSize, const bool aDedicated, uint32_t& aPage);
+		void _destroyPage(Page& aPage);
+
+		// Finds a page that every batch is done with, or creates one while under sMaxPages
+		bool _acquirePage(uint32_t& aPage);
+
+		void _submit();
+
+		// Recycles completed batches and the pages only they were reading, waiting for the oldest batch
+		// first when aWait is set
+		void _retire(const bool aWait);
+
+		VulkanGraphicsContext* mContext;
+		VmaAllocator mAllocator;
+		VkCommandPool mCommandPool = VK_NULL_HANDLE;
+
+		mutable std::mutex mMutex;
+
+		std::vector<Page> mPages;
+		uint32_t mCurrentPage = sNoPage;
+
+		std::vector<PendingUpload> mPending;
+		VkDeviceSize mPendingBytes = 0;
+
+		std::deque<Batch> mInFlight;
+		std::vector<Batch> mFreeBatches;
+		uint64_t mNextBatch = 1;
+		uint64_t mCompletedBatch = 0;
+
+		VulkanUploadStats mStats;
+};
+
+#endif // vulkanuploadmanager_h__
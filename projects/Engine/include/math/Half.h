@@ -0,0 +1,29 @@
+#ifndef half_h__
+#define half_h__
+
+#include <cstdint>
+
+#include <glm/gtc/packing.hpp>
+
+// IEEE 754 binary16, only meant for storage. Convert to float for any arithmetic.
+class Half
+{
+	public:
+		Half() = default;
+
+		explicit Half(const float aValue)
+		{
+			bits = glm::packHalf1x16(aValue);
+		}
+
+		operator float() const
+		{
+			return glm::unpackHalf1x16(bits);
+		}
+
+		uint16_t bits = 0;
+};
+
+static_assert(sizeof(Half) == 2, "Half is used directly in vertex data");
+
+#endif // half_h__
@@ -15,7 +15,7 @@ class PhysicsSystem final : public System
 
 		void initialize() override;
 
-		void fixedUpdate() override;
+		void fixedUpdate(const float aFixedDeltaTime) override;
 
 		void dispose() override;
 
@@ -0,0 +1,70 @@
+#ifndef headlessrendersystem_h__
+#define headlessrendersystem_h__
+
+#include <memory>
+
+#include "ecs/System.h"
+
+#include "events/ApplicationEvent.h"
+
+#include "graphics/null/NullCommandBuffer.h"
+#include "graphics/null/NullFramebuffer.h"
+#include "graphics/null/NullGraphicsContext.h"
+#include "graphics/null/NullSwapChain.h"
+
+#include "assets/RenderPassAsset.h"
+
+#include "systems/SandboxScene.h"
+
+// Drop-in replacement for RenderSystem used by windowless applications. It builds the same scene
+// and records the same command stream, but against the null backend, so a frame costs only the
+// CPU work the engine does before handing commands to a driver.
+class HeadlessRenderSystem final : public System
+{
+	public:
+		explicit HeadlessRenderSystem(uint32_t aWidth, uint32_t aHeight);
+		HeadlessRenderSystem(const HeadlessRenderSystem&) = delete;
+		HeadlessRenderSystem(HeadlessRenderSystem&&) noexcept = delete;
+		~HeadlessRenderSystem();
+
+		HeadlessRenderSystem& operator=(const HeadlessRenderSystem&) = delete;
+		HeadlessRenderSystem& operator=(HeadlessRenderSystem&&) noexcept = delete;
+
+		void initialize() override;
+
+		void update(const float aDeltaTime) override;
+		void extract(FramePacket& aPacket) override;
+
+		void render(const FramePacket& aPacket) override;
+
+		void onEvent(Event& aEvent) override;
+
+		NullGraphicsContext* getContext() const { return mContext; }
+
+	private:
+		const uint32_t mFlightSize = 2;
+		uint32_t mCurrentFrame = 0;
+
+		uint32_t mWidth;
+		uint32_t mHeight;
+
+		NullGraphicsContext* mContext;
+		NullSwapChain* mSwapChain;
+		IRenderPass* mRenderPass = nullptr;
+
+		NullCommandBuffer** mPrimaryBuffer = nullptr;
+		NullFramebuffer** mFramebuffers = nullptr;
+		NullCommandBuffer* mCpyBuffer = nullptr;
+
+		SandboxScene* mScene;
+		std::shared_ptr<RenderPassAsset> mRenderPassAsset;
+
+		bool mCpyPending = true;
+
+		void _constructFramebuffers();
+		void _destroyFramebuffers();
+
+		bool _onResize(WindowResizeEvent& aEvent);
+};
+
+#endif // headlessrendersystem_h__
@@ -13,16 +13,11 @@
 #include "graphics/vk/VulkanGraphicsContext.h"
 #include "graphics/vk/VulkanRenderPass.h"
 #include "graphics/vk/VulkanSwapChain.h"
-#include "graphics/vk/VulkanGraphicsPipeline.h"
-#include "graphics/vk/VulkanPipelineLayout.h"
-#include "graphics/vk/VulkanVertexBuffer.h"
-#include "graphics/vk/VulkanIndexBuffer.h"
-#include "graphics/vk/VulkanTexture.h"
-#include "graphics/UniformBufferPool.h"
-
-#include "assets/ShaderAsset.h"
+
 #include "assets/RenderPassAsset.h"
 
+#include "systems/SandboxScene.h"
+
 class RenderSystem final : public System
 {
 	public:
@@ -36,9 +31,12 @@ class RenderSystem final : public System
 
 		void initialize() override;
 
-		void preRender() override;
-		void render() override;
-		void postRender() override;
+		void update(const float aDeltaTime) override;
+		void extract(FramePacket& aPacket) override;
+
+		void preRender(const FramePacket& aPacket) override;
+		void render(const FramePacket& aPacket) override;
+		void postRender(const FramePacket& aPacket) override;
 
 		void onEvent(Event& aEvent) override;
 	private:
@@ -49,30 +47,12 @@ class RenderSystem final : public System
 		VulkanSwapChain* mSwapChain;
 		IRenderPass* mRenderPass;
 
-		IGraphicsPipeline* mGraphicsPipeline;
-		VulkanPipelineLayout* mLayout{};
-
 		VulkanCommandBuffer** mPrimaryBuffer = nullptr;
 		VulkanFramebuffer** mFramebuffers = nullptr;
 
 		VulkanCommandBuffer* mCpyBuffer = nullptr;
 
-		VulkanVertexBuffer* mVertexBuffer;
-		VulkanIndexBuffer* mIndexBuffer;
-
-		UniformBufferObject* mUboObject0;
-		UniformBufferPool* mUboPool;
-
-		DescriptorSetPool* mDescPool;
-
-		VulkanTexture* mTexture;
-		VulkanTexture* mTexture2;
-		VulkanSampler* mSampler;
-
-		SceneData* mSceneData = nullptr;
-		MaterialInstance* mMaterialInstance{};
-		MaterialInstance* mMaterialInstance2{};
-		std::vector<MaterialInstance*> mInstances;
+		SandboxScene* mScene;
 
 		CommandBufferInheritanceInfo mPrimaryInheritance = {};
 		CommandBufferRecordInfo mPrimaryRecordInfo = {};
@@ -81,7 +61,6 @@ class RenderSystem final : public System
 
 		bool _onResize(WindowResizeEvent& aEvent) const;
 
-		std::shared_ptr<ShaderAsset> mShaderAsset;
 		std::shared_ptr<RenderPassAsset> mRenderPassAsset;
 
 		uint8_t mCpyReady = 2;
@@ -0,0 +1,55 @@
+#ifndef sandboxscene_h__
+#define sandboxscene_h__
+
+#include <memory>
+#include <vector>
+
+#include "graphics/DescriptorSetPool.h"
+#include "graphics/FramePacket.h"
+#include "graphics/Material.h"
+#include "graphics/SceneData.h"
+#include "graphics/UniformBufferPool.h"
+
+#include "assets/ShaderAsset.h"
+
+// Test scene drawn by RenderSystem and HeadlessRenderSystem: a rotating cube, a second cube with
+// its own texture and a column of instances. Owns the assets, materials and scene uniforms, the
+// render systems own everything tied to their backend.
+class SandboxScene
+{
+	public:
+		SandboxScene();
+		SandboxScene(const SandboxScene&) = delete;
+		SandboxScene(SandboxScene&&) noexcept = delete;
+		~SandboxScene();
+
+		SandboxScene& operator=(const SandboxScene&) = delete;
+		SandboxScene& operator=(SandboxScene&&) noexcept = delete;
+
+		void initialize();
+		void update(const float aDeltaTime);
+
+		// Fills the camera and the draws of aPacket for the target extent it carries
+		void extract(FramePacket& aPacket) const;
+
+		Mesh* getMesh() const { return mMesh; }
+		IGraphicsPipeline* getPipeline() const { return mShaderAsset->getPipeline(); }
+		SceneData* getSceneData() const { return mSceneData; }
+
+	private:
+		DescriptorSetPool* mDescPool;
+		UniformBufferPool* mUboPool = nullptr;
+
+		Mesh* mMesh = nullptr;
+
+		SceneData* mSceneData = nullptr;
+		MaterialInstance* mMaterialInstance = nullptr;
+		MaterialInstance* mMaterialInstance2 = nullptr;
+		std::vector<MaterialInstance*> mInstances;
+
+		std::shared_ptr<ShaderAsset> mShaderAsset;
+
+		float mAngle = 0.0f;
+};
+
+#endif // sandboxscene_h__
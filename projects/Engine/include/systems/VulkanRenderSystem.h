@@ -23,9 +23,9 @@ class VulkanRenderSystem : public System
 
 		void initialize() override;
 
-		void preRender() override;
-		void render() override;
-		void postRender() override;
+		void preRender(const FramePacket& aPacket) override;
+		void render(const FramePacket& aPacket) override;
+		void postRender(const FramePacket& aPacket) override;
 
 		void onEvent(Event& aEvent) override;
 
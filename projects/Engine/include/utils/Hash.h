@@ -0,0 +1,14 @@
+#ifndef hash_h__
+#define hash_h__
+
+#include <cstddef>
+#include <cstdint>
+
+class Hash
+{
+	public:
+		// XXH64, fast enough to fingerprint whole source files
+		static uint64_t xxh64(const void* aData, const size_t aSize, const uint64_t aSeed = 0);
+};
+
+#endif // hash_h__
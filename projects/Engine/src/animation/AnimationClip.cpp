@@ -0,0 +1,102 @@
+#include "animation/AnimationClip.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "animation/Pose.h"
+
+uint32_t AnimationTrack::getComponentCount(const EAnimationChannel aChannel)
+{
+	return aChannel == ANIMATION_CHANNEL_ROTATION ? 4 : 3;
+}
+
+AnimationClip::AnimationClip(std::string aName, std::vector<AnimationTrack> aTracks)
+	: mName(std::move(aName)), mTracks(std::move(aTracks))
+{
+	for (const AnimationTrack& track : mTracks)
+	{
+		if (!track.times.empty())
+		{
+			mDuration = std::max(mDuration, track.times.back());
+		}
+	}
+}
+
+const std::string& AnimationClip::getName() const
+{
+	return mName;
+}
+
+float AnimationClip::getDuration() const
+{
+	return mDuration;
+}
+
+const std::vector<AnimationTrack>& AnimationClip::getTracks() const
+{
+	return mTracks;
+}
+
+void AnimationClip::sample(const float aTime, Pose& aPose) const
+{
+	const size_t jointCount = aPose.getJointCount();
+
+	for (const AnimationTrack& track : mTracks)
+	{
+		const size_t keyCount = track.times.size();
+		if (keyCount == 0 || track.joint >= jointCount)
+		{
+			continue;
+		}
+
+		const uint32_t components = AnimationTrack::getComponentCount(track.channel);
+
+		// First key after aTime, the pair around it is (next - 1, next)
+		const size_t next = static_cast<size_t>(std::upper_bound(track.times.begin(), track.times.end(), aTime) - track.times.begin());
+		const size_t from = next == 0 ? 0 : next - 1;
+		const size_t to = std::min(next, keyCount - 1);
+
+		float blend = 0.0f;
+		if (from != to && track.interpolation == ANIMATION_INTERPOLATION_LINEAR)
+		{
+			blend = (aTime - track.times[from]) / (track.times[to] - track.times[from]);
+		}
+
+		const float* a = track.values.data() + from * components;
+		const float* b = track.values.data() + to * components;
+
+		float value[4];
+		for (uint32_t c = 0; c < components; c++)
+		{
+			value[c] = a[c] + (b[c] - a[c]) * blend;
+		}
+
+		if (track.channel == ANIMATION_CHANNEL_ROTATION)
+		{
+			// Along the shorter arc, then back to unit length
+			const float dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+			const float sign = dot < 0.0f ? -1.0f : 1.0f;
+
+			float lengthSquared = 0.0f;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				value[c] = a[c] * (1.0f - blend) + b[c] * blend * sign;
+				lengthSquared += value[c] * value[c];
+			}
+
+			const float scale = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				value[c] *= scale;
+			}
+		}
+
+		float* destination[4];
+		aPose.getChannel(track.channel, destination);
+
+		for (uint32_t c = 0; c < components; c++)
+		{
+			destination[c][track.joint] = value[c];
+		}
+	}
+}
@@ -0,0 +1,508 @@
+#include "animation/AnimationCompression.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "animation/Pose.h"
+
+namespace detail
+{
+	// Same mapping of the smallest three components as CompressedClip's decoder
+	static constexpr float sRotationRange = 0.70710678f;
+	static constexpr float sRotationSteps = 32767.0f;
+
+	// Track with its keys reduced and encoded, before they are packed into the clip's stream
+	struct EncodedTrack
+	{
+		CompressedTrack track;
+		std::vector<uint16_t> times;
+		std::vector<uint64_t> keys;
+	};
+
+	// Angle between two rotations, from the chord between them so that small angles stay precise
+	static double sRotationAngle(const float* aA, const float* aB)
+	{
+		const double dot = static_cast<double>(aA[0]) * aB[0] + static_cast<double>(aA[1]) * aB[1] +
+			static_cast<double>(aA[2]) * aB[2] + static_cast<double>(aA[3]) * aB[3];
+		const double sign = dot < 0.0 ? -1.0 : 1.0;
+
+		double chordSquared = 0.0;
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			const double difference = aA[c] - aB[c] * sign;
+			chordSquared += difference * difference;
+		}
+
+		return 4.0 * std::asin(std::min(std::sqrt(chordSquared) * 0.5, 1.0));
+	}
+
+	static double sError(const EAnimationChannel aChannel, const float* aA, const float* aB)
+	{
+		if (aChannel == ANIMATION_CHANNEL_ROTATION)
+		{
+			return sRotationAngle(aA, aB);
+		}
+
+		double error = 0.0;
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			error = std::max(error, std::fabs(static_cast<double>(aA[c]) - aB[c]));
+		}
+
+		return error;
+	}
+
+	static void sNormalize(float* aRotation)
+	{
+		const float lengthSquared = aRotation[0] * aRotation[0] + aRotation[1] * aRotation[1] + aRotation[2] * aRotation[2] +
+			aRotation[3] * aRotation[3];
+		const float scale = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			aRotation[c] *= scale;
+		}
+
+		aRotation[3] = lengthSquared > 0.0f ? aRotation[3] : 1.0f;
+	}
+
+	// What CompressedClip::sample computes between two decoded keys
+	static void sInterpolate(const EAnimationChannel aChannel, const float* aA, const float* aB, const float aBlend, float* aOut)
+	{
+		if (aChannel != ANIMATION_CHANNEL_ROTATION)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				aOut[c] = aA[c] + (aB[c] - aA[c]) * aBlend;
+			}
+
+			return;
+		}
+
+		const float dot = aA[0] * aB[0] + aA[1] * aB[1] + aA[2] * aB[2] + aA[3] * aB[3];
+		const float to = dot < 0.0f ? -aBlend : aBlend;
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			aOut[c] = aA[c] * (1.0f - aBlend) + aB[c] * to;
+		}
+
+		sNormalize(aOut);
+	}
+
+	// 48 bit smallest three key of a unit quaternion, and what it decodes to
+	static uint64_t sEncodeRotation(const float* aRotation, float* aDecoded)
+	{
+		uint32_t largest = 0;
+		for (uint32_t c = 1; c < 4; c++)
+		{
+			largest = std::fabs(aRotation[c]) > std::fabs(aRotation[largest]) ? c : largest;
+		}
+
+		// q and -q are the same rotation, the decoder rebuilds the largest component as positive
+		const float sign = aRotation[largest] < 0.0f ? -1.0f : 1.0f;
+
+		uint64_t key = static_cast<uint64_t>(largest) << 45;
+		float squared = 0.0f;
+
+		for (uint32_t c = 0, slot = 0; c < 4; c++)
+		{
+			if (c == largest)
+			{
+				continue;
+			}
+
+			const float normalized = (aRotation[c] * sign + sRotationRange) / (2.0f * sRotationRange);
+			const uint64_t value = static_cast<uint64_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * sRotationSteps));
+
+			aDecoded[c] = static_cast<float>(value) * (2.0f * sRotationRange / sRotationSteps) - sRotationRange;
+			squared += aDecoded[c] * aDecoded[c];
+
+			key |= value << (slot * 15);
+			slot++;
+		}
+
+		aDecoded[largest] = std::sqrt(std::max(0.0f, 1.0f - squared));
+		sNormalize(aDecoded);
+
+		return key;
+	}
+
+	static void sWriteBits(std::vector<uint8_t>& aStream, uint64_t& aBit, const uint64_t aValue, const uint32_t aCount)
+	{
+		for (uint32_t i = 0; i < aCount; i++, aBit++)
+		{
+			if ((aBit >> 3) >= aStream.size())
+			{
+				aStream.push_back(0);
+			}
+
+			aStream[aBit >> 3] |= static_cast<uint8_t>(((aValue >> i) & 1) << (aBit & 7));
+		}
+	}
+
+	// Length of a tick. Exported clips are usually sampled at a fixed rate, those get ticks that divide their
+	// frames so that every key lands on one exactly. Anything else is split into as many ticks as fit.
+	static float sFindTimeStep(const AnimationClip& aClip)
+	{
+		const double duration = aClip.getDuration();
+		const double finest = duration / CompressedClip::sMaxTicks;
+
+		if (duration <= 0.0)
+		{
+			return 1.0f;
+		}
+
+		double frame = duration;
+		for (const AnimationTrack& track : aClip.getTracks())
+		{
+			for (size_t key = 1; key < track.times.size(); key++)
+			{
+				const double interval = static_cast<double>(track.times[key]) - track.times[key - 1];
+				frame = interval > finest ? std::min(frame, interval) : frame;
+			}
+		}
+
+		const double frames = std::round(duration / frame);
+		frame = duration / frames;
+
+		for (const AnimationTrack& track : aClip.getTracks())
+		{
+			for (const float time : track.times)
+			{
+				if (std::fabs(time / frame - std::round(time / frame)) > 0.001)
+				{
+					return static_cast<float>(finest);
+				}
+			}
+		}
+
+		return static_cast<float>(frame / std::floor(CompressedClip::sMaxTicks / frames));
+	}
+
+	// Encodes aTrack into aOut, false when the track can be left out
+	static bool sEncodeTrack(const AnimationTrack& aTrack, const float aDuration, const float aTimeStep, const Pose& aRestPose,
+		const float aTolerance, EncodedTrack& aOut)
+	{
+		const EAnimationChannel channel = aTrack.channel;
+		const uint32_t components = AnimationTrack::getComponentCount(channel);
+		const size_t keyCount = aTrack.times.size();
+
+		if (keyCount == 0 || aTrack.values.size() < keyCount * components || aTrack.joint >= aRestPose.getJointCount())
+		{
+			return false;
+		}
+
+		std::vector<float> source(aTrack.values.begin(), aTrack.values.begin() + keyCount * components);
+		if (channel == ANIMATION_CHANNEL_ROTATION)
+		{
+			for (size_t key = 0; key < keyCount; key++)
+			{
+				sNormalize(source.data() + key * 4);
+			}
+		}
+
+		float rest[4];
+		const float* restArrays[4];
+		aRestPose.getChannel(channel, restArrays);
+
+		for (uint32_t c = 0; c < components; c++)
+		{
+			rest[c] = restArrays[c][aTrack.joint];
+		}
+
+		bool constant = true;
+		bool atRest = true;
+
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			constant &= sError(channel, source.data() + key * components, source.data()) <= aTolerance;
+			atRest &= sError(channel, source.data() + key * components, rest) <= aTolerance;
+		}
+
+		if (atRest)
+		{
+			return false;
+		}
+
+		CompressedTrack& track = aOut.track;
+		track = {};
+		track.joint = aTrack.joint;
+		track.channel = static_cast<uint8_t>(channel);
+		track.interpolation = static_cast<uint8_t>(aTrack.interpolation);
+
+		// Key times in ticks, as the decoder computes them
+		std::vector<float> positions(keyCount);
+		std::vector<uint16_t> times(keyCount);
+
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			positions[key] = std::clamp(aTrack.times[key], 0.0f, aDuration) / aTimeStep;
+			times[key] = static_cast<uint16_t>(std::min(std::round(positions[key]), static_cast<float>(CompressedClip::sMaxTicks)));
+		}
+
+		const bool linear = aTrack.interpolation == ANIMATION_INTERPOLATION_LINEAR;
+
+		// The source at a position. Linear keys are stored as the source at their tick rather than at their own
+		// time, which only differ for clips off a fixed rate, or they would be off by however far the source
+		// moves in half a tick.
+		const auto sampleSource = [&](const float aPosition, float* aOut)
+		{
+			const size_t next = static_cast<size_t>(std::upper_bound(positions.begin(), positions.end(), aPosition) - positions.begin());
+			const size_t from = next == 0 ? 0 : next - 1;
+			const size_t to = std::min(next, keyCount - 1);
+			const float blend = from != to && linear ? (aPosition - positions[from]) / (positions[to] - positions[from]) : 0.0f;
+
+			sInterpolate(channel, source.data() + from * components, source.data() + to * components, blend, aOut);
+		};
+
+		std::vector<float> stored(source);
+		if (linear)
+		{
+			for (size_t key = 0; key < keyCount; key++)
+			{
+				sampleSource(static_cast<float>(times[key]), stored.data() + key * components);
+			}
+		}
+
+		// Every key quantized, and the value it decodes to
+		std::vector<uint64_t> keys(keyCount);
+		std::vector<float> decoded(keyCount * components);
+
+		if (channel == ANIMATION_CHANNEL_ROTATION)
+		{
+			track.bits = CompressedClip::sRotationBits;
+
+			for (size_t key = 0; key < keyCount; key++)
+			{
+				keys[key] = sEncodeRotation(stored.data() + key * 4, decoded.data() + key * 4);
+			}
+		}
+		else if (constant)
+		{
+			track.bits = 0;
+			std::copy(source.begin(), source.begin() + 3, track.minimum);
+		}
+		else
+		{
+			float largestExtent = 0.0f;
+
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				float minimum = stored[c];
+				float maximum = stored[c];
+
+				for (size_t key = 1; key < keyCount; key++)
+				{
+					minimum = std::min(minimum, stored[key * 3 + c]);
+					maximum = std::max(maximum, stored[key * 3 + c]);
+				}
+
+				track.minimum[c] = minimum;
+				track.extent[c] = maximum - minimum;
+				largestExtent = std::max(largestExtent, maximum - minimum);
+			}
+
+			// Steps of at most the tolerance leave rounding at most half of it, the rest is for key reduction
+			track.bits = 1;
+			while (track.bits < CompressedClip::sMaxBits && largestExtent / static_cast<float>((1u << track.bits) - 1) > aTolerance)
+			{
+				track.bits++;
+			}
+
+			const float steps = static_cast<float>((1u << track.bits) - 1);
+
+			for (size_t key = 0; key < keyCount; key++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					const float normalized = track.extent[c] > 0.0f ? (stored[key * 3 + c] - track.minimum[c]) / track.extent[c] : 0.0f;
+					const uint64_t value = static_cast<uint64_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * steps));
+
+					keys[key] |= value << (c * track.bits);
+					decoded[key * 3 + c] = track.minimum[c] + track.extent[c] * (static_cast<float>(value) / steps);
+				}
+			}
+		}
+
+		if (constant)
+		{
+			aOut.times = { 0 };
+			aOut.keys = { keys[0] };
+			track.keyCount = 1;
+			return true;
+		}
+
+		// Of keys that land on the same time step only the last one can be reached
+		std::vector<size_t> candidates;
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			if (key + 1 == keyCount || times[key + 1] != times[key])
+			{
+				candidates.push_back(key);
+			}
+		}
+
+		// Whether interpolating from key aFrom to key aTo stays within the tolerance of the source at every
+		// source key between them. Interpolated rotations do not turn at a constant rate, so they are also
+		// compared halfway between source keys.
+		const bool halfways = linear && channel == ANIMATION_CHANNEL_ROTATION;
+
+		const auto fits = [&](const size_t aFrom, const size_t aTo)
+		{
+			const float span = static_cast<float>(times[aTo] - times[aFrom]);
+
+			float expected[4];
+			float value[4];
+
+			for (size_t key = aFrom + 1; key <= aTo; key++)
+			{
+				for (uint32_t sample = halfways ? 0 : 1; sample < (key < aTo ? 2u : 1u); sample++)
+				{
+					const float position = sample == 0 ? (positions[key - 1] + positions[key]) * 0.5f : positions[key];
+					sampleSource(position, expected);
+
+					const float blend = linear ? std::clamp((position - static_cast<float>(times[aFrom])) / span, 0.0f, 1.0f) : 0.0f;
+					sInterpolate(channel, decoded.data() + aFrom * components, decoded.data() + aTo * components, blend, value);
+
+					if (sError(channel, value, expected) > aTolerance)
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		};
+
+		std::vector<size_t> kept = { candidates[0] };
+
+		size_t anchor = 0;
+		while (anchor + 1 < candidates.size())
+		{
+			size_t next = anchor + 1;
+			while (next + 1 < candidates.size() && fits(candidates[anchor], candidates[next + 1]))
+			{
+				next++;
+			}
+
+			kept.push_back(candidates[next]);
+			anchor = next;
+		}
+
+		for (const size_t key : kept)
+		{
+			aOut.times.push_back(times[key]);
+			aOut.keys.push_back(keys[key]);
+		}
+
+		track.keyCount = static_cast<uint32_t>(kept.size());
+		return true;
+	}
+}
+
+CompressedClip AnimationCompression::compress(const AnimationClip& aClip, const Pose& aRestPose, const AnimationCompressionSettings& aSettings)
+{
+	const float timeStep = detail::sFindTimeStep(aClip);
+
+	std::vector<detail::EncodedTrack> encoded;
+
+	for (const AnimationTrack& track : aClip.getTracks())
+	{
+		float tolerance = aSettings.translationTolerance;
+		tolerance = track.channel == ANIMATION_CHANNEL_ROTATION ? aSettings.rotationTolerance : tolerance;
+		tolerance = track.channel == ANIMATION_CHANNEL_SCALE ? aSettings.scaleTolerance : tolerance;
+
+		detail::EncodedTrack result;
+		if (detail::sEncodeTrack(track, aClip.getDuration(), timeStep, aRestPose, tolerance, result))
+		{
+			encoded.push_back(std::move(result));
+		}
+	}
+
+	// Grouped by channel so that the decoder handles a block of tracks the same way
+	std::stable_sort(encoded.begin(), encoded.end(), [](const detail::EncodedTrack& aLeft, const detail::EncodedTrack& aRight)
+	{
+		return aLeft.track.channel != aRight.track.channel ? aLeft.track.channel < aRight.track.channel : aLeft.track.joint < aRight.track.joint;
+	});
+
+	std::vector<CompressedTrack> tracks;
+	std::vector<uint16_t> times;
+	std::vector<uint8_t> keys;
+	uint64_t bit = 0;
+
+	tracks.reserve(encoded.size());
+
+	for (detail::EncodedTrack& result : encoded)
+	{
+		result.track.firstTime = static_cast<uint32_t>(times.size());
+		result.track.firstBit = static_cast<uint32_t>(bit);
+
+		times.insert(times.end(), result.times.begin(), result.times.end());
+
+		for (const uint64_t key : result.keys)
+		{
+			detail::sWriteBits(keys, bit, key, result.track.bits * 3u);
+		}
+
+		tracks.push_back(result.track);
+	}
+
+	return CompressedClip(aClip.getName(), aClip.getDuration(), timeStep, std::move(tracks), std::move(times), std::move(keys));
+}
+
+size_t AnimationCompression::getRawBytes(const AnimationClip& aClip)
+{
+	size_t bytes = 0;
+
+	for (const AnimationTrack& track : aClip.getTracks())
+	{
+		bytes += (track.times.size() + track.values.size()) * sizeof(float);
+	}
+
+	return bytes;
+}
+
+AnimationCompressionError AnimationCompression::measure(const AnimationClip& aSource, const CompressedClip& aCompressed, const Pose& aRestPose,
+	const float aSampleRate)
+{
+	AnimationCompressionError error;
+
+	const float duration = aSource.getDuration();
+	const size_t sampleCount = static_cast<size_t>(std::ceil(duration * aSampleRate)) + 1;
+
+	Pose source;
+	Pose compressed;
+
+	for (size_t sample = 0; sample < sampleCount; sample++)
+	{
+		const float time = std::min(static_cast<float>(sample) / aSampleRate, duration);
+
+		source = aRestPose;
+		compressed = aRestPose;
+
+		aSource.sample(time, source);
+		aCompressed.sample(time, compressed);
+
+		for (size_t joint = 0; joint < aRestPose.getJointCount(); joint++)
+		{
+			const float sourceTranslation[3] = { source.translationX[joint], source.translationY[joint], source.translationZ[joint] };
+			const float compressedTranslation[3] = { compressed.translationX[joint], compressed.translationY[joint], compressed.translationZ[joint] };
+
+			const float sourceRotation[4] = { source.rotationX[joint], source.rotationY[joint], source.rotationZ[joint], source.rotationW[joint] };
+			const float compressedRotation[4] = { compressed.rotationX[joint], compressed.rotationY[joint], compressed.rotationZ[joint],
+				compressed.rotationW[joint] };
+
+			const float sourceScale[3] = { source.scaleX[joint], source.scaleY[joint], source.scaleZ[joint] };
+			const float compressedScale[3] = { compressed.scaleX[joint], compressed.scaleY[joint], compressed.scaleZ[joint] };
+
+			error.translation = std::max(error.translation, static_cast<float>(detail::sError(ANIMATION_CHANNEL_TRANSLATION, sourceTranslation,
+				compressedTranslation)));
+			error.rotation = std::max(error.rotation, static_cast<float>(detail::sError(ANIMATION_CHANNEL_ROTATION, sourceRotation,
+				compressedRotation)));
+			error.scale = std::max(error.scale, static_cast<float>(detail::sError(ANIMATION_CHANNEL_SCALE, sourceScale, compressedScale)));
+		}
+	}
+
+	return error;
+}
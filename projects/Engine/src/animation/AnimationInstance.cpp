@@ -0,0 +1,197 @@
+#include "animation/AnimationInstance.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "animation/Skeleton.h"
+
+namespace detail
+{
+	// Large meshes are skinned in parallel ranges of this many vertices within their character's job
+	static constexpr size_t sVertexGrainSize = 4096;
+}
+
+AnimationInstance::AnimationInstance(const Skeleton* aSkeleton, const SkinBinding* aBinding)
+	: mSkeleton(aSkeleton), mBinding(aBinding), mSkinningMethod(SKINNING_METHOD_LINEAR_BLEND)
+{
+	mPose = mSkeleton->getRestPose();
+	mPose.toModel(*mSkeleton, mModel);
+
+	if (mBinding != nullptr)
+	{
+		mSkinnedVertices = mBinding->getBindVertices();
+	}
+
+	_computeBounds();
+}
+
+size_t AnimationInstance::play(const CompressedClip* aClip, const float aWeight, const bool aLoop, const float aSpeed)
+{
+	AnimationLayer layer;
+	layer.clip = aClip;
+	layer.weight = aWeight;
+	layer.loop = aLoop;
+	layer.speed = aSpeed;
+
+	mLayers.push_back(layer);
+	return mLayers.size() - 1;
+}
+
+void AnimationInstance::stopAll()
+{
+	mLayers.clear();
+}
+
+size_t AnimationInstance::getLayerCount() const
+{
+	return mLayers.size();
+}
+
+AnimationLayer& AnimationInstance::getLayer(const size_t aLayer)
+{
+	return mLayers[aLayer];
+}
+
+void AnimationInstance::setSkinningMethod(const ESkinningMethod aMethod)
+{
+	mSkinningMethod = aMethod;
+}
+
+ESkinningMethod AnimationInstance::getSkinningMethod() const
+{
+	return mSkinningMethod;
+}
+
+void AnimationInstance::update(const float aDeltaTime)
+{
+	std::vector<const Pose*> poses;
+	std::vector<float> weights;
+
+	mLayerPoses.resize(mLayers.size());
+
+	for (size_t i = 0; i < mLayers.size(); i++)
+	{
+		AnimationLayer& layer = mLayers[i];
+		if (layer.clip == nullptr || layer.weight <= 0.0f)
+		{
+			continue;
+		}
+
+		const float duration = layer.clip->getDuration();
+		layer.time += aDeltaTime * layer.speed;
+
+		if (layer.loop && duration > 0.0f)
+		{
+			layer.time = std::fmod(layer.time, duration);
+			layer.time += layer.time < 0.0f ? duration : 0.0f;
+		}
+		else
+		{
+			layer.time = std::clamp(layer.time, 0.0f, duration);
+		}
+
+		mLayerPoses[i] = mSkeleton->getRestPose();
+		layer.clip->sample(layer.time, mLayerPoses[i]);
+
+		poses.push_back(&mLayerPoses[i]);
+		weights.push_back(layer.weight);
+	}
+
+	if (poses.empty())
+	{
+		mPose = mSkeleton->getRestPose();
+	}
+	else if (poses.size() == 1)
+	{
+		mPose = *poses.front();
+	}
+	else
+	{
+		Pose::blend(poses.data(), weights.data(), poses.size(), mPose);
+	}
+
+	mPose.toModel(*mSkeleton, mModel);
+
+	if (mBinding != nullptr)
+	{
+		_skin();
+	}
+
+	_computeBounds();
+}
+
+const Skeleton* AnimationInstance::getSkeleton() const
+{
+	return mSkeleton;
+}
+
+const Pose& AnimationInstance::getPose() const
+{
+	return mPose;
+}
+
+const std::vector<JointMatrix>& AnimationInstance::getModelTransforms() const
+{
+	return mModel;
+}
+
+const std::vector<Vertex>& AnimationInstance::getSkinnedVertices() const
+{
+	return mSkinnedVertices;
+}
+
+const Vector3f& AnimationInstance::getBoundsMin() const
+{
+	return mBoundsMin;
+}
+
+const Vector3f& AnimationInstance::getBoundsMax() const
+{
+	return mBoundsMax;
+}
+
+void AnimationInstance::_skin()
+{
+	Skinning::computePalette(*mSkeleton, mModel, mPalette);
+
+	if (mSkinningMethod == SKINNING_METHOD_DUAL_QUATERNION)
+	{
+		Skinning::computeDualQuaternions(mPalette, mDualQuaternions);
+	}
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, mBinding->getVertexCount(), detail::sVertexGrainSize),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			if (mSkinningMethod == SKINNING_METHOD_DUAL_QUATERNION)
+			{
+				Skinning::skinDualQuaternion(*mBinding, mDualQuaternions.data(), aRange.begin(), aRange.end(), mSkinnedVertices.data());
+			}
+			else
+			{
+				Skinning::skinLinearBlend(*mBinding, mPalette.data(), aRange.begin(), aRange.end(), mSkinnedVertices.data());
+			}
+		});
+}
+
+void AnimationInstance::_computeBounds()
+{
+	const size_t count = mBinding != nullptr ? mSkinnedVertices.size() : mModel.size();
+
+	mBoundsMin = Vector3f(0.0f);
+	mBoundsMax = Vector3f(0.0f);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vector3f position = mBinding != nullptr ? mSkinnedVertices[i].position :
+			Vector3f(mModel[i].m[3], mModel[i].m[7], mModel[i].m[11]);
+
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			mBoundsMin.v[axis] = i == 0 ? position.v[axis] : std::min(mBoundsMin.v[axis], position.v[axis]);
+			mBoundsMax.v[axis] = i == 0 ? position.v[axis] : std::max(mBoundsMax.v[axis], position.v[axis]);
+		}
+	}
+}
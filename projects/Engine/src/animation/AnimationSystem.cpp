@@ -0,0 +1,16 @@
+#include "animation/AnimationSystem.h"
+
+#include "animation/components/Animator.h"
+#include "core/Profiler.h"
+#include "ecs/EntityManager.h"
+
+void AnimationSystem::update(const float aDeltaTime)
+{
+	PRIMAL_PROFILE_SCOPE("AnimationSystem::update");
+
+	// Characters are independent of each other, and each is enough work to be a job of its own
+	parallel_for_each(EntityManager::instance().getComponentsByType<Animator>(), [aDeltaTime](Animator* aAnimator)
+	{
+		aAnimator->getInstance().update(aDeltaTime);
+	}, 1);
+}
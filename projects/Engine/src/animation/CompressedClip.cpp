@@ -0,0 +1,307 @@
+#include "animation/CompressedClip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "animation/Pose.h"
+
+namespace detail
+{
+	static constexpr size_t sBlockSize = 64;
+
+	// Keys are read 8 bytes at a time, so the stream carries that much past its last key
+	static constexpr size_t sKeyPadding = sizeof(uint64_t);
+
+	// The three smallest components of a unit quaternion lie within +-1/sqrt(2)
+	static constexpr float sRotationRange = 0.70710678f;
+	static constexpr float sRotationSteps = 32767.0f;
+
+	// Keys around the sample time of a block of tracks and what they decode to, one array per component
+	struct SampleBlock
+	{
+		float from[3][sBlockSize];
+		float to[3][sBlockSize];
+		int32_t fromLargest[sBlockSize];
+		int32_t toLargest[sBlockSize];
+		float blend[sBlockSize];
+
+		float minimum[3][sBlockSize];
+		float step[3][sBlockSize];
+
+		float out[4][sBlockSize];
+	};
+
+	static uint64_t sReadBits(const uint8_t* aKeys, const uint64_t aBit, const uint32_t aCount)
+	{
+		uint64_t word;
+		memcpy(&word, aKeys + (aBit >> 3), sizeof(word));
+
+		return (word >> (aBit & 7)) & ((uint64_t(1) << aCount) - 1);
+	}
+
+	// Keys of aTrack around aPosition, in ticks, and the fraction between them
+	static void sFindKeys(const CompressedTrack& aTrack, const uint16_t* aTimes, const float aPosition, uint32_t& aFrom, uint32_t& aTo,
+		float& aBlend)
+	{
+		const uint16_t* times = aTimes + aTrack.firstTime;
+		const uint32_t next = static_cast<uint32_t>(std::upper_bound(times, times + aTrack.keyCount, aPosition,
+			[](const float aValue, const uint16_t aTime) { return aValue < static_cast<float>(aTime); }) - times);
+
+		aFrom = next == 0 ? 0 : next - 1;
+		aTo = std::min(next, aTrack.keyCount - 1);
+
+		aBlend = 0.0f;
+		if (aFrom != aTo && aTrack.interpolation == ANIMATION_INTERPOLATION_LINEAR)
+		{
+			aBlend = (aPosition - static_cast<float>(times[aFrom])) / static_cast<float>(times[aTo] - times[aFrom]);
+		}
+	}
+
+	// Quaternion from its three smallest components and the index of the largest one
+	static inline void sUnpackRotation(const float aSmallest0, const float aSmallest1, const float aSmallest2, const int32_t aLargest,
+		float& aX, float& aY, float& aZ, float& aW)
+	{
+		const float largest = std::sqrt(std::max(0.0f, 1.0f - aSmallest0 * aSmallest0 - aSmallest1 * aSmallest1 - aSmallest2 * aSmallest2));
+
+		aX = aLargest == 0 ? largest : aSmallest0;
+		aY = aLargest == 0 ? aSmallest0 : (aLargest == 1 ? largest : aSmallest1);
+		aZ = aLargest <= 1 ? aSmallest1 : (aLargest == 2 ? largest : aSmallest2);
+		aW = aLargest == 3 ? largest : aSmallest2;
+	}
+
+	static void sDecodeVectors(const CompressedTrack* aTracks, const size_t aCount, const uint16_t* aTimes, const uint8_t* aKeys,
+		const float aPosition, SampleBlock& aBlock)
+	{
+		for (size_t i = 0; i < aCount; i++)
+		{
+			const CompressedTrack& track = aTracks[i];
+
+			uint32_t from, to;
+			sFindKeys(track, aTimes, aPosition, from, to, aBlock.blend[i]);
+
+			const uint32_t bits = track.bits;
+			const uint64_t mask = (uint64_t(1) << bits) - 1;
+			const float step = bits > 0 ? 1.0f / static_cast<float>(mask) : 0.0f;
+
+			const uint64_t a = sReadBits(aKeys, track.firstBit + static_cast<uint64_t>(from) * bits * 3, bits * 3);
+			const uint64_t b = sReadBits(aKeys, track.firstBit + static_cast<uint64_t>(to) * bits * 3, bits * 3);
+
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				aBlock.from[c][i] = static_cast<float>((a >> (c * bits)) & mask);
+				aBlock.to[c][i] = static_cast<float>((b >> (c * bits)) & mask);
+				aBlock.minimum[c][i] = track.minimum[c];
+				aBlock.step[c][i] = track.extent[c] * step;
+			}
+		}
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			const float* from = aBlock.from[c];
+			const float* to = aBlock.to[c];
+			const float* minimum = aBlock.minimum[c];
+			const float* step = aBlock.step[c];
+			const float* blend = aBlock.blend;
+			float* out = aBlock.out[c];
+
+			for (size_t i = 0; i < aCount; i++)
+			{
+				out[i] = minimum[i] + step[i] * (from[i] + (to[i] - from[i]) * blend[i]);
+			}
+		}
+	}
+
+	static void sDecodeRotations(const CompressedTrack* aTracks, const size_t aCount, const uint16_t* aTimes, const uint8_t* aKeys,
+		const float aPosition, SampleBlock& aBlock)
+	{
+		const uint32_t keyBits = CompressedClip::sRotationBits * 3;
+
+		for (size_t i = 0; i < aCount; i++)
+		{
+			const CompressedTrack& track = aTracks[i];
+
+			uint32_t from, to;
+			sFindKeys(track, aTimes, aPosition, from, to, aBlock.blend[i]);
+
+			const uint64_t a = sReadBits(aKeys, track.firstBit + static_cast<uint64_t>(from) * keyBits, keyBits);
+			const uint64_t b = sReadBits(aKeys, track.firstBit + static_cast<uint64_t>(to) * keyBits, keyBits);
+
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				aBlock.from[c][i] = static_cast<float>((a >> (c * 15)) & 0x7FFF);
+				aBlock.to[c][i] = static_cast<float>((b >> (c * 15)) & 0x7FFF);
+			}
+
+			aBlock.fromLargest[i] = static_cast<int32_t>((a >> 45) & 3);
+			aBlock.toLargest[i] = static_cast<int32_t>((b >> 45) & 3);
+		}
+
+		const float scale = 2.0f * sRotationRange / sRotationSteps;
+
+		for (size_t i = 0; i < aCount; i++)
+		{
+			float ax, ay, az, aw;
+			sUnpackRotation(aBlock.from[0][i] * scale - sRotationRange, aBlock.from[1][i] * scale - sRotationRange,
+				aBlock.from[2][i] * scale - sRotationRange, aBlock.fromLargest[i], ax, ay, az, aw);
+
+			float bx, by, bz, bw;
+			sUnpackRotation(aBlock.to[0][i] * scale - sRotationRange, aBlock.to[1][i] * scale - sRotationRange,
+				aBlock.to[2][i] * scale - sRotationRange, aBlock.toLargest[i], bx, by, bz, bw);
+
+			// Along the shorter arc, then back to unit length
+			const float blend = aBlock.blend[i];
+			const float to = ax * bx + ay * by + az * bz + aw * bw < 0.0f ? -blend : blend;
+			const float from = 1.0f - blend;
+
+			const float x = ax * from + bx * to;
+			const float y = ay * from + by * to;
+			const float z = az * from + bz * to;
+			const float w = aw * from + bw * to;
+			const float scaleLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+
+			aBlock.out[0][i] = x * scaleLength;
+			aBlock.out[1][i] = y * scaleLength;
+			aBlock.out[2][i] = z * scaleLength;
+			aBlock.out[3][i] = w * scaleLength;
+		}
+	}
+}
+
+CompressedClip::CompressedClip(std::string aName, const float aDuration, const float aTimeStep, std::vector<CompressedTrack> aTracks,
+	std::vector<uint16_t> aTimes, std::vector<uint8_t> aKeys)
+	: mName(std::move(aName)), mDuration(aDuration), mTimeStep(aTimeStep), mTracks(std::move(aTracks)), mTimes(std::move(aTimes)),
+	mKeys(std::move(aKeys)), mKeyBytes(mKeys.size())
+{
+	mKeys.resize(mKeyBytes + detail::sKeyPadding, 0);
+}
+
+const std::string& CompressedClip::getName() const
+{
+	return mName;
+}
+
+float CompressedClip::getDuration() const
+{
+	return mDuration;
+}
+
+float CompressedClip::getTimeStep() const
+{
+	return mTimeStep;
+}
+
+const std::vector<CompressedTrack>& CompressedClip::getTracks() const
+{
+	return mTracks;
+}
+
+const std::vector<uint16_t>& CompressedClip::getTimes() const
+{
+	return mTimes;
+}
+
+const uint8_t* CompressedClip::getKeyData() const
+{
+	return mKeys.data();
+}
+
+size_t CompressedClip::getKeyBytes() const
+{
+	return mKeyBytes;
+}
+
+size_t CompressedClip::getMemoryUsage() const
+{
+	return mName.size() + mTracks.size() * sizeof(CompressedTrack) + mTimes.size() * sizeof(uint16_t) + mKeys.size();
+}
+
+bool CompressedClip::isValid(const size_t aJointCount) const
+{
+	if (!(mTimeStep > 0.0f) || !std::isfinite(mTimeStep))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < mTracks.size(); i++)
+	{
+		const CompressedTrack& track = mTracks[i];
+
+		if (track.joint >= aJointCount || track.channel > ANIMATION_CHANNEL_SCALE || track.interpolation > ANIMATION_INTERPOLATION_STEP ||
+			(i > 0 && track.channel < mTracks[i - 1].channel))
+		{
+			return false;
+		}
+
+		const bool rotation = track.channel == ANIMATION_CHANNEL_ROTATION;
+		if ((rotation && track.bits != sRotationBits) || track.bits > sMaxBits || track.keyCount == 0 ||
+			static_cast<uint64_t>(track.firstTime) + track.keyCount > mTimes.size() ||
+			track.firstBit + static_cast<uint64_t>(track.keyCount) * track.bits * 3 > static_cast<uint64_t>(mKeyBytes) * 8)
+		{
+			return false;
+		}
+
+		// Interpolation divides by the distance between neighbouring keys
+		const uint16_t* times = mTimes.data() + track.firstTime;
+		for (uint32_t key = 1; key < track.keyCount; key++)
+		{
+			if (times[key] <= times[key - 1])
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void CompressedClip::sample(const float aTime, Pose& aPose) const
+{
+	const size_t jointCount = aPose.getJointCount();
+	const float position = std::clamp(aTime, 0.0f, mDuration) / mTimeStep;
+
+	detail::SampleBlock block;
+
+	size_t begin = 0;
+	while (begin < mTracks.size())
+	{
+		// Every block holds tracks of one channel
+		const EAnimationChannel channel = static_cast<EAnimationChannel>(mTracks[begin].channel);
+
+		size_t end = begin + 1;
+		while (end < mTracks.size() && end - begin < detail::sBlockSize && mTracks[end].channel == channel)
+		{
+			end++;
+		}
+
+		if (channel == ANIMATION_CHANNEL_ROTATION)
+		{
+			detail::sDecodeRotations(mTracks.data() + begin, end - begin, mTimes.data(), mKeys.data(), position, block);
+		}
+		else
+		{
+			detail::sDecodeVectors(mTracks.data() + begin, end - begin, mTimes.data(), mKeys.data(), position, block);
+		}
+
+		float* destination[4];
+		aPose.getChannel(channel, destination);
+
+		const uint32_t components = AnimationTrack::getComponentCount(channel);
+
+		for (size_t i = 0; i < end - begin; i++)
+		{
+			const uint32_t joint = mTracks[begin + i].joint;
+			if (joint >= jointCount)
+			{
+				continue;
+			}
+
+			for (uint32_t c = 0; c < components; c++)
+			{
+				destination[c][joint] = block.out[c][i];
+			}
+		}
+
+		begin = end;
+	}
+}
@@ -0,0 +1,293 @@
+#include "animation/Pose.h"
+
+#include <cmath>
+
+#include "animation/Skeleton.h"
+
+namespace detail
+{
+	// Local matrices of a pose, one array per element like the pose itself
+	struct LocalMatrices
+	{
+		std::vector<float> m[12];
+
+		void resize(const size_t aCount)
+		{
+			for (std::vector<float>& element : m)
+			{
+				element.resize(aCount);
+			}
+		}
+	};
+
+	static LocalMatrices& sGetScratch()
+	{
+		static thread_local LocalMatrices sScratch;
+		return sScratch;
+	}
+
+	static void sNormalizeRotations(Pose& aPose)
+	{
+		const size_t count = aPose.getJointCount();
+
+		float* x = aPose.rotationX.data();
+		float* y = aPose.rotationY.data();
+		float* z = aPose.rotationZ.data();
+		float* w = aPose.rotationW.data();
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const float lengthSquared = x[i] * x[i] + y[i] * y[i] + z[i] * z[i] + w[i] * w[i];
+			const float scale = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+
+			x[i] *= scale;
+			y[i] *= scale;
+			z[i] *= scale;
+			w[i] = lengthSquared > 0.0f ? w[i] * scale : 1.0f;
+		}
+	}
+}
+
+JointMatrix JointMatrix::identity()
+{
+	return { { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f } };
+}
+
+JointMatrix JointMatrix::fromTrs(const float* aTranslation, const float* aRotation, const float* aScale)
+{
+	const float x = aRotation[0];
+	const float y = aRotation[1];
+	const float z = aRotation[2];
+	const float w = aRotation[3];
+
+	JointMatrix result;
+	result.m[0] = (1.0f - 2.0f * (y * y + z * z)) * aScale[0];
+	result.m[1] = 2.0f * (x * y - z * w) * aScale[1];
+	result.m[2] = 2.0f * (x * z + y * w) * aScale[2];
+	result.m[3] = aTranslation[0];
+	result.m[4] = 2.0f * (x * y + z * w) * aScale[0];
+	result.m[5] = (1.0f - 2.0f * (x * x + z * z)) * aScale[1];
+	result.m[6] = 2.0f * (y * z - x * w) * aScale[2];
+	result.m[7] = aTranslation[1];
+	result.m[8] = 2.0f * (x * z - y * w) * aScale[0];
+	result.m[9] = 2.0f * (y * z + x * w) * aScale[1];
+	result.m[10] = (1.0f - 2.0f * (x * x + y * y)) * aScale[2];
+	result.m[11] = aTranslation[2];
+
+	return result;
+}
+
+JointMatrix JointMatrix::multiply(const JointMatrix& aLeft, const JointMatrix& aRight)
+{
+	JointMatrix result;
+
+	for (size_t row = 0; row < 3; row++)
+	{
+		const float* left = aLeft.m + row * 4;
+
+		for (size_t column = 0; column < 4; column++)
+		{
+			result.m[row * 4 + column] = left[0] * aRight.m[column] + left[1] * aRight.m[4 + column] + left[2] * aRight.m[8 + column];
+		}
+
+		result.m[row * 4 + 3] += left[3];
+	}
+
+	return result;
+}
+
+void Pose::resize(const size_t aJointCount)
+{
+	translationX.assign(aJointCount, 0.0f);
+	translationY.assign(aJointCount, 0.0f);
+	translationZ.assign(aJointCount, 0.0f);
+
+	rotationX.assign(aJointCount, 0.0f);
+	rotationY.assign(aJointCount, 0.0f);
+	rotationZ.assign(aJointCount, 0.0f);
+	rotationW.assign(aJointCount, 1.0f);
+
+	scaleX.assign(aJointCount, 1.0f);
+	scaleY.assign(aJointCount, 1.0f);
+	scaleZ.assign(aJointCount, 1.0f);
+}
+
+size_t Pose::getJointCount() const
+{
+	return translationX.size();
+}
+
+void Pose::getChannel(const EAnimationChannel aChannel, float* aArrays[4])
+{
+	switch (aChannel)
+	{
+		case ANIMATION_CHANNEL_TRANSLATION:
+			aArrays[0] = translationX.data();
+			aArrays[1] = translationY.data();
+			aArrays[2] = translationZ.data();
+			aArrays[3] = nullptr;
+			break;
+		case ANIMATION_CHANNEL_ROTATION:
+			aArrays[0] = rotationX.data();
+			aArrays[1] = rotationY.data();
+			aArrays[2] = rotationZ.data();
+			aArrays[3] = rotationW.data();
+			break;
+		case ANIMATION_CHANNEL_SCALE:
+			aArrays[0] = scaleX.data();
+			aArrays[1] = scaleY.data();
+			aArrays[2] = scaleZ.data();
+			aArrays[3] = nullptr;
+			break;
+	}
+}
+
+void Pose::getChannel(const EAnimationChannel aChannel, const float* aArrays[4]) const
+{
+	float* arrays[4];
+	const_cast<Pose*>(this)->getChannel(aChannel, arrays);
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		aArrays[i] = arrays[i];
+	}
+}
+
+void Pose::blend(const Pose& aFrom, const Pose& aTo, const float aWeight, Pose& aOut)
+{
+	const size_t count = aFrom.getJointCount();
+	if (&aOut != &aFrom && &aOut != &aTo)
+	{
+		aOut.resize(count);
+	}
+
+	const float from = 1.0f - aWeight;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		aOut.translationX[i] = aFrom.translationX[i] * from + aTo.translationX[i] * aWeight;
+		aOut.translationY[i] = aFrom.translationY[i] * from + aTo.translationY[i] * aWeight;
+		aOut.translationZ[i] = aFrom.translationZ[i] * from + aTo.translationZ[i] * aWeight;
+
+		aOut.scaleX[i] = aFrom.scaleX[i] * from + aTo.scaleX[i] * aWeight;
+		aOut.scaleY[i] = aFrom.scaleY[i] * from + aTo.scaleY[i] * aWeight;
+		aOut.scaleZ[i] = aFrom.scaleZ[i] * from + aTo.scaleZ[i] * aWeight;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const float dot = aFrom.rotationX[i] * aTo.rotationX[i] + aFrom.rotationY[i] * aTo.rotationY[i] +
+			aFrom.rotationZ[i] * aTo.rotationZ[i] + aFrom.rotationW[i] * aTo.rotationW[i];
+		const float to = dot < 0.0f ? -aWeight : aWeight;
+
+		aOut.rotationX[i] = aFrom.rotationX[i] * from + aTo.rotationX[i] * to;
+		aOut.rotationY[i] = aFrom.rotationY[i] * from + aTo.rotationY[i] * to;
+		aOut.rotationZ[i] = aFrom.rotationZ[i] * from + aTo.rotationZ[i] * to;
+		aOut.rotationW[i] = aFrom.rotationW[i] * from + aTo.rotationW[i] * to;
+	}
+
+	detail::sNormalizeRotations(aOut);
+}
+
+void Pose::blend(const Pose* const* aPoses, const float* aWeights, const size_t aCount, Pose& aOut)
+{
+	if (aCount == 0)
+	{
+		return;
+	}
+
+	float total = 0.0f;
+	for (size_t pose = 0; pose < aCount; pose++)
+	{
+		total += aWeights[pose];
+	}
+
+	const Pose& first = *aPoses[0];
+	const size_t count = first.getJointCount();
+
+	aOut.resize(count);
+
+	for (std::vector<float>* channel : { &aOut.rotationW, &aOut.scaleX, &aOut.scaleY, &aOut.scaleZ })
+	{
+		channel->assign(count, 0.0f);
+	}
+
+	for (size_t pose = 0; pose < aCount; pose++)
+	{
+		const Pose& source = *aPoses[pose];
+		const float weight = total > 0.0f ? aWeights[pose] / total : 1.0f / static_cast<float>(aCount);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			aOut.translationX[i] += source.translationX[i] * weight;
+			aOut.translationY[i] += source.translationY[i] * weight;
+			aOut.translationZ[i] += source.translationZ[i] * weight;
+
+			aOut.scaleX[i] += source.scaleX[i] * weight;
+			aOut.scaleY[i] += source.scaleY[i] * weight;
+			aOut.scaleZ[i] += source.scaleZ[i] * weight;
+
+			// Every rotation joins the average on the same side as the first pose's
+			const float dot = first.rotationX[i] * source.rotationX[i] + first.rotationY[i] * source.rotationY[i] +
+				first.rotationZ[i] * source.rotationZ[i] + first.rotationW[i] * source.rotationW[i];
+			const float signedWeight = dot < 0.0f ? -weight : weight;
+
+			aOut.rotationX[i] += source.rotationX[i] * signedWeight;
+			aOut.rotationY[i] += source.rotationY[i] * signedWeight;
+			aOut.rotationZ[i] += source.rotationZ[i] * signedWeight;
+			aOut.rotationW[i] += source.rotationW[i] * signedWeight;
+		}
+	}
+
+	detail::sNormalizeRotations(aOut);
+}
+
+void Pose::toModel(const Skeleton& aSkeleton, std::vector<JointMatrix>& aModel) const
+{
+	const size_t count = getJointCount();
+
+	detail::LocalMatrices& local = detail::sGetScratch();
+	local.resize(count);
+
+	float* m[12];
+	for (size_t element = 0; element < 12; element++)
+	{
+		m[element] = local.m[element].data();
+	}
+
+	// JointMatrix::fromTrs for every joint at once
+	for (size_t i = 0; i < count; i++)
+	{
+		const float x = rotationX[i];
+		const float y = rotationY[i];
+		const float z = rotationZ[i];
+		const float w = rotationW[i];
+
+		m[0][i] = (1.0f - 2.0f * (y * y + z * z)) * scaleX[i];
+		m[1][i] = 2.0f * (x * y - z * w) * scaleY[i];
+		m[2][i] = 2.0f * (x * z + y * w) * scaleZ[i];
+		m[3][i] = translationX[i];
+		m[4][i] = 2.0f * (x * y + z * w) * scaleX[i];
+		m[5][i] = (1.0f - 2.0f * (x * x + z * z)) * scaleY[i];
+		m[6][i] = 2.0f * (y * z - x * w) * scaleZ[i];
+		m[7][i] = translationY[i];
+		m[8][i] = 2.0f * (x * z - y * w) * scaleX[i];
+		m[9][i] = 2.0f * (y * z + x * w) * scaleY[i];
+		m[10][i] = (1.0f - 2.0f * (x * x + y * y)) * scaleZ[i];
+		m[11][i] = translationZ[i];
+	}
+
+	aModel.resize(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		JointMatrix matrix;
+		for (size_t element = 0; element < 12; element++)
+		{
+			matrix.m[element] = m[element][i];
+		}
+
+		const int32_t parent = aSkeleton.getParent(i);
+		aModel[i] = JointMatrix::multiply(parent == Skeleton::sNoParent ? aSkeleton.getRootTransform() : aModel[parent], matrix);
+	}
+}
@@ -0,0 +1,80 @@
+#include "animation/Skeleton.h"
+
+#include "core/Log.h"
+
+Skeleton::Skeleton()
+	: mRootTransform(JointMatrix::identity())
+{
+}
+
+bool Skeleton::build(std::vector<int32_t> aParents, std::vector<std::string> aNames, Pose aRestPose,
+	std::vector<JointMatrix> aInverseBinds, const JointMatrix& aRootTransform)
+{
+	const size_t count = aParents.size();
+
+	if (count > sMaxJoints || aNames.size() != count || aRestPose.getJointCount() != count || aInverseBinds.size() != count)
+	{
+		PRIMAL_INTERNAL_ERROR("Skeleton needs one name, rest transform and inverse bind per joint, at most {0} joints", sMaxJoints);
+		return false;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (aParents[i] != sNoParent && (aParents[i] < 0 || static_cast<size_t>(aParents[i]) >= i))
+		{
+			PRIMAL_INTERNAL_ERROR("Skeleton joint {0} comes before its parent {1}", i, aParents[i]);
+			return false;
+		}
+	}
+
+	mParents = std::move(aParents);
+	mNames = std::move(aNames);
+	mRestPose = std::move(aRestPose);
+	mInverseBinds = std::move(aInverseBinds);
+	mRootTransform = aRootTransform;
+
+	return true;
+}
+
+size_t Skeleton::getJointCount() const
+{
+	return mParents.size();
+}
+
+int32_t Skeleton::getParent(const size_t aJoint) const
+{
+	return mParents[aJoint];
+}
+
+const std::string& Skeleton::getName(const size_t aJoint) const
+{
+	return mNames[aJoint];
+}
+
+int32_t Skeleton::findJoint(const std::string& aName) const
+{
+	for (size_t i = 0; i < mNames.size(); i++)
+	{
+		if (mNames[i] == aName)
+		{
+			return static_cast<int32_t>(i);
+		}
+	}
+
+	return sNoParent;
+}
+
+const Pose& Skeleton::getRestPose() const
+{
+	return mRestPose;
+}
+
+const std::vector<JointMatrix>& Skeleton::getInverseBinds() const
+{
+	return mInverseBinds;
+}
+
+const JointMatrix& Skeleton::getRootTransform() const
+{
+	return mRootTransform;
+}
@@ -0,0 +1,370 @@
+#include "animation/Skinning.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "animation/Skeleton.h"
+#include "graphics/Mesh.h"
+
+namespace detail
+{
+	// Skinned attributes of one block, SoA, before they are written out
+	struct SkinnedBlock
+	{
+		float position[3][Skinning::sBlockSize];
+		float normal[3][Skinning::sBlockSize];
+		float tangent[3][Skinning::sBlockSize];
+	};
+
+	static void sNormalize(float* aX, float* aY, float* aZ, const size_t aCount)
+	{
+		for (size_t v = 0; v < aCount; v++)
+		{
+			const float lengthSquared = aX[v] * aX[v] + aY[v] * aY[v] + aZ[v] * aZ[v];
+			const float scale = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+
+			aX[v] *= scale;
+			aY[v] *= scale;
+			aZ[v] *= scale;
+		}
+	}
+
+	// Normalizes normals and tangents of a block and writes it to aOut with binormals rebuilt from them
+	static void sWriteBlock(const SkinBinding& aBinding, SkinnedBlock& aBlock, const size_t aFirst, const size_t aCount, Vertex* aOut)
+	{
+		sNormalize(aBlock.normal[0], aBlock.normal[1], aBlock.normal[2], aCount);
+		sNormalize(aBlock.tangent[0], aBlock.tangent[1], aBlock.tangent[2], aCount);
+
+		const float* handedness = aBinding.handedness.data() + aFirst;
+
+		for (size_t v = 0; v < aCount; v++)
+		{
+			Vertex& vertex = aOut[aFirst + v];
+
+			const Vector3f normal(aBlock.normal[0][v], aBlock.normal[1][v], aBlock.normal[2][v]);
+			const Vector3f tangent(aBlock.tangent[0][v], aBlock.tangent[1][v], aBlock.tangent[2][v]);
+
+			vertex.position = Vector3f(aBlock.position[0][v], aBlock.position[1][v], aBlock.position[2][v]);
+			vertex.normal = normal;
+			vertex.tangent = tangent;
+			vertex.binormal = normal.cross(tangent) * handedness[v];
+		}
+	}
+
+	// Rotation of a matrix with unit columns, x, y, z, w
+	static void sToQuaternion(const float* aColumns[3], float* aQuaternion)
+	{
+		const float m00 = aColumns[0][0], m10 = aColumns[0][1], m20 = aColumns[0][2];
+		const float m01 = aColumns[1][0], m11 = aColumns[1][1], m21 = aColumns[1][2];
+		const float m02 = aColumns[2][0], m12 = aColumns[2][1], m22 = aColumns[2][2];
+
+		const float trace = m00 + m11 + m22;
+
+		if (trace > 0.0f)
+		{
+			const float s = std::sqrt(trace + 1.0f) * 2.0f;
+			aQuaternion[0] = (m21 - m12) / s;
+			aQuaternion[1] = (m02 - m20) / s;
+			aQuaternion[2] = (m10 - m01) / s;
+			aQuaternion[3] = 0.25f * s;
+		}
+		else if (m00 > m11 && m00 > m22)
+		{
+			const float s = std::sqrt(1.0f + m00 - m11 - m22) * 2.0f;
+			aQuaternion[0] = 0.25f * s;
+			aQuaternion[1] = (m01 + m10) / s;
+			aQuaternion[2] = (m02 + m20) / s;
+			aQuaternion[3] = (m21 - m12) / s;
+		}
+		else if (m11 > m22)
+		{
+			const float s = std::sqrt(1.0f + m11 - m00 - m22) * 2.0f;
+			aQuaternion[0] = (m01 + m10) / s;
+			aQuaternion[1] = 0.25f * s;
+			aQuaternion[2] = (m12 + m21) / s;
+			aQuaternion[3] = (m02 - m20) / s;
+		}
+		else
+		{
+			const float s = std::sqrt(1.0f + m22 - m00 - m11) * 2.0f;
+			aQuaternion[0] = (m02 + m20) / s;
+			aQuaternion[1] = (m12 + m21) / s;
+			aQuaternion[2] = 0.25f * s;
+			aQuaternion[3] = (m10 - m01) / s;
+		}
+	}
+}
+
+bool SkinBinding::build(const Mesh& aMesh)
+{
+	const SkinVertex* skin = aMesh.getSkin();
+	if (skin == nullptr)
+	{
+		return false;
+	}
+
+	const size_t count = aMesh.getVertexCount();
+
+	mBindVertices.resize(count);
+	VertexFormat::decode(aMesh.getData(), count, aMesh.getVertexFormat(), aMesh.getBoundsMin(), aMesh.getBoundsMax(), mBindVertices.data());
+
+	for (std::vector<float>* stream : { &positionX, &positionY, &positionZ, &normalX, &normalY, &normalZ,
+		&tangentX, &tangentY, &tangentZ, &handedness })
+	{
+		stream->resize(count);
+	}
+
+	for (size_t influence = 0; influence < 4; influence++)
+	{
+		joints[influence].resize(count);
+		weights[influence].resize(count);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vertex& vertex = mBindVertices[i];
+
+		positionX[i] = vertex.position.x;
+		positionY[i] = vertex.position.y;
+		positionZ[i] = vertex.position.z;
+
+		normalX[i] = vertex.normal.x;
+		normalY[i] = vertex.normal.y;
+		normalZ[i] = vertex.normal.z;
+
+		tangentX[i] = vertex.tangent.x;
+		tangentY[i] = vertex.tangent.y;
+		tangentZ[i] = vertex.tangent.z;
+
+		handedness[i] = vertex.normal.cross(vertex.tangent).dot(vertex.binormal) < 0.0f ? -1.0f : 1.0f;
+
+		for (size_t influence = 0; influence < 4; influence++)
+		{
+			joints[influence][i] = skin[i].joints[influence];
+			weights[influence][i] = skin[i].weights[influence];
+		}
+	}
+
+	return true;
+}
+
+size_t SkinBinding::getVertexCount() const
+{
+	return mBindVertices.size();
+}
+
+const std::vector<Vertex>& SkinBinding::getBindVertices() const
+{
+	return mBindVertices;
+}
+
+void Skinning::computePalette(const Skeleton& aSkeleton, const std::vector<JointMatrix>& aModel, std::vector<JointMatrix>& aPalette)
+{
+	const std::vector<JointMatrix>& inverseBinds = aSkeleton.getInverseBinds();
+
+	aPalette.resize(aModel.size());
+
+	for (size_t i = 0; i < aModel.size(); i++)
+	{
+		aPalette[i] = JointMatrix::multiply(aModel[i], inverseBinds[i]);
+	}
+}
+
+void Skinning::computeDualQuaternions(const std::vector<JointMatrix>& aPalette, std::vector<DualQuaternion>& aDualQuaternions)
+{
+	aDualQuaternions.resize(aPalette.size());
+
+	for (size_t i = 0; i < aPalette.size(); i++)
+	{
+		const float* m = aPalette[i].m;
+
+		float columns[3][3];
+		const float* columnPointers[3];
+
+		for (size_t column = 0; column < 3; column++)
+		{
+			const float x = m[column];
+			const float y = m[4 + column];
+			const float z = m[8 + column];
+
+			const float length = std::sqrt(x * x + y * y + z * z);
+			const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+
+			columns[column][0] = x * scale;
+			columns[column][1] = y * scale;
+			columns[column][2] = z * scale;
+			columnPointers[column] = columns[column];
+		}
+
+		DualQuaternion& dq = aDualQuaternions[i];
+		detail::sToQuaternion(columnPointers, dq.real);
+
+		// dual = 0.5 * (translation, 0) * real
+		const float tx = m[3];
+		const float ty = m[7];
+		const float tz = m[11];
+		const float* q = dq.real;
+
+		dq.dual[0] = 0.5f * (tx * q[3] + ty * q[2] - tz * q[1]);
+		dq.dual[1] = 0.5f * (ty * q[3] + tz * q[0] - tx * q[2]);
+		dq.dual[2] = 0.5f * (tz * q[3] + tx * q[1] - ty * q[0]);
+		dq.dual[3] = -0.5f * (tx * q[0] + ty * q[1] + tz * q[2]);
+	}
+}
+
+void Skinning::skinLinearBlend(const SkinBinding& aBinding, const JointMatrix* aPalette, const size_t aBegin, const size_t aEnd, Vertex* aOut)
+{
+	detail::SkinnedBlock block;
+	float blended[12][sBlockSize];
+
+	for (size_t first = aBegin; first < aEnd; first += sBlockSize)
+	{
+		const size_t count = std::min(sBlockSize, aEnd - first);
+
+		// Gather: the weighted sum of up to four palette matrices per vertex
+		for (size_t v = 0; v < count; v++)
+		{
+			const size_t i = first + v;
+
+			const float* m0 = aPalette[aBinding.joints[0][i]].m;
+			const float* m1 = aPalette[aBinding.joints[1][i]].m;
+			const float* m2 = aPalette[aBinding.joints[2][i]].m;
+			const float* m3 = aPalette[aBinding.joints[3][i]].m;
+
+			const float w0 = aBinding.weights[0][i];
+			const float w1 = aBinding.weights[1][i];
+			const float w2 = aBinding.weights[2][i];
+			const float w3 = aBinding.weights[3][i];
+
+			for (size_t element = 0; element < 12; element++)
+			{
+				blended[element][v] = m0[element] * w0 + m1[element] * w1 + m2[element] * w2 + m3[element] * w3;
+			}
+		}
+
+		const float* px = aBinding.positionX.data() + first;
+		const float* py = aBinding.positionY.data() + first;
+		const float* pz = aBinding.positionZ.data() + first;
+		const float* nx = aBinding.normalX.data() + first;
+		const float* ny = aBinding.normalY.data() + first;
+		const float* nz = aBinding.normalZ.data() + first;
+		const float* tx = aBinding.tangentX.data() + first;
+		const float* ty = aBinding.tangentY.data() + first;
+		const float* tz = aBinding.tangentZ.data() + first;
+
+		for (size_t v = 0; v < count; v++)
+		{
+			block.position[0][v] = blended[0][v] * px[v] + blended[1][v] * py[v] + blended[2][v] * pz[v] + blended[3][v];
+			block.position[1][v] = blended[4][v] * px[v] + blended[5][v] * py[v] + blended[6][v] * pz[v] + blended[7][v];
+			block.position[2][v] = blended[8][v] * px[v] + blended[9][v] * py[v] + blended[10][v] * pz[v] + blended[11][v];
+
+			block.normal[0][v] = blended[0][v] * nx[v] + blended[1][v] * ny[v] + blended[2][v] * nz[v];
+			block.normal[1][v] = blended[4][v] * nx[v] + blended[5][v] * ny[v] + blended[6][v] * nz[v];
+			block.normal[2][v] = blended[8][v] * nx[v] + blended[9][v] * ny[v] + blended[10][v] * nz[v];
+
+			block.tangent[0][v] = blended[0][v] * tx[v] + blended[1][v] * ty[v] + blended[2][v] * tz[v];
+			block.tangent[1][v] = blended[4][v] * tx[v] + blended[5][v] * ty[v] + blended[6][v] * tz[v];
+			block.tangent[2][v] = blended[8][v] * tx[v] + blended[9][v] * ty[v] + blended[10][v] * tz[v];
+		}
+
+		detail::sWriteBlock(aBinding, block, first, count, aOut);
+	}
+}
+
+void Skinning::skinDualQuaternion(const SkinBinding& aBinding, const DualQuaternion* aDualQuaternions, const size_t aBegin,
+	const size_t aEnd, Vertex* aOut)
+{
+	detail::SkinnedBlock block;
+	float blended[8][sBlockSize];
+
+	for (size_t first = aBegin; first < aEnd; first += sBlockSize)
+	{
+		const size_t count = std::min(sBlockSize, aEnd - first);
+
+		// Gather: the weighted sum of up to four dual quaternions per vertex, each flipped onto the
+		// hemisphere of the first so that the blend takes the shorter path
+		for (size_t v = 0; v < count; v++)
+		{
+			const size_t i = first + v;
+			const DualQuaternion& q0 = aDualQuaternions[aBinding.joints[0][i]];
+
+			float sum[8] = {};
+
+			for (size_t influence = 0; influence < 4; influence++)
+			{
+				const DualQuaternion& q = aDualQuaternions[aBinding.joints[influence][i]];
+				const float dot = q0.real[0] * q.real[0] + q0.real[1] * q.real[1] + q0.real[2] * q.real[2] + q0.real[3] * q.real[3];
+				const float weight = dot < 0.0f ? -aBinding.weights[influence][i] : aBinding.weights[influence][i];
+
+				for (size_t c = 0; c < 4; c++)
+				{
+					sum[c] += q.real[c] * weight;
+					sum[4 + c] += q.dual[c] * weight;
+				}
+			}
+
+			for (size_t element = 0; element < 8; element++)
+			{
+				blended[element][v] = sum[element];
+			}
+		}
+
+		const float* px = aBinding.positionX.data() + first;
+		const float* py = aBinding.positionY.data() + first;
+		const float* pz = aBinding.positionZ.data() + first;
+		const float* nx = aBinding.normalX.data() + first;
+		const float* ny = aBinding.normalY.data() + first;
+		const float* nz = aBinding.normalZ.data() + first;
+		const float* tx = aBinding.tangentX.data() + first;
+		const float* ty = aBinding.tangentY.data() + first;
+		const float* tz = aBinding.tangentZ.data() + first;
+
+		for (size_t v = 0; v < count; v++)
+		{
+			const float lengthSquared = blended[0][v] * blended[0][v] + blended[1][v] * blended[1][v] +
+				blended[2][v] * blended[2][v] + blended[3][v] * blended[3][v];
+			const float scale = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+
+			const float rx = blended[0][v] * scale;
+			const float ry = blended[1][v] * scale;
+			const float rz = blended[2][v] * scale;
+			const float rw = blended[3][v] * scale;
+			const float dx = blended[4][v] * scale;
+			const float dy = blended[5][v] * scale;
+			const float dz = blended[6][v] * scale;
+			const float dw = blended[7][v] * scale;
+
+			// translation = 2 * (rw * d - dw * r + r x d)
+			const float translationX = 2.0f * (rw * dx - dw * rx + ry * dz - rz * dy);
+			const float translationY = 2.0f * (rw * dy - dw * ry + rz * dx - rx * dz);
+			const float translationZ = 2.0f * (rw * dz - dw * rz + rx * dy - ry * dx);
+
+			// Rotations as v + 2 * r x (r x v + rw * v)
+			float cx = ry * pz[v] - rz * py[v] + rw * px[v];
+			float cy = rz * px[v] - rx * pz[v] + rw * py[v];
+			float cz = rx * py[v] - ry * px[v] + rw * pz[v];
+
+			block.position[0][v] = px[v] + 2.0f * (ry * cz - rz * cy) + translationX;
+			block.position[1][v] = py[v] + 2.0f * (rz * cx - rx * cz) + translationY;
+			block.position[2][v] = pz[v] + 2.0f * (rx * cy - ry * cx) + translationZ;
+
+			cx = ry * nz[v] - rz * ny[v] + rw * nx[v];
+			cy = rz * nx[v] - rx * nz[v] + rw * ny[v];
+			cz = rx * ny[v] - ry * nx[v] + rw * nz[v];
+
+			block.normal[0][v] = nx[v] + 2.0f * (ry * cz - rz * cy);
+			block.normal[1][v] = ny[v] + 2.0f * (rz * cx - rx * cz);
+			block.normal[2][v] = nz[v] + 2.0f * (rx * cy - ry * cx);
+
+			cx = ry * tz[v] - rz * ty[v] + rw * tx[v];
+			cy = rz * tx[v] - rx * tz[v] + rw * ty[v];
+			cz = rx * ty[v] - ry * tx[v] + rw * tz[v];
+
+			block.tangent[0][v] = tx[v] + 2.0f * (ry * cz - rz * cy);
+			block.tangent[1][v] = ty[v] + 2.0f * (rz * cx - rx * cz);
+			block.tangent[2][v] = tz[v] + 2.0f * (rx * cy - ry * cx);
+		}
+
+		detail::sWriteBlock(aBinding, block, first, count, aOut);
+	}
+}
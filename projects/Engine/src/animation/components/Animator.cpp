@@ -0,0 +1,21 @@
+#include "animation/components/Animator.h"
+
+Animator::Animator(const Skeleton* aSkeleton, const SkinBinding* aBinding)
+{
+	mInstance = new AnimationInstance(aSkeleton, aBinding);
+}
+
+Animator::~Animator()
+{
+	delete mInstance;
+}
+
+AnimationInstance& Animator::getInstance()
+{
+	return *mInstance;
+}
+
+const AnimationInstance& Animator::getInstance() const
+{
+	return *mInstance;
+}
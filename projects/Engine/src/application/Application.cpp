@@ -1,72 +1,178 @@
 #include "application/Application.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
 #include "assets/AssetManager.h"
+#include "assets/TextureStreamer.h"
 #include "core/Log.h"
+#include "core/PrimalAssert.h"
+#include "core/Profiler.h"
+#include "core/Time.h"
 #include "input/Input.h"
 #include "ecs/SystemManager.h"
+#include "graphics/Material.h"
+#include "systems/HeadlessRenderSystem.h"
 #include "systems/RenderSystem.h"
 #include "physics/PhysicsSystem.h"
+#include "animation/AnimationSystem.h"
 #include "application/ApplicationLayer.h"
 #include "systems/VulkanRenderSystem.h"
 #include "ecs/EntityManager.h"
 
 Application* Application::sInstance;
+std::vector<std::string> Application::sArguments;
+
+void Application::setArguments(const int aArgc, char** aArgv)
+{
+	sArguments.assign(aArgv + std::min(aArgc, 1), aArgv + aArgc);
+}
+
+bool Application::hasArgument(const std::string& aArgument)
+{
+	return std::find(sArguments.begin(), sArguments.end(), aArgument) != sArguments.end();
+}
 
 Application::Application()
+	: Application(ApplicationCreateInfo())
+{
+}
+
+Application::Application(const ApplicationCreateInfo& aCreateInfo)
+	: mFrameLimit(aCreateInfo.frameLimit)
 {
 	Log::construct();
 
 	sInstance = this;
 
-	mWindow = Window::create();
-	mWindow->setEventCallback(BIND_EVENT_FUNCTION(Application::onEvent));
-
 	EntityManager::instance().setEventCallback(BIND_EVENT_FUNCTION(Application::onEvent));
 
-	SystemManager::instance().addSystem<RenderSystem>(mWindow);
+	if (aCreateInfo.headless)
+	{
+		SystemManager::instance().addSystem<HeadlessRenderSystem>(aCreateInfo.window.width, aCreateInfo.window.height);
+	}
+	else
+	{
+		mWindow = Window::create(aCreateInfo.window);
+		mWindow->setEventCallback(BIND_EVENT_FUNCTION(Application::onEvent));
+
+		SystemManager::instance().addSystem<RenderSystem>(mWindow);
+	}
+
 	SystemManager::instance().addSystem<PhysicsSystem>();
+	SystemManager::instance().addSystem<AnimationSystem>();
 	SystemManager::instance().configure();
+
+	if (aCreateInfo.hotReload)
+	{
+		AssetManager::instance().setHotReload(true);
+	}
 }
 
 Application::~Application()
 {
-	SystemManager::instance().removeSystem<RenderSystem>();
+	mRenderTaskGroup.wait();
+
+	if (isHeadless())
+	{
+		SystemManager::instance().removeSystem<HeadlessRenderSystem>();
+	}
+	else
+	{
+		SystemManager::instance().removeSystem<RenderSystem>();
+	}
+
 	SystemManager::instance().removeSystem<PhysicsSystem>();
+	SystemManager::instance().removeSystem<AnimationSystem>();
 	delete mWindow;
 	sInstance = nullptr;
 }
 
-void Application::run() const
+void Application::run()
 {
+	PRIMAL_PROFILE_THREAD("Main");
+
+	mFrameTimer.reset();
+
 	while(mRunning)
 	{
-		Input::_poll();
+		const float frameTime = mFrameTimer.elapsed();
+		mFrameTimer.reset();
+
+		Time::_advance(frameTime);
 
-		if(Input::isKeyPressed(KEY_ESCAPE))
+		if (mWindow != nullptr)
 		{
-			mWindow->close();
+			Input::_poll();
+
+			if(Input::isKeyPressed(KEY_ESCAPE))
+			{
+				mWindow->close();
+			}
 		}
 
-		SystemManager::instance().update();
-		SystemManager::instance().fixedUpdate();
+		_step(frameTime);
+		_render(frameTime);
 
-		SystemManager::instance().render();
+		{
+			PRIMAL_PROFILE_SCOPE("ApplicationLayer::update");
 
-		for (ApplicationLayer* layer : mLayerStack)
-			layer->onUpdate();
+			for (ApplicationLayer* layer : mLayerStack)
+				layer->onUpdate();
 
-		for (ApplicationLayer* layer : mLayerStack)
-			layer->onRender();
+			for (ApplicationLayer* layer : mLayerStack)
+				layer->onRender();
+		}
 
-		mWindow->refresh();
-		mWindow->pollEvents();
+		if (mWindow != nullptr)
+		{
+			PRIMAL_PROFILE_SCOPE("Window::present");
+
+			mWindow->refresh();
+			mWindow->pollEvents();
+		}
+
+		PRIMAL_PROFILE_FRAME();
+
+		if (mFrameLimit != 0 && mFrameIndex >= mFrameLimit)
+		{
+			mRunning = false;
+		}
 	}
+
+	mRenderTaskGroup.wait();
+}
+
+void Application::close()
+{
+	mRunning = false;
+}
+
+void Application::setFixedTimeStep(const float aTimeStep)
+{
+	PRIMAL_INTERNAL_ASSERT(aTimeStep > 0.0f, "Fixed time step must be positive");
+
+	mFixedTimeStep = aTimeStep;
+	Time::_setFixedDeltaTime(aTimeStep);
+}
+
+void Application::setMaxFixedSteps(const uint32_t aMaxSteps)
+{
+	mMaxFixedSteps = aMaxSteps > 0 ? aMaxSteps : 1;
+}
+
+void Application::setPipelined(const bool aPipelined)
+{
+	mRenderTaskGroup.wait();
+	mPipelined = aPipelined;
 }
 
 void Application::onEvent(Event& aEvent)
 {
 	EventDispatcher dispatcher(aEvent);
 	dispatcher.dispatch<WindowCloseEvent>(BIND_EVENT_FUNCTION(Application::_onWindowClose));
+	dispatcher.dispatch<WindowResizeEvent>(BIND_EVENT_FUNCTION(Application::_onWindowResize));
 	dispatcher.dispatch<KeyPressedEvent>(BIND_EVENT_FUNCTION(Application::_onKeyPressed));
 	dispatcher.dispatch<KeyReleasedEvent>(BIND_EVENT_FUNCTION(Application::_onKeyReleased));
 	dispatcher.dispatch<MouseMovedEvent>(BIND_EVENT_FUNCTION(Application::_onMouseMoved));
@@ -108,12 +214,105 @@ void Application::popOverlay(ApplicationLayer* aOverlay)
 	aOverlay->onDetach();
 }
 
+void Application::_step(const float aFrameTime)
+{
+	PRIMAL_PROFILE_SCOPE("Application::_step");
+
+	SystemManager::instance().update(aFrameTime);
+
+	mAccumulator += aFrameTime;
+
+	uint32_t steps = 0;
+	while (mAccumulator >= mFixedTimeStep && steps < mMaxFixedSteps)
+	{
+		SystemManager::instance().fixedUpdate(mFixedTimeStep);
+
+		mAccumulator -= mFixedTimeStep;
+		++steps;
+	}
+
+	// Drop whole steps we could not catch up on, so a long hitch doesn't spiral into ever longer frames
+	if (mAccumulator >= mFixedTimeStep)
+	{
+		mAccumulator = std::fmod(mAccumulator, mFixedTimeStep);
+	}
+
+	Time::_setInterpolationAlpha(mAccumulator / mFixedTimeStep);
+}
+
+void Application::_render(const float aFrameTime)
+{
+	PRIMAL_PROFILE_SCOPE("Application::_render");
+
+	// The packet extracted last frame may still be rendering; it must finish before the
+	// render systems are touched again
+	{
+		PRIMAL_PROFILE_SCOPE("Application::waitForRender");
+		mRenderTaskGroup.wait();
+	}
+
+	// Nothing renders right now, so rebuilt assets can replace the ones the last frame used
+	AssetManager::instance().update();
+
+	FramePacket& packet = mFramePackets[mFrameIndex % 2];
+	packet.reset();
+	packet.frameIndex = mFrameIndex++;
+	packet.deltaTime = aFrameTime;
+	packet.interpolationAlpha = Time::interpolationAlpha();
+
+	SystemManager::instance().extract(packet);
+
+	_streamTextures(packet);
+
+	if (mPipelined)
+	{
+		mRenderTaskGroup.run([&packet]
+		{
+			PRIMAL_PROFILE_SCOPE("Application::renderTask");
+			SystemManager::instance().render(packet);
+		});
+	}
+	else
+	{
+		SystemManager::instance().render(packet);
+	}
+}
+
+void Application::_streamTextures(const FramePacket& aPacket)
+{
+	PRIMAL_PROFILE_SCOPE("Application::streamTextures");
+
+	// Every texture of a material is requested at the largest size any of its draws spans
+	std::unordered_map<Material*, float> materialSizes;
+	for (const DrawItem& draw : aPacket.draws)
+	{
+		float& size = materialSizes[draw.material->getParentMaterial()];
+		size = std::max(size, draw.screenSize);
+	}
+
+	for (const auto& material : materialSizes)
+	{
+		for (ITexture* texture : material.first->getTextures())
+		{
+			TextureStreamer::instance().request(texture, material.second);
+		}
+	}
+
+	TextureStreamer::instance().update();
+}
+
 bool Application::_onWindowClose(WindowCloseEvent& aEvent)
 {
 	mRunning = false;
 	return true;
 }
 
+bool Application::_onWindowResize(WindowResizeEvent& aEvent)
+{
+	mRenderTaskGroup.wait();
+	return false;
+}
+
 bool Application::_onKeyPressed(KeyPressedEvent& aEvent) const
 {
 	Input::_setKeyPressed(aEvent.getKeyCode());
@@ -1 +1,11 @@
-#include "assets/Asset.h"
\ No newline at end of file
+#include "assets/Asset.h"
+
+#include "assets/AssetManager.h"
+
+Asset::~Asset()
+{
+	if (mResidentType != nullptr)
+	{
+		AssetManager::instance()._release(*mResidentType, mResidentBytes);
+	}
+}
@@ -1,7 +1,13 @@
 #include "assets/AssetManager.h"
 
+#include <algorithm>
+
+#include <tbb/parallel_for_each.h>
 #include <tbb/task_scheduler_init.h>
-#include <thread>
+
+#include "core/Log.h"
+#include "core/Profiler.h"
+#include "filesystem/FileSystem.h"
 
 AssetManager& AssetManager::instance()
 {
@@ -9,105 +15,828 @@ AssetManager& AssetManager::instance()
 	return *instance;
 }
 
-// NOT THREAD SAFE
-void AssetManager::_loadAssetAsync(std::list<std::string>::iterator& aIter, const uint8_t aPrio)
+AssetManager::AssetManager()
+	: mArena(tbb::task_scheduler_init::default_num_threads())
+{
+	const uint32_t threads = static_cast<uint32_t>(std::max(1, tbb::task_scheduler_init::default_num_threads()));
+
+	mMaxInFlight[assetLoadHighPrio] = threads;
+	mMaxInFlight[assetLoadMedPrio] = std::max(1u, threads / 2);
+	mMaxInFlight[assetLoadLowPrio] = std::max(1u, threads / 4);
+
+	for (uint8_t prio = 0; prio < sPriorityCount; ++prio)
+	{
+		mInFlight[prio] = 0;
+	}
+
+	mPending = 0;
+	mUseClock = 0;
+}
+
+AssetManager::Shard& AssetManager::_getShard(const std::string& aName)
+{
+	return mShards[std::hash<std::string>()(aName) % sShardCount];
+}
+
+void AssetManager::_schedule()
 {
-	const auto asset = mAssets.find(*aIter);
-	if (asset != mAssets.end())
+	for (int prio = sPriorityCount - 1; prio >= 0; --prio)
 	{
-		mAsyncTaskGroup.run([=] 
+		while (true)
 		{
-			asset->second->_load();
+			uint32_t inFlight = mInFlight[prio].load(std::memory_order_acquire);
+			if (inFlight >= mMaxInFlight[prio].load(std::memory_order_relaxed))
+			{
+				break;
+			}
+
+			if (!mInFlight[prio].compare_exchange_weak(inFlight, inFlight + 1, std::memory_order_acq_rel))
+			{
+				continue;
+			}
+
+			PendingLoad load;
+			if (!mQueues[prio].try_pop(load))
+			{
+				mInFlight[prio].fetch_sub(1, std::memory_order_acq_rel);
+
+				// Something may have been pushed after the pop failed but before the slot was handed back,
+				// and that push saw the slot as taken. Retry so it isn't left behind.
+				if (mQueues[prio].empty())
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			const uint8_t loadPrio = static_cast<uint8_t>(prio);
+			mArena.enqueue([this, loadPrio, load]
+			{
+				_execute(loadPrio, load);
+			});
+		}
+	}
+}
+
+AssetManager::AssetEntry AssetManager::_acquire(const AssetDependency& aDependency, bool& aCreated)
+{
+	Shard& shard = _getShard(aDependency.name);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	auto element = shard.assets.find(aDependency.name);
+	aCreated = element == shard.assets.end() || element->second.asset == nullptr;
+
+	if (element == shard.assets.end())
+	{
+		element = shard.assets.emplace(aDependency.name, AssetEntry{ nullptr, nullptr, aDependency.create }).first;
+	}
+
+	if (aCreated)
+	{
+		_instantiate(element->second, aDependency.name);
+	}
+
+	_touch(element->second);
+
+	return element->second;
+}
+
+void AssetManager::_execute(const uint8_t aPrio, PendingLoad aLoad)
+{
+	// A synchronous load() of the same asset may already have taken it
+	if (!aLoad.state->_claim())
+	{
+		mInFlight[aPrio].fetch_sub(1, std::memory_order_acq_rel);
+		_schedule();
+		_finishPending();
+		return;
+	}
+
+	std::vector<AssetDependency> dependencies;
+	std::vector<AssetFileRead> reads;
+	if (!_gather(aLoad.asset.get(), dependencies, reads) || !_track(aLoad.asset.get(), dependencies, reads))
+	{
+		aLoad.state->_complete(true);
+		_finishPending();
+
+		mInFlight[aPrio].fetch_sub(1, std::memory_order_acq_rel);
+		_schedule();
+		return;
+	}
+
+	// The parent holds one count itself so it cannot be finalized while dependencies are still being
+	// registered. Whichever thread drops the count to zero finalizes it.
+	auto remaining = std::make_shared<std::atomic<size_t>>(dependencies.size() + reads.size() + 1);
+	auto resume = [this, aLoad, remaining]
+	{
+		if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			_finalize(aLoad.asset.get(), aLoad.state.get());
+			_finishPending();
+		}
+	};
+
+	for (const AssetDependency& dependency : dependencies)
+	{
+		bool created;
+		AssetEntry entry = _acquire(dependency, created);
+
+		if (created)
+		{
+			mPending.fetch_add(1, std::memory_order_relaxed);
+			mQueues[aPrio].push({ entry.asset, entry.state });
+		}
+
+		if (entry.state != nullptr)
+		{
+			entry.state->onComplete(resume);
+		}
+		else
+		{
+			resume();
+		}
+	}
+
+	// Read completions arrive on the file reader's thread, which must not run the decode in _load()
+	for (const AssetFileRead& read : reads)
+	{
+		FileView* target = read.target;
+
+		FileSystem::instance().readAsync(read.path, [this, target, resume](FileView aData)
+		{
+			*target = std::move(aData);
+			mArena.enqueue(resume);
 		});
 	}
 
-	switch (aPrio)
+	// Finalizes here if every dependency was already resident. Otherwise the parent gives up its slot
+	// and is finalized by the thread that completes its last dependency, so no worker blocks on it.
+	resume();
+
+	mInFlight[aPrio].fetch_sub(1, std::memory_order_acq_rel);
+	_schedule();
+}
+
+void AssetManager::_finishPending()
+{
+	if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
 	{
-		case assetLoadHighPrio:
-			mAsyncAssetQueueHigh.erase(aIter);
-			aIter = mAsyncAssetQueueHigh.begin();
-			break;
+		std::lock_guard<std::mutex> lock(mIdleMutex);
+		mIdleCv.notify_all();
+	}
+}
 
-		case assetLoadMedPrio:
-			mAsyncAssetQueueMedium.erase(aIter);
-			aIter = mAsyncAssetQueueMedium.begin();
-			break;
+void AssetManager::_loadNow(const PendingLoad& aLoad)
+{
+	std::vector<AssetDependency> dependencies;
+	std::vector<AssetFileRead> reads;
+	if (!_gather(aLoad.asset.get(), dependencies, reads) || !_track(aLoad.asset.get(), dependencies, reads))
+	{
+		aLoad.state->_complete(true);
+		return;
+	}
 
-		case assetLoadLowPrio:
-			mAsyncAssetQueueLow.erase(aIter);
-			aIter = mAsyncAssetQueueLow.begin();
-			break;
+	for (const AssetFileRead& read : reads)
+	{
+		*read.target = FileSystem::instance().view(read.path);
+	}
+
+	// Counted like in _execute. A dependency that another loader owns finalizes this asset when it
+	// completes, instead of the worker blocking on it while the owner may need that worker.
+	auto remaining = std::make_shared<std::atomic<size_t>>(dependencies.size() + 1);
+	auto resume = [this, aLoad, remaining]
+	{
+		if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			_finalize(aLoad.asset.get(), aLoad.state.get());
+		}
+	};
 
-		default:
-			break;
+	tbb::parallel_for_each(dependencies.begin(), dependencies.end(), [this, &resume](const AssetDependency& aDependency)
+	{
+		bool created;
+		AssetEntry entry = _acquire(aDependency, created);
+
+		if (entry.state == nullptr)
+		{
+			resume();
+			return;
+		}
+
+		if (entry.state->_claim())
+		{
+			_loadNow({ entry.asset, entry.state });
+		}
+
+		entry.state->onComplete(resume);
+	});
+
+	resume();
+}
+
+void AssetManager::_finalize(Asset* aAsset, AssetLoadState* aState)
+{
+	bool failed = false;
+	{
+		PRIMAL_PROFILE_SCOPE("AssetManager::load");
+
+		// Descriptor parsing throws on malformed input. With hot reload that is a file still being
+		// edited, which must not take down the worker.
+		try
+		{
+			aAsset->_load();
+		}
+		catch (const std::exception& aException)
+		{
+			PRIMAL_INTERNAL_ERROR("Failed to load asset {0}: {1}", aAsset->mName, aException.what());
+			failed = true;
+		}
 	}
 
-	// Cramming tasks down TBB's throat causes tasks to drop
-	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	_addResident(aAsset);
+	aAsset->mLoaded = true;
+
+	if (aState != nullptr)
+	{
+		aState->_complete(failed);
+	}
 }
 
-AssetManager::AssetManager()
+bool AssetManager::_gather(Asset* aAsset, std::vector<AssetDependency>& aDependencies, std::vector<AssetFileRead>& aReads)
 {
-	tbb::task_scheduler_init(4);
+	PRIMAL_PROFILE_SCOPE("AssetManager::gatherDependencies");
 
-	// Do Async Loads //
-	mAsyncTaskGroup.run([=]
+	// Descriptors are already parsed here, so a half saved one throws before _load() is reached
+	try
 	{
-		while (true)
+		aDependencies = aAsset->_gatherDependencies();
+		aReads = aAsset->_gatherReads();
+	}
+	catch (const std::exception& aException)
+	{
+		PRIMAL_INTERNAL_ERROR("Failed to load asset {0}: {1}", aAsset->mName, aException.what());
+		return false;
+	}
+
+	return true;
+}
+
+void AssetManager::_addResident(Asset* aAsset)
+{
+	aAsset->mResidentBytes = aAsset->getMemoryUsage();
+	aAsset->mResidentType = &typeid(*aAsset);
+
+	std::lock_guard<std::mutex> lock(mResidencyMutex);
+
+	AssetResidencyStats& stats = mResidency[std::type_index(*aAsset->mResidentType)];
+	stats.residentBytes += aAsset->mResidentBytes;
+	stats.residentCount++;
+}
+
+void AssetManager::_release(const std::type_info& aType, const size_t aBytes)
+{
+	std::lock_guard<std::mutex> lock(mResidencyMutex);
+
+	AssetResidencyStats& stats = mResidency[std::type_index(aType)];
+	stats.residentBytes -= aBytes;
+	stats.residentCount--;
+}
+
+void AssetManager::_touch(AssetEntry& aEntry)
+{
+	aEntry.lastUse = mUseClock.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void AssetManager::_instantiate(AssetEntry& aEntry, const std::string& aName)
+{
+	aEntry.asset = aEntry.create();
+	aEntry.asset->mName = aName;
+	aEntry.state = std::make_shared<AssetLoadState>();
+
+	if (aEntry.evicted)
+	{
+		aEntry.evicted = false;
+
+		std::lock_guard<std::mutex> lock(mResidencyMutex);
+		mResidency[std::type_index(typeid(*aEntry.asset))].restreamCount++;
+	}
+}
+
+void AssetManager::_evict()
+{
+	std::unordered_map<std::type_index, size_t> excess;
+	{
+		std::lock_guard<std::mutex> lock(mResidencyMutex);
+
+		for (const auto& residency : mResidency)
+		{
+			const AssetResidencyStats& stats = residency.second;
+			if (stats.budget != 0 && stats.residentBytes > stats.budget)
+			{
+				excess[residency.first] = stats.residentBytes - stats.budget;
+			}
+		}
+	}
+
+	if (excess.empty())
+		return;
+
+	PRIMAL_PROFILE_SCOPE("AssetManager::evict");
+
+	struct Candidate
+	{
+		std::string name;
+		uint64_t lastUse;
+		std::type_index type;
+	};
+
+	// Only the manager's own reference may remain, anything else means the asset is still in use
+	std::vector<Candidate> candidates;
+	for (Shard& shard : mShards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		for (const auto& element : shard.assets)
+		{
+			const AssetEntry& entry = element.second;
+
+			if (entry.asset == nullptr || !entry.create || entry.asset.use_count() != 1 || entry.asset->mResidentType == nullptr)
+				continue;
+
+			if (entry.state != nullptr && !entry.state->isReady())
+				continue;
+
+			const std::type_index type(*entry.asset->mResidentType);
+			if (excess.count(type) != 0)
+			{
+				candidates.push_back({ element.first, entry.lastUse, type });
+			}
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& aLeft, const Candidate& aRight)
+	{
+		return aLeft.lastUse < aRight.lastUse;
+	});
+
+	size_t evictedBytes = 0;
+	uint32_t evictedCount = 0;
+
+	for (const Candidate& candidate : candidates)
+	{
+		size_t& remaining = excess[candidate.type];
+		if (remaining == 0)
+			continue;
+
+		// Dependents often keep raw pointers into the assets they were built from
 		{
-			mQueueMutex.lock();
-			auto it = mAsyncAssetQueueHigh.begin();
-			while (it != mAsyncAssetQueueHigh.end())
-				_loadAssetAsync(it, assetLoadHighPrio);
-			mQueueMutex.unlock();
+			std::lock_guard<std::mutex> lock(mLinksMutex);
 
-			mQueueMutex.lock();
-			it = mAsyncAssetQueueMedium.begin();
-			while (it != mAsyncAssetQueueMedium.end())
+			bool required = false;
+
+			const auto dependents = mDependents.find(candidate.name);
+			if (dependents != mDependents.end())
 			{
-				if (mAsyncAssetQueueHigh.size() > 0)
+				for (const std::string& dependent : dependents->second)
 				{
-					mQueueMutex.unlock();
-					break;
+					Shard& shard = _getShard(dependent);
+					std::lock_guard<std::mutex> shardLock(shard.mutex);
+
+					const auto element = shard.assets.find(dependent);
+					if (element != shard.assets.end() && element->second.asset != nullptr)
+					{
+						required = true;
+						break;
+					}
 				}
-				_loadAssetAsync(it, assetLoadMedPrio);
 			}
-			mQueueMutex.unlock();
 
-			mQueueMutex.lock();
-			it = mAsyncAssetQueueLow.begin();
-			while (it != mAsyncAssetQueueLow.end())
+			if (required)
+				continue;
+		}
+
+		std::shared_ptr<Asset> asset;
+		{
+			Shard& shard = _getShard(candidate.name);
+			std::lock_guard<std::mutex> lock(shard.mutex);
+
+			const auto element = shard.assets.find(candidate.name);
+			if (element == shard.assets.end() || element->second.asset == nullptr || element->second.asset.use_count() != 1)
+				continue;
+
+			asset = std::move(element->second.asset);
+			element->second.state = nullptr;
+			element->second.evicted = true;
+		}
+
+		const size_t bytes = asset->mResidentBytes;
+		remaining = bytes < remaining ? remaining - bytes : 0;
+
+		evictedBytes += bytes;
+		evictedCount++;
+
+		{
+			std::lock_guard<std::mutex> lock(mResidencyMutex);
+
+			AssetResidencyStats& stats = mResidency[candidate.type];
+			stats.evictedBytes += bytes;
+			stats.evictedCount++;
+		}
+
+		// Destroying the asset releases its resident bytes
+		asset.reset();
+	}
+
+	if (evictedCount > 0)
+	{
+		PRIMAL_INTERNAL_INFO("Evicted {0} assets, {1} bytes", evictedCount, evictedBytes);
+	}
+}
+
+void AssetManager::setBudget(const std::type_index& aType, const size_t aBytes)
+{
+	std::lock_guard<std::mutex> lock(mResidencyMutex);
+	mResidency[aType].budget = aBytes;
+}
+
+AssetResidencyStats AssetManager::getResidencyStats(const std::type_index& aType) const
+{
+	std::lock_guard<std::mutex> lock(mResidencyMutex);
+
+	const auto residency = mResidency.find(aType);
+	if (residency == mResidency.end())
+		return {};
+
+	return residency->second;
+}
+
+AssetResidencyStats AssetManager::getResidencyStats() const
+{
+	AssetResidencyStats total;
+
+	std::lock_guard<std::mutex> lock(mResidencyMutex);
+
+	for (const auto& residency : mResidency)
+	{
+		const AssetResidencyStats& stats = residency.second;
+
+		total.budget += stats.budget;
+		total.residentBytes += stats.residentBytes;
+		total.residentCount += stats.residentCount;
+		total.evictedBytes += stats.evictedBytes;
+		total.evictedCount += stats.evictedCount;
+		total.restreamCount += stats.restreamCount;
+	}
+
+	return total;
+}
+
+bool AssetManager::isResident(const std::string& aName)
+{
+	Shard& shard = _getShard(aName);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	const auto element = shard.assets.find(aName);
+	if (element == shard.assets.end() || element->second.asset == nullptr)
+		return false;
+
+	return element->second.state == nullptr || element->second.state->isReady();
+}
+
+bool AssetManager::_track(const Asset* aAsset, const std::vector<AssetDependency>& aDependencies, const std::vector<AssetFileRead>& aReads)
+{
+	AssetLinks links;
+	links.sources = aAsset->_gatherSources();
+
+	for (const AssetFileRead& read : aReads)
+	{
+		links.sources.push_back(read.path);
+	}
+
+	for (const AssetDependency& dependency : aDependencies)
+	{
+		links.dependencies.push_back(dependency.name);
+	}
+
+	const std::string& name = aAsset->mName;
+
+	std::lock_guard<std::mutex> lock(mLinksMutex);
+
+	const auto previous = mLinks.find(name);
+	if (previous != mLinks.end())
+	{
+		for (const std::string& source : previous->second.sources)
+		{
+			mSourceUsers[source].erase(name);
+		}
+
+		for (const std::string& dependency : previous->second.dependencies)
+		{
+			mDependents[dependency].erase(name);
+		}
+	}
+
+	for (const std::string& source : links.sources)
+	{
+		mSourceUsers[source].insert(name);
+	}
+
+	for (const std::string& dependency : links.dependencies)
+	{
+		mDependents[dependency].insert(name);
+	}
+
+	mLinks[name] = std::move(links);
+
+	// Every loader records its links before it loads its dependencies, so whichever asset of a cycle is
+	// tracked last sees the whole cycle
+	std::vector<std::string> open = mLinks[name].dependencies;
+	std::unordered_set<std::string> visited;
+
+	while (!open.empty())
+	{
+		std::string dependency = std::move(open.back());
+		open.pop_back();
+
+		if (dependency == name)
+		{
+			PRIMAL_INTERNAL_ERROR("Asset depends on itself through its dependencies, failing its load: {0}", name);
+			return false;
+		}
+
+		if (!visited.insert(dependency).second)
+			continue;
+
+		const auto dependencies = mLinks.find(dependency);
+		if (dependencies != mLinks.end())
+		{
+			open.insert(open.end(), dependencies->second.dependencies.begin(), dependencies->second.dependencies.end());
+		}
+	}
+
+	return true;
+}
+
+void AssetManager::setHotReload(const bool aEnabled)
+{
+	mHotReload = aEnabled;
+	FileSystem::instance().setWatching(aEnabled);
+}
+
+bool AssetManager::isHotReloadEnabled() const
+{
+	return mHotReload;
+}
+
+void AssetManager::reload(const std::string& aName)
+{
+	_queueReload(aName);
+}
+
+void AssetManager::_queueReload(const std::string& aName)
+{
+	std::vector<std::string> open = { aName };
+
+	std::lock_guard<std::mutex> lock(mLinksMutex);
+
+	while (!open.empty())
+	{
+		std::string name = std::move(open.back());
+		open.pop_back();
+
+		if (!mReloadQueue.insert(name).second)
+			continue;
+
+		const auto dependents = mDependents.find(name);
+		if (dependents != mDependents.end())
+		{
+			open.insert(open.end(), dependents->second.begin(), dependents->second.end());
+		}
+	}
+}
+
+void AssetManager::update()
+{
+	PRIMAL_PROFILE_SCOPE("AssetManager::update");
+
+	if (mHotReload)
+	{
+		std::vector<std::string> changed;
+		FileSystem::instance().pollChanges(changed);
+
+		std::vector<std::string> names;
+		{
+			std::lock_guard<std::mutex> lock(mLinksMutex);
+
+			for (const std::string& path : changed)
 			{
-				if (mAsyncAssetQueueMedium.size() > 0 || mAsyncAssetQueueHigh.size() > 0)
+				const auto users = mSourceUsers.find(path);
+				if (users != mSourceUsers.end())
 				{
-					mQueueMutex.unlock();
-					break;
+					names.insert(names.end(), users->second.begin(), users->second.end());
+				}
+			}
+		}
+
+		for (const std::string& name : names)
+		{
+			_queueReload(name);
+		}
+	}
+
+	if (_swapReloads())
+	{
+		_startReloads();
+	}
+
+	_evict();
+}
+
+bool AssetManager::_swapReloads()
+{
+	for (const auto& reload : mReloading)
+	{
+		if (!reload.second.state->isReady())
+			return false;
+	}
+
+	for (const auto& reload : mReloading)
+	{
+		const std::string& name = reload.first;
+
+		// The previous version stays in place until the sources load again
+		if (reload.second.state->hasFailed())
+		{
+			PRIMAL_INTERNAL_WARN("Asset reload failed, keeping the previous version: {0}", name);
+			continue;
+		}
+
+		{
+			Shard& shard = _getShard(name);
+			std::lock_guard<std::mutex> lock(shard.mutex);
+
+			// Unloaded while it was being rebuilt
+			const auto element = shard.assets.find(name);
+			if (element == shard.assets.end())
+				continue;
+
+			element->second.asset = reload.second.asset;
+			element->second.state = reload.second.state;
+			element->second.evicted = false;
+		}
+
+		PRIMAL_INTERNAL_INFO("Asset reloaded: {0}", name);
+
+		for (const auto& listener : mReloadListeners)
+		{
+			listener.second(name, reload.second.asset);
+		}
+	}
+
+	mReloading.clear();
+
+	return true;
+}
+
+void AssetManager::_startReloads()
+{
+	if (mReloadQueue.empty())
+		return;
+
+	// An asset is only rebuilt once nothing it depends on is still waiting, so it binds the new versions
+	std::vector<std::string> ready;
+	{
+		std::lock_guard<std::mutex> lock(mLinksMutex);
+
+		for (const std::string& name : mReloadQueue)
+		{
+			bool waiting = false;
+
+			const auto links = mLinks.find(name);
+			if (links != mLinks.end())
+			{
+				for (const std::string& dependency : links->second.dependencies)
+				{
+					if (dependency != name && mReloadQueue.count(dependency) != 0)
+					{
+						waiting = true;
+						break;
+					}
 				}
-				_loadAssetAsync(it, assetLoadLowPrio);
 			}
-			mQueueMutex.unlock();
 
-			std::unique_lock<std::mutex> lock(mCvMutex);
-			while (!mWaitingAssets)
+			if (!waiting)
 			{
-				mCv.wait(lock);
+				ready.push_back(name);
 			}
-			--mWaitingAssets;
 		}
-	});
+	}
+
+	// Only a dependency cycle can leave nothing ready, rebuild everything rather than stall
+	if (ready.empty())
+	{
+		ready.assign(mReloadQueue.begin(), mReloadQueue.end());
+	}
+
+	for (const std::string& name : ready)
+	{
+		mReloadQueue.erase(name);
+
+		std::function<std::shared_ptr<Asset>()> create;
+		{
+			Shard& shard = _getShard(name);
+			std::lock_guard<std::mutex> lock(shard.mutex);
+
+			// Evicted assets are streamed in from the changed files whenever they are needed again
+			const auto element = shard.assets.find(name);
+			if (element != shard.assets.end() && element->second.asset != nullptr)
+			{
+				create = element->second.create;
+			}
+		}
+
+		if (!create)
+			continue;
+
+		PendingLoad load = { create(), std::make_shared<AssetLoadState>() };
+		load.asset->mName = name;
+
+		mReloading.emplace_back(name, load);
+
+		// The replacement is not registered until it is swapped in, so get() keeps returning the old
+		// asset in the meantime
+		mPending.fetch_add(1, std::memory_order_relaxed);
+		mQueues[assetLoadHighPrio].push(std::move(load));
+	}
+
+	_schedule();
+}
+
+size_t AssetManager::addReloadListener(AssetReloadCallback aCallback)
+{
+	const size_t listener = mNextReloadListener++;
+	mReloadListeners.emplace_back(listener, std::move(aCallback));
+
+	return listener;
+}
+
+void AssetManager::removeReloadListener(const size_t aListener)
+{
+	mReloadListeners.erase(std::remove_if(mReloadListeners.begin(), mReloadListeners.end(), [aListener](const auto& aEntry)
+	{
+		return aEntry.first == aListener;
+	}), mReloadListeners.end());
+}
+
+void AssetManager::waitAll()
+{
+	std::unique_lock<std::mutex> lock(mIdleMutex);
+	mIdleCv.wait(lock, [this] { return mPending.load(std::memory_order_acquire) == 0; });
+}
+
+void AssetManager::setMaxConcurrency(const uint8_t aPrio, const uint32_t aCount)
+{
+	if (aPrio >= sPriorityCount)
+		return;
+
+	mMaxInFlight[aPrio] = std::max(1u, aCount);
+	_schedule();
+}
+
+uint32_t AssetManager::getMaxConcurrency(const uint8_t aPrio) const
+{
+	if (aPrio >= sPriorityCount)
+		return 0;
+
+	return mMaxInFlight[aPrio];
+}
+
+size_t AssetManager::getPendingCount() const
+{
+	return mPending;
 }
 
 void AssetManager::unloadAll()
 {
-	mAssets.clear();
+	waitAll();
+
+	for (Shard& shard : mShards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		shard.assets.clear();
+	}
 }
 
 bool AssetManager::unload(const std::string& aName)
 {
-	const auto loc = mAssets.find(aName);
-	if (loc == mAssets.end())
+	Shard& shard = _getShard(aName);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	const auto loc = shard.assets.find(aName);
+	if (loc == shard.assets.end())
 		return false;
 
-	mAssets.erase(loc);
+	shard.assets.erase(loc);
 	return true;
-}
\ No newline at end of file
+}
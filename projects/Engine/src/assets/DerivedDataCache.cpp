@@ -0,0 +1,185 @@
+#include "assets/DerivedDataCache.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "core/Log.h"
+#include "filesystem/FileSystem.h"
+#include "filesystem/MappedFile.h"
+#include "utils/Hash.h"
+
+namespace detail
+{
+	static constexpr uint32_t sEntryMagic = 0x43444450; // 'PDDC'
+	static constexpr uint32_t sEntryVersion = 1;
+
+	// Padded to 16 bytes so payloads keep the alignment the cooked formats expect
+	struct EntryHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t size;
+	};
+
+	static_assert(sizeof(EntryHeader) == 16, "Derived data entries assume a 16 byte header");
+
+	static constexpr uint64_t sSeeds[2] = { 0x243F6A8885A308D3ull, 0x13198A2E03707344ull };
+}
+
+DerivedDataKey::DerivedDataKey(const char* aKind, const uint32_t aVersion)
+{
+	mHash[0] = detail::sSeeds[0];
+	mHash[1] = detail::sSeeds[1];
+
+	add(std::string(aKind));
+	add(aVersion);
+}
+
+DerivedDataKey& DerivedDataKey::add(const void* aData, const size_t aSize)
+{
+	// The size goes in as well so differently split inputs cannot produce the same key
+	const uint64_t size = aSize;
+
+	for (uint64_t& hash : mHash)
+	{
+		hash = Hash::xxh64(aData, aSize, hash);
+		hash = Hash::xxh64(&size, sizeof(size), hash);
+	}
+
+	return *this;
+}
+
+DerivedDataKey& DerivedDataKey::add(const FileView& aFile)
+{
+	return add(aFile.data(), aFile.size());
+}
+
+DerivedDataKey& DerivedDataKey::add(const std::string& aValue)
+{
+	return add(aValue.data(), aValue.size());
+}
+
+DerivedDataKey& DerivedDataKey::add(const uint32_t aValue)
+{
+	return add(&aValue, sizeof(aValue));
+}
+
+std::string DerivedDataKey::str() const
+{
+	static const char digits[] = "0123456789abcdef";
+
+	std::string key(32, '0');
+
+	for (size_t part = 0; part < 2; ++part)
+	{
+		for (size_t nibble = 0; nibble < 16; ++nibble)
+		{
+			key[part * 16 + nibble] = digits[(mHash[part] >> (60 - nibble * 4)) & 0xF];
+		}
+	}
+
+	return key;
+}
+
+DerivedDataCache::DerivedDataCache()
+	: mDirectory("cache/derived"), mEnabled(true), mHits(0), mMisses(0)
+{
+}
+
+DerivedDataCache& DerivedDataCache::instance()
+{
+	static DerivedDataCache* instance = new DerivedDataCache();
+	return *instance;
+}
+
+void DerivedDataCache::setDirectory(const Path& aDirectory)
+{
+	mDirectory = aDirectory;
+}
+
+Path DerivedDataCache::getDirectory() const
+{
+	return mDirectory;
+}
+
+void DerivedDataCache::setEnabled(const bool aEnabled)
+{
+	mEnabled = aEnabled;
+}
+
+bool DerivedDataCache::isEnabled() const
+{
+	return mEnabled;
+}
+
+Path DerivedDataCache::_getPath(const std::string& aKey) const
+{
+	// Fanned out over 256 directories so none of them grows huge
+	return mDirectory / aKey.substr(0, 2) / aKey;
+}
+
+bool DerivedDataCache::get(const DerivedDataKey& aKey, FileView& aData)
+{
+	if (!mEnabled)
+		return false;
+
+	auto mapping = std::make_shared<MappedFile>();
+
+	if (mapping->open(_getPath(aKey.str())) && mapping->size() >= sizeof(detail::EntryHeader))
+	{
+		detail::EntryHeader header;
+		memcpy(&header, mapping->data(), sizeof(header));
+
+		if (header.magic == detail::sEntryMagic && header.version == detail::sEntryVersion &&
+			header.size == mapping->size() - sizeof(header))
+		{
+			const uint8_t* data = mapping->data() + sizeof(header);
+			aData = FileView(data, static_cast<size_t>(header.size), std::move(mapping));
+
+			mHits.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		PRIMAL_INTERNAL_WARN("Ignoring invalid derived data entry {0}", aKey.str());
+	}
+
+	mMisses.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+bool DerivedDataCache::put(const DerivedDataKey& aKey, const void* aData, const size_t aSize)
+{
+	if (!mEnabled)
+		return false;
+
+	// Absolute so the entry is written where get() maps it instead of resolving through the mounts
+	std::error_code error;
+	const Path path = std::filesystem::absolute(_getPath(aKey.str()), error);
+	if (error)
+		return false;
+
+	const detail::EntryHeader header = { detail::sEntryMagic, detail::sEntryVersion, aSize };
+
+	std::vector<char> entry(sizeof(header) + aSize);
+	memcpy(entry.data(), &header, sizeof(header));
+	memcpy(entry.data() + sizeof(header), aData, aSize);
+
+	if (!FileSystem::instance().replace(path, entry.data(), entry.size()))
+	{
+		PRIMAL_INTERNAL_WARN("Could not write derived data to {0}", path.string());
+		return false;
+	}
+
+	return true;
+}
+
+uint64_t DerivedDataCache::getHitCount() const
+{
+	return mHits;
+}
+
+uint64_t DerivedDataCache::getMissCount() const
+{
+	return mMisses;
+}
@@ -1,282 +1,1921 @@
 #include "assets/MeshAsset.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
 #include <fx/gltf.h>
+#include <glm/gtc/quaternion.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
+#include "animation/AnimationCompression.h"
+#include "animation/Skeleton.h"
+#include "animation/Skinning.h"
+#include "assets/DerivedDataCache.h"
+#include "assets/MeshFormat.h"
+#include "core/Log.h"
+#include "filesystem/FileSystem.h"
+#include "graphics/MeshClusters.h"
+#include "graphics/MeshGeometry.h"
+#include "graphics/MeshOptimizer.h"
+#include "graphics/MeshSimplifier.h"
 #include "utils/StringUtils.h"
 #include "math/Vector3.h"
 
 namespace detail
 {
-	struct BufferInfo
-	{
-		fx::gltf::Accessor const* accessor;
+	// Bump whenever the importer output changes, so stale cache entries are never used
+	static constexpr uint32_t sImporterVersion = 9;
 
-		uint8_t const* data;
-		uint32_t dataStride;
-		uint32_t totalSize;
+	// Vertices decoded per task when a single primitive is large enough to be split
+	static constexpr size_t sVertexGrainSize = 16384;
+
+	// Where the elements of an accessor live, with the buffer view's stride already applied
+	struct AccessorView
+	{
+		const uint8_t* data = nullptr;
+		size_t stride = 0;
+		size_t count = 0;
+		uint32_t components = 0;
+		fx::gltf::Accessor::ComponentType componentType = fx::gltf::Accessor::ComponentType::None;
+		bool normalized = false;
 
-		bool hasData() const noexcept
+		bool isValid() const noexcept
 		{
 			return data != nullptr;
 		}
 	};
 
-	static uint32_t sCalculateDataTypeSize(const fx::gltf::Accessor& aAccessor) noexcept
+	static_assert(sizeof(SkinVertex) == sizeof(PMeshSkinVertex), "Skin vertices are used straight from the cooked mesh");
+	static_assert(sizeof(CompressedTrack) == sizeof(PMeshTrack), "Compressed tracks are copied to and from the cooked mesh");
+
+	// Skeleton and compressed clips of the skin a document's meshes are imported with
+	struct AnimationImport
+	{
+		// Joint of every entry of the skin's joint list, and of every node, or -1
+		std::vector<uint16_t> skinToJoint;
+		std::vector<int32_t> nodeToJoint;
+
+		PMeshAnimationHeader header = {};
+		std::vector<PMeshJoint> joints;
+		std::vector<CompressedClip> clips;
+	};
+
+	struct PrimitiveJob
+	{
+		const fx::gltf::Primitive* primitive;
+		size_t vertexCount;
+		size_t indexCount;
+		PMeshSubmesh* submesh;
+		Vertex* vertices;
+		void* indices;
+		uint32_t indexSize;
+		bool hasColor;
+
+		// Null unless the document has a skin
+		PMeshSkinVertex* skin;
+		const std::vector<uint16_t>* skinToJoint;
+	};
+
+	struct SubmeshData
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+
+		// Parallel to vertices, empty for static meshes
+		std::vector<PMeshSkinVertex> skin;
+
+		// Empty means a single level covering every index
+		std::vector<PMeshLod> lods;
+		std::vector<PMeshCluster> clusters;
+	};
+
+	static uint64_t sTableEnd(const PMeshHeader& aHeader)
+	{
+		return sizeof(PMeshHeader) + static_cast<uint64_t>(aHeader.submeshCount) * sizeof(PMeshSubmesh) +
+			static_cast<uint64_t>(aHeader.lodCount) * sizeof(PMeshLod) + static_cast<uint64_t>(aHeader.clusterCount) * sizeof(PMeshCluster);
+	}
+
+	static uint64_t sAlign(const uint64_t aOffset)
+	{
+		const uint64_t alignment = pmeshBlobAlignment;
+		return (aOffset + alignment - 1) / alignment * alignment;
+	}
+
+	// Places the vertex, index and skin blobs and the animation section behind the tables, each on a
+	// pmeshBlobAlignment boundary. skinStride and animationBytes have to be set already.
+	static void sLayout(PMeshHeader& aHeader, const uint64_t aVertexCount, const uint64_t aIndexCount)
 	{
-		uint32_t elementSize;
-		switch(aAccessor.componentType)
+		aHeader.vertexOffset = sAlign(sTableEnd(aHeader));
+		aHeader.vertexBytes = aVertexCount * aHeader.vertexStride;
+		aHeader.indexOffset = sAlign(aHeader.vertexOffset + aHeader.vertexBytes);
+		aHeader.indexBytes = aIndexCount * aHeader.indexSize;
+		aHeader.skinOffset = sAlign(aHeader.indexOffset + aHeader.indexBytes);
+		aHeader.skinBytes = aVertexCount * aHeader.skinStride;
+		aHeader.animationOffset = sAlign(aHeader.skinOffset + aHeader.skinBytes);
+	}
+
+	static uint64_t sFileEnd(const PMeshHeader& aHeader)
+	{
+		return aHeader.animationOffset + aHeader.animationBytes;
+	}
+
+	static uint32_t sGetComponentSize(const fx::gltf::Accessor::ComponentType aType) noexcept
+	{
+		switch (aType)
 		{
 			case fx::gltf::Accessor::ComponentType::Byte:
 			case fx::gltf::Accessor::ComponentType::UnsignedByte:
-				elementSize = 1;
-				break;
+				return 1;
 
 			case fx::gltf::Accessor::ComponentType::Short:
 			case fx::gltf::Accessor::ComponentType::UnsignedShort:
-				elementSize = 2;
-				break;
+				return 2;
 
 			case fx::gltf::Accessor::ComponentType::Float:
 			case fx::gltf::Accessor::ComponentType::UnsignedInt:
-				elementSize = 4;
-				break;
+				return 4;
 
-			default: 
-				elementSize = 0;
-				break;
+			default:
+				return 0;
 		}
+	}
 
-		switch(aAccessor.type)
+	static uint32_t sGetComponentCount(const fx::gltf::Accessor::Type aType) noexcept
+	{
+		switch (aType)
 		{
-			case fx::gltf::Accessor::Type::Mat2:
-				return 4 * elementSize;
-			case fx::gltf::Accessor::Type::Mat3:
-				return 9 * elementSize;
-			case fx::gltf::Accessor::Type::Mat4:
-				return 16 * elementSize;
 			case fx::gltf::Accessor::Type::Scalar:
-				return elementSize;
+				return 1;
 			case fx::gltf::Accessor::Type::Vec2:
-				return 2 * elementSize;
+				return 2;
 			case fx::gltf::Accessor::Type::Vec3:
-				return 3 * elementSize;
+				return 3;
 			case fx::gltf::Accessor::Type::Vec4:
-				return 4 * elementSize;
-			default: 
+			case fx::gltf::Accessor::Type::Mat2:
+				return 4;
+			case fx::gltf::Accessor::Type::Mat3:
+				return 9;
+			case fx::gltf::Accessor::Type::Mat4:
+				return 16;
+			default:
 				return 0;
 		}
 	}
 
-	static uint32_t sGetAccessorTypeSize(fx::gltf::Accessor const& aAccessor)
+	static AccessorView sGetView(const fx::gltf::Document& aDocument, const int32_t aAccessor, const std::string& aPath)
+	{
+		if (aAccessor < 0 || static_cast<size_t>(aAccessor) >= aDocument.accessors.size())
+		{
+			return {};
+		}
+
+		const fx::gltf::Accessor& accessor = aDocument.accessors[aAccessor];
+
+		if (!accessor.sparse.empty())
+		{
+			PRIMAL_INTERNAL_WARN("Sparse accessor {0} is read without its sparse values: {1}", aAccessor, aPath);
+		}
+
+		if (accessor.bufferView < 0 || static_cast<size_t>(accessor.bufferView) >= aDocument.bufferViews.size())
+		{
+			return {};
+		}
+
+		const fx::gltf::BufferView& bufferView = aDocument.bufferViews[accessor.bufferView];
+		if (bufferView.buffer < 0 || static_cast<size_t>(bufferView.buffer) >= aDocument.buffers.size())
+		{
+			return {};
+		}
+
+		const fx::gltf::Buffer& buffer = aDocument.buffers[bufferView.buffer];
+
+		AccessorView view;
+		view.count = accessor.count;
+		view.components = sGetComponentCount(accessor.type);
+		view.componentType = accessor.componentType;
+		view.normalized = accessor.normalized;
+
+		const size_t elementSize = static_cast<size_t>(sGetComponentSize(accessor.componentType)) * view.components;
+		view.stride = bufferView.byteStride > 0 ? bufferView.byteStride : elementSize;
+
+		const uint64_t offset = static_cast<uint64_t>(bufferView.byteOffset) + accessor.byteOffset;
+		const uint64_t end = view.count > 0 ? offset + (view.count - 1) * view.stride + elementSize : offset;
+
+		if (elementSize == 0 || end > buffer.data.size())
+		{
+			PRIMAL_INTERNAL_ERROR("Accessor {0} reads past the end of its buffer: {1}", aAccessor, aPath);
+			return {};
+		}
+
+		view.data = buffer.data.data() + offset;
+		return view;
+	}
+
+	template<typename T>
+	static float sToFloat(const T aValue, const bool aNormalized)
+	{
+		if (!aNormalized || std::is_floating_point<T>::value)
+		{
+			return static_cast<float>(aValue);
+		}
+
+		// Signed normalized values map both -max-1 and -max to -1
+		const float scaled = static_cast<float>(aValue) / static_cast<float>(std::numeric_limits<T>::max());
+		return std::max(scaled, -1.0f);
+	}
+
+	// Component aComponent of element aIndex, normalized integers mapped like sToFloat does
+	static float sReadComponent(const AccessorView& aView, const size_t aIndex, const uint32_t aComponent)
 	{
-		switch (aAccessor.componentType)
+		const uint8_t* element = aView.data + aIndex * aView.stride;
+
+		switch (aView.componentType)
 		{
 			case fx::gltf::Accessor::ComponentType::Byte:
+			{
+				int8_t value;
+				memcpy(&value, element + aComponent * sizeof(value), sizeof(value));
+				return sToFloat(value, aView.normalized);
+			}
 			case fx::gltf::Accessor::ComponentType::UnsignedByte:
-				return 1;
-
+			{
+				uint8_t value;
+				memcpy(&value, element + aComponent * sizeof(value), sizeof(value));
+				return sToFloat(value, aView.normalized);
+			}
 			case fx::gltf::Accessor::ComponentType::Short:
+			{
+				int16_t value;
+				memcpy(&value, element + aComponent * sizeof(value), sizeof(value));
+				return sToFloat(value, aView.normalized);
+			}
 			case fx::gltf::Accessor::ComponentType::UnsignedShort:
-				return 2;
-
-			case fx::gltf::Accessor::ComponentType::Float:
+			{
+				uint16_t value;
+				memcpy(&value, element + aComponent * sizeof(value), sizeof(value));
+				return sToFloat(value, aView.normalized);
+			}
 			case fx::gltf::Accessor::ComponentType::UnsignedInt:
-				return 4;
-
+			{
+				uint32_t value;
+				memcpy(&value, element + aComponent * sizeof(value), sizeof(value));
+				return sToFloat(value, aView.normalized);
+			}
+			case fx::gltf::Accessor::ComponentType::Float:
+			{
+				float value;
+				memcpy(&value, element + aComponent * sizeof(value), sizeof(value));
+				return value;
+			}
 			default:
-				return 0;
+				return 0.0f;
 		}
 	}
 
-	static BufferInfo sGetData(fx::gltf::Document const& aDocument, fx::gltf::Accessor const& aAccessor)
+	// Writes up to aCount components, starting at component aFirst of each element, to the floats aField
+	// selects in the vertices [aBegin, aEnd)
+	template<typename T, typename Field>
+	static void sDecodeRange(const AccessorView& aView, const uint32_t aFirst, const uint32_t aCount,
+		Vertex* aVertices, const size_t aBegin, const size_t aEnd, Field aField)
 	{
-		fx::gltf::BufferView const& bufferView = aDocument.bufferViews[aAccessor.bufferView];
-		fx::gltf::Buffer const& buffer = aDocument.buffers[bufferView.buffer];
+		const uint32_t components = aView.components > aFirst ? std::min(aView.components - aFirst, aCount) : 0;
+		const size_t end = std::min(aEnd, aView.count);
 
-		const uint32_t dataTypeSize = sCalculateDataTypeSize(aAccessor);
-		return BufferInfo{ &aAccessor, &buffer.data[static_cast<uint64_t>(bufferView.byteOffset) + aAccessor.byteOffset], dataTypeSize, aAccessor.count * dataTypeSize };
-	}
-}
+		for (size_t i = aBegin; i < end; i++)
+		{
+			const uint8_t* element = aView.data + i * aView.stride + aFirst * sizeof(T);
+			float* field = aField(aVertices[i]);
 
-MeshAsset::MeshAsset(const std::string& aPath)
-{
-	mPath = aPath;
-}
+			for (uint32_t c = 0; c < components; c++)
+			{
+				T value;
+				memcpy(&value, element + c * sizeof(T), sizeof(T));
 
-MeshAsset::~MeshAsset()
-{
-	for(size_t i = 0; i < mMeshes.size(); i++)
-	{
-		delete mMeshes[i];
+				field[c] = sToFloat(value, aView.normalized);
+			}
+		}
 	}
 
-	mMeshes.clear();
-}
-
-Mesh* MeshAsset::getMesh(const size_t aIndex)
-{
-	if(aIndex < mMeshes.size())
+	template<typename Field>
+	static void sDecodeAttribute(const AccessorView& aView, const uint32_t aFirst, const uint32_t aCount,
+		Vertex* aVertices, const size_t aBegin, const size_t aEnd, Field aField)
 	{
-		return mMeshes[aIndex];
+		switch (aView.componentType)
+		{
+			case fx::gltf::Accessor::ComponentType::Byte:
+				sDecodeRange<int8_t>(aView, aFirst, aCount, aVertices, aBegin, aEnd, aField);
+				break;
+			case fx::gltf::Accessor::ComponentType::UnsignedByte:
+				sDecodeRange<uint8_t>(aView, aFirst, aCount, aVertices, aBegin, aEnd, aField);
+				break;
+			case fx::gltf::Accessor::ComponentType::Short:
+				sDecodeRange<int16_t>(aView, aFirst, aCount, aVertices, aBegin, aEnd, aField);
+				break;
+			case fx::gltf::Accessor::ComponentType::UnsignedShort:
+				sDecodeRange<uint16_t>(aView, aFirst, aCount, aVertices, aBegin, aEnd, aField);
+				break;
+			case fx::gltf::Accessor::ComponentType::UnsignedInt:
+				sDecodeRange<uint32_t>(aView, aFirst, aCount, aVertices, aBegin, aEnd, aField);
+				break;
+			case fx::gltf::Accessor::ComponentType::Float:
+				sDecodeRange<float>(aView, aFirst, aCount, aVertices, aBegin, aEnd, aField);
+				break;
+			default:
+				break;
+		}
 	}
 
-	return nullptr;
-}
+	template<typename T, typename Index>
+	static bool sCopyIndices(const AccessorView& aView, Index* aIndices, const size_t aVertexCount)
+	{
+		bool valid = true;
 
-void MeshAsset::_load()
-{
-	const bool isText = StringUtils::endsWith(mPath, "gltf");
-	const bool isBinary = StringUtils::endsWith(mPath, "glb");
+		for (size_t i = 0; i < aView.count; i++)
+		{
+			T value;
+			memcpy(&value, aView.data + i * aView.stride, sizeof(T));
 
-	fx::gltf::Document document;
+			if (static_cast<size_t>(value) >= aVertexCount)
+			{
+				valid = false;
+				value = 0;
+			}
 
-	if (isText)
-	{
-		document = fx::gltf::LoadFromText(mPath);
+			aIndices[i] = static_cast<Index>(value);
+		}
+
+		return valid;
 	}
 
-	if(isBinary)
+	template<typename Index>
+	static bool sDecodeIndices(const AccessorView& aView, Index* aIndices, const size_t aIndexCount, const size_t aVertexCount)
 	{
-		document = fx::gltf::LoadFromBinary(mPath);
-	}
+		if (!aView.isValid())
+		{
+			for (size_t i = 0; i < aIndexCount; i++)
+			{
+				aIndices[i] = static_cast<Index>(i);
+			}
 
-	//size_t sceneCount = document.scenes.size();
-	//size_t meshCount = document.meshes.size();
-	//size_t textureCount = document.textures.size();
-	//size_t imageCount = document.images.size();
-	//size_t materialCount = document.materials.size();
-	//size_t cameraCount = document.cameras.size();
-	//size_t nodeCount = document.nodes.size();
-	//size_t skinCount = document.skins.size();
-	//size_t samplerCount = document.samplers.size();
-	//size_t animationCount = document.animations.size();
-	//size_t accessorCount = document.accessors.size();
-	//size_t bufferCount = document.buffers.size();
-	//size_t bufferViewCount = document.bufferViews.size();
+			return true;
+		}
 
-	for(const auto& mesh : document.meshes)
-	{
-		std::vector<Vector3f> positions;
-		std::vector<Vector2f> uvs;
-		std::vector<Vector3f> normals;
-		std::vector<Vector3f> tangents;
-		std::vector<Vector3f> binormals;
+		switch (aView.componentType)
+		{
+			case fx::gltf::Accessor::ComponentType::UnsignedByte:
+				return sCopyIndices<uint8_t>(aView, aIndices, aVertexCount);
+			case fx::gltf::Accessor::ComponentType::UnsignedShort:
+				return sCopyIndices<uint16_t>(aView, aIndices, aVertexCount);
+			case fx::gltf::Accessor::ComponentType::UnsignedInt:
+				return sCopyIndices<uint32_t>(aView, aIndices, aVertexCount);
+			default:
+				return false;
+		}
+	}
 
-		std::vector<uint16_t> indices;
+	// Reads the first four influences of the vertices [aBegin, aEnd), with joints moved to the skeleton's
+	// order and weights normalized. Vertices without any influence are bound to the first joint. Returns
+	// false when a joint was out of range.
+	static bool sDecodeSkin(const AccessorView& aJoints, const AccessorView& aWeights, const std::vector<uint16_t>& aSkinToJoint,
+		PMeshSkinVertex* aSkin, const size_t aBegin, const size_t aEnd)
+	{
+		const bool hasInfluences = aJoints.isValid() && aWeights.isValid() && aJoints.components == 4 && aWeights.components == 4;
+		bool valid = true;
 
-		for(const auto& primitive : mesh.primitives)
+		for (size_t i = aBegin; i < aEnd; i++)
 		{
-			for(const auto& attribute : primitive.attributes)
+			PMeshSkinVertex skin = {};
+			float total = 0.0f;
+
+			for (uint32_t c = 0; hasInfluences && i < aJoints.count && i < aWeights.count && c < 4; c++)
 			{
-				if(attribute.first == "POSITION")
+				const uint32_t joint = static_cast<uint32_t>(sReadComponent(aJoints, i, c));
+				const float weight = std::max(sReadComponent(aWeights, i, c), 0.0f);
+
+				if (joint >= aSkinToJoint.size())
 				{
-					auto accessor = document.accessors[attribute.second];
-					auto positionBuffer = detail::sGetData(document, accessor);
+					valid &= weight == 0.0f;
+					continue;
+				}
 
-					uint32_t elementSize = detail::sGetAccessorTypeSize(accessor);
+				skin.joints[c] = aSkinToJoint[joint];
+				skin.weights[c] = weight;
+				total += weight;
+			}
 
-					if (positionBuffer.hasData())
-					{
-						for (uint32_t i = 0; i < positionBuffer.totalSize / sizeof(float); i += 3)
-						{
-							float x = ((float*)positionBuffer.data)[i];
-							float y = ((float*)positionBuffer.data)[i + 1];
-							float z = ((float*)positionBuffer.data)[i + 2];
-
-							positions.push_back({ x, y, z });
-						}
-					}
-				}
-				else if(attribute.first == "TEXCOORD_0")
+			if (total > 0.0f)
+			{
+				for (float& weight : skin.weights)
 				{
-					auto accessor = document.accessors[attribute.second];
-					auto uvBuffer = detail::sGetData(document, accessor);
+					weight /= total;
+				}
+			}
+			else
+			{
+				skin = {};
+				skin.weights[0] = 1.0f;
+			}
 
-					uint32_t elementSize = detail::sGetAccessorTypeSize(accessor);
+			aSkin[i] = skin;
+		}
 
-					if(uvBuffer.hasData())
-					{
-						for (uint32_t i = 0; i < uvBuffer.totalSize / sizeof(float); i += 2)
-						{
-							float x = ((float*)uvBuffer.data)[i];
-							float y = ((float*)uvBuffer.data)[i + 1];
+		return valid;
+	}
 
-							uvs.push_back({ x, y });
-						}
-					}
-				}
-				else if(attribute.first == "NORMAL")
+	// Generates tangents, and normals too when aNormals is set, over gathered attribute arrays
+	static void sGenerateAttributes(PrimitiveJob& aJob, const bool aNormals)
+	{
+		std::vector<uint32_t> indices(aJob.indexCount);
+
+		for (size_t i = 0; i < aJob.indexCount; i++)
+		{
+			indices[i] = aJob.indexSize == sizeof(uint16_t) ? static_cast<const uint16_t*>(aJob.indices)[i] :
+				static_cast<const uint32_t*>(aJob.indices)[i];
+		}
+
+		indices.resize(indices.size() - indices.size() % 3);
+
+		std::vector<Vector3f> positions(aJob.vertexCount);
+		std::vector<Vector3f> normals(aJob.vertexCount);
+		std::vector<Vector2f> uvs(aJob.vertexCount);
+
+		for (size_t i = 0; i < aJob.vertexCount; i++)
+		{
+			positions[i] = aJob.vertices[i].position;
+			normals[i] = aJob.vertices[i].normal;
+			uvs[i] = aJob.vertices[i].uv;
+		}
+
+		if (aNormals)
+		{
+			MeshGeometry::computeNormals(positions.data(), positions.size(), indices.data(), indices.size(), normals.data());
+		}
+
+		std::vector<Vector3f> tangents(aJob.vertexCount);
+		std::vector<Vector3f> binormals(aJob.vertexCount);
+
+		MeshGeometry::computeTangents(positions.data(), uvs.data(), normals.data(), positions.size(),
+			indices.data(), indices.size(), tangents.data(), binormals.data());
+
+		for (size_t i = 0; i < aJob.vertexCount; i++)
+		{
+			aJob.vertices[i].normal = normals[i];
+			aJob.vertices[i].tangent = tangents[i];
+			aJob.vertices[i].binormal = binormals[i];
+		}
+	}
+
+	static void sDecodePrimitive(const fx::gltf::Document& aDocument, PrimitiveJob& aJob, const std::string& aPath)
+	{
+		AccessorView position;
+		AccessorView uv;
+		AccessorView normal;
+		AccessorView tangent;
+		AccessorView color;
+		AccessorView joints;
+		AccessorView weights;
+
+		for (const auto& attribute : aJob.primitive->attributes)
+		{
+			if (attribute.first == "POSITION")
+			{
+				position = sGetView(aDocument, static_cast<int32_t>(attribute.second), aPath);
+			}
+			else if (attribute.first == "TEXCOORD_0")
+			{
+				uv = sGetView(aDocument, static_cast<int32_t>(attribute.second), aPath);
+			}
+			else if (attribute.first == "NORMAL")
+			{
+				normal = sGetView(aDocument, static_cast<int32_t>(attribute.second), aPath);
+			}
+			else if (attribute.first == "TANGENT")
+			{
+				tangent = sGetView(aDocument, static_cast<int32_t>(attribute.second), aPath);
+			}
+			else if (attribute.first == "COLOR_0")
+			{
+				color = sGetView(aDocument, static_cast<int32_t>(attribute.second), aPath);
+			}
+			else if (attribute.first == "JOINTS_0")
+			{
+				joints = sGetView(aDocument, static_cast<int32_t>(attribute.second), aPath);
+			}
+			else if (attribute.first == "WEIGHTS_0")
+			{
+				weights = sGetView(aDocument, static_cast<int32_t>(attribute.second), aPath);
+			}
+		}
+
+		std::atomic<bool> validSkin(true);
+
+		Vertex* vertices = aJob.vertices;
+		aJob.hasColor = color.isValid();
+
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, aJob.vertexCount, sVertexGrainSize),
+			[&](const tbb::blocked_range<size_t>& aRange)
+			{
+				Vertex initial = {};
+				initial.color = { 1, 1, 1, 1 };
+
+				std::fill(vertices + aRange.begin(), vertices + aRange.end(), initial);
+
+				if (position.isValid())
 				{
-					auto accessor = document.accessors[attribute.second];
-					auto normalBuffer = detail::sGetData(document, accessor);
+					sDecodeAttribute(position, 0, 3, vertices, aRange.begin(), aRange.end(), [](Vertex& v) { return v.position.v; });
+				}
 
-					uint32_t elementSize = detail::sGetAccessorTypeSize(accessor);
+				if (uv.isValid())
+				{
+					sDecodeAttribute(uv, 0, 2, vertices, aRange.begin(), aRange.end(), [](Vertex& v) { return v.uv.v; });
+				}
 
-					if (normalBuffer.hasData())
-					{
-						for (uint32_t i = 0; i < normalBuffer.totalSize / sizeof(float); i += 3)
-						{
-							float x = ((float*)normalBuffer.data)[i];
-							float y = ((float*)normalBuffer.data)[i + 1];
-							float z = ((float*)normalBuffer.data)[i + 2];
-
-							normals.push_back({ x, y, z });
-						}
-					}
+				if (normal.isValid())
+				{
+					sDecodeAttribute(normal, 0, 3, vertices, aRange.begin(), aRange.end(), [](Vertex& v) { return v.normal.v; });
 				}
-				else if(attribute.first == "TANGENT")
+
+				if (color.isValid())
 				{
-					auto accessor = document.accessors[attribute.second];
-					auto tangentBuffer = detail::sGetData(document, accessor);
+					sDecodeAttribute(color, 0, 4, vertices, aRange.begin(), aRange.end(), [](Vertex& v) { return v.color.v; });
+				}
 
-					uint32_t elementSize = detail::sGetAccessorTypeSize(accessor);
+				if (tangent.isValid())
+				{
+					// The handedness in w is parked in the binormal until the binormal can be derived from it
+					sDecodeAttribute(tangent, 0, 3, vertices, aRange.begin(), aRange.end(), [](Vertex& v) { return v.tangent.v; });
+					sDecodeAttribute(tangent, 3, 1, vertices, aRange.begin(), aRange.end(), [](Vertex& v) { return v.binormal.v; });
 
-					if (tangentBuffer.hasData())
+					for (size_t i = aRange.begin(); i < aRange.end(); i++)
 					{
-						for (uint32_t i = 0; i < tangentBuffer.totalSize / sizeof(float); i += 4)
-						{
-							float x = ((float*)tangentBuffer.data)[i];
-							float y = ((float*)tangentBuffer.data)[i + 1];
-							float z = ((float*)tangentBuffer.data)[i + 2];
-							float w = ((float*)tangentBuffer.data)[i + 3];
-
-							tangents.push_back({ x, y, z });
-							binormals.push_back({ w, 0, 0 });
-						}
+						const float w = vertices[i].binormal.x;
+						vertices[i].binormal = vertices[i].normal.cross(vertices[i].tangent) * w;
 					}
 				}
-			}
 
-			auto indexAccessor = document.accessors[primitive.indices];
-			auto indexBuffer = detail::sGetData(document, indexAccessor);
-
-			if(indexBuffer.hasData())
-			{
-				for (uint32_t i = 0; i < indexBuffer.totalSize / sizeof(uint16_t); i++)
+				if (aJob.skin != nullptr && !sDecodeSkin(joints, weights, *aJob.skinToJoint, aJob.skin, aRange.begin(), aRange.end()))
 				{
-					uint16_t idx = ((uint16_t*)indexBuffer.data)[i];
-
-					indices.push_back({ idx });
+					validSkin = false;
 				}
-			}
+			});
+
+		if (!validSkin)
+		{
+			PRIMAL_INTERNAL_WARN("Primitive has weighted joints outside of its skin, they were dropped: {0}", aPath);
+		}
+
+		PMeshSubmesh& submesh = *aJob.submesh;
+
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			submesh.boundsMin[axis] = aJob.vertexCount > 0 ? vertices[0].position.v[axis] : 0.0f;
+			submesh.boundsMax[axis] = submesh.boundsMin[axis];
+		}
 
-			if(primitive.material >= 0)
+		for (size_t i = 1; i < aJob.vertexCount; i++)
+		{
+			for (size_t axis = 0; axis < 3; axis++)
 			{
-				auto material = document.materials[primitive.material];
+				submesh.boundsMin[axis] = std::min(submesh.boundsMin[axis], vertices[i].position.v[axis]);
+				submesh.boundsMax[axis] = std::max(submesh.boundsMax[axis], vertices[i].position.v[axis]);
 			}
+		}
 
-			Mesh* primalMesh = new Mesh();
-			primalMesh->positions = positions;
-			primalMesh->uvs = uvs;
-			primalMesh->normals = normals;
-			primalMesh->tangents = tangents;
+		const AccessorView indices = sGetView(aDocument, aJob.primitive->indices, aPath);
 
-			primalMesh->triangles = indices;
+		bool valid;
+		if (aJob.primitive->indices >= 0 && !indices.isValid())
+		{
+			valid = false;
+		}
+		else if (aJob.indexSize == sizeof(uint16_t))
+		{
+			valid = sDecodeIndices(indices, static_cast<uint16_t*>(aJob.indices), aJob.indexCount, aJob.vertexCount);
+		}
+		else
+		{
+			valid = sDecodeIndices(indices, static_cast<uint32_t*>(aJob.indices), aJob.indexCount, aJob.vertexCount);
+		}
 
-			primalMesh->calculateBinormals();
-			primalMesh->build();
+		if (!valid)
+		{
+			PRIMAL_INTERNAL_WARN("Primitive has indices that are out of range or not integers, or missing, they were replaced with 0: {0}", aPath);
+		}
 
-			mMeshes.push_back(primalMesh);
+		// Tangents are derived from the normals, so new normals mean new tangents as well
+		if (!normal.isValid() || !tangent.isValid())
+		{
+			sGenerateAttributes(aJob, !normal.isValid());
 		}
 	}
+
+	// Writes float submeshes and an animation section as a cooked blob, with 16 bit indices whenever every
+	// submesh allows it
+	static void sWriteCooked(const std::vector<SubmeshData>& aSubmeshes, const std::vector<char>& aAnimation, std::vector<char>& aCooked)
+	{
+		bool wideIndices = false;
+		bool skinned = false;
+		uint64_t vertexCount = 0;
+		uint64_t indexCount = 0;
+
+		std::vector<PMeshSubmesh> submeshes(aSubmeshes.size());
+		std::vector<PMeshLod> lods;
+		std::vector<PMeshCluster> clusters;
+
+		for (size_t i = 0; i < aSubmeshes.size(); i++)
+		{
+			const SubmeshData& data = aSubmeshes[i];
+			PMeshSubmesh& submesh = submeshes[i];
+
+			submesh.firstVertex = static_cast<uint32_t>(vertexCount);
+			submesh.vertexCount = static_cast<uint32_t>(data.vertices.size());
+			submesh.firstIndex = static_cast<uint32_t>(indexCount);
+			submesh.indexCount = static_cast<uint32_t>(data.indices.size());
+			submesh.firstLod = static_cast<uint32_t>(lods.size());
+
+			if (data.lods.empty())
+			{
+				lods.push_back({ 0, submesh.indexCount, 0, 0, 0.0f, 0 });
+			}
+			else
+			{
+				lods.insert(lods.end(), data.lods.begin(), data.lods.end());
+			}
+
+			submesh.lodCount = static_cast<uint32_t>(lods.size()) - submesh.firstLod;
+			submesh.firstCluster = static_cast<uint32_t>(clusters.size());
+			submesh.clusterCount = static_cast<uint32_t>(data.clusters.size());
+
+			clusters.insert(clusters.end(), data.clusters.begin(), data.clusters.end());
+
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				submesh.boundsMin[axis] = data.vertices.empty() ? 0.0f : data.vertices[0].position.v[axis];
+				submesh.boundsMax[axis] = submesh.boundsMin[axis];
+			}
+
+			for (const Vertex& vertex : data.vertices)
+			{
+				for (size_t axis = 0; axis < 3; axis++)
+				{
+					submesh.boundsMin[axis] = std::min(submesh.boundsMin[axis], vertex.position.v[axis]);
+					submesh.boundsMax[axis] = std::max(submesh.boundsMax[axis], vertex.position.v[axis]);
+				}
+			}
+
+			wideIndices |= data.vertices.size() > std::numeric_limits<uint16_t>::max() + size_t(1);
+			skinned |= !data.skin.empty();
+			vertexCount += data.vertices.size();
+			indexCount += data.indices.size();
+		}
+
+		PMeshHeader header = {};
+		header.magic = pmeshMagic;
+		header.version = pmeshVersion;
+		header.vertexStride = sizeof(Vertex);
+		header.vertexFormat = VERTEX_FORMAT_FLOAT;
+		header.indexSize = wideIndices ? sizeof(uint32_t) : sizeof(uint16_t);
+		header.submeshCount = static_cast<uint32_t>(submeshes.size());
+		header.lodCount = static_cast<uint32_t>(lods.size());
+		header.clusterCount = static_cast<uint32_t>(clusters.size());
+		header.skinStride = skinned ? sizeof(PMeshSkinVertex) : 0;
+		header.animationBytes = aAnimation.size();
+		sLayout(header, vertexCount, indexCount);
+
+		for (size_t i = 0; i < submeshes.size(); i++)
+		{
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				header.boundsMin[axis] = i == 0 ? submeshes[i].boundsMin[axis] : std::min(header.boundsMin[axis], submeshes[i].boundsMin[axis]);
+				header.boundsMax[axis] = i == 0 ? submeshes[i].boundsMax[axis] : std::max(header.boundsMax[axis], submeshes[i].boundsMax[axis]);
+			}
+		}
+
+		aCooked.assign(static_cast<size_t>(sFileEnd(header)), 0);
+
+		memcpy(aCooked.data(), &header, sizeof(header));
+		memcpy(aCooked.data() + header.animationOffset, aAnimation.data(), aAnimation.size());
+
+		char* tables = aCooked.data() + sizeof(header);
+		memcpy(tables, submeshes.data(), submeshes.size() * sizeof(PMeshSubmesh));
+		tables += submeshes.size() * sizeof(PMeshSubmesh);
+		memcpy(tables, lods.data(), lods.size() * sizeof(PMeshLod));
+		tables += lods.size() * sizeof(PMeshLod);
+		memcpy(tables, clusters.data(), clusters.size() * sizeof(PMeshCluster));
+
+		for (size_t i = 0; i < aSubmeshes.size(); i++)
+		{
+			const SubmeshData& data = aSubmeshes[i];
+
+			memcpy(aCooked.data() + header.vertexOffset + static_cast<uint64_t>(submeshes[i].firstVertex) * sizeof(Vertex),
+				data.vertices.data(), data.vertices.size() * sizeof(Vertex));
+
+			if (skinned)
+			{
+				PMeshSkinVertex* skin = reinterpret_cast<PMeshSkinVertex*>(aCooked.data() + header.skinOffset) + submeshes[i].firstVertex;
+
+				for (size_t vertex = 0; vertex < data.vertices.size(); vertex++)
+				{
+					skin[vertex] = vertex < data.skin.size() ? data.skin[vertex] : PMeshSkinVertex{ {}, { 1.0f, 0.0f, 0.0f, 0.0f } };
+				}
+			}
+
+			uint8_t* indices = reinterpret_cast<uint8_t*>(aCooked.data() + header.indexOffset) +
+				static_cast<uint64_t>(submeshes[i].firstIndex) * header.indexSize;
+
+			if (wideIndices)
+			{
+				memcpy(indices, data.indices.data(), data.indices.size() * sizeof(uint32_t));
+			}
+			else
+			{
+				uint16_t* narrow = reinterpret_cast<uint16_t*>(indices);
+				for (size_t index = 0; index < data.indices.size(); index++)
+				{
+					narrow[index] = static_cast<uint16_t>(data.indices[index]);
+				}
+			}
+		}
+	}
+
+	// Splits a float cooked blob back into one vertex and 32 bit index list per submesh
+	static void sReadCooked(const std::vector<char>& aCooked, std::vector<SubmeshData>& aSubmeshes)
+	{
+		const PMeshHeader* header = reinterpret_cast<const PMeshHeader*>(aCooked.data());
+		const PMeshSubmesh* submeshes = reinterpret_cast<const PMeshSubmesh*>(aCooked.data() + sizeof(PMeshHeader));
+		const PMeshLod* lods = reinterpret_cast<const PMeshLod*>(submeshes + header->submeshCount);
+		const PMeshCluster* clusters = reinterpret_cast<const PMeshCluster*>(lods + header->lodCount);
+		const Vertex* vertices = reinterpret_cast<const Vertex*>(aCooked.data() + header->vertexOffset);
+		const uint8_t* indices = reinterpret_cast<const uint8_t*>(aCooked.data() + header->indexOffset);
+		const PMeshSkinVertex* skin = header->skinStride != 0 ?
+			reinterpret_cast<const PMeshSkinVertex*>(aCooked.data() + header->skinOffset) : nullptr;
+
+		aSubmeshes.resize(header->submeshCount);
+
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, header->submeshCount, 1), [&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t i = aRange.begin(); i != aRange.end(); ++i)
+			{
+				const PMeshSubmesh& submesh = submeshes[i];
+				SubmeshData& data = aSubmeshes[i];
+
+				data.vertices.assign(vertices + submesh.firstVertex, vertices + submesh.firstVertex + submesh.vertexCount);
+				data.lods.assign(lods + submesh.firstLod, lods + submesh.firstLod + submesh.lodCount);
+				data.clusters.assign(clusters + submesh.firstCluster, clusters + submesh.firstCluster + submesh.clusterCount);
+				data.indices.resize(submesh.indexCount);
+
+				if (skin != nullptr)
+				{
+					data.skin.assign(skin + submesh.firstVertex, skin + submesh.firstVertex + submesh.vertexCount);
+				}
+
+				for (size_t index = 0; index < submesh.indexCount; index++)
+				{
+					const size_t at = static_cast<size_t>(submesh.firstIndex) + index;
+
+					if (header->indexSize == sizeof(uint16_t))
+					{
+						data.indices[index] = reinterpret_cast<const uint16_t*>(indices)[at];
+					}
+					else
+					{
+						data.indices[index] = reinterpret_cast<const uint32_t*>(indices)[at];
+					}
+				}
+			}
+		});
+	}
+
+	// Appends simplified levels behind the full mesh. The levels only reference vertices of the full mesh,
+	// so they all share its vertices.
+	static void sGenerateLods(SubmeshData& aData, const MeshImportSettings& aSettings)
+	{
+		std::vector<SimplifiedLod> simplified = MeshSimplifier::generateLods(aData.vertices, aData.indices,
+			aSettings.lodCount, aSettings.lodReduction, aSettings.lodMaxError);
+
+		aData.lods.clear();
+		aData.lods.push_back({ 0, static_cast<uint32_t>(aData.indices.size()), 0, 0, 0.0f, 0 });
+
+		for (SimplifiedLod& lod : simplified)
+		{
+			if (aSettings.optimize)
+			{
+				MeshOptimizer::optimizeVertexCache(lod.indices, aData.vertices.size());
+			}
+
+			aData.lods.push_back({ static_cast<uint32_t>(aData.indices.size()), static_cast<uint32_t>(lod.indices.size()), 0, 0, lod.error, 0 });
+			aData.indices.insert(aData.indices.end(), lod.indices.begin(), lod.indices.end());
+		}
+	}
+
+	// Clusters every LOD on its own, reordering the triangles inside each LOD's range
+	static void sBuildClusters(SubmeshData& aData)
+	{
+		if (aData.lods.empty())
+		{
+			aData.lods.push_back({ 0, static_cast<uint32_t>(aData.indices.size()), 0, 0, 0.0f, 0 });
+		}
+
+		aData.clusters.clear();
+
+		for (PMeshLod& lod : aData.lods)
+		{
+			const std::vector<MeshCluster> clusters = MeshClusters::build(aData.vertices, aData.indices.data() + lod.firstIndex, lod.indexCount);
+
+			lod.firstCluster = static_cast<uint32_t>(aData.clusters.size());
+			lod.clusterCount = static_cast<uint32_t>(clusters.size());
+
+			for (const MeshCluster& cluster : clusters)
+			{
+				PMeshCluster stored = {};
+				stored.firstIndex = lod.firstIndex + cluster.firstIndex;
+				stored.indexCount = cluster.indexCount;
+				stored.radius = cluster.radius;
+				stored.coneCutoff = cluster.coneCutoff;
+
+				for (size_t axis = 0; axis < 3; axis++)
+				{
+					stored.center[axis] = cluster.center.v[axis];
+					stored.coneAxis[axis] = cluster.coneAxis.v[axis];
+				}
+
+				aData.clusters.push_back(stored);
+			}
+		}
+	}
+
+	// Skin influences follow their vertices through the optimizer's remap tables
+	static void sRemapSkin(const std::vector<uint32_t>& aRemap, std::vector<PMeshSkinVertex>& aSkin)
+	{
+		std::vector<PMeshSkinVertex> skin(aRemap.size());
+
+		for (size_t i = 0; i < aRemap.size(); i++)
+		{
+			skin[i] = aSkin[aRemap[i]];
+		}
+
+		aSkin.swap(skin);
+	}
+
+	// Welds and reorders every submesh of a float cooked blob for the vertex cache, generates its LODs and
+	// clusters and finally orders the vertices for fetch by their first use across all of them
+	static void sProcess(std::vector<char>& aCooked, const MeshImportSettings& aSettings, const std::string& aPath)
+	{
+		std::vector<SubmeshData> submeshes;
+		sReadCooked(aCooked, submeshes);
+
+		const PMeshHeader* header = reinterpret_cast<const PMeshHeader*>(aCooked.data());
+		const std::vector<char> animation(aCooked.data() + header->animationOffset, aCooked.data() + sFileEnd(*header));
+
+		std::vector<MeshOptimizeResult> results(submeshes.size());
+
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, submeshes.size(), 1), [&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t i = aRange.begin(); i != aRange.end(); ++i)
+			{
+				SubmeshData& submesh = submeshes[i];
+				const bool skinned = !submesh.skin.empty();
+
+				// Vertices only weld when their influences match too
+				if (aSettings.optimize)
+				{
+					results[i] = MeshOptimizer::optimize(submesh.vertices, submesh.indices, skinned ? submesh.skin.data() : nullptr,
+						sizeof(PMeshSkinVertex));
+
+					if (skinned)
+					{
+						sRemapSkin(results[i].remap, submesh.skin);
+					}
+				}
+
+				if (aSettings.lodCount > 0)
+				{
+					sGenerateLods(submesh, aSettings);
+				}
+
+				if (aSettings.clusters)
+				{
+					sBuildClusters(submesh);
+				}
+
+				if (aSettings.optimize && (aSettings.lodCount > 0 || aSettings.clusters))
+				{
+					const std::vector<uint32_t> remap = MeshOptimizer::optimizeVertexFetch(submesh.vertices, submesh.indices);
+
+					if (skinned)
+					{
+						sRemapSkin(remap, submesh.skin);
+					}
+				}
+			}
+		});
+
+		if (aSettings.optimize)
+		{
+			MeshOptimizeResult total;
+			for (const MeshOptimizeResult& result : results)
+			{
+				total.before += result.before;
+				total.after += result.after;
+				total.verticesBefore += result.verticesBefore;
+				total.verticesAfter += result.verticesAfter;
+			}
+
+			PRIMAL_INTERNAL_INFO("Optimized {0}: {1} -> {2} vertices, ACMR {3:.3f} -> {4:.3f}, ATVR {5:.3f} -> {6:.3f}", aPath,
+				total.verticesBefore, total.verticesAfter, total.before.getAcmr(), total.after.getAcmr(),
+				total.before.getAtvr(), total.after.getAtvr());
+		}
+
+		if (aSettings.lodCount > 0)
+		{
+			size_t triangles = 0;
+			size_t coarsest = 0;
+			size_t levels = 0;
+
+			for (const SubmeshData& submesh : submeshes)
+			{
+				triangles += submesh.lods.front().indexCount / 3;
+				coarsest += submesh.lods.back().indexCount / 3;
+				levels = std::max(levels, submesh.lods.size() - 1);
+			}
+
+			PRIMAL_INTERNAL_INFO("Simplified {0}: up to {1} LODs, {2} -> {3} triangles at the coarsest", aPath, levels, triangles, coarsest);
+		}
+
+		sWriteCooked(submeshes, animation, aCooked);
+	}
+
+	// Re-encodes the float vertices of a cooked blob in aFormat, every submesh quantized to its own bounds
+	static void sQuantize(std::vector<char>& aCooked, const EVertexFormat aFormat)
+	{
+		const PMeshHeader* source = reinterpret_cast<const PMeshHeader*>(aCooked.data());
+		const PMeshSubmesh* submeshes = reinterpret_cast<const PMeshSubmesh*>(aCooked.data() + sizeof(PMeshHeader));
+		const Vertex* vertices = reinterpret_cast<const Vertex*>(aCooked.data() + source->vertexOffset);
+
+		const uint64_t stride = VertexFormat::getStride(aFormat);
+
+		PMeshHeader header = *source;
+		header.vertexStride = static_cast<uint32_t>(stride);
+		header.vertexFormat = aFormat;
+		sLayout(header, source->vertexBytes / sizeof(Vertex), source->indexBytes / source->indexSize);
+
+		std::vector<char> quantized(static_cast<size_t>(sFileEnd(header)), 0);
+
+		memcpy(quantized.data(), &header, sizeof(header));
+		memcpy(quantized.data() + sizeof(header), submeshes, static_cast<size_t>(sTableEnd(header) - sizeof(header)));
+		memcpy(quantized.data() + header.indexOffset, aCooked.data() + source->indexOffset, header.indexBytes);
+		memcpy(quantized.data() + header.skinOffset, aCooked.data() + source->skinOffset, header.skinBytes);
+		memcpy(quantized.data() + header.animationOffset, aCooked.data() + source->animationOffset, header.animationBytes);
+
+		uint8_t* out = reinterpret_cast<uint8_t*>(quantized.data() + header.vertexOffset);
+
+		for (uint32_t i = 0; i < header.submeshCount; i++)
+		{
+			const PMeshSubmesh& submesh = submeshes[i];
+			const Vector3f boundsMin(submesh.boundsMin[0], submesh.boundsMin[1], submesh.boundsMin[2]);
+			const Vector3f boundsMax(submesh.boundsMax[0], submesh.boundsMax[1], submesh.boundsMax[2]);
+
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, submesh.vertexCount, sVertexGrainSize),
+				[&](const tbb::blocked_range<size_t>& aRange)
+				{
+					const size_t first = submesh.firstVertex + aRange.begin();
+					VertexFormat::encode(vertices + first, aRange.size(), aFormat, boundsMin, boundsMax, out + first * stride);
+				});
+		}
+
+		aCooked.swap(quantized);
+	}
+
+	// Local transform of a node as a row major 3x4 matrix
+	static JointMatrix sGetNodeMatrix(const fx::gltf::Node& aNode)
+	{
+		if (aNode.matrix == fx::gltf::defaults::IdentityMatrix)
+		{
+			return JointMatrix::fromTrs(aNode.translation.data(), aNode.rotation.data(), aNode.scale.data());
+		}
+
+		JointMatrix matrix;
+		for (size_t row = 0; row < 3; row++)
+		{
+			for (size_t column = 0; column < 4; column++)
+			{
+				matrix.m[row * 4 + column] = aNode.matrix[column * 4 + row];
+			}
+		}
+
+		return matrix;
+	}
+
+	// Local transform of a node split into translation, rotation and scale, decomposing its matrix when it
+	// has one. Mirroring matrices are not supported.
+	static void sGetNodeTrs(const fx::gltf::Node& aNode, float* aTranslation, float* aRotation, float* aScale)
+	{
+		if (aNode.matrix == fx::gltf::defaults::IdentityMatrix)
+		{
+			memcpy(aTranslation, aNode.translation.data(), 3 * sizeof(float));
+			memcpy(aRotation, aNode.rotation.data(), 4 * sizeof(float));
+			memcpy(aScale, aNode.scale.data(), 3 * sizeof(float));
+			return;
+		}
+
+		const std::array<float, 16>& matrix = aNode.matrix;
+		glm::mat3 rotation(1.0f);
+
+		for (int column = 0; column < 3; column++)
+		{
+			const glm::vec3 axis(matrix[column * 4], matrix[column * 4 + 1], matrix[column * 4 + 2]);
+
+			aScale[column] = glm::length(axis);
+			rotation[column] = aScale[column] > 0.0f ? axis / aScale[column] : glm::vec3(0.0f);
+		}
+
+		const glm::quat quaternion = glm::normalize(glm::quat_cast(rotation));
+
+		aRotation[0] = quaternion.x;
+		aRotation[1] = quaternion.y;
+		aRotation[2] = quaternion.z;
+		aRotation[3] = quaternion.w;
+
+		memcpy(aTranslation, matrix.data() + 12, 3 * sizeof(float));
+	}
+
+	// Rest pose of aCount joints, built from their local translation, rotation and scale
+	static Pose sGetRestPose(const PMeshJoint* aJoints, const size_t aCount)
+	{
+		Pose pose;
+		pose.resize(aCount);
+
+		for (size_t i = 0; i < aCount; i++)
+		{
+			const PMeshJoint& joint = aJoints[i];
+
+			pose.translationX[i] = joint.translation[0];
+			pose.translationY[i] = joint.translation[1];
+			pose.translationZ[i] = joint.translation[2];
+			pose.rotationX[i] = joint.rotation[0];
+			pose.rotationY[i] = joint.rotation[1];
+			pose.rotationZ[i] = joint.rotation[2];
+			pose.rotationW[i] = joint.rotation[3];
+			pose.scaleX[i] = joint.scale[0];
+			pose.scaleY[i] = joint.scale[1];
+			pose.scaleZ[i] = joint.scale[2];
+		}
+
+		return pose;
+	}
+
+	// Imports the first skin of aDocument as the skeleton, joints ordered parents first, with every
+	// animation channel that moves one of its joints. Returns false when there is no skin to import.
+	static bool sImportAnimation(const fx::gltf::Document& aDocument, const std::string& aPath, const AnimationCompressionSettings& aSettings,
+		AnimationImport& aImport)
+	{
+		if (aDocument.skins.empty())
+		{
+			return false;
+		}
+
+		if (aDocument.skins.size() > 1)
+		{
+			PRIMAL_INTERNAL_WARN("Only the first of {0} skins is imported, every skinned primitive is bound to it: {1}",
+				aDocument.skins.size(), aPath);
+		}
+
+		const fx::gltf::Skin& skin = aDocument.skins[0];
+		const size_t nodeCount = aDocument.nodes.size();
+		const size_t jointCount = skin.joints.size();
+
+		if (jointCount == 0 || jointCount > Skeleton::sMaxJoints)
+		{
+			PRIMAL_INTERNAL_ERROR("Skin has {0} joints, skinned meshes need 1 to {1}: {2}", jointCount, Skeleton::sMaxJoints, aPath);
+			return false;
+		}
+
+		std::vector<int32_t> nodeParents(nodeCount, -1);
+		for (size_t node = 0; node < nodeCount; node++)
+		{
+			for (const int32_t child : aDocument.nodes[node].children)
+			{
+				if (child >= 0 && static_cast<size_t>(child) < nodeCount)
+				{
+					nodeParents[child] = static_cast<int32_t>(node);
+				}
+			}
+		}
+
+		std::vector<int32_t> nodeToSkin(nodeCount, -1);
+		for (size_t i = 0; i < jointCount; i++)
+		{
+			if (skin.joints[i] >= nodeCount)
+			{
+				PRIMAL_INTERNAL_ERROR("Skin joint {0} is not a node: {1}", i, aPath);
+				return false;
+			}
+
+			nodeToSkin[skin.joints[i]] = static_cast<int32_t>(i);
+		}
+
+		// The nearest ancestor that is a joint becomes the parent, and joints are sorted by how many joints
+		// are above them. Walks stop after nodeCount steps in case the hierarchy has a cycle.
+		std::vector<int32_t> skinParents(jointCount, -1);
+		std::vector<uint32_t> depths(jointCount, 0);
+
+		for (size_t i = 0; i < jointCount; i++)
+		{
+			int32_t node = nodeParents[skin.joints[i]];
+
+			for (size_t steps = 0; node >= 0 && steps < nodeCount; steps++)
+			{
+				if (nodeToSkin[node] >= 0)
+				{
+					skinParents[i] = skinParents[i] < 0 ? nodeToSkin[node] : skinParents[i];
+					depths[i]++;
+				}
+
+				node = nodeParents[node];
+			}
+		}
+
+		std::vector<uint32_t> order(jointCount);
+		for (size_t i = 0; i < jointCount; i++)
+		{
+			order[i] = static_cast<uint32_t>(i);
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&](const uint32_t aLeft, const uint32_t aRight) { return depths[aLeft] < depths[aRight]; });
+
+		aImport.skinToJoint.resize(jointCount);
+		for (size_t joint = 0; joint < jointCount; joint++)
+		{
+			aImport.skinToJoint[order[joint]] = static_cast<uint16_t>(joint);
+		}
+
+		aImport.nodeToJoint.assign(nodeCount, -1);
+		for (size_t i = 0; i < jointCount; i++)
+		{
+			aImport.nodeToJoint[skin.joints[i]] = aImport.skinToJoint[i];
+		}
+
+		const AccessorView inverseBinds = sGetView(aDocument, skin.inverseBindMatrices, aPath);
+		const bool hasInverseBinds = inverseBinds.isValid() && inverseBinds.components == 16 && inverseBinds.count >= jointCount;
+
+		if (skin.inverseBindMatrices >= 0 && !hasInverseBinds)
+		{
+			PRIMAL_INTERNAL_WARN("Skin inverse bind matrices are unusable, the joints are bound at identity: {0}", aPath);
+		}
+
+		aImport.joints.resize(jointCount);
+
+		for (size_t joint = 0; joint < jointCount; joint++)
+		{
+			const uint32_t index = order[joint];
+			const fx::gltf::Node& node = aDocument.nodes[skin.joints[index]];
+
+			PMeshJoint& stored = aImport.joints[joint];
+			stored = {};
+			strncpy(stored.name, node.name.c_str(), sizeof(stored.name) - 1);
+			stored.parent = skinParents[index] >= 0 ? aImport.skinToJoint[skinParents[index]] : Skeleton::sNoParent;
+			sGetNodeTrs(node, stored.translation, stored.rotation, stored.scale);
+
+			// Accessor matrices are column major
+			for (uint32_t row = 0; row < 3; row++)
+			{
+				for (uint32_t column = 0; column < 4; column++)
+				{
+					stored.inverseBind[row * 4 + column] = hasInverseBinds ? sReadComponent(inverseBinds, index, column * 4 + row) :
+						(row == column ? 1.0f : 0.0f);
+				}
+			}
+		}
+
+		// Joint transforms include every node above the skeleton, taken from the first root joint
+		JointMatrix root = JointMatrix::identity();
+		int32_t ancestor = nodeParents[skin.joints[order[0]]];
+
+		for (size_t steps = 0; ancestor >= 0 && steps < nodeCount; steps++)
+		{
+			root = JointMatrix::multiply(sGetNodeMatrix(aDocument.nodes[ancestor]), root);
+			ancestor = nodeParents[ancestor];
+		}
+
+		memcpy(aImport.header.rootTransform, root.m, sizeof(root.m));
+
+		const Pose restPose = sGetRestPose(aImport.joints.data(), aImport.joints.size());
+
+		bool cubicSpline = false;
+		size_t rawBytes = 0;
+		size_t compressedBytes = 0;
+		AnimationCompressionError error;
+
+		for (const fx::gltf::Animation& animation : aDocument.animations)
+		{
+			std::vector<AnimationTrack> tracks;
+
+			for (const fx::gltf::Animation::Channel& channel : animation.channels)
+			{
+				const int32_t node = channel.target.node;
+				if (node < 0 || static_cast<size_t>(node) >= nodeCount || aImport.nodeToJoint[node] < 0 ||
+					channel.sampler < 0 || static_cast<size_t>(channel.sampler) >= animation.samplers.size())
+				{
+					continue;
+				}
+
+				EAnimationChannel type;
+				if (channel.target.path == "translation")
+				{
+					type = ANIMATION_CHANNEL_TRANSLATION;
+				}
+				else if (channel.target.path == "rotation")
+				{
+					type = ANIMATION_CHANNEL_ROTATION;
+				}
+				else if (channel.target.path == "scale")
+				{
+					type = ANIMATION_CHANNEL_SCALE;
+				}
+				else
+				{
+					continue;
+				}
+
+				const fx::gltf::Animation::Sampler& sampler = animation.samplers[channel.sampler];
+				const bool cubic = sampler.interpolation == fx::gltf::Animation::Sampler::Type::CubicSpline;
+
+				const AccessorView times = sGetView(aDocument, sampler.input, aPath);
+				const AccessorView values = sGetView(aDocument, sampler.output, aPath);
+				const uint32_t components = AnimationTrack::getComponentCount(type);
+
+				if (!times.isValid() || !values.isValid() || times.components != 1 || values.components != components ||
+					values.count < times.count * (cubic ? 3 : 1))
+				{
+					PRIMAL_INTERNAL_WARN("Skipping a {0} channel of animation \"{1}\" with unusable keys: {2}", channel.target.path,
+						animation.name, aPath);
+					continue;
+				}
+
+				cubicSpline |= cubic;
+
+				AnimationTrack track;
+				track.joint = static_cast<uint32_t>(aImport.nodeToJoint[node]);
+				track.channel = type;
+				track.interpolation = sampler.interpolation == fx::gltf::Animation::Sampler::Type::Step ?
+					ANIMATION_INTERPOLATION_STEP : ANIMATION_INTERPOLATION_LINEAR;
+
+				track.times.resize(times.count);
+				track.values.resize(times.count * components);
+
+				// Cubic spline keys are an in tangent, the value and an out tangent
+				for (size_t key = 0; key < times.count; key++)
+				{
+					track.times[key] = sReadComponent(times, key, 0);
+
+					for (uint32_t c = 0; c < components; c++)
+					{
+						track.values[key * components + c] = sReadComponent(values, cubic ? key * 3 + 1 : key, c);
+					}
+				}
+
+				tracks.push_back(std::move(track));
+			}
+
+			const AnimationClip clip(animation.name.substr(0, sizeof(PMeshClip::name) - 1), std::move(tracks));
+			aImport.clips.push_back(AnimationCompression::compress(clip, restPose, aSettings));
+
+			const AnimationCompressionError clipError = AnimationCompression::measure(clip, aImport.clips.back(), restPose);
+			error.translation = std::max(error.translation, clipError.translation);
+			error.rotation = std::max(error.rotation, clipError.rotation);
+			error.scale = std::max(error.scale, clipError.scale);
+
+			rawBytes += AnimationCompression::getRawBytes(clip);
+			compressedBytes += aImport.clips.back().getMemoryUsage();
+		}
+
+		if (cubicSpline)
+		{
+			PRIMAL_INTERNAL_WARN("Cubic spline channels are imported as linear between their keys: {0}", aPath);
+		}
+
+		if (!aImport.clips.empty())
+		{
+			PRIMAL_INTERNAL_INFO("Compressed {0} clips of {1}: {2} -> {3} bytes, at most {4} off in translation, {5} radians in rotation, {6} in scale",
+				aImport.clips.size(), aPath, rawBytes, compressedBytes, error.translation, error.rotation, error.scale);
+		}
+
+		return true;
+	}
+
+	static uint64_t sAnimationBytes(const PMeshAnimationHeader& aHeader)
+	{
+		return sizeof(PMeshAnimationHeader) + static_cast<uint64_t>(aHeader.jointCount) * sizeof(PMeshJoint) +
+			static_cast<uint64_t>(aHeader.clipCount) * sizeof(PMeshClip) + static_cast<uint64_t>(aHeader.trackCount) * sizeof(PMeshTrack) +
+			static_cast<uint64_t>(aHeader.timeCount) * sizeof(uint16_t) + aHeader.keyBytes;
+	}
+
+	static void sWriteAnimation(AnimationImport& aImport, std::vector<char>& aSection)
+	{
+		std::vector<PMeshClip> clips(aImport.clips.size());
+
+		PMeshAnimationHeader& header = aImport.header;
+		header.jointCount = static_cast<uint32_t>(aImport.joints.size());
+		header.clipCount = static_cast<uint32_t>(aImport.clips.size());
+
+		for (size_t i = 0; i < aImport.clips.size(); i++)
+		{
+			const CompressedClip& clip = aImport.clips[i];
+
+			PMeshClip& stored = clips[i];
+			strncpy(stored.name, clip.getName().c_str(), sizeof(stored.name) - 1);
+			stored.duration = clip.getDuration();
+			stored.timeStep = clip.getTimeStep();
+			stored.firstTrack = header.trackCount;
+			stored.trackCount = static_cast<uint32_t>(clip.getTracks().size());
+			stored.firstTime = header.timeCount;
+			stored.timeCount = static_cast<uint32_t>(clip.getTimes().size());
+			stored.firstKeyByte = header.keyBytes;
+			stored.keyBytes = static_cast<uint32_t>(clip.getKeyBytes());
+
+			header.trackCount += stored.trackCount;
+			header.timeCount += stored.timeCount;
+			header.keyBytes += stored.keyBytes;
+		}
+
+		aSection.resize(static_cast<size_t>(sAnimationBytes(header)));
+
+		char* out = aSection.data();
+		memcpy(out, &header, sizeof(PMeshAnimationHeader));
+		out += sizeof(PMeshAnimationHeader);
+		memcpy(out, aImport.joints.data(), aImport.joints.size() * sizeof(PMeshJoint));
+		out += aImport.joints.size() * sizeof(PMeshJoint);
+		memcpy(out, clips.data(), clips.size() * sizeof(PMeshClip));
+		out += clips.size() * sizeof(PMeshClip);
+
+		for (const CompressedClip& clip : aImport.clips)
+		{
+			memcpy(out, clip.getTracks().data(), clip.getTracks().size() * sizeof(PMeshTrack));
+			out += clip.getTracks().size() * sizeof(PMeshTrack);
+		}
+
+		for (const CompressedClip& clip : aImport.clips)
+		{
+			memcpy(out, clip.getTimes().data(), clip.getTimes().size() * sizeof(uint16_t));
+			out += clip.getTimes().size() * sizeof(uint16_t);
+		}
+
+		for (const CompressedClip& clip : aImport.clips)
+		{
+			memcpy(out, clip.getKeyData(), clip.getKeyBytes());
+			out += clip.getKeyBytes();
+		}
+	}
+
+	// Builds the skeleton and clips of a cooked animation section, false when any of it is out of range
+	static bool sReadAnimation(const uint8_t* aData, const uint64_t aSize, Skeleton& aSkeleton, std::vector<CompressedClip>& aClips)
+	{
+		if (aSize < sizeof(PMeshAnimationHeader))
+		{
+			return false;
+		}
+
+		PMeshAnimationHeader header;
+		memcpy(&header, aData, sizeof(header));
+
+		if (sAnimationBytes(header) > aSize || header.jointCount == 0 || header.jointCount > Skeleton::sMaxJoints)
+		{
+			return false;
+		}
+
+		const PMeshJoint* joints = reinterpret_cast<const PMeshJoint*>(aData + sizeof(PMeshAnimationHeader));
+		const PMeshClip* clips = reinterpret_cast<const PMeshClip*>(joints + header.jointCount);
+		const PMeshTrack* tracks = reinterpret_cast<const PMeshTrack*>(clips + header.clipCount);
+		const uint16_t* times = reinterpret_cast<const uint16_t*>(tracks + header.trackCount);
+		const uint8_t* keys = reinterpret_cast<const uint8_t*>(times + header.timeCount);
+
+		std::vector<int32_t> parents(header.jointCount);
+		std::vector<std::string> names(header.jointCount);
+		std::vector<JointMatrix> inverseBinds(header.jointCount);
+
+		for (uint32_t i = 0; i < header.jointCount; i++)
+		{
+			const PMeshJoint& joint = joints[i];
+
+			parents[i] = joint.parent;
+			names[i] = std::string(joint.name, strnlen(joint.name, sizeof(joint.name)));
+			memcpy(inverseBinds[i].m, joint.inverseBind, sizeof(joint.inverseBind));
+		}
+
+		JointMatrix root;
+		memcpy(root.m, header.rootTransform, sizeof(root.m));
+
+		if (!aSkeleton.build(std::move(parents), std::move(names), sGetRestPose(joints, header.jointCount), std::move(inverseBinds), root))
+		{
+			return false;
+		}
+
+		aClips.reserve(header.clipCount);
+
+		for (uint32_t i = 0; i < header.clipCount; i++)
+		{
+			const PMeshClip& clip = clips[i];
+			if (static_cast<uint64_t>(clip.firstTrack) + clip.trackCount > header.trackCount ||
+				static_cast<uint64_t>(clip.firstTime) + clip.timeCount > header.timeCount ||
+				static_cast<uint64_t>(clip.firstKeyByte) + clip.keyBytes > header.keyBytes)
+			{
+				return false;
+			}
+
+			std::vector<CompressedTrack> clipTracks(clip.trackCount);
+			memcpy(clipTracks.data(), tracks + clip.firstTrack, clip.trackCount * sizeof(PMeshTrack));
+
+			aClips.emplace_back(std::string(clip.name, strnlen(clip.name, sizeof(clip.name))), clip.duration, clip.timeStep, std::move(clipTracks),
+				std::vector<uint16_t>(times + clip.firstTime, times + clip.firstTime + clip.timeCount),
+				std::vector<uint8_t>(keys + clip.firstKeyByte, keys + clip.firstKeyByte + clip.keyBytes));
+
+			if (!aClips.back().isValid(header.jointCount))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// The skinning kernels index the joint palette with these unchecked
+	static bool sSkinInRange(const SkinVertex* aSkin, const uint64_t aVertexCount, const size_t aJointCount)
+	{
+		for (uint64_t vertex = 0; vertex < aVertexCount; vertex++)
+		{
+			for (const uint16_t joint : aSkin[vertex].joints)
+			{
+				if (joint >= aJointCount)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Decodes every triangle primitive straight into the .pmesh layout, one submesh per primitive. Indices
+	// are 16 bit unless a primitive has more vertices than 16 bit indices can address. Quantized formats
+	// are encoded from the float vertices afterwards. With a skin in the document every primitive gets
+	// influences, and the skeleton and clips go into the animation section.
+	static bool sImportGltf(const std::string& aPath, const MeshImportSettings& aSettings, std::vector<char>& aCooked)
+	{
+		fx::gltf::Document document;
+
+		try
+		{
+			if (StringUtils::endsWith(aPath, "glb"))
+			{
+				document = fx::gltf::LoadFromBinary(aPath);
+			}
+			else
+			{
+				document = fx::gltf::LoadFromText(aPath);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			PRIMAL_INTERNAL_ERROR("Could not read glTF file {0}: {1}", aPath, e.what());
+			return false;
+		}
+
+		std::vector<PrimitiveJob> jobs;
+		bool wideIndices = false;
+
+		for (const auto& mesh : document.meshes)
+		{
+			for (const auto& primitive : mesh.primitives)
+			{
+				if (primitive.mode != fx::gltf::Primitive::Mode::Triangles)
+				{
+					PRIMAL_INTERNAL_WARN("Skipping a primitive of mesh \"{0}\" that is not a triangle list: {1}", mesh.name, aPath);
+					continue;
+				}
+
+				const auto position = primitive.attributes.find("POSITION");
+				if (position == primitive.attributes.end() || position->second >= document.accessors.size() ||
+					(primitive.indices >= 0 && static_cast<size_t>(primitive.indices) >= document.accessors.size()))
+				{
+					PRIMAL_INTERNAL_WARN("Skipping a primitive of mesh \"{0}\" without valid positions or indices: {1}", mesh.name, aPath);
+					continue;
+				}
+
+				PrimitiveJob job = {};
+				job.primitive = &primitive;
+				job.vertexCount = document.accessors[position->second].count;
+				job.indexCount = primitive.indices >= 0 ? document.accessors[primitive.indices].count : job.vertexCount;
+
+				wideIndices |= job.vertexCount > std::numeric_limits<uint16_t>::max() + size_t(1);
+
+				jobs.push_back(job);
+			}
+		}
+
+		const uint32_t indexSize = wideIndices ? sizeof(uint32_t) : sizeof(uint16_t);
+
+		AnimationImport animation;
+		const bool skinned = sImportAnimation(document, aPath, aSettings.animation, animation);
+
+		std::vector<char> section;
+		if (skinned)
+		{
+			sWriteAnimation(animation, section);
+		}
+
+		PMeshHeader header = {};
+		header.magic = pmeshMagic;
+		header.version = pmeshVersion;
+		header.vertexStride = sizeof(Vertex);
+		header.vertexFormat = VERTEX_FORMAT_FLOAT;
+		header.indexSize = indexSize;
+		header.submeshCount = static_cast<uint32_t>(jobs.size());
+		header.lodCount = header.submeshCount;
+		header.skinStride = skinned ? sizeof(PMeshSkinVertex) : 0;
+		header.animationBytes = section.size();
+
+		std::vector<PMeshSubmesh> submeshes(jobs.size());
+		std::vector<PMeshLod> lods(jobs.size());
+
+		uint64_t vertexCount = 0;
+		uint64_t indexCount = 0;
+
+		for (size_t i = 0; i < jobs.size(); i++)
+		{
+			submeshes[i].firstVertex = static_cast<uint32_t>(vertexCount);
+			submeshes[i].vertexCount = static_cast<uint32_t>(jobs[i].vertexCount);
+			submeshes[i].firstIndex = static_cast<uint32_t>(indexCount);
+			submeshes[i].indexCount = static_cast<uint32_t>(jobs[i].indexCount);
+			submeshes[i].firstLod = static_cast<uint32_t>(i);
+			submeshes[i].lodCount = 1;
+
+			lods[i] = { 0, submeshes[i].indexCount, 0, 0, 0.0f, 0 };
+
+			vertexCount += jobs[i].vertexCount;
+			indexCount += jobs[i].indexCount;
+		}
+
+		sLayout(header, vertexCount, indexCount);
+
+		// Zero filled, which takes care of the padding between the blobs
+		aCooked.assign(static_cast<size_t>(sFileEnd(header)), 0);
+		memcpy(aCooked.data() + header.animationOffset, section.data(), section.size());
+
+		for (size_t i = 0; i < jobs.size(); i++)
+		{
+			jobs[i].submesh = &submeshes[i];
+			jobs[i].vertices = reinterpret_cast<Vertex*>(aCooked.data() + header.vertexOffset) + submeshes[i].firstVertex;
+			jobs[i].indices = aCooked.data() + header.indexOffset + static_cast<uint64_t>(submeshes[i].firstIndex) * indexSize;
+			jobs[i].indexSize = indexSize;
+			jobs[i].skin = skinned ? reinterpret_cast<PMeshSkinVertex*>(aCooked.data() + header.skinOffset) + submeshes[i].firstVertex : nullptr;
+			jobs[i].skinToJoint = &animation.skinToJoint;
+		}
+
+		// Every primitive writes only its own ranges, large primitives split their vertices further
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, jobs.size(), 1), [&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t i = aRange.begin(); i != aRange.end(); ++i)
+			{
+				sDecodePrimitive(document, jobs[i], aPath);
+			}
+		});
+
+		for (size_t i = 0; i < submeshes.size(); i++)
+		{
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				header.boundsMin[axis] = i == 0 ? submeshes[i].boundsMin[axis] : std::min(header.boundsMin[axis], submeshes[i].boundsMin[axis]);
+				header.boundsMax[axis] = i == 0 ? submeshes[i].boundsMax[axis] : std::max(header.boundsMax[axis], submeshes[i].boundsMax[axis]);
+			}
+		}
+
+		memcpy(aCooked.data(), &header, sizeof(header));
+		memcpy(aCooked.data() + sizeof(header), submeshes.data(), submeshes.size() * sizeof(PMeshSubmesh));
+		memcpy(aCooked.data() + sizeof(header) + submeshes.size() * sizeof(PMeshSubmesh), lods.data(), lods.size() * sizeof(PMeshLod));
+
+		if (aSettings.optimize || aSettings.lodCount > 0 || aSettings.clusters)
+		{
+			sProcess(aCooked, aSettings, aPath);
+		}
+
+		if (aSettings.vertexFormat != VERTEX_FORMAT_FLOAT)
+		{
+			const bool hasColor = std::any_of(jobs.begin(), jobs.end(), [](const PrimitiveJob& aJob) { return aJob.hasColor; });
+			sQuantize(aCooked, VertexFormat::withColor(aSettings.vertexFormat, hasColor));
+		}
+
+		return true;
+	}
+}
+
+MeshAsset::MeshAsset(const std::string& aPath, const MeshImportSettings& aSettings)
+	: mSkeleton(nullptr)
+{
+	mPath = aPath;
+	mSettings = aSettings;
+}
+
+MeshAsset::~MeshAsset()
+{
+	for(size_t i = 0; i < mMeshes.size(); i++)
+	{
+		delete mMeshes[i];
+	}
+
+	mMeshes.clear();
+
+	delete mSkeleton;
+}
+
+Mesh* MeshAsset::getMesh(const size_t aIndex)
+{
+	if(aIndex < mMeshes.size())
+	{
+		return mMeshes[aIndex];
+	}
+
+	return nullptr;
+}
+
+const Skeleton* MeshAsset::getSkeleton() const
+{
+	return mSkeleton;
+}
+
+size_t MeshAsset::getClipCount() const
+{
+	return mClips.size();
+}
+
+const CompressedClip* MeshAsset::getClip(const size_t aIndex) const
+{
+	return aIndex < mClips.size() ? &mClips[aIndex] : nullptr;
+}
+
+const CompressedClip* MeshAsset::findClip(const std::string& aName) const
+{
+	for (const CompressedClip& clip : mClips)
+	{
+		if (clip.getName() == aName)
+		{
+			return &clip;
+		}
+	}
+
+	return nullptr;
+}
+
+size_t MeshAsset::getMemoryUsage() const
+{
+	size_t bytes = mCooked.size();
+
+	for (const Mesh* mesh : mMeshes)
+	{
+		bytes += mesh->getMemoryUsage();
+	}
+
+	for (const CompressedClip& clip : mClips)
+	{
+		bytes += clip.getMemoryUsage();
+	}
+
+	return bytes;
+}
+
+std::vector<std::string> MeshAsset::_gatherSources() const
+{
+	return { mPath };
+}
+
+void MeshAsset::_load()
+{
+	if (StringUtils::endsWith(mPath, ".pmesh"))
+	{
+		mCooked = FileSystem::instance().view(mPath);
+		_loadCooked(mPath);
+		return;
+	}
+
+	const FileView source = FileSystem::instance().view(mPath);
+	if (!source.isValid())
+	{
+		PRIMAL_INTERNAL_ERROR("Mesh file does not exist: {0}", mPath);
+		return;
+	}
+
+	// Imports are stored in the cooked layout, so a cache hit loads exactly like a .pmesh. Buffers a
+	// .gltf references externally are not part of the key.
+	DerivedDataKey key("mesh", detail::sImporterVersion);
+	key.add(source).add(sizeof(Vertex)).add(static_cast<uint32_t>(mSettings.vertexFormat)).add(mSettings.optimize ? 1u : 0u)
+		.add(mSettings.lodCount).add(&mSettings.lodReduction, sizeof(float)).add(&mSettings.lodMaxError, sizeof(float))
+		.add(mSettings.clusters ? 1u : 0u).add(&mSettings.animation, sizeof(AnimationCompressionSettings));
+
+	if (!DerivedDataCache::instance().get(key, mCooked))
+	{
+		auto cooked = std::make_shared<std::vector<char>>();
+		if (!detail::sImportGltf(mPath, mSettings, *cooked))
+		{
+			return;
+		}
+
+		DerivedDataCache::instance().put(key, cooked->data(), cooked->size());
+
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(cooked->data());
+		const size_t size = cooked->size();
+
+		mCooked = FileView(data, size, std::move(cooked));
+	}
+
+	_loadCooked(mPath);
+}
+
+void MeshAsset::_loadCooked(const std::string& aPath)
+{
+	if (!mCooked.isValid())
+	{
+		PRIMAL_INTERNAL_ERROR("Could not open cooked mesh: {0}", aPath);
+		return;
+	}
+
+	const uint8_t* base = mCooked.data();
+	const size_t size = mCooked.size();
+
+	if (size < sizeof(PMeshHeader))
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked mesh is truncated: {0}", aPath);
+		return;
+	}
+
+	const PMeshHeader* header = reinterpret_cast<const PMeshHeader*>(base);
+
+	if (header->magic != pmeshMagic || header->version != pmeshVersion)
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked mesh has an unknown format, recook it: {0}", aPath);
+		return;
+	}
+
+	if (!VertexFormat::isValid(header->vertexFormat) ||
+		header->vertexStride != VertexFormat::getStride(static_cast<EVertexFormat>(header->vertexFormat)) ||
+		(header->indexSize != sizeof(uint16_t) && header->indexSize != sizeof(uint32_t)))
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked mesh vertex layout does not match this build, recook it: {0}", aPath);
+		return;
+	}
+
+	const uint64_t tableEnd = detail::sTableEnd(*header);
+	if (tableEnd > size || header->vertexOffset + header->vertexBytes > size || header->indexOffset + header->indexBytes > size ||
+		header->skinOffset + header->skinBytes > size || header->animationOffset + header->animationBytes > size)
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked mesh is truncated: {0}", aPath);
+		return;
+	}
+
+	const PMeshSubmesh* submeshes = reinterpret_cast<const PMeshSubmesh*>(base + sizeof(PMeshHeader));
+	const PMeshLod* lods = reinterpret_cast<const PMeshLod*>(submeshes + header->submeshCount);
+	const PMeshCluster* clusters = reinterpret_cast<const PMeshCluster*>(lods + header->lodCount);
+	const uint8_t* vertices = base + header->vertexOffset;
+	const EVertexFormat vertexFormat = static_cast<EVertexFormat>(header->vertexFormat);
+	const uint8_t* indices = base + header->indexOffset;
+	const EIndexType indexType = header->indexSize == sizeof(uint16_t) ? INDEX_TYPE_UINT16 : INDEX_TYPE_UINT32;
+
+	const uint64_t vertexCount = header->vertexBytes / header->vertexStride;
+	const uint64_t indexCount = header->indexBytes / header->indexSize;
+
+	// Submeshes are addressed by index, so one that is out of range fails the whole mesh
+	for (uint32_t i = 0; i < header->submeshCount; i++)
+	{
+		const PMeshSubmesh& submesh = submeshes[i];
+
+		if (static_cast<uint64_t>(submesh.firstVertex) + submesh.vertexCount > vertexCount ||
+			static_cast<uint64_t>(submesh.firstIndex) + submesh.indexCount > indexCount ||
+			static_cast<uint64_t>(submesh.firstLod) + submesh.lodCount > header->lodCount ||
+			static_cast<uint64_t>(submesh.firstCluster) + submesh.clusterCount > header->clusterCount)
+		{
+			PRIMAL_INTERNAL_ERROR("Cooked mesh submesh {0} is out of range, recook it: {1}", i, aPath);
+			return;
+		}
+	}
+
+	const SkinVertex* skin = nullptr;
+
+	if (header->skinStride != 0)
+	{
+		Skeleton* skeleton = new Skeleton();
+
+		if (header->skinStride != sizeof(SkinVertex) || header->skinBytes != vertexCount * sizeof(SkinVertex) ||
+			!detail::sReadAnimation(base + header->animationOffset, header->animationBytes, *skeleton, mClips))
+		{
+			PRIMAL_INTERNAL_ERROR("Cooked mesh skin or animation is out of range, loading it without: {0}", aPath);
+
+			delete skeleton;
+			mClips.clear();
+		}
+		else
+		{
+			skin = reinterpret_cast<const SkinVertex*>(base + header->skinOffset);
+
+			if (!detail::sSkinInRange(skin, vertexCount, skeleton->getJointCount()))
+			{
+				PRIMAL_INTERNAL_ERROR("Cooked mesh skin references joints past its skeleton, recook it: {0}", aPath);
+
+				delete skeleton;
+				mClips.clear();
+				return;
+			}
+
+			mSkeleton = skeleton;
+		}
+	}
+
+	mMeshes.reserve(header->submeshCount);
+
+	for (uint32_t i = 0; i < header->submeshCount; i++)
+	{
+		const PMeshSubmesh& submesh = submeshes[i];
+
+		std::vector<MeshLod> meshLods;
+		meshLods.reserve(submesh.lodCount);
+
+		for (uint32_t lod = 0; lod < submesh.lodCount; lod++)
+		{
+			const PMeshLod& range = lods[submesh.firstLod + lod];
+
+			if (static_cast<uint64_t>(range.firstIndex) + range.indexCount > submesh.indexCount ||
+				static_cast<uint64_t>(range.firstCluster) + range.clusterCount > submesh.clusterCount)
+			{
+				PRIMAL_INTERNAL_ERROR("Cooked mesh submesh {0} has a LOD out of range: {1}", i, aPath);
+				break;
+			}
+
+			meshLods.push_back({ range.firstIndex, range.indexCount, range.error, range.firstCluster, range.clusterCount });
+		}
+
+		std::vector<MeshCluster> meshClusters;
+		meshClusters.reserve(submesh.clusterCount);
+
+		for (uint32_t cluster = 0; cluster < submesh.clusterCount; cluster++)
+		{
+			const PMeshCluster& stored = clusters[submesh.firstCluster + cluster];
+
+			if (static_cast<uint64_t>(stored.firstIndex) + stored.indexCount > submesh.indexCount)
+			{
+				PRIMAL_INTERNAL_ERROR("Cooked mesh submesh {0} has a cluster out of range, culling it as a whole: {1}", i, aPath);
+
+				meshClusters.clear();
+				for (MeshLod& lod : meshLods)
+				{
+					lod.clusterCount = 0;
+				}
+
+				break;
+			}
+
+			meshClusters.push_back({ stored.firstIndex, stored.indexCount,
+				{ stored.center[0], stored.center[1], stored.center[2] }, stored.radius,
+				{ stored.coneAxis[0], stored.coneAxis[1], stored.coneAxis[2] }, stored.coneCutoff });
+		}
+
+		Mesh* mesh = new Mesh();
+		mesh->build(vertices + static_cast<uint64_t>(submesh.firstVertex) * header->vertexStride, submesh.vertexCount, vertexFormat,
+			indices + static_cast<uint64_t>(submesh.firstIndex) * header->indexSize, submesh.indexCount, indexType,
+			{ submesh.boundsMin[0], submesh.boundsMin[1], submesh.boundsMin[2] },
+			{ submesh.boundsMax[0], submesh.boundsMax[1], submesh.boundsMax[2] });
+		mesh->setLods(std::move(meshLods));
+		mesh->setClusters(std::move(meshClusters));
+
+		if (skin != nullptr)
+		{
+			mesh->setSkin(skin + submesh.firstVertex);
+		}
+
+		mMeshes.push_back(mesh);
+	}
+}
+
+bool MeshAsset::cook(const std::string& aSource, const std::string& aDestination, const MeshImportSettings& aSettings)
+{
+	std::vector<char> cooked;
+	if (!detail::sImportGltf(aSource, aSettings, cooked))
+	{
+		return false;
+	}
+
+	// Loaded meshes may still map the previous file
+	if (!FileSystem::instance().replace(aDestination, cooked.data(), cooked.size()))
+	{
+		PRIMAL_INTERNAL_ERROR("Could not write cooked mesh: {0}", aDestination);
+		return false;
+	}
+
+	const PMeshHeader* header = reinterpret_cast<const PMeshHeader*>(cooked.data());
+	PRIMAL_INTERNAL_INFO("Cooked {0} into {1} ({2} submeshes, {3} vertices, {4} indices, {5} bytes of animation)", aSource, aDestination,
+		header->submeshCount, header->vertexBytes / header->vertexStride, header->indexBytes / header->indexSize, header->animationBytes);
+
+	return true;
 }
@@ -22,6 +22,11 @@ IRenderPass* RenderPassAsset::getRenderPass() const
 	return mRenderPass;
 }
 
+std::vector<std::string> RenderPassAsset::_gatherSources() const
+{
+	return { mPath };
+}
+
 void RenderPassAsset::_load()
 {
 	const std::string fileContent = FileSystem::instance().loadToString(mPath);
@@ -19,6 +19,11 @@ ISampler* SamplerAsset::getSampler() const
 	return mSampler;
 }
 
+std::vector<std::string> SamplerAsset::_gatherSources() const
+{
+	return { mFileName };
+}
+
 void SamplerAsset::_load()
 {
 	const std::string& contents = FileSystem::instance().loadToString(mFileName);
@@ -1,5 +1,6 @@
 #include "assets/AssetManager.h"
 #include "assets/ShaderAsset.h"
+#include "assets/ShaderModuleAsset.h"
 #include "core/PrimalAssert.h"
 #include "filesystem/FileSystem.h"
 #include "graphics/GraphicsFactory.h"
@@ -40,118 +41,62 @@ IPipelineLayout* ShaderAsset::getLayout() const
 	return mGraphicsPipelineCreateInfo.layout;
 }
 
-void ShaderAsset::_load()
+std::vector<AssetDependency> ShaderAsset::_gatherDependencies()
 {
-	const std::string fileContent = FileSystem::instance().loadToString(mPath);
+	mDescriptor = FileSystem::instance().loadToString(mPath);
 
-	const auto jsonValue = nlohmann::json::parse(fileContent);
+	const auto jsonValue = nlohmann::json::parse(mDescriptor);
 
 	const auto shaders = jsonValue["shaders"];
 	PRIMAL_ASSERT(shaders.is_object(), "Could not load shaders.");
 
-	const std::string vertPath = shaders.contains("vertexPath") ? shaders["vertexPath"] : "";
-	const std::string fragPath = shaders.contains("fragmentPath") ? shaders["fragmentPath"] : "";
-	const std::string geomPath = shaders.contains("geometryPath") ? shaders["geometryPath"] : "";
-	const std::string tesPath = shaders.contains("tesPath") ? shaders["tesPath"] : "";
-	const std::string tcsPath = shaders.contains("tcsPath") ? shaders["tcsPath"] : "";
-
-	if (!vertPath.empty())
-	{
-		auto data = FileSystem::instance().getBytes(vertPath);
-
-		ShaderStageCreateInfo info = {};
-		ShaderModuleCreateInfo moduleCreateInfo = {};
-		moduleCreateInfo.flags = 0;
-		moduleCreateInfo.code = data;
-
-		info.flags = 0;
-		info.module = GraphicsFactory::instance().createShaderModule();
-		info.module->construct(moduleCreateInfo);
-		info.stage = SHADER_STAGE_VERTEX;
-		info.name = "main";
-
-		IShaderStage* stage = GraphicsFactory::instance().createShaderStage();
-		stage->construct(info);
+	const std::pair<EShaderStageFlagBits, const char*> stageKeys[] = {
+		{ SHADER_STAGE_VERTEX, "vertexPath" },
+		{ SHADER_STAGE_FRAGMENT, "fragmentPath" },
+		{ SHADER_STAGE_GEOMETRY, "geometryPath" },
+		{ SHADER_STAGE_TESSELLATION_CONTROL, "tcsPath" },
+		{ SHADER_STAGE_TESSELLATION_EVALUATION, "tesPath" }
+	};
 
-		mGraphicsPipelineCreateInfo.stages.push_back(stage);
-	}
+	std::vector<AssetDependency> dependencies;
+	mStages.clear();
 
-	if (!fragPath.empty())
+	// Modules are keyed by their SPIR-V path, so effects sharing a stage load it once
+	for (const auto& stageKey : stageKeys)
 	{
-		auto data = FileSystem::instance().getBytes(fragPath);
+		if (!shaders.contains(stageKey.second))
+			continue;
 
-		ShaderStageCreateInfo info = {};
-		ShaderModuleCreateInfo moduleCreateInfo = {};
-		moduleCreateInfo.flags = 0;
-		moduleCreateInfo.code = data;
+		const std::string path = shaders[stageKey.second];
+		if (path.empty())
+			continue;
 
-		info.flags = 0;
-		info.module = GraphicsFactory::instance().createShaderModule();
-		info.module->construct(moduleCreateInfo);
-		info.stage = SHADER_STAGE_FRAGMENT;
-		info.name = "main";
-
-		IShaderStage* stage = GraphicsFactory::instance().createShaderStage();
-		stage->construct(info);
-
-		mGraphicsPipelineCreateInfo.stages.push_back(stage);
+		mStages.emplace_back(stageKey.first, path);
+		dependencies.push_back(AssetDependency::of<ShaderModuleAsset>(path, path));
 	}
 
-	if (!geomPath.empty())
-	{
-		auto data = FileSystem::instance().getBytes(geomPath);
-
-		ShaderStageCreateInfo info = {};
-		ShaderModuleCreateInfo moduleCreateInfo = {};
-		moduleCreateInfo.flags = 0;
-		moduleCreateInfo.code = data;
-
-		info.flags = 0;
-		info.module = GraphicsFactory::instance().createShaderModule();
-		info.module->construct(moduleCreateInfo);
-		info.stage = SHADER_STAGE_GEOMETRY;
-		info.name = "main";
-
-		IShaderStage* stage = GraphicsFactory::instance().createShaderStage();
-		stage->construct(info);
-
-		mGraphicsPipelineCreateInfo.stages.push_back(stage);
-	}
-
-	if (!tcsPath.empty())
-	{
-		auto data = FileSystem::instance().getBytes(tcsPath);
-
-		ShaderStageCreateInfo info = {};
-		ShaderModuleCreateInfo moduleCreateInfo = {};
-		moduleCreateInfo.flags = 0;
-		moduleCreateInfo.code = data;
-
-		info.flags = 0;
-		info.module = GraphicsFactory::instance().createShaderModule();
-		info.module->construct(moduleCreateInfo);
-		info.stage = SHADER_STAGE_TESSELLATION_CONTROL;
-		info.name = "main";
+	return dependencies;
+}
 
-		IShaderStage* stage = GraphicsFactory::instance().createShaderStage();
-		stage->construct(info);
+std::vector<std::string> ShaderAsset::_gatherSources() const
+{
+	return { mPath };
+}
 
-		mGraphicsPipelineCreateInfo.stages.push_back(stage);
-	}
+void ShaderAsset::_load()
+{
+	const auto jsonValue = nlohmann::json::parse(mDescriptor);
+	mDescriptor.clear();
 
-	if (!tesPath.empty())
+	for (const auto& stagePath : mStages)
 	{
-		auto data = FileSystem::instance().getBytes(tesPath);
+		const auto module = AssetManager::instance().get<ShaderModuleAsset>(stagePath.second);
+		PRIMAL_ASSERT(module != nullptr, "Shader module was not loaded.");
 
 		ShaderStageCreateInfo info = {};
-		ShaderModuleCreateInfo moduleCreateInfo = {};
-		moduleCreateInfo.flags = 0;
-		moduleCreateInfo.code = data;
-
 		info.flags = 0;
-		info.module = GraphicsFactory::instance().createShaderModule();
-		info.module->construct(moduleCreateInfo);
-		info.stage = SHADER_STAGE_TESSELLATION_EVALUATION;
+		info.module = module->getModule();
+		info.stage = stagePath.first;
 		info.name = "main";
 
 		IShaderStage* stage = GraphicsFactory::instance().createShaderStage();
@@ -434,9 +379,9 @@ void ShaderAsset::_load()
 	mPipeline = GraphicsFactory::instance().createGraphicsPipeline();
 	mPipeline->construct(mGraphicsPipelineCreateInfo);
 
+	// Modules stay with their ShaderModuleAsset, only the stages belong to this pipeline
 	for (const auto & stage : mGraphicsPipelineCreateInfo.stages)
 	{
-		delete stage->getModule();
 		delete stage;
 	}
 	mGraphicsPipelineCreateInfo.stages.clear();
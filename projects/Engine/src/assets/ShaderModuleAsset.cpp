@@ -0,0 +1,42 @@
+#include "assets/ShaderModuleAsset.h"
+#include "core/Log.h"
+#include "filesystem/FileSystem.h"
+#include "graphics/GraphicsFactory.h"
+
+ShaderModuleAsset::ShaderModuleAsset(const std::string& aPath)
+	: mPath(aPath)
+{
+}
+
+ShaderModuleAsset::~ShaderModuleAsset()
+{
+	delete mModule;
+}
+
+IShaderModule* ShaderModuleAsset::getModule() const
+{
+	return mModule;
+}
+
+std::vector<AssetFileRead> ShaderModuleAsset::_gatherReads()
+{
+	return { { mPath, &mCode } };
+}
+
+void ShaderModuleAsset::_load()
+{
+	if (!mCode.isValid())
+	{
+		PRIMAL_INTERNAL_ERROR("Shader module does not exist: {0}", mPath);
+		return;
+	}
+
+	ShaderModuleCreateInfo moduleCreateInfo = {};
+	moduleCreateInfo.flags = 0;
+	moduleCreateInfo.code.assign(mCode.data(), mCode.data() + mCode.size());
+
+	mCode = FileView();
+
+	mModule = GraphicsFactory::instance().createShaderModule();
+	mModule->construct(moduleCreateInfo);
+}
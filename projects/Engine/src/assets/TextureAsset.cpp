@@ -5,12 +5,125 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 #include "core/Log.h"
+#include "core/PrimalAssert.h"
 #include <json/json.hpp>
 #include "assets/SamplerAsset.h"
 #include "graphics/vk/VulkanTexture.h"
 #include "graphics/GraphicsFactory.h"
+#include "assets/DerivedDataCache.h"
+#include "assets/TextureFormat.h"
+#include "graphics/MaterialManager.h"
+#include "utils/StringUtils.h"
+
+#include <memory>
+
+namespace detail
+{
+	// Bump whenever cooking produces different levels, so stale cache entries are never used
+	static constexpr uint32_t sImporterVersion = 2;
+
+	static uint64_t sAlignLevel(const uint64_t aOffset)
+	{
+		return (aOffset + ptexLevelAlignment - 1) / ptexLevelAlignment * ptexLevelAlignment;
+	}
+
+	static ETextureCompression sParseCompression(const std::string& aName)
+	{
+		if (aName == "bc1") return ETextureCompression::BC1;
+		if (aName == "bc3") return ETextureCompression::BC3;
+		if (aName == "bc5") return ETextureCompression::BC5;
+		if (aName == "bc7") return ETextureCompression::BC7;
+
+		if (aName != "none")
+		{
+			PRIMAL_INTERNAL_WARN("Unknown texture compression {0}, storing uncompressed.", aName);
+		}
+
+		return ETextureCompression::NONE;
+	}
+
+	static EMipFilter sParseMipFilter(const std::string& aName)
+	{
+		if (aName == "kaiser") return EMipFilter::KAISER;
+
+		if (aName != "box")
+		{
+			PRIMAL_INTERNAL_WARN("Unknown mip filter {0}, using a box filter.", aName);
+		}
+
+		return EMipFilter::BOX;
+	}
+
+	// Decodes aEncoded and writes the .ptex layout into aCooked
+	static bool sCookTexture(const FileView& aEncoded, const TextureImportSettings& aSettings,
+		const std::string& aName, std::vector<char>& aCooked)
+	{
+		int x, y, channels;
+		unsigned char* pixels = stbi_load_from_memory(aEncoded.data(), static_cast<int>(aEncoded.size()), &x, &y, &channels, STBI_rgb_alpha);
+		if (pixels == nullptr)
+		{
+			PRIMAL_INTERNAL_ERROR("Could not decode texture file: {0}", aName);
+			return false;
+		}
+
+		const uint32_t width = static_cast<uint32_t>(x);
+		const uint32_t height = static_cast<uint32_t>(y);
+		const bool srgb = aSettings.srgb && aSettings.compression != ETextureCompression::BC5;
+		const EDataFormat format = TextureCompressor::getFormat(aSettings.compression, srgb);
+		const uint32_t levelCount = aSettings.mips ? TextureCompressor::getLevelCount(width, height) : 1;
+
+		PTexHeader header = {};
+		header.magic = ptexMagic;
+		header.version = ptexVersion;
+		header.format = static_cast<uint32_t>(format);
+		header.width = width;
+		header.height = height;
+		header.levelCount = levelCount;
+
+		std::vector<PTexLevel> levels(levelCount);
+		uint64_t offset = sizeof(PTexHeader) + sizeof(PTexLevel) * levelCount;
+
+		for (uint32_t level = 0; level < levelCount; level++)
+		{
+			offset = sAlignLevel(offset);
+
+			levels[level].offset = offset;
+			levels[level].bytes = TextureCompressor::getLevelSize(format, std::max(width >> level, 1u), std::max(height >> level, 1u));
+
+			offset += levels[level].bytes;
+		}
+
+		aCooked.assign(offset, 0);
+		memcpy(aCooked.data(), &header, sizeof(header));
+		memcpy(aCooked.data() + sizeof(header), levels.data(), sizeof(PTexLevel) * levelCount);
+
+		// Every level is filtered from the one above it before that one is compressed
+		std::vector<uint8_t> current(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		std::vector<uint8_t> next;
+		stbi_image_free(pixels);
+
+		for (uint32_t level = 0; level < levelCount; level++)
+		{
+			const uint32_t levelWidth = std::max(width >> level, 1u);
+			const uint32_t levelHeight = std::max(height >> level, 1u);
+
+			TextureCompressor::compress(current.data(), levelWidth, levelHeight, aSettings.compression,
+				reinterpret_cast<uint8_t*>(aCooked.data() + levels[level].offset));
+
+			if (level + 1 < levelCount)
+			{
+				next.resize(static_cast<size_t>(std::max(levelWidth / 2, 1u)) * std::max(levelHeight / 2, 1u) * 4);
+				TextureCompressor::downsample(current.data(), levelWidth, levelHeight, srgb, aSettings.mipFilter, next.data());
+				current.swap(next);
+			}
+		}
+
+		return true;
+	}
+}
 
 TextureAsset::TextureAsset(const std::string& aPath, const uint32_t aDesiredChannels)
+	: mUploadedBytes(0), mTexture(nullptr), mSampler(nullptr)
 {
 	mPath = aPath;
 	mDesiredChannels = aDesiredChannels;
@@ -19,10 +132,11 @@ TextureAsset::TextureAsset(const std::string& aPath, const uint32_t aDesiredChan
 
 TextureAsset::~TextureAsset()
 {
+	TextureStreamer::instance().remove(this);
 	delete mTexture;
 }
 
-ImageFile TextureAsset::getData() const
+const ImageFile& TextureAsset::getData() const
 {
 	return mFile;
 }
@@ -37,62 +151,267 @@ ISampler* TextureAsset::getSampler() const
 	return mSampler;
 }
 
-void TextureAsset::_load()
+std::vector<AssetDependency> TextureAsset::_gatherDependencies()
 {
-	Path loadPath = FileSystem::instance().getMountedDirectory();
-
 	const std::string jsonData = FileSystem::instance().loadToString(mPath);
 	const auto jsonValue = nlohmann::json::parse(jsonData);
 
-	const std::string samplerName = jsonValue["samplername"];
-	auto sampler = AssetManager::instance().load<SamplerAsset>(samplerName, samplerName);
+	mSamplerName = jsonValue["samplername"].get<std::string>();
+	mTextureFile = jsonValue["texturefile"].get<std::string>();
+	mBindingPoint = jsonValue["bindingpoint"];
+	mShaderStage = jsonValue["shaderstage"];
 
-	mSampler = sampler->getSampler();
+	mSettings = {};
+	mSettings.compression = detail::sParseCompression(jsonValue.value("compression", std::string("none")));
+	mSettings.srgb = jsonValue.value("srgb", mSettings.srgb);
+	mSettings.mips = jsonValue.value("mips", mSettings.mips);
+	mSettings.mipFilter = detail::sParseMipFilter(jsonValue.value("mipfilter", std::string("box")));
+	mStreamed = jsonValue.value("streamed", true);
 
-	uint32_t bindingPoint = jsonValue["bindingpoint"];
-	uint32_t shaderStage = jsonValue["shaderstage"];
+	return { AssetDependency::of<SamplerAsset>(mSamplerName, mSamplerName) };
+}
+
+std::vector<AssetFileRead> TextureAsset::_gatherReads()
+{
+	return { { mTextureFile, &mEncoded } };
+}
+
+size_t TextureAsset::getMemoryUsage() const
+{
+	// The cooked levels stay mapped next to the uploaded copy of the resident ones
+	return mCooked.size() + mUploadedBytes.load(std::memory_order_relaxed);
+}
+
+uint32_t TextureAsset::getLevelCount() const
+{
+	return mHeader != nullptr ? mHeader->levelCount : 0;
+}
+
+uint32_t TextureAsset::getLevelWidth(const uint32_t aLevel) const
+{
+	return std::max(mHeader->width >> aLevel, 1u);
+}
 
-	// TODO: Cache texture file as image asset
-	const std::string textureFileName = jsonValue["texturefile"];
-	loadPath += textureFileName;
+uint32_t TextureAsset::getLevelHeight(const uint32_t aLevel) const
+{
+	return std::max(mHeader->height >> aLevel, 1u);
+}
 
-	int x, y, channels;
-	auto widePath = loadPath.native();
+size_t TextureAsset::getLevelSize(const uint32_t aLevel) const
+{
+	return static_cast<size_t>(mLevels[aLevel].bytes);
+}
 
-	std::vector<char> convertedPath;
-	convertedPath.reserve(widePath.size());
+uint32_t TextureAsset::getResidentLevel() const
+{
+	return mResidentLevel;
+}
 
-	std::string s;
+bool TextureAsset::setResidentLevel(const uint32_t aLevel)
+{
+	if (mTexture == nullptr || aLevel >= getLevelCount())
+	{
+		return false;
+	}
 
-	for (const auto& c : widePath)
+	if (aLevel == mResidentLevel)
 	{
-		if (c > 255)
+		return true;
+	}
+
+	_selectLevels(aLevel);
+	mResidentLevel = aLevel;
+
+	mTexture->reconstruct(_getCreateInfo());
+	mUploadedBytes.store(mFile.size, std::memory_order_relaxed);
+
+	MaterialManager::instance().markTextureDirty(mTexture);
+
+	return true;
+}
+
+std::vector<std::string> TextureAsset::_gatherSources() const
+{
+	return { mPath };
+}
+
+void TextureAsset::_load()
+{
+	const auto sampler = AssetManager::instance().get<SamplerAsset>(mSamplerName);
+	PRIMAL_ASSERT(sampler != nullptr, "Texture sampler was not loaded.");
+
+	mSampler = sampler->getSampler();
+
+	if (mDesiredChannels != STBI_rgb_alpha)
+	{
+		PRIMAL_INTERNAL_ERROR("Textures are uploaded as RGBA, {0} channels are not supported: {1}", mDesiredChannels, mPath);
+		return;
+	}
+
+	const FileView file = std::move(mEncoded);
+	if (!file.isValid())
+	{
+		PRIMAL_INTERNAL_ERROR("Texture file does not exist: {0}", mTextureFile);
+		return;
+	}
+
+	if (StringUtils::endsWith(mTextureFile, ".ptex"))
+	{
+		mCooked = file;
+	}
+	else
+	{
+		// Imports are stored in the cooked layout, so a cache hit loads exactly like a .ptex
+		DerivedDataKey key("texture", detail::sImporterVersion);
+		key.add(file).add(static_cast<uint32_t>(mSettings.compression)).add(mSettings.srgb ? 1u : 0u)
+			.add(mSettings.mips ? 1u : 0u).add(static_cast<uint32_t>(mSettings.mipFilter));
+
+		if (!DerivedDataCache::instance().get(key, mCooked))
 		{
-			PRIMAL_INTERNAL_ERROR("Invalid character code in path.");
-			return;
+			auto cooked = std::make_shared<std::vector<char>>();
+			if (!detail::sCookTexture(file, mSettings, mTextureFile, *cooked))
+			{
+				return;
+			}
+
+			DerivedDataCache::instance().put(key, cooked->data(), cooked->size());
+
+			const uint8_t* data = reinterpret_cast<const uint8_t*>(cooked->data());
+			const size_t size = cooked->size();
+
+			mCooked = FileView(data, size, std::move(cooked));
 		}
-		convertedPath.push_back(static_cast<char>(c));
-		s += static_cast<char>(c);
 	}
 
-	unsigned char* payload = stbi_load(s.c_str(), &x, &y, &channels, mDesiredChannels);
-	std::vector<unsigned char> results;
-	results.resize(static_cast<size_t>(x) * static_cast<size_t>(y) * mDesiredChannels);
-	memcpy(results.data(), payload, results.size());
-	stbi_image_free(payload);
+	if (!_loadCooked())
+	{
+		return;
+	}
+
+	// Streamed textures start with their smallest levels only, the streamer brings in the rest on request
+	mResidentLevel = mStreamed ? TextureStreamer::getMinResidentLevel(*this) : 0;
+	_selectLevels(mResidentLevel);
+
+	mTexture = GraphicsFactory::instance().createTexture();
+	mTexture->construct(_getCreateInfo());
+	mUploadedBytes.store(mFile.size, std::memory_order_relaxed);
 
-	mFile.payload = results;
-	mFile.bitsPerPixel = 8;
-	mFile.channels = mDesiredChannels;
-	mFile.width = x;
-	mFile.height = y;
+	if (mResidentLevel > 0)
+	{
+		TextureStreamer::instance().add(this, mTexture);
+	}
+}
 
+TextureCreateInfo TextureAsset::_getCreateInfo()
+{
 	TextureCreateInfo textureCreateInfo = {};
 	textureCreateInfo.sampler = mSampler;
 	textureCreateInfo.textureAsset = this;
-	textureCreateInfo.binding = bindingPoint;
-	textureCreateInfo.shaderStageAccess = shaderStage;
+	textureCreateInfo.binding = mBindingPoint;
+	textureCreateInfo.shaderStageAccess = mShaderStage;
 
-	mTexture = GraphicsFactory::instance().createTexture();
-	mTexture->construct(textureCreateInfo);
+	return textureCreateInfo;
+}
+
+bool TextureAsset::_loadCooked()
+{
+	const uint8_t* base = mCooked.data();
+	const size_t size = mCooked.size();
+
+	if (size < sizeof(PTexHeader))
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked texture is truncated: {0}", mTextureFile);
+		return false;
+	}
+
+	const PTexHeader* header = reinterpret_cast<const PTexHeader*>(base);
+
+	if (header->magic != ptexMagic || header->version != ptexVersion)
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked texture has an unknown format, recook it: {0}", mTextureFile);
+		return false;
+	}
+
+	const EDataFormat format = static_cast<EDataFormat>(header->format);
+
+	if (header->width == 0 || header->height == 0 || header->levelCount == 0 ||
+		header->levelCount > TextureCompressor::getLevelCount(header->width, header->height) ||
+		TextureCompressor::getLevelSize(format, header->width, header->height) == 0)
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked texture has an unsupported layout: {0}", mTextureFile);
+		return false;
+	}
+
+	if (sizeof(PTexHeader) + sizeof(PTexLevel) * header->levelCount > size)
+	{
+		PRIMAL_INTERNAL_ERROR("Cooked texture is truncated: {0}", mTextureFile);
+		return false;
+	}
+
+	const PTexLevel* levels = reinterpret_cast<const PTexLevel*>(base + sizeof(PTexHeader));
+
+	for (uint32_t level = 0; level < header->levelCount; level++)
+	{
+		const size_t expected = TextureCompressor::getLevelSize(format, std::max(header->width >> level, 1u), std::max(header->height >> level, 1u));
+
+		if (levels[level].offset % ptexLevelAlignment != 0 || levels[level].bytes != expected ||
+			(level > 0 && levels[level].offset < levels[level - 1].offset + levels[level - 1].bytes) ||
+			levels[level].offset + levels[level].bytes > size)
+		{
+			PRIMAL_INTERNAL_ERROR("Cooked texture level {0} is out of range: {1}", level, mTextureFile);
+			return false;
+		}
+	}
+
+	mHeader = header;
+	mLevels = levels;
+
+	return true;
+}
+
+void TextureAsset::_selectLevels(const uint32_t aFirstLevel)
+{
+	const PTexLevel& first = mLevels[aFirstLevel];
+	const PTexLevel& last = mLevels[mHeader->levelCount - 1];
+
+	mFile.payload = mCooked.data() + first.offset;
+	mFile.size = static_cast<size_t>(last.offset + last.bytes - first.offset);
+	mFile.format = static_cast<EDataFormat>(mHeader->format);
+	mFile.width = getLevelWidth(aFirstLevel);
+	mFile.height = getLevelHeight(aFirstLevel);
+
+	mFile.levelOffsets.clear();
+	for (uint32_t level = aFirstLevel; level < mHeader->levelCount; level++)
+	{
+		mFile.levelOffsets.push_back(mLevels[level].offset - first.offset);
+	}
+}
+
+bool TextureAsset::cook(const std::string& aSource, const std::string& aDestination, const TextureImportSettings& aSettings)
+{
+	const FileView source = FileSystem::instance().view(aSource);
+	if (!source.isValid())
+	{
+		PRIMAL_INTERNAL_ERROR("Texture file does not exist: {0}", aSource);
+		return false;
+	}
+
+	std::vector<char> cooked;
+	if (!detail::sCookTexture(source, aSettings, aSource, cooked))
+	{
+		return false;
+	}
+
+	// The streamer keeps the previous file mapped
+	if (!FileSystem::instance().replace(aDestination, cooked.data(), cooked.size()))
+	{
+		PRIMAL_INTERNAL_ERROR("Could not write cooked texture: {0}", aDestination);
+		return false;
+	}
+
+	const PTexHeader* header = reinterpret_cast<const PTexHeader*>(cooked.data());
+	PRIMAL_INTERNAL_INFO("Cooked {0} into {1} ({2}x{3}, {4} levels, {5} bytes)", aSource, aDestination,
+		header->width, header->height, header->levelCount, cooked.size());
+
+	return true;
 }
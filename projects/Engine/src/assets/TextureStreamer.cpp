@@ -0,0 +1,311 @@
+#include "assets/TextureStreamer.h"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace detail
+{
+	static uint32_t sLevelExtent(const IStreamableTexture& aTexture, const uint32_t aLevel)
+	{
+		return std::max(aTexture.getLevelWidth(aLevel), aTexture.getLevelHeight(aLevel));
+	}
+
+	// How far a texture at aLevel falls short of the requested size, above 1 when it is undersampled
+	static float sUndersampling(const IStreamableTexture& aTexture, const uint32_t aLevel, const float aScreenSize)
+	{
+		return aScreenSize / static_cast<float>(sLevelExtent(aTexture, aLevel));
+	}
+}
+
+TextureStreamer& TextureStreamer::instance()
+{
+	static TextureStreamer streamer;
+	return streamer;
+}
+
+void TextureStreamer::add(IStreamableTexture* aTexture, const ITexture* aHandle)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	Entry& entry = mEntries[aTexture];
+	entry = {};
+	entry.texture = aTexture;
+	entry.handle = aHandle;
+	entry.targetLevel = aTexture->getResidentLevel();
+
+	if (aHandle != nullptr)
+	{
+		mHandles[aHandle] = aTexture;
+	}
+}
+
+void TextureStreamer::remove(IStreamableTexture* aTexture)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	const auto entry = mEntries.find(aTexture);
+	if (entry == mEntries.end())
+	{
+		return;
+	}
+
+	if (entry->second.handle != nullptr)
+	{
+		mHandles.erase(entry->second.handle);
+	}
+
+	mEntries.erase(entry);
+}
+
+void TextureStreamer::setBudget(const size_t aBytes)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBudget = aBytes;
+}
+
+size_t TextureStreamer::getBudget() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBudget;
+}
+
+void TextureStreamer::setMaxUploadPerUpdate(const size_t aBytes)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mMaxUpload = aBytes;
+}
+
+size_t TextureStreamer::getMaxUploadPerUpdate() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mMaxUpload;
+}
+
+void TextureStreamer::request(IStreamableTexture* aTexture, const float aScreenSize)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	const auto entry = mEntries.find(aTexture);
+	if (entry != mEntries.end())
+	{
+		entry->second.pendingSize = std::max(entry->second.pendingSize, aScreenSize);
+	}
+}
+
+void TextureStreamer::request(const ITexture* aHandle, const float aScreenSize)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	const auto handle = mHandles.find(aHandle);
+	if (handle == mHandles.end())
+	{
+		return;
+	}
+
+	Entry& entry = mEntries[handle->second];
+	entry.pendingSize = std::max(entry.pendingSize, aScreenSize);
+}
+
+void TextureStreamer::update()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	std::vector<Entry*> entries;
+	entries.reserve(mEntries.size());
+
+	for (auto& pair : mEntries)
+	{
+		Entry& entry = pair.second;
+
+		if (entry.pendingSize >= entry.screenSize || entry.requestAge >= sRequestLifetime)
+		{
+			entry.screenSize = entry.pendingSize;
+			entry.requestAge = 0;
+		}
+		else
+		{
+			entry.requestAge++;
+		}
+
+		entry.pendingSize = 0.0f;
+		entries.push_back(&entry);
+	}
+
+	size_t requestedBytes = 0;
+	_assignTargets(entries, requestedBytes);
+
+	// Drops first, so their memory is free before anything streams in
+	std::vector<Entry*> streaming;
+
+	for (Entry* entry : entries)
+	{
+		const uint32_t resident = entry->texture->getResidentLevel();
+
+		if (entry->targetLevel > resident)
+		{
+			const size_t dropped = _getBytesFrom(*entry->texture, resident) - _getBytesFrom(*entry->texture, entry->targetLevel);
+			if (entry->texture->setResidentLevel(entry->targetLevel))
+			{
+				mStats.droppedBytes += dropped;
+			}
+		}
+		else if (entry->targetLevel < resident)
+		{
+			streaming.push_back(entry);
+		}
+	}
+
+	std::sort(streaming.begin(), streaming.end(), [](const Entry* aLeft, const Entry* aRight)
+	{
+		return detail::sUndersampling(*aLeft->texture, aLeft->texture->getResidentLevel(), aLeft->screenSize) >
+			detail::sUndersampling(*aRight->texture, aRight->texture->getResidentLevel(), aRight->screenSize);
+	});
+
+	size_t uploaded = 0;
+
+	for (Entry* entry : streaming)
+	{
+		const uint32_t resident = entry->texture->getResidentLevel();
+		const size_t bytes = _getBytesFrom(*entry->texture, entry->targetLevel) - _getBytesFrom(*entry->texture, resident);
+
+		if (mMaxUpload != 0 && uploaded != 0 && uploaded + bytes > mMaxUpload)
+		{
+			continue;
+		}
+
+		if (entry->texture->setResidentLevel(entry->targetLevel))
+		{
+			uploaded += bytes;
+			mStats.streamedBytes += bytes;
+		}
+	}
+
+	mStats.budget = mBudget;
+	mStats.requestedBytes = requestedBytes;
+	mStats.textureCount = static_cast<uint32_t>(entries.size());
+	mStats.residentBytes = 0;
+	mStats.pendingLevels = 0;
+
+	for (const Entry* entry : entries)
+	{
+		const uint32_t resident = entry->texture->getResidentLevel();
+
+		mStats.residentBytes += _getBytesFrom(*entry->texture, resident);
+		mStats.pendingLevels += resident > entry->targetLevel ? resident - entry->targetLevel : 0;
+	}
+}
+
+TextureStreamingStats TextureStreamer::getStats() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+uint32_t TextureStreamer::getTargetLevel(IStreamableTexture* aTexture) const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	const auto entry = mEntries.find(aTexture);
+	return entry != mEntries.end() ? entry->second.targetLevel : aTexture->getResidentLevel();
+}
+
+uint32_t TextureStreamer::getWantedLevel(const IStreamableTexture& aTexture, const float aScreenSize)
+{
+	const uint32_t minResident = getMinResidentLevel(aTexture);
+
+	uint32_t level = 0;
+	while (level < minResident && static_cast<float>(detail::sLevelExtent(aTexture, level + 1)) >= aScreenSize)
+	{
+		level++;
+	}
+
+	return level;
+}
+
+uint32_t TextureStreamer::getMinResidentLevel(const IStreamableTexture& aTexture)
+{
+	const uint32_t levelCount = aTexture.getLevelCount();
+
+	for (uint32_t level = 0; level < levelCount; level++)
+	{
+		if (detail::sLevelExtent(aTexture, level) <= sMinResidentSize)
+		{
+			return level;
+		}
+	}
+
+	return levelCount - 1;
+}
+
+size_t TextureStreamer::_getBytesFrom(const IStreamableTexture& aTexture, const uint32_t aLevel)
+{
+	size_t bytes = 0;
+
+	for (uint32_t level = aLevel; level < aTexture.getLevelCount(); level++)
+	{
+		bytes += aTexture.getLevelSize(level);
+	}
+
+	return bytes;
+}
+
+size_t TextureStreamer::_assignTargets(const std::vector<Entry*>& aEntries, size_t& aRequestedBytes) const
+{
+	size_t total = 0;
+	aRequestedBytes = 0;
+
+	using Candidate = std::pair<float, Entry*>;
+	std::priority_queue<Candidate> candidates;
+
+	for (Entry* entry : aEntries)
+	{
+		const uint32_t wanted = getWantedLevel(*entry->texture, entry->screenSize);
+		const uint32_t minResident = getMinResidentLevel(*entry->texture);
+
+		aRequestedBytes += _getBytesFrom(*entry->texture, wanted);
+
+		if (mBudget == 0)
+		{
+			entry->targetLevel = wanted;
+			continue;
+		}
+
+		entry->targetLevel = minResident;
+		total += _getBytesFrom(*entry->texture, minResident);
+
+		if (wanted < minResident)
+		{
+			candidates.push({ detail::sUndersampling(*entry->texture, minResident, entry->screenSize), entry });
+		}
+	}
+
+	if (mBudget == 0)
+	{
+		return aRequestedBytes;
+	}
+
+	// Every finer level costs about four times the previous one, so a texture that cannot afford its next
+	// level is done
+	while (!candidates.empty())
+	{
+		Entry* entry = candidates.top().second;
+		candidates.pop();
+
+		const size_t cost = entry->texture->getLevelSize(entry->targetLevel - 1);
+		if (total + cost > mBudget)
+		{
+			continue;
+		}
+
+		entry->targetLevel--;
+		total += cost;
+
+		if (entry->targetLevel > getWantedLevel(*entry->texture, entry->screenSize))
+		{
+			candidates.push({ detail::sUndersampling(*entry->texture, entry->targetLevel, entry->screenSize), entry });
+		}
+	}
+
+	return total;
+}
@@ -0,0 +1,283 @@
+#include "assets/TextureStreamingSimulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+
+#include "core/Log.h"
+#include "graphics/TextureCompressor.h"
+
+class TextureStreamingSimulation::SimulatedTexture final : public IStreamableTexture
+{
+	public:
+		SimulatedTexture(const uint32_t aSize, const EDataFormat aFormat)
+			: mSize(aSize), mFormat(aFormat), mLevelCount(TextureCompressor::getLevelCount(aSize, aSize)), mResidentLevel(0)
+		{
+			mResidentLevel = TextureStreamer::getMinResidentLevel(*this);
+		}
+
+		uint32_t getLevelCount() const override
+		{
+			return mLevelCount;
+		}
+
+		uint32_t getLevelWidth(const uint32_t aLevel) const override
+		{
+			return std::max(mSize >> aLevel, 1u);
+		}
+
+		uint32_t getLevelHeight(const uint32_t aLevel) const override
+		{
+			return getLevelWidth(aLevel);
+		}
+
+		size_t getLevelSize(const uint32_t aLevel) const override
+		{
+			return TextureCompressor::getLevelSize(mFormat, getLevelWidth(aLevel), getLevelHeight(aLevel));
+		}
+
+		uint32_t getResidentLevel() const override
+		{
+			return mResidentLevel;
+		}
+
+		bool setResidentLevel(const uint32_t aLevel) override
+		{
+			mResidentLevel = std::min(aLevel, mLevelCount - 1);
+			return true;
+		}
+
+	private:
+		uint32_t mSize;
+		EDataFormat mFormat;
+		uint32_t mLevelCount;
+		uint32_t mResidentLevel;
+};
+
+TextureStreamingSimulation::TextureStreamingSimulation(const TextureStreamingSimulationInfo& aInfo)
+	: mInfo(aInfo)
+{
+	std::mt19937 random(mInfo.seed);
+	std::uniform_real_distribution<float> position(-mInfo.sceneExtent * 0.5f, mInfo.sceneExtent * 0.5f);
+	std::uniform_real_distribution<float> radius(mInfo.minObjectRadius, mInfo.maxObjectRadius);
+	std::uniform_int_distribution<uint32_t> sizeShift(0, 2);
+
+	mTextures.reserve(mInfo.objectCount);
+	mObjects.reserve(mInfo.objectCount);
+
+	for (uint32_t i = 0; i < mInfo.objectCount; i++)
+	{
+		// A mix of full, half and quarter size textures, like a real scene's
+		const uint32_t size = std::max(mInfo.textureSize >> sizeShift(random), 1u);
+		mTextures.push_back(std::make_unique<SimulatedTexture>(size, mInfo.textureFormat));
+
+		Object object;
+		object.radius = radius(random);
+		object.center = Vector3f(position(random), object.radius, position(random));
+		object.texture = mTextures.back().get();
+
+		mObjects.push_back(object);
+	}
+}
+
+TextureStreamingSimulation::~TextureStreamingSimulation()
+{
+	for (auto& texture : mTextures)
+	{
+		mStreamer.remove(texture.get());
+	}
+}
+
+void TextureStreamingSimulation::addKeyframe(const float aTime, const Vector3f& aPosition, const Vector3f& aTarget)
+{
+	mKeyframes.push_back({ aTime, aPosition, aTarget });
+}
+
+const std::vector<TextureStreamingSample>& TextureStreamingSimulation::run()
+{
+	if (mKeyframes.empty())
+	{
+		_addDefaultPath();
+	}
+
+	mStreamer.setBudget(mInfo.budget);
+	mStreamer.setMaxUploadPerUpdate(mInfo.maxUploadPerUpdate);
+
+	for (auto& texture : mTextures)
+	{
+		texture->setResidentLevel(TextureStreamer::getMinResidentLevel(*texture));
+		mStreamer.add(texture.get());
+	}
+
+	mSamples.clear();
+
+	const float duration = mKeyframes.back().time;
+	const uint32_t stepCount = static_cast<uint32_t>(std::ceil(duration / mInfo.timeStep)) + 1;
+	mSamples.reserve(stepCount);
+
+	size_t peakResident = 0;
+	size_t peakRequested = 0;
+	uint32_t overBudgetSteps = 0;
+	uint32_t starvedSteps = 0;
+	double coverage = 0.0;
+
+	const TextureStreamingStats initial = mStreamer.getStats();
+
+	for (uint32_t step = 0; step < stepCount; step++)
+	{
+		const float time = std::min(static_cast<float>(step) * mInfo.timeStep, duration);
+
+		Vector3f position;
+		Vector3f forward;
+		_sampleCamera(time, position, forward);
+
+		const uint32_t visible = _requestVisible(position, forward);
+		mStreamer.update();
+
+		const TextureStreamingStats stats = mStreamer.getStats();
+
+		TextureStreamingSample sample;
+		sample.time = time;
+		sample.budget = stats.budget;
+		sample.residentBytes = stats.residentBytes;
+		sample.requestedBytes = stats.requestedBytes;
+		sample.visibleObjects = visible;
+		sample.pendingLevels = stats.pendingLevels;
+		sample.streamedBytes = stats.streamedBytes - initial.streamedBytes;
+		sample.droppedBytes = stats.droppedBytes - initial.droppedBytes;
+		mSamples.push_back(sample);
+
+		peakResident = std::max(peakResident, sample.residentBytes);
+		peakRequested = std::max(peakRequested, sample.requestedBytes);
+		overBudgetSteps += sample.budget != 0 && sample.residentBytes > sample.budget ? 1 : 0;
+		starvedSteps += sample.pendingLevels > 0 ? 1 : 0;
+
+		// Resident bytes beyond what is requested are levels waiting out sRequestLifetime, not coverage
+		coverage += sample.requestedBytes > 0 ? static_cast<double>(std::min(sample.residentBytes, sample.requestedBytes)) /
+			static_cast<double>(sample.requestedBytes) : 1.0;
+	}
+
+	const TextureStreamingSample& last = mSamples.back();
+
+	PRIMAL_INTERNAL_INFO("Texture streaming simulation: {0} textures, {1} steps over {2:.1f}s, budget {3} bytes",
+		mTextures.size(), mSamples.size(), duration, mInfo.budget);
+	PRIMAL_INTERNAL_INFO("  peak resident {0} bytes, peak requested {1} bytes, mean coverage {2:.1f}%",
+		peakResident, peakRequested, 100.0 * coverage / static_cast<double>(mSamples.size()));
+	PRIMAL_INTERNAL_INFO("  streamed {0} bytes, dropped {1} bytes, {2} steps with levels pending, {3} steps over budget",
+		last.streamedBytes, last.droppedBytes, starvedSteps, overBudgetSteps);
+
+	for (auto& texture : mTextures)
+	{
+		mStreamer.remove(texture.get());
+	}
+
+	return mSamples;
+}
+
+const std::vector<TextureStreamingSample>& TextureStreamingSimulation::getSamples() const
+{
+	return mSamples;
+}
+
+bool TextureStreamingSimulation::writeCsv(const std::string& aPath) const
+{
+	std::ofstream stream(aPath, std::ios::trunc);
+	if (!stream)
+	{
+		PRIMAL_INTERNAL_ERROR("Failed to write texture streaming samples to {0}", aPath);
+		return false;
+	}
+
+	stream << "time,budget,resident,requested,visible,pending_levels,streamed,dropped\n";
+
+	for (const TextureStreamingSample& sample : mSamples)
+	{
+		stream << sample.time << ',' << sample.budget << ',' << sample.residentBytes << ',' << sample.requestedBytes << ','
+			<< sample.visibleObjects << ',' << sample.pendingLevels << ',' << sample.streamedBytes << ',' << sample.droppedBytes << '\n';
+	}
+
+	return static_cast<bool>(stream);
+}
+
+void TextureStreamingSimulation::_addDefaultPath()
+{
+	const float half = mInfo.sceneExtent * 0.5f;
+	const float eye = 4.0f;
+
+	// Low across the scene, a turn, back along the other diagonal, up to an overview and a dive into the middle
+	addKeyframe(0.0f, Vector3f(-half, eye, -half), Vector3f(half, eye, half));
+	addKeyframe(20.0f, Vector3f(half * 0.8f, eye, half * 0.8f), Vector3f(half * 2.0f, eye, half * 2.0f));
+	addKeyframe(24.0f, Vector3f(half * 0.8f, eye, half * 0.8f), Vector3f(half * 0.8f, eye, -half));
+	addKeyframe(40.0f, Vector3f(half * 0.8f, eye, -half * 0.8f), Vector3f(-half, eye, half));
+	addKeyframe(50.0f, Vector3f(0.0f, mInfo.sceneExtent, -half * 0.5f), Vector3f(0.0f, 0.0f, 0.0f));
+	addKeyframe(55.0f, Vector3f(0.0f, mInfo.sceneExtent, -half * 0.5f), Vector3f(0.0f, 0.0f, 0.0f));
+	addKeyframe(60.0f, Vector3f(0.0f, eye * 2.0f, 0.0f), Vector3f(half, 0.0f, half));
+}
+
+void TextureStreamingSimulation::_sampleCamera(const float aTime, Vector3f& aPosition, Vector3f& aForward) const
+{
+	size_t next = 0;
+	while (next < mKeyframes.size() && mKeyframes[next].time < aTime)
+	{
+		next++;
+	}
+
+	Vector3f target;
+
+	if (next == 0 || next == mKeyframes.size())
+	{
+		const Keyframe& keyframe = mKeyframes[next == 0 ? 0 : next - 1];
+		aPosition = keyframe.position;
+		target = keyframe.target;
+	}
+	else
+	{
+		const Keyframe& from = mKeyframes[next - 1];
+		const Keyframe& to = mKeyframes[next];
+		const float blend = (aTime - from.time) / std::max(to.time - from.time, std::numeric_limits<float>::epsilon());
+
+		aPosition = from.position;
+		aPosition.lerp(to.position, blend);
+		target = from.target;
+		target.lerp(to.target, blend);
+	}
+
+	aForward = target - aPosition;
+	aForward.normalize();
+}
+
+uint32_t TextureStreamingSimulation::_requestVisible(const Vector3f& aPosition, const Vector3f& aForward)
+{
+	// The same estimate Mesh::getScreenSize makes, culled against a cone around the horizontal field of view
+	const float tanHalfFov = std::tan(mInfo.verticalFieldOfView * 0.5f);
+	const float pixelsPerUnit = mInfo.viewportHeight * 0.5f / tanHalfFov;
+	const float coneAngle = std::atan(tanHalfFov * mInfo.aspectRatio);
+
+	uint32_t visible = 0;
+
+	for (const Object& object : mObjects)
+	{
+		const Vector3f toCenter = object.center - aPosition;
+		const float distance = toCenter.length();
+
+		if (distance <= object.radius)
+		{
+			mStreamer.request(object.texture, std::numeric_limits<float>::max());
+			visible++;
+			continue;
+		}
+
+		const float angle = std::acos(std::clamp(toCenter.dot(aForward) / distance, -1.0f, 1.0f));
+		if (angle - std::asin(object.radius / distance) > coneAngle)
+		{
+			continue;
+		}
+
+		mStreamer.request(object.texture, 2.0f * object.radius * pixelsPerUnit / (distance - object.radius));
+		visible++;
+	}
+
+	return visible;
+}
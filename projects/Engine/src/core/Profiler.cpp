@@ -0,0 +1,408 @@
+#include "core/Profiler.h"
+
+#ifdef PRIMAL_ENABLE_PROFILING
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+#include "core/Log.h"
+
+namespace detail
+{
+	static thread_local uint32_t sProfileDepth = 0;
+
+	static void sWriteEscaped(std::ofstream& aStream, const char* aText)
+	{
+		for (const char* c = aText; *c != '\0'; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				aStream << '\\';
+			}
+			aStream << *c;
+		}
+	}
+
+	static void sWriteMicros(std::ofstream& aStream, const uint64_t aNanoseconds)
+	{
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(aNanoseconds) / 1000.0);
+		aStream << buffer;
+	}
+}
+
+Profiler& Profiler::instance()
+{
+	static Profiler* instance = new Profiler();
+	return *instance;
+}
+
+Profiler::Profiler()
+	: mCapturing(false)
+{
+	mFrameStart = now();
+}
+
+uint64_t Profiler::now()
+{
+	using Clock = std::chrono::steady_clock;
+	static const Clock::time_point sEpoch = Clock::now();
+
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sEpoch).count());
+}
+
+void Profiler::frameMark()
+{
+	const uint64_t end = now();
+
+	ProfileFrameSummary summary;
+	summary.start = mFrameStart;
+	summary.durationNs = end - mFrameStart;
+
+	std::lock_guard<std::mutex> lock(mFrameMutex);
+
+	summary.frame = mFrameIndex++;
+	_drain(summary);
+
+	if (mCapturing.load(std::memory_order_relaxed))
+	{
+		mCapturedFrames.push_back(end);
+	}
+
+	mHistory.push_back(std::move(summary));
+	while (mHistory.size() > mHistorySize)
+	{
+		mHistory.pop_front();
+	}
+
+	mFrameStart = end;
+}
+
+void Profiler::setThreadName(const char* aName)
+{
+	ThreadBuffer* buffer = _getThreadBuffer();
+
+	std::lock_guard<std::mutex> lock(mThreadsMutex);
+	buffer->name = aName;
+}
+
+void Profiler::beginCapture()
+{
+	std::lock_guard<std::mutex> lock(mFrameMutex);
+
+	mCapture.clear();
+	mCapturedFrames.clear();
+	mCapturing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::endCapture()
+{
+	std::lock_guard<std::mutex> lock(mFrameMutex);
+
+	// Pick up the scopes closed since the last frame marker; they are not part of any frame summary
+	ProfileFrameSummary partial;
+	_drain(partial);
+
+	mCapturing.store(false, std::memory_order_relaxed);
+}
+
+bool Profiler::isCapturing() const
+{
+	return mCapturing.load(std::memory_order_relaxed);
+}
+
+bool Profiler::writeChromeTrace(const std::string& aPath) const
+{
+	std::ofstream stream(aPath, std::ios::out | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		PRIMAL_INTERNAL_ERROR("Failed to open {0} for writing the profiler trace", aPath);
+		return false;
+	}
+
+	stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+	bool first = true;
+	const auto separator = [&stream, &first]()
+	{
+		if (!first)
+		{
+			stream << ",\n";
+		}
+		first = false;
+	};
+
+	{
+		std::lock_guard<std::mutex> lock(mThreadsMutex);
+		for (const auto& thread : mThreads)
+		{
+			separator();
+			stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id << ",\"args\":{\"name\":\"";
+			detail::sWriteEscaped(stream, thread->name.empty() ? "Worker" : thread->name.c_str());
+			stream << "\"}}";
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mFrameMutex);
+
+	for (const CapturedEvent& event : mCapture)
+	{
+		separator();
+		stream << "{\"name\":\"";
+		detail::sWriteEscaped(stream, event.name);
+		stream << "\",\"cat\":\"primal\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":";
+		detail::sWriteMicros(stream, event.start);
+		stream << ",\"dur\":";
+		detail::sWriteMicros(stream, event.end - event.start);
+		stream << "}";
+	}
+
+	for (const uint64_t frame : mCapturedFrames)
+	{
+		separator();
+		stream << "{\"name\":\"Frame\",\"cat\":\"primal\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":";
+		detail::sWriteMicros(stream, frame);
+		stream << "}";
+	}
+
+	stream << "\n]}\n";
+
+	PRIMAL_INTERNAL_INFO("Wrote {0} profiler events to {1}", mCapture.size(), aPath);
+
+	return stream.good();
+}
+
+void Profiler::setHistorySize(const size_t aFrames)
+{
+	std::lock_guard<std::mutex> lock(mFrameMutex);
+
+	mHistorySize = aFrames > 0 ? aFrames : 1;
+	while (mHistory.size() > mHistorySize)
+	{
+		mHistory.pop_front();
+	}
+}
+
+size_t Profiler::getHistorySize() const
+{
+	std::lock_guard<std::mutex> lock(mFrameMutex);
+	return mHistorySize;
+}
+
+ProfileFrameSummary Profiler::getLastFrame() const
+{
+	std::lock_guard<std::mutex> lock(mFrameMutex);
+
+	if (mHistory.empty())
+	{
+		return {};
+	}
+
+	return mHistory.back();
+}
+
+std::vector<ProfileScopeStats> Profiler::getTopScopes(const size_t aCount) const
+{
+	std::unordered_map<std::string_view, ProfileScopeStats> merged;
+	size_t frames = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(mFrameMutex);
+
+		frames = mHistory.size();
+		for (const ProfileFrameSummary& frame : mHistory)
+		{
+			for (const ProfileScopeStats& scope : frame.scopes)
+			{
+				auto it = merged.find(scope.name);
+				if (it == merged.end())
+				{
+					merged.insert({ scope.name, scope });
+				}
+				else
+				{
+					it->second.totalNs += scope.totalNs;
+					it->second.selfNs += scope.selfNs;
+					it->second.calls += scope.calls;
+				}
+			}
+		}
+	}
+
+	std::vector<ProfileScopeStats> result;
+	result.reserve(merged.size());
+
+	for (auto& pair : merged)
+	{
+		ProfileScopeStats stats = pair.second;
+		stats.totalNs /= frames;
+		stats.selfNs /= frames;
+		stats.calls = static_cast<uint32_t>(stats.calls / frames);
+		result.push_back(stats);
+	}
+
+	std::sort(result.begin(), result.end(), [](const ProfileScopeStats& aLeft, const ProfileScopeStats& aRight)
+	{
+		return aLeft.selfNs > aRight.selfNs;
+	});
+
+	if (result.size() > aCount)
+	{
+		result.resize(aCount);
+	}
+
+	return result;
+}
+
+void Profiler::logSummary(const size_t aCount) const
+{
+	uint64_t frameTime = 0;
+	size_t frames = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(mFrameMutex);
+
+		for (const ProfileFrameSummary& frame : mHistory)
+		{
+			frameTime += frame.durationNs;
+		}
+		frames = mHistory.size();
+	}
+
+	if (frames == 0)
+	{
+		return;
+	}
+
+	PRIMAL_INTERNAL_INFO("Profiler: {0:.3f} ms/frame over {1} frames", static_cast<double>(frameTime / frames) / 1e6, frames);
+
+	for (const ProfileScopeStats& scope : getTopScopes(aCount))
+	{
+		PRIMAL_INTERNAL_INFO("  {0:<40} self {1:>8.3f} ms  total {2:>8.3f} ms  calls {3}", scope.name,
+			static_cast<double>(scope.selfNs) / 1e6, static_cast<double>(scope.totalNs) / 1e6, scope.calls);
+	}
+}
+
+uint64_t Profiler::getDroppedEvents() const
+{
+	std::lock_guard<std::mutex> lock(mThreadsMutex);
+
+	uint64_t dropped = 0;
+	for (const auto& thread : mThreads)
+	{
+		dropped += thread->dropped.load(std::memory_order_relaxed);
+	}
+
+	return dropped;
+}
+
+void Profiler::_record(const char* aName, const uint64_t aStart, const uint64_t aEnd, const uint32_t aDepth)
+{
+	ThreadBuffer* buffer = _getThreadBuffer();
+
+	const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	const uint64_t tail = buffer->tail.load(std::memory_order_acquire);
+
+	if (head - tail >= sRingSize)
+	{
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer->events[head & (sRingSize - 1)] = { aName, aStart, aEnd, aDepth };
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+Profiler::ThreadBuffer* Profiler::_getThreadBuffer()
+{
+	static thread_local ThreadBuffer* tBuffer = nullptr;
+
+	if (tBuffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(mThreadsMutex);
+
+		mThreads.push_back(std::make_unique<ThreadBuffer>());
+		tBuffer = mThreads.back().get();
+		tBuffer->id = static_cast<uint32_t>(mThreads.size() - 1);
+	}
+
+	return tBuffer;
+}
+
+void Profiler::_drain(ProfileFrameSummary& aSummary)
+{
+	std::vector<ThreadBuffer*> threads;
+	{
+		std::lock_guard<std::mutex> lock(mThreadsMutex);
+		for (const auto& thread : mThreads)
+		{
+			threads.push_back(thread.get());
+		}
+	}
+
+	const bool capturing = mCapturing.load(std::memory_order_relaxed);
+	std::unordered_map<const char*, size_t> indices;
+
+	for (ThreadBuffer* thread : threads)
+	{
+		const uint64_t tail = thread->tail.load(std::memory_order_relaxed);
+		const uint64_t head = thread->head.load(std::memory_order_acquire);
+
+		// Scopes close children first, so the time of every direct child is known when its parent arrives
+		for (uint64_t i = tail; i != head; ++i)
+		{
+			const ProfileEvent& event = thread->events[i & (sRingSize - 1)];
+			const uint32_t depth = event.depth < sMaxDepth ? event.depth : sMaxDepth - 1;
+			const uint64_t duration = event.end - event.start;
+			const uint64_t children = thread->childTime[depth + 1];
+
+			thread->childTime[depth + 1] = 0;
+			thread->childTime[depth] += duration;
+
+			auto it = indices.find(event.name);
+			if (it == indices.end())
+			{
+				it = indices.insert({ event.name, aSummary.scopes.size() }).first;
+				aSummary.scopes.push_back({ event.name, 0, 0, 0 });
+			}
+
+			ProfileScopeStats& stats = aSummary.scopes[it->second];
+			stats.totalNs += duration;
+			stats.selfNs += duration > children ? duration - children : 0;
+			++stats.calls;
+
+			if (capturing)
+			{
+				mCapture.push_back({ event.name, event.start, event.end, thread->id });
+			}
+		}
+
+		thread->tail.store(head, std::memory_order_release);
+	}
+
+	std::sort(aSummary.scopes.begin(), aSummary.scopes.end(), [](const ProfileScopeStats& aLeft, const ProfileScopeStats& aRight)
+	{
+		return aLeft.totalNs > aRight.totalNs;
+	});
+}
+
+ProfileScope::ProfileScope(const char* aName)
+	: mName(aName)
+{
+	++detail::sProfileDepth;
+	mStart = Profiler::now();
+}
+
+ProfileScope::~ProfileScope()
+{
+	const uint64_t end = Profiler::now();
+	--detail::sProfileDepth;
+
+	Profiler::instance()._record(mName, mStart, end, detail::sProfileDepth);
+}
+
+#endif
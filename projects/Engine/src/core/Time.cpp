@@ -0,0 +1,50 @@
+#include "core/Time.h"
+
+float Time::sDeltaTime = 0.0f;
+float Time::sFixedDeltaTime = 1.0f / 60.0f;
+float Time::sInterpolationAlpha = 0.0f;
+
+double Time::sElapsed = 0.0;
+uint64_t Time::sFrameCount = 0;
+
+float Time::deltaTime()
+{
+	return sDeltaTime;
+}
+
+float Time::fixedDeltaTime()
+{
+	return sFixedDeltaTime;
+}
+
+float Time::interpolationAlpha()
+{
+	return sInterpolationAlpha;
+}
+
+double Time::elapsed()
+{
+	return sElapsed;
+}
+
+uint64_t Time::frameCount()
+{
+	return sFrameCount;
+}
+
+void Time::_advance(const float aDeltaTime)
+{
+	sDeltaTime = aDeltaTime;
+	sElapsed += static_cast<double>(aDeltaTime);
+	++sFrameCount;
+}
+
+void Time::_setFixedDeltaTime(const float aFixedDeltaTime)
+{
+	sFixedDeltaTime = aFixedDeltaTime;
+}
+
+void Time::_setInterpolationAlpha(const float aAlpha)
+{
+	sInterpolationAlpha = aAlpha;
+}
@@ -1,4 +1,5 @@
 #include "ecs/SystemManager.h"
+#include "core/Profiler.h"
 
 SystemManager& SystemManager::instance()
 {
@@ -14,42 +15,58 @@ void SystemManager::configure()
 	}
 }
 
-void SystemManager::update()
+void SystemManager::update(const float aDeltaTime)
 {
+	PRIMAL_PROFILE_SCOPE("SystemManager::update");
+
+	for (const auto& system : mSystems)
+	{
+		system->update(aDeltaTime);
+	}
+
 	for (const auto& system : mSystems)
 	{
-		system->update();
+		system->lateUpdate(aDeltaTime);
 	}
+}
+
+void SystemManager::fixedUpdate(const float aFixedDeltaTime)
+{
+	PRIMAL_PROFILE_SCOPE("SystemManager::fixedUpdate");
 
 	for (const auto& system : mSystems)
 	{
-		system->lateUpdate();
+		system->fixedUpdate(aFixedDeltaTime);
 	}
 }
 
-void SystemManager::fixedUpdate()
+void SystemManager::extract(FramePacket& aPacket)
 {
+	PRIMAL_PROFILE_SCOPE("SystemManager::extract");
+
 	for (const auto& system : mSystems)
 	{
-		system->fixedUpdate();
+		system->extract(aPacket);
 	}
 }
 
-void SystemManager::render()
+void SystemManager::render(const FramePacket& aPacket)
 {
+	PRIMAL_PROFILE_SCOPE("SystemManager::render");
+
 	for (const auto& system : mSystems)
 	{
-		system->preRender();
+		system->preRender(aPacket);
 	}
 
 	for (const auto& system : mSystems)
 	{
-		system->render();
+		system->render(aPacket);
 	}
 
 	for (const auto& system : mSystems)
 	{
-		system->postRender();
+		system->postRender(aPacket);
 	}
 }
 
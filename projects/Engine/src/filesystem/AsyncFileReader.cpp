@@ -0,0 +1,432 @@
+#include "filesystem/AsyncFileReader.h"
+
+#include <algorithm>
+#include <fstream>
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "core/Log.h"
+#include "core/Profiler.h"
+
+namespace detail
+{
+	// Single reads are capped so a huge file cannot monopolize the queue, the rest is resubmitted
+	constexpr size_t sMaxReadChunk = size_t(1) << 24;
+}
+
+AsyncFileReader& AsyncFileReader::instance()
+{
+	static AsyncFileReader* instance = new AsyncFileReader();
+	return *instance;
+}
+
+AsyncFileReader::AsyncFileReader()
+{
+	mPending = 0;
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+	mUseIoUring = mRing.init(sQueueDepth);
+
+	if (mUseIoUring)
+	{
+		mThreads.emplace_back([this] { _completionLoop(); });
+		PRIMAL_INTERNAL_INFO("Async file reads use io_uring ({0} entries)", mRing.getEntries());
+		return;
+	}
+
+	PRIMAL_INTERNAL_WARN("io_uring is unavailable, async file reads fall back to reader threads");
+#endif
+
+	for (uint32_t i = 0; i < sFallbackThreads; ++i)
+	{
+		mThreads.emplace_back([this] { _workerLoop(); });
+	}
+}
+
+bool AsyncFileReader::isUsingIoUring() const
+{
+	return mUseIoUring;
+}
+
+size_t AsyncFileReader::getPendingCount() const
+{
+	return mPending;
+}
+
+void AsyncFileReader::waitIdle()
+{
+	std::unique_lock<std::mutex> lock(mIdleMutex);
+	mIdleCv.wait(lock, [this] { return mPending.load(std::memory_order_acquire) == 0; });
+}
+
+void AsyncFileReader::read(const Path& aPath, AsyncReadCallback aCallback)
+{
+	std::vector<AsyncReadRequest> requests(1);
+	requests[0].path = aPath;
+	requests[0].callback = std::move(aCallback);
+
+	read(std::move(requests));
+}
+
+void AsyncFileReader::read(const Path& aPath, uint8_t* aBuffer, const size_t aCapacity, AsyncReadCallback aCallback)
+{
+	std::vector<AsyncReadRequest> requests(1);
+	requests[0].path = aPath;
+	requests[0].callback = std::move(aCallback);
+	requests[0].buffer = aBuffer;
+	requests[0].capacity = aCapacity;
+
+	read(std::move(requests));
+}
+
+void AsyncFileReader::read(std::vector<AsyncReadRequest> aRequests)
+{
+	if (aRequests.empty())
+		return;
+
+	mPending.fetch_add(aRequests.size(), std::memory_order_relaxed);
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+	if (mUseIoUring)
+	{
+		std::vector<PendingRead*> reads;
+		reads.reserve(aRequests.size());
+
+		// Opening stays synchronous, it is a metadata lookup that is almost always cached
+		for (AsyncReadRequest& request : aRequests)
+		{
+			PendingRead* read = _open(request);
+			if (read != nullptr)
+				reads.push_back(read);
+		}
+
+		if (reads.empty())
+			return;
+
+		std::lock_guard<std::mutex> lock(mSubmitMutex);
+
+		// The completion thread gave up on the ring after these were opened
+		if (!mUseIoUring)
+		{
+			for (PendingRead* read : reads)
+			{
+				_fallBack(read);
+			}
+
+			return;
+		}
+
+		for (PendingRead* read : reads)
+		{
+			if (mInFlight < mRing.getEntries())
+			{
+				_prepare(read);
+				++mInFlight;
+			}
+			else
+			{
+				mBacklog.push_back(read);
+			}
+		}
+
+		// The completion thread reaps without this lock, so waiting for room cannot deadlock
+		mRing.submit(true);
+		return;
+	}
+#endif
+
+	{
+		std::lock_guard<std::mutex> lock(mWorkMutex);
+
+		for (AsyncReadRequest& request : aRequests)
+		{
+			mWork.push_back(std::move(request));
+		}
+	}
+
+	mWorkCv.notify_all();
+}
+
+std::shared_ptr<const void> AsyncFileReader::_allocate(const AsyncReadRequest& aRequest, const size_t aSize, uint8_t*& aData)
+{
+	if (aRequest.buffer != nullptr)
+	{
+		if (aSize > aRequest.capacity)
+			return nullptr;
+
+		// The caller owns the memory, the view only needs something non-null to count as valid
+		aData = aRequest.buffer;
+		return std::shared_ptr<const void>(aRequest.buffer, [](const void*) {});
+	}
+
+	std::shared_ptr<uint8_t> buffer = mBuffers.acquire(std::max<size_t>(aSize, 1));
+	aData = buffer.get();
+
+	return buffer;
+}
+
+void AsyncFileReader::_finish(AsyncReadRequest& aRequest, FileView aData)
+{
+	if (aRequest.callback)
+	{
+		aRequest.callback(std::move(aData));
+	}
+
+	if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		std::lock_guard<std::mutex> lock(mIdleMutex);
+		mIdleCv.notify_all();
+	}
+}
+
+void AsyncFileReader::_readBlocking(AsyncReadRequest& aRequest)
+{
+	PRIMAL_PROFILE_SCOPE("AsyncFileReader::readBlocking");
+
+	std::ifstream file(aRequest.path, std::ios::ate | std::ios::binary);
+	if (!file.is_open())
+	{
+		_finish(aRequest, FileView());
+		return;
+	}
+
+	const size_t size = static_cast<size_t>(file.tellg());
+
+	uint8_t* data = nullptr;
+	std::shared_ptr<const void> owner = _allocate(aRequest, size, data);
+	if (owner == nullptr)
+	{
+		PRIMAL_INTERNAL_ERROR("Read buffer too small for {0}", aRequest.path.string());
+		_finish(aRequest, FileView());
+		return;
+	}
+
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+
+	if (!file.good() && !file.eof())
+	{
+		_finish(aRequest, FileView());
+		return;
+	}
+
+	_finish(aRequest, FileView(data, size, std::move(owner)));
+}
+
+void AsyncFileReader::_workerLoop()
+{
+	PRIMAL_PROFILE_THREAD("File Reader");
+
+	while (true)
+	{
+		AsyncReadRequest request;
+		{
+			std::unique_lock<std::mutex> lock(mWorkMutex);
+			mWorkCv.wait(lock, [this] { return !mWork.empty(); });
+
+			request = std::move(mWork.front());
+			mWork.pop_front();
+		}
+
+		_readBlocking(request);
+	}
+}
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+
+AsyncFileReader::PendingRead* AsyncFileReader::_open(AsyncReadRequest& aRequest)
+{
+	const int file = open(aRequest.path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0)
+	{
+		_finish(aRequest, FileView());
+		return nullptr;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0)
+	{
+		close(file);
+		_finish(aRequest, FileView());
+		return nullptr;
+	}
+
+	const size_t size = static_cast<size_t>(info.st_size);
+
+	uint8_t* data = nullptr;
+	std::shared_ptr<const void> owner = _allocate(aRequest, size, data);
+	if (owner == nullptr)
+	{
+		close(file);
+		PRIMAL_INTERNAL_ERROR("Read buffer too small for {0}", aRequest.path.string());
+		_finish(aRequest, FileView());
+		return nullptr;
+	}
+
+	if (size == 0)
+	{
+		close(file);
+		_finish(aRequest, FileView(data, 0, std::move(owner)));
+		return nullptr;
+	}
+
+	return new PendingRead{ std::move(aRequest), file, data, size, 0, std::move(owner) };
+}
+
+void AsyncFileReader::_prepare(PendingRead* aRead)
+{
+	const size_t chunk = std::min(aRead->size - aRead->offset, detail::sMaxReadChunk);
+
+	// The ring never holds more than mInFlight entries, so there is always room here
+	mRing.prepareRead(aRead->file, aRead->data + aRead->offset, static_cast<uint32_t>(chunk), aRead->offset, reinterpret_cast<uint64_t>(aRead));
+}
+
+void AsyncFileReader::_fallBack(PendingRead* aRead)
+{
+	close(aRead->file);
+
+	{
+		std::lock_guard<std::mutex> lock(mWorkMutex);
+		mWork.push_back(std::move(aRead->request));
+	}
+
+	mWorkCv.notify_one();
+	delete aRead;
+}
+
+void AsyncFileReader::_completionLoop()
+{
+	PRIMAL_PROFILE_THREAD("File Reader");
+
+	std::vector<IoCompletion> completions;
+	std::vector<PendingRead*> resubmit;
+	std::vector<PendingRead*> finished;
+
+	while (true)
+	{
+		completions.clear();
+		mRing.waitCompletions(completions);
+
+		resubmit.clear();
+		finished.clear();
+
+		for (const IoCompletion& completion : completions)
+		{
+			PendingRead* read = reinterpret_cast<PendingRead*>(completion.userData);
+
+			if (completion.result == -EINTR || completion.result == -EAGAIN)
+			{
+				resubmit.push_back(read);
+				continue;
+			}
+
+			if (completion.result < 0)
+			{
+				close(read->file);
+				read->file = -1;
+
+				// Kernels before 5.6 accept the ring but not IORING_OP_READ
+				if (completion.result == -EINVAL || completion.result == -EOPNOTSUPP)
+				{
+					std::lock_guard<std::mutex> lock(mWorkMutex);
+
+					if (mThreads.size() == 1)
+					{
+						PRIMAL_INTERNAL_WARN("io_uring does not support reads here, async file reads fall back to reader threads");
+
+						// New reads go straight to the reader threads instead of failing on the ring first
+						mUseIoUring = false;
+
+						for (uint32_t i = 0; i < sFallbackThreads; ++i)
+						{
+							mThreads.emplace_back([this] { _workerLoop(); });
+						}
+					}
+
+					mWork.push_back(std::move(read->request));
+					mWorkCv.notify_one();
+
+					delete read;
+					read = nullptr;
+				}
+
+				finished.push_back(read);
+				continue;
+			}
+
+			read->offset += static_cast<size_t>(completion.result);
+
+			// A zero length read means the file shrank since it was opened
+			if (completion.result == 0)
+			{
+				read->size = read->offset;
+			}
+
+			if (read->offset < read->size)
+			{
+				resubmit.push_back(read);
+				continue;
+			}
+
+			close(read->file);
+			finished.push_back(read);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mSubmitMutex);
+
+			for (PendingRead* read : resubmit)
+			{
+				_prepare(read);
+			}
+
+			mInFlight -= static_cast<uint32_t>(finished.size());
+
+			if (!mUseIoUring)
+			{
+				for (PendingRead* read : mBacklog)
+				{
+					_fallBack(read);
+				}
+
+				mBacklog.clear();
+			}
+
+			while (!mBacklog.empty() && mInFlight < mRing.getEntries())
+			{
+				_prepare(mBacklog.front());
+				mBacklog.pop_front();
+				++mInFlight;
+			}
+
+			// This thread is the one that reaps, so it cannot wait for room. The next waitCompletions
+			// submits what the kernel did not take.
+			mRing.submit(false);
+		}
+
+		// Callbacks run after the queue has been refilled so the disk is busy while they execute
+		for (PendingRead* read : finished)
+		{
+			if (read == nullptr)
+				continue;
+
+			if (read->file < 0)
+			{
+				_finish(read->request, FileView());
+			}
+			else
+			{
+				_finish(read->request, FileView(read->data, read->size, std::move(read->owner)));
+			}
+
+			delete read;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,208 @@
+#include "filesystem/Compression.h"
+
+#include <cstring>
+#include <vector>
+
+namespace detail
+{
+	constexpr size_t sMinMatch = 4;
+	constexpr size_t sLastLiterals = 5;
+	constexpr size_t sMatchSearchLimit = 12;
+	constexpr size_t sMaxOffset = 65535;
+	constexpr uint32_t sHashLog = 14;
+
+	static uint32_t sRead32(const uint8_t* aData)
+	{
+		uint32_t value;
+		memcpy(&value, aData, sizeof(value));
+		return value;
+	}
+
+	static uint32_t sHash(const uint32_t aValue)
+	{
+		return (aValue * 2654435761u) >> (32 - sHashLog);
+	}
+
+	static uint8_t* sWriteLength(uint8_t* aOut, size_t aLength)
+	{
+		while (aLength >= 255)
+		{
+			*aOut++ = 255;
+			aLength -= 255;
+		}
+
+		*aOut++ = static_cast<uint8_t>(aLength);
+		return aOut;
+	}
+
+	static bool sReadLength(const uint8_t*& aIn, const uint8_t* aEnd, size_t& aLength)
+	{
+		uint8_t byte;
+		do
+		{
+			if (aIn >= aEnd)
+				return false;
+
+			byte = *aIn++;
+			aLength += byte;
+		}
+		while (byte == 255);
+
+		return true;
+	}
+}
+
+size_t Compression::lz4CompressBound(const size_t aSize)
+{
+	return aSize + aSize / 255 + 16;
+}
+
+size_t Compression::lz4Compress(const uint8_t* aSource, const size_t aSize, uint8_t* aDestination, const size_t aCapacity)
+{
+	if (aCapacity < lz4CompressBound(aSize))
+		return 0;
+
+	const uint8_t* ip = aSource;
+	const uint8_t* anchor = aSource;
+	const uint8_t* const end = aSource + aSize;
+	uint8_t* op = aDestination;
+
+	if (aSize > detail::sMatchSearchLimit)
+	{
+		// The format requires the last match to start 12 bytes and end 5 bytes before the end of the block
+		const uint8_t* const matchLimit = end - detail::sLastLiterals;
+		const uint8_t* const searchLimit = end - detail::sMatchSearchLimit;
+
+		std::vector<uint32_t> table(size_t(1) << detail::sHashLog, 0);
+
+		while (ip < searchLimit)
+		{
+			const uint32_t sequence = detail::sRead32(ip);
+			const uint32_t hash = detail::sHash(sequence);
+
+			const uint8_t* candidate = aSource + table[hash];
+			table[hash] = static_cast<uint32_t>(ip - aSource);
+
+			if (candidate >= ip || static_cast<size_t>(ip - candidate) > detail::sMaxOffset || detail::sRead32(candidate) != sequence)
+			{
+				++ip;
+				continue;
+			}
+
+			while (ip > anchor && candidate > aSource && ip[-1] == candidate[-1])
+			{
+				--ip;
+				--candidate;
+			}
+
+			const uint8_t* matchEnd = ip + detail::sMinMatch;
+			const uint8_t* candidateEnd = candidate + detail::sMinMatch;
+			while (matchEnd < matchLimit && *matchEnd == *candidateEnd)
+			{
+				++matchEnd;
+				++candidateEnd;
+			}
+
+			const size_t literalLength = static_cast<size_t>(ip - anchor);
+			const size_t matchLength = static_cast<size_t>(matchEnd - ip) - detail::sMinMatch;
+			const uint16_t offset = static_cast<uint16_t>(ip - candidate);
+
+			uint8_t* token = op++;
+			*token = static_cast<uint8_t>(((literalLength < 15 ? literalLength : 15) << 4) | (matchLength < 15 ? matchLength : 15));
+
+			if (literalLength >= 15)
+				op = detail::sWriteLength(op, literalLength - 15);
+
+			memcpy(op, anchor, literalLength);
+			op += literalLength;
+
+			*op++ = static_cast<uint8_t>(offset & 0xFF);
+			*op++ = static_cast<uint8_t>(offset >> 8);
+
+			if (matchLength >= 15)
+				op = detail::sWriteLength(op, matchLength - 15);
+
+			ip = matchEnd;
+			anchor = ip;
+
+			if (ip < searchLimit)
+			{
+				table[detail::sHash(detail::sRead32(ip - 2))] = static_cast<uint32_t>(ip - 2 - aSource);
+			}
+		}
+	}
+
+	const size_t literalLength = static_cast<size_t>(end - anchor);
+
+	*op++ = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+	if (literalLength >= 15)
+		op = detail::sWriteLength(op, literalLength - 15);
+
+	memcpy(op, anchor, literalLength);
+	op += literalLength;
+
+	return static_cast<size_t>(op - aDestination);
+}
+
+bool Compression::lz4Decompress(const uint8_t* aSource, const size_t aSize, uint8_t* aDestination, const size_t aDecompressedSize)
+{
+	const uint8_t* ip = aSource;
+	const uint8_t* const inEnd = aSource + aSize;
+	uint8_t* op = aDestination;
+	uint8_t* const outEnd = aDestination + aDecompressedSize;
+
+	while (ip < inEnd)
+	{
+		const uint8_t token = *ip++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !detail::sReadLength(ip, inEnd, literalLength))
+			return false;
+
+		if (literalLength > static_cast<size_t>(inEnd - ip) || literalLength > static_cast<size_t>(outEnd - op))
+			return false;
+
+		memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// The last sequence carries literals only
+		if (ip == inEnd)
+			break;
+
+		if (inEnd - ip < 2)
+			return false;
+
+		const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+		ip += 2;
+
+		if (offset == 0 || offset > static_cast<size_t>(op - aDestination))
+			return false;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !detail::sReadLength(ip, inEnd, matchLength))
+			return false;
+
+		matchLength += detail::sMinMatch;
+
+		if (matchLength > static_cast<size_t>(outEnd - op))
+			return false;
+
+		// Matches may overlap the bytes they produce, so copy forward one byte at a time when they do
+		const uint8_t* match = op - offset;
+		if (offset >= matchLength)
+		{
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; ++i)
+			{
+				*op++ = *match++;
+			}
+		}
+	}
+
+	return op == outEnd;
+}
@@ -0,0 +1,188 @@
+#include "filesystem/DirectoryIndex.h"
+
+#include <algorithm>
+
+namespace detail
+{
+	static void sSplit(const std::string& aPath, std::string& aParent, std::string& aName)
+	{
+		const size_t separator = aPath.rfind('/');
+
+		if (separator == std::string::npos)
+		{
+			aParent.clear();
+			aName = aPath;
+		}
+		else
+		{
+			aParent = aPath.substr(0, separator);
+			aName = aPath.substr(separator + 1);
+		}
+	}
+
+	static std::string sJoin(const std::string& aDirectory, const std::string& aName)
+	{
+		return aDirectory.empty() ? aName : aDirectory + "/" + aName;
+	}
+
+	static bool sEraseName(std::vector<std::string>& aNames, const std::string& aName)
+	{
+		const auto name = std::find(aNames.begin(), aNames.end(), aName);
+		if (name == aNames.end())
+			return false;
+
+		*name = std::move(aNames.back());
+		aNames.pop_back();
+
+		return true;
+	}
+}
+
+DirectoryIndex::DirectoryIndex()
+{
+	clear();
+}
+
+void DirectoryIndex::addFile(const std::string& aPath)
+{
+	if (!mFiles.insert(aPath).second)
+		return;
+
+	std::string parent;
+	std::string name;
+	detail::sSplit(aPath, parent, name);
+
+	addDirectory(parent);
+	mDirectories[parent].files.push_back(std::move(name));
+}
+
+void DirectoryIndex::addDirectory(const std::string& aPath)
+{
+	if (mDirectories.find(aPath) != mDirectories.end())
+		return;
+
+	mDirectories.emplace(aPath, Node());
+
+	std::string parent;
+	std::string name;
+	detail::sSplit(aPath, parent, name);
+
+	// Parents are created first, and the lookup happens after the recursion may have rehashed
+	addDirectory(parent);
+	mDirectories[parent].directories.push_back(std::move(name));
+}
+
+bool DirectoryIndex::removeFile(const std::string& aPath)
+{
+	if (mFiles.erase(aPath) == 0)
+		return false;
+
+	std::string parent;
+	std::string name;
+	detail::sSplit(aPath, parent, name);
+
+	const auto node = mDirectories.find(parent);
+	if (node != mDirectories.end())
+	{
+		detail::sEraseName(node->second.files, name);
+	}
+
+	return true;
+}
+
+bool DirectoryIndex::removeDirectory(const std::string& aPath)
+{
+	if (aPath.empty())
+	{
+		const bool empty = mFiles.empty() && mDirectories.size() == 1;
+		clear();
+
+		return !empty;
+	}
+
+	if (mDirectories.find(aPath) == mDirectories.end())
+		return false;
+
+	_eraseTree(aPath);
+
+	std::string parent;
+	std::string name;
+	detail::sSplit(aPath, parent, name);
+
+	const auto node = mDirectories.find(parent);
+	if (node != mDirectories.end())
+	{
+		detail::sEraseName(node->second.directories, name);
+	}
+
+	return true;
+}
+
+void DirectoryIndex::_eraseTree(const std::string& aPath)
+{
+	const auto node = mDirectories.find(aPath);
+	if (node == mDirectories.end())
+		return;
+
+	Node children = std::move(node->second);
+	mDirectories.erase(node);
+
+	for (const std::string& file : children.files)
+	{
+		mFiles.erase(detail::sJoin(aPath, file));
+	}
+
+	for (const std::string& directory : children.directories)
+	{
+		_eraseTree(detail::sJoin(aPath, directory));
+	}
+}
+
+void DirectoryIndex::clear()
+{
+	mFiles.clear();
+	mDirectories.clear();
+
+	// The root always exists so an empty mount still lists as an empty directory
+	mDirectories.emplace(std::string(), Node());
+}
+
+bool DirectoryIndex::hasFile(const std::string& aPath) const
+{
+	return mFiles.find(aPath) != mFiles.end();
+}
+
+bool DirectoryIndex::hasDirectory(const std::string& aPath) const
+{
+	return mDirectories.find(aPath) != mDirectories.end();
+}
+
+void DirectoryIndex::list(const std::string& aDirectory, const bool aRecursive, std::vector<std::string>& aFiles) const
+{
+	const auto node = mDirectories.find(aDirectory);
+	if (node == mDirectories.end())
+		return;
+
+	for (const std::string& file : node->second.files)
+	{
+		aFiles.push_back(detail::sJoin(aDirectory, file));
+	}
+
+	if (!aRecursive)
+		return;
+
+	for (const std::string& directory : node->second.directories)
+	{
+		list(detail::sJoin(aDirectory, directory), true, aFiles);
+	}
+}
+
+size_t DirectoryIndex::getFileCount() const
+{
+	return mFiles.size();
+}
+
+size_t DirectoryIndex::getDirectoryCount() const
+{
+	return mDirectories.size();
+}
@@ -0,0 +1,204 @@
+#include "filesystem/DirectoryMount.h"
+
+#include <fstream>
+#include <mutex>
+
+#include "filesystem/MappedFile.h"
+
+DirectoryMount::DirectoryMount(const Path& aRoot, const bool aIndexed)
+	: mRoot(aRoot), mIndexed(aIndexed)
+{
+	if (mIndexed)
+	{
+		_scan(mIndex, "", true);
+	}
+}
+
+const Path& DirectoryMount::getRoot() const
+{
+	return mRoot;
+}
+
+bool DirectoryMount::isIndexed() const
+{
+	return mIndexed;
+}
+
+size_t DirectoryMount::getFileCount() const
+{
+	std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+	return mIndex.getFileCount();
+}
+
+void DirectoryMount::_scan(DirectoryIndex& aIndex, const std::string& aDirectory, const bool aRecursive) const
+{
+	const Path directory = _resolve(aDirectory);
+
+	std::error_code error;
+	if (!std::filesystem::is_directory(directory, error))
+		return;
+
+	aIndex.addDirectory(aDirectory);
+
+	std::string prefix = directory.generic_string();
+	if (!prefix.empty() && prefix.back() != '/')
+	{
+		prefix += '/';
+	}
+
+	const auto options = std::filesystem::directory_options::skip_permission_denied;
+	std::filesystem::recursive_directory_iterator iterator(directory, options, error);
+	const std::filesystem::recursive_directory_iterator end;
+
+	for (; !error && iterator != end; iterator.increment(error))
+	{
+		const std::string path = iterator->path().generic_string();
+		if (path.compare(0, prefix.size(), prefix) != 0)
+			continue;
+
+		const std::string relative = path.substr(prefix.size());
+		const std::string mountPath = aDirectory.empty() ? relative : aDirectory + "/" + relative;
+
+		std::error_code statusError;
+		if (iterator->is_directory(statusError))
+		{
+			aIndex.addDirectory(mountPath);
+
+			if (!aRecursive)
+			{
+				iterator.disable_recursion_pending();
+			}
+		}
+		else if (iterator->is_regular_file(statusError))
+		{
+			aIndex.addFile(mountPath);
+		}
+	}
+}
+
+void DirectoryMount::refresh(const std::string& aPath)
+{
+	if (!mIndexed)
+		return;
+
+	std::error_code error;
+	const std::filesystem::file_status status = std::filesystem::status(_resolve(aPath), error);
+
+	std::unique_lock<std::shared_mutex> lock(mIndexMutex);
+
+	if (aPath.empty())
+	{
+		mIndex.clear();
+		_scan(mIndex, "", true);
+		return;
+	}
+
+	mIndex.removeFile(aPath);
+	mIndex.removeDirectory(aPath);
+
+	if (std::filesystem::is_regular_file(status))
+	{
+		mIndex.addFile(aPath);
+	}
+	else if (std::filesystem::is_directory(status))
+	{
+		_scan(mIndex, aPath, true);
+	}
+}
+
+Path DirectoryMount::_resolve(const std::string& aPath) const
+{
+	return mRoot.empty() ? Path(aPath) : mRoot / aPath;
+}
+
+bool DirectoryMount::exists(const std::string& aPath) const
+{
+	if (mIndexed)
+	{
+		std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+		return mIndex.hasFile(aPath);
+	}
+
+	std::error_code error;
+	return std::filesystem::is_regular_file(_resolve(aPath), error);
+}
+
+bool DirectoryMount::isDirectory(const std::string& aPath) const
+{
+	if (mIndexed)
+	{
+		std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+		return mIndex.hasDirectory(aPath);
+	}
+
+	std::error_code error;
+	return std::filesystem::is_directory(_resolve(aPath), error);
+}
+
+void DirectoryMount::list(const std::string& aDirectory, const bool aRecursive, std::vector<std::string>& aFiles) const
+{
+	if (mIndexed)
+	{
+		std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+		mIndex.list(aDirectory, aRecursive, aFiles);
+
+		return;
+	}
+
+	DirectoryIndex index;
+	_scan(index, aDirectory, aRecursive);
+	index.list(aDirectory, aRecursive, aFiles);
+}
+
+bool DirectoryMount::read(const std::string& aPath, std::vector<char>& aData) const
+{
+	if (mIndexed && !exists(aPath))
+		return false;
+
+	// Opening is the existence check, a missing file costs a single failed open
+	std::ifstream file(_resolve(aPath), std::ios::ate | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	const std::streamoff size = file.tellg();
+	if (size < 0)
+		return false;
+
+	aData.resize(static_cast<size_t>(size));
+
+	file.seekg(0);
+	file.read(aData.data(), size);
+
+	return file.good() || file.eof();
+}
+
+FileView DirectoryMount::view(const std::string& aPath) const
+{
+	if (mIndexed && !exists(aPath))
+		return FileView();
+
+	auto mapping = std::make_shared<MappedFile>();
+	if (mapping->open(_resolve(aPath)))
+	{
+		const uint8_t* data = mapping->data();
+		const size_t size = mapping->size();
+
+		return FileView(data, size, std::move(mapping));
+	}
+
+	// Empty files cannot be mapped
+	auto buffer = std::make_shared<std::vector<char>>();
+	if (!read(aPath, *buffer))
+		return FileView();
+
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer->data());
+	const size_t size = buffer->size();
+
+	return FileView(data, size, std::move(buffer));
+}
+
+bool DirectoryMount::getNativePath(const std::string& aPath, Path& aNativePath) const
+{
+	aNativePath = _resolve(aPath);
+	return true;
+}
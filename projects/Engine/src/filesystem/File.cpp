@@ -57,6 +57,8 @@ void File::save(const EFileSaveMode& aMode) const
 
 	stream << mData.c_str();
 	stream.close();
+
+	FileSystem::instance().refresh(mPath);
 }
 
 std::string File::data() const
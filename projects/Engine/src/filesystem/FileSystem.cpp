@@ -1,15 +1,49 @@
 #include "filesystem/FileSystem.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <unordered_set>
 
-#include <stb/stb_image.h>
+#include "filesystem/PackMount.h"
 
 #include "core/Log.h"
 #include "core/PrimalAssert.h"
 
+namespace detail
+{
+	static std::string sNormalize(const Path& aPath)
+	{
+		std::string path = aPath.generic_string();
+
+		while (path.size() >= 2 && path[0] == '.' && path[1] == '/')
+		{
+			path.erase(0, 2);
+		}
+
+		while (!path.empty() && path.back() == '/')
+		{
+			path.pop_back();
+		}
+
+		if (path == ".")
+		{
+			path.clear();
+		}
+
+		return path;
+	}
+
+	static FileInfo sMakeFileInfo(const Path& aPath)
+	{
+		return { aPath.stem().string(), aPath.extension().string(), aPath.filename().string(), aPath.parent_path().string(), aPath.root_path().string() };
+	}
+}
+
 FileSystem::FileSystem()
+	: mWorkingDirectory("", false)
 {
-	mMountedPath = "";
 }
 
 FileSystem& FileSystem::instance()
@@ -18,41 +52,142 @@ FileSystem& FileSystem::instance()
 	return *instance;
 }
 
-void FileSystem::mount(const Path& aPath)
+template<typename Function>
+bool FileSystem::_findInMounts(const Path& aPath, Function&& aFunction) const
 {
-	if(exists(aPath))
+	const std::string path = detail::sNormalize(aPath);
+
+	if (!aPath.is_absolute())
 	{
-		mMountedPath = aPath;
-		mMountedPath += "/";
+		std::shared_lock<std::shared_mutex> lock(mMountMutex);
 
-		PRIMAL_INTERNAL_INFO("Path mounted: {0}", aPath);
-		return;
+		for (const MountPoint& mountPoint : mMounts)
+		{
+			if (aFunction(*mountPoint.mount, path))
+				return true;
+		}
+	}
+
+	return aFunction(mWorkingDirectory, path);
+}
+
+bool FileSystem::mount(const Path& aPath, const int32_t aPriority)
+{
+	std::error_code error;
+
+	MountPoint mountPoint = { aPath, aPriority, false, nullptr };
+
+	if (std::filesystem::is_directory(aPath, error))
+	{
+		auto directory = std::make_unique<DirectoryMount>(aPath);
+
+		PRIMAL_INTERNAL_INFO("Path mounted: {0} ({1} files)", aPath.string(), directory->getFileCount());
+		mountPoint.directory = true;
+		mountPoint.mount = std::move(directory);
+	}
+	else if (std::filesystem::is_regular_file(aPath, error))
+	{
+		auto pack = std::make_unique<PackMount>(aPath);
+		if (!pack->isOpen())
+			return false;
+
+		PRIMAL_INTERNAL_INFO("Pack mounted: {0} ({1} entries)", aPath.string(), pack->getEntryCount());
+		mountPoint.mount = std::move(pack);
+	}
+	else
+	{
+		PRIMAL_INTERNAL_ERROR("Cannot mount path, directory or pack not found: {0}", aPath.string());
+		return false;
+	}
+
+	if (mountPoint.directory)
+	{
+		std::lock_guard<std::mutex> watcherLock(mWatcherMutex);
+
+		if (mWatcher != nullptr)
+		{
+			mWatcher->watch(aPath);
+		}
 	}
 
-	PRIMAL_INTERNAL_ERROR("Cannot mount path, directory not found: {0}", aPath);
+	std::unique_lock<std::shared_mutex> lock(mMountMutex);
+
+	const auto position = std::find_if(mMounts.begin(), mMounts.end(), [aPriority](const MountPoint& aMount)
+	{
+		return aMount.priority <= aPriority;
+	});
+
+	mMounts.insert(position, std::move(mountPoint));
+
+	return true;
+}
+
+void FileSystem::unmount(const Path& aPath)
+{
+	{
+		std::lock_guard<std::mutex> watcherLock(mWatcherMutex);
+
+		if (mWatcher != nullptr)
+		{
+			mWatcher->unwatch(aPath);
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> lock(mMountMutex);
+
+	mMounts.erase(std::remove_if(mMounts.begin(), mMounts.end(), [&aPath](const MountPoint& aMount)
+	{
+		return aMount.path == aPath;
+	}), mMounts.end());
+
+	PRIMAL_INTERNAL_INFO("Path unmounted: {0}", aPath.string());
 }
 
 void FileSystem::unmount()
 {
-	PRIMAL_INTERNAL_INFO("Path unmounted");
-	mMountedPath = "";
+	std::unique_lock<std::shared_mutex> lock(mMountMutex);
+
+	{
+		std::lock_guard<std::mutex> watcherLock(mWatcherMutex);
+
+		if (mWatcher != nullptr)
+		{
+			mWatcher = std::make_unique<FileWatcher>();
+		}
+	}
+
+	mMounts.clear();
+
+	PRIMAL_INTERNAL_INFO("All paths unmounted");
 }
 
 Path FileSystem::getMountedDirectory() const
 {
-	return mMountedPath;
+	std::shared_lock<std::shared_mutex> lock(mMountMutex);
+
+	for (const MountPoint& mountPoint : mMounts)
+	{
+		if (mountPoint.directory)
+		{
+			Path path = mountPoint.path;
+			path += "/";
+
+			return path;
+		}
+	}
+
+	return "";
 }
 
 File* FileSystem::load(const Path& aPath) const
 {
-	if(exists(aPath))
+	std::vector<char> data;
+	if (getBytes(aPath, data))
 	{
 		File* file = new File();
-		const std::string data = loadToString(aPath);
+		file->mData.assign(data.begin(), data.end());
 
-		file->mData = data;
-		
-		Path fullPath = mMountedPath;
+		Path fullPath = getMountedDirectory();
 		fullPath += aPath;
 
 		file->mPath = fullPath;
@@ -67,82 +202,204 @@ File* FileSystem::load(const Path& aPath) const
 
 std::string FileSystem::loadToString(const Path& aPath) const
 {
-	Path loadPath = mMountedPath;
-	loadPath += aPath;
+	const FileView file = view(aPath);
 
-	if(exists(loadPath))
+	if (file.isValid())
 	{
-		std::ifstream stream(loadPath.string());
-		std::string str((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
-		stream.close();
-
-		return str;
+		return file.str();
 	}
 
-	PRIMAL_INTERNAL_ERROR("File does not exist at path: {0}", loadPath.string());
+	PRIMAL_INTERNAL_ERROR("File does not exist at path: {0}", aPath.string());
 
 	return "";
 }
 
 std::vector<char> FileSystem::getBytes(const Path& aPath) const
 {
-	Path loadPath = mMountedPath;
-	loadPath += aPath;
+	std::vector<char> buffer;
+	getBytes(aPath, buffer);
 
-	if (exists(loadPath))
+	return buffer;
+}
+
+bool FileSystem::getBytes(const Path& aPath, std::vector<char>& aData) const
+{
+	return _findInMounts(aPath, [&aData](const IMount& aMount, const std::string& aMountPath)
 	{
-		std::ifstream file(loadPath.c_str(), std::ios::ate | std::ios::binary);
+		return aMount.read(aMountPath, aData);
+	});
+}
 
-		PRIMAL_ASSERT(file.is_open(), "Failed to open file");
+FileView FileSystem::view(const Path& aPath) const
+{
+	FileView file;
 
-		const size_t fileSize = static_cast<size_t>(file.tellg());
-		std::vector<char> buffer(fileSize);
+	_findInMounts(aPath, [&file](const IMount& aMount, const std::string& aMountPath)
+	{
+		file = aMount.view(aMountPath);
+		return file.isValid();
+	});
 
-		file.seekg(0);
-		file.read(buffer.data(), fileSize);
+	return file;
+}
 
-		file.close();
+void FileSystem::readAsync(const Path& aPath, AsyncReadCallback aCallback) const
+{
+	Path nativePath;
+	FileView file;
 
-		return buffer;
+	const bool found = _findInMounts(aPath, [&nativePath, &file](const IMount& aMount, const std::string& aMountPath)
+	{
+		if (!aMount.exists(aMountPath))
+			return false;
+
+		if (!aMount.getNativePath(aMountPath, nativePath))
+		{
+			file = aMount.view(aMountPath);
+		}
+
+		return true;
+	});
+
+	if (found && !nativePath.empty())
+	{
+		AsyncFileReader::instance().read(nativePath, std::move(aCallback));
+		return;
 	}
 
-	return std::vector<char>();
+	aCallback(std::move(file));
 }
 
 bool FileSystem::exists(const Path& aPath) const
 {
-	Path loadPath = mMountedPath;
-	loadPath += aPath;
-
-	return std::filesystem::exists(loadPath);
+	return _findInMounts(aPath, [](const IMount& aMount, const std::string& aMountPath)
+	{
+		return aMount.exists(aMountPath);
+	});
 }
 
 bool FileSystem::isFile(const Path& aPath) const
 {
-	Path loadPath = mMountedPath;
-	loadPath += aPath;
-
-	return std::filesystem::is_regular_file(loadPath);
+	return exists(aPath);
 }
 
 bool FileSystem::isDirectory(const Path& aPath) const
 {
-	Path loadPath = mMountedPath;
-	loadPath += aPath;
+	return _findInMounts(aPath, [](const IMount& aMount, const std::string& aMountPath)
+	{
+		return aMount.isDirectory(aMountPath);
+	});
+}
 
-	return std::filesystem::is_directory(loadPath);
+void FileSystem::refresh(const Path& aPath) const
+{
+	const std::string path = detail::sNormalize(aPath);
+
+	std::shared_lock<std::shared_mutex> lock(mMountMutex);
+
+	for (const MountPoint& mountPoint : mMounts)
+	{
+		if (!mountPoint.directory)
+			continue;
+
+		// Paths that went through getMountedDirectory() still carry the mount root
+		const std::string root = detail::sNormalize(mountPoint.path);
+		DirectoryMount& directory = static_cast<DirectoryMount&>(*mountPoint.mount);
+
+		if (!root.empty() && path.size() > root.size() && path.compare(0, root.size(), root) == 0 && path[root.size()] == '/')
+		{
+			directory.refresh(path.substr(root.size() + 1));
+		}
+		else if (!aPath.is_absolute())
+		{
+			directory.refresh(path);
+		}
+	}
 }
 
-File* FileSystem::create(const std::string& aPath) const
+void FileSystem::setWatching(const bool aWatching)
 {
-	Path loadPath = mMountedPath;
-	loadPath += aPath;
+	std::shared_lock<std::shared_mutex> lock(mMountMutex);
+	std::lock_guard<std::mutex> watcherLock(mWatcherMutex);
+
+	if (!aWatching)
+	{
+		mWatcher.reset();
+		return;
+	}
+
+	if (mWatcher != nullptr)
+		return;
+
+	mWatcher = std::make_unique<FileWatcher>();
+
+	for (const MountPoint& mountPoint : mMounts)
+	{
+		if (mountPoint.directory)
+		{
+			mWatcher->watch(mountPoint.path);
+		}
+	}
+}
+
+bool FileSystem::isWatching() const
+{
+	std::lock_guard<std::mutex> watcherLock(mWatcherMutex);
+	return mWatcher != nullptr;
+}
+
+void FileSystem::pollChanges(std::vector<std::string>& aChanged)
+{
+	std::vector<FileChange> changes;
+	{
+		std::lock_guard<std::mutex> watcherLock(mWatcherMutex);
+
+		if (mWatcher == nullptr)
+			return;
+
+		mWatcher->poll(changes);
+	}
+
+	if (changes.empty())
+		return;
+
+	std::shared_lock<std::shared_mutex> lock(mMountMutex);
+
+	for (const FileChange& change : changes)
+	{
+		for (const MountPoint& mountPoint : mMounts)
+		{
+			if (mountPoint.directory && mountPoint.path == change.root)
+			{
+				static_cast<DirectoryMount&>(*mountPoint.mount).refresh(change.path);
+			}
+		}
+
+		// A full rescan only resyncs the index, there is no single path to report
+		if (change.path.empty())
+			continue;
+
+		const std::string root = detail::sNormalize(change.root);
+
+		aChanged.push_back(change.path);
+
+		if (!root.empty())
+		{
+			aChanged.push_back(root + "/" + change.path);
+		}
+	}
+}
 
-	if(exists(loadPath))
+File* FileSystem::create(const std::string& aPath) const
+{
+	if(exists(aPath))
 	{
-		return load(loadPath);
+		return load(aPath);
 	}
 
+	Path loadPath = getMountedDirectory();
+	loadPath += aPath;
+
 	File* file = new File();
 	file->mPath = loadPath;
 
@@ -151,44 +408,129 @@ File* FileSystem::create(const std::string& aPath) const
 
 void FileSystem::createDirectory(const Path& aPath) const
 {
-	Path loadPath = mMountedPath;
+	Path loadPath = getMountedDirectory();
 	loadPath += aPath;
 
-	if(!exists(loadPath))
+	if(!std::filesystem::exists(loadPath))
 	{
 		std::filesystem::create_directory(loadPath);
+		refresh(loadPath);
 	}
 }
 
-std::vector<FileInfo> FileSystem::getFilesInPath(const Path& aPath, const bool aRecursive) const
+bool FileSystem::replace(const Path& aPath, const void* aData, const size_t aSize) const
 {
-	Path loadPath = mMountedPath;
-	loadPath += aPath;
+	static std::atomic<uint64_t> sWrites{ 0 };
 
-	std::vector<FileInfo> files;
+	// Replaces the file reads currently find, new files go to the highest priority directory mount like create()
+	Path nativePath;
+	const bool found = _findInMounts(aPath, [&nativePath](const IMount& aMount, const std::string& aMountPath)
+	{
+		if (!aMount.exists(aMountPath))
+			return false;
+
+		aMount.getNativePath(aMountPath, nativePath);
+		return true;
+	});
+
+	if (found && nativePath.empty())
+	{
+		PRIMAL_INTERNAL_ERROR("Cannot replace a file inside a pack: {0}", aPath.string());
+		return false;
+	}
 
-	if (aRecursive)
+	if (!found)
 	{
-		for (const auto& p : std::filesystem::recursive_directory_iterator(loadPath))
+		nativePath = aPath.is_absolute() ? Path() : getMountedDirectory();
+		nativePath += aPath;
+	}
+
+	// Unique across threads and across processes writing the same file
+	const uint64_t now = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+	Path temporary = nativePath;
+	temporary += ".tmp" + std::to_string(now) + "_" + std::to_string(sWrites.fetch_add(1, std::memory_order_relaxed));
+
+	std::error_code error;
+
+	if (nativePath.has_parent_path())
+	{
+		std::filesystem::create_directories(nativePath.parent_path(), error);
+	}
+
+	{
+		std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
 		{
-			if (p.is_directory())
-				continue;
+			return false;
+		}
 
-			const auto& path = p.path();
-			files.push_back({ path.stem().string(), path.extension().string(), path.filename().string(), path.parent_path().string(), path.root_path().string() });
+		stream.write(static_cast<const char*>(aData), static_cast<std::streamsize>(aSize));
+
+		if (!stream.good())
+		{
+			stream.close();
+			std::filesystem::remove(temporary, error);
+			return false;
 		}
 	}
-	else
+
+	std::filesystem::rename(temporary, nativePath, error);
+	if (error)
 	{
-		for (const auto& p : std::filesystem::directory_iterator(loadPath))
+		std::filesystem::remove(temporary, error);
+		return false;
+	}
+
+	refresh(aPath);
+
+	return true;
+}
+
+std::vector<FileInfo> FileSystem::getFilesInPath(const Path& aPath, const bool aRecursive) const
+{
+	const std::string path = detail::sNormalize(aPath);
+
+	std::vector<FileInfo> files;
+	std::vector<std::string> listing;
+	std::unordered_set<std::string> seen;
+
+	const auto collect = [&](const IMount& aMount)
+	{
+		listing.clear();
+		aMount.list(path, aRecursive, listing);
+
+		for (const std::string& file : listing)
 		{
-			if (p.is_directory())
+			// A file in a higher priority mount hides the same path further down
+			if (!seen.insert(file).second)
 				continue;
 
-			const auto& path = p.path();
-			files.push_back({ path.stem().string(), path.extension().string(), path.filename().string(), path.parent_path().string(), path.root_path().string() });
+			Path nativePath;
+			files.push_back(detail::sMakeFileInfo(aMount.getNativePath(file, nativePath) ? nativePath : Path(file)));
+		}
+	};
+
+	bool found = false;
+
+	if (!aPath.is_absolute())
+	{
+		std::shared_lock<std::shared_mutex> lock(mMountMutex);
+
+		for (const MountPoint& mountPoint : mMounts)
+		{
+			if (mountPoint.mount->isDirectory(path))
+			{
+				collect(*mountPoint.mount);
+				found = true;
+			}
 		}
 	}
 
+	if (!found)
+	{
+		collect(mWorkingDirectory);
+	}
+
 	return files;
 }
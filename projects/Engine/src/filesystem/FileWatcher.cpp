@@ -0,0 +1,232 @@
+#include "filesystem/FileWatcher.h"
+
+#include <unordered_set>
+
+#include "core/Log.h"
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace detail
+{
+	// Editors that save atomically write a temporary file and rename it over the original, so moves
+	// count as writes. Creation of plain files is ignored, the close that follows is reported instead.
+	static constexpr uint32_t sWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR;
+
+	static std::string sJoin(const std::string& aDirectory, const char* aName)
+	{
+		return aDirectory.empty() ? std::string(aName) : aDirectory + "/" + aName;
+	}
+}
+
+FileWatcher::FileWatcher()
+{
+	mDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (mDescriptor < 0)
+	{
+		PRIMAL_INTERNAL_WARN("inotify is unavailable, file changes will not be detected");
+	}
+}
+
+FileWatcher::~FileWatcher()
+{
+	if (mDescriptor >= 0)
+	{
+		close(mDescriptor);
+	}
+}
+
+bool FileWatcher::isValid() const
+{
+	return mDescriptor >= 0;
+}
+
+bool FileWatcher::watch(const Path& aRoot)
+{
+	if (!isValid())
+		return false;
+
+	for (const Path& root : mRoots)
+	{
+		if (root == aRoot)
+			return true;
+	}
+
+	std::error_code error;
+	if (!std::filesystem::is_directory(aRoot, error))
+		return false;
+
+	mRoots.push_back(aRoot);
+	_addWatches(mRoots.size() - 1, "");
+
+	return true;
+}
+
+void FileWatcher::unwatch(const Path& aRoot)
+{
+	for (size_t root = 0; root < mRoots.size(); ++root)
+	{
+		if (mRoots[root].empty() || mRoots[root] != aRoot)
+			continue;
+
+		for (auto watch = mWatches.begin(); watch != mWatches.end(); )
+		{
+			if (watch->second.root == root)
+			{
+				inotify_rm_watch(mDescriptor, watch->first);
+				watch = mWatches.erase(watch);
+			}
+			else
+			{
+				++watch;
+			}
+		}
+
+		mRoots[root].clear();
+	}
+}
+
+void FileWatcher::_addWatches(const size_t aRoot, const std::string& aDirectory)
+{
+	const Path directory = aDirectory.empty() ? mRoots[aRoot] : mRoots[aRoot] / aDirectory;
+
+	const int watch = inotify_add_watch(mDescriptor, directory.string().c_str(), detail::sWatchMask);
+	if (watch < 0)
+	{
+		PRIMAL_INTERNAL_WARN("Could not watch directory {0}: {1}", directory.string(), strerror(errno));
+		return;
+	}
+
+	mWatches[watch] = { aRoot, aDirectory };
+
+	std::error_code error;
+	const auto options = std::filesystem::directory_options::skip_permission_denied;
+
+	for (std::filesystem::directory_iterator iterator(directory, options, error), end; !error && iterator != end; iterator.increment(error))
+	{
+		std::error_code statusError;
+		if (iterator->is_directory(statusError) && !iterator->is_symlink(statusError))
+		{
+			_addWatches(aRoot, detail::sJoin(aDirectory, iterator->path().filename().string().c_str()));
+		}
+	}
+}
+
+void FileWatcher::poll(std::vector<FileChange>& aChanges)
+{
+	if (!isValid())
+		return;
+
+	std::unordered_set<std::string> reported;
+	const auto report = [&](const size_t aRoot, const std::string& aPath)
+	{
+		if (reported.insert(std::to_string(aRoot) + ':' + aPath).second)
+		{
+			aChanges.push_back({ mRoots[aRoot], aPath });
+		}
+	};
+
+	alignas(inotify_event) char buffer[16 * 1024];
+
+	while (true)
+	{
+		const ssize_t size = read(mDescriptor, buffer, sizeof(buffer));
+		if (size <= 0)
+			break;
+
+		for (ssize_t offset = 0; offset < size; )
+		{
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+			// The kernel dropped events, nothing short of a full rescan is reliable anymore
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				PRIMAL_INTERNAL_WARN("File watcher queue overflowed, rescanning all watched directories");
+
+				for (size_t root = 0; root < mRoots.size(); ++root)
+				{
+					if (!mRoots[root].empty())
+					{
+						report(root, "");
+					}
+				}
+
+				continue;
+			}
+
+			const auto watch = mWatches.find(event->wd);
+			if (watch == mWatches.end())
+				continue;
+
+			if (event->mask & IN_IGNORED)
+			{
+				mWatches.erase(watch);
+				continue;
+			}
+
+			if (event->len == 0)
+				continue;
+
+			const size_t root = watch->second.root;
+			const std::string path = detail::sJoin(watch->second.path, event->name);
+
+			if (event->mask & IN_ISDIR)
+			{
+				// Files may have landed in a new directory before its watch exists, the rescan triggered
+				// by reporting the directory picks them up
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					_addWatches(root, path);
+				}
+
+				report(root, path);
+			}
+			else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE))
+			{
+				report(root, path);
+			}
+		}
+	}
+}
+
+#else
+
+FileWatcher::FileWatcher()
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+}
+
+bool FileWatcher::isValid() const
+{
+	return false;
+}
+
+bool FileWatcher::watch(const Path& aRoot)
+{
+	PRIMAL_INTERNAL_WARN("File watching is not supported on this platform: {0}", aRoot.string());
+	return false;
+}
+
+void FileWatcher::unwatch(const Path& aRoot)
+{
+}
+
+void FileWatcher::_addWatches(const size_t aRoot, const std::string& aDirectory)
+{
+}
+
+void FileWatcher::poll(std::vector<FileChange>& aChanges)
+{
+}
+
+#endif
@@ -0,0 +1,200 @@
+#include "filesystem/IoUring.h"
+
+#if defined(PRIMAL_PLATFORM_LINUX)
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace detail
+{
+	static int sSetup(const uint32_t aEntries, io_uring_params* aParams)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_setup, aEntries, aParams));
+	}
+
+	static int sEnter(const int aRing, const uint32_t aSubmit, const uint32_t aMinComplete, const uint32_t aFlags)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_enter, aRing, aSubmit, aMinComplete, aFlags, nullptr, 0));
+	}
+}
+
+IoUring::~IoUring()
+{
+	if (mSqes != nullptr)
+		munmap(mSqes, mSqesSize);
+
+	if (mCqMapping != nullptr && mCqMapping != mSqMapping)
+		munmap(mCqMapping, mCqMappingSize);
+
+	if (mSqMapping != nullptr)
+		munmap(mSqMapping, mSqMappingSize);
+
+	if (mRing >= 0)
+		close(mRing);
+}
+
+bool IoUring::init(const uint32_t aEntries)
+{
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	const int ring = detail::sSetup(aEntries, &params);
+	if (ring < 0)
+		return false;
+
+	mSqMappingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	mCqMappingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+	const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMapping)
+	{
+		mSqMappingSize = std::max(mSqMappingSize, mCqMappingSize);
+		mCqMappingSize = mSqMappingSize;
+	}
+
+	void* sq = mmap(nullptr, mSqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+	if (sq == MAP_FAILED)
+	{
+		close(ring);
+		return false;
+	}
+
+	void* cq = sq;
+	if (!singleMapping)
+	{
+		cq = mmap(nullptr, mCqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+		if (cq == MAP_FAILED)
+		{
+			munmap(sq, mSqMappingSize);
+			close(ring);
+			return false;
+		}
+	}
+
+	mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	void* sqes = mmap(nullptr, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED)
+	{
+		if (cq != sq)
+			munmap(cq, mCqMappingSize);
+
+		munmap(sq, mSqMappingSize);
+		close(ring);
+		return false;
+	}
+
+	char* sqBase = static_cast<char*>(sq);
+	char* cqBase = static_cast<char*>(cq);
+
+	mRing = ring;
+	mSqMapping = sq;
+	mCqMapping = cq;
+	mSqes = static_cast<io_uring_sqe*>(sqes);
+
+	mSqHead = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.head);
+	mSqTail = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.tail);
+	mSqArray = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.array);
+	mSqMask = *reinterpret_cast<uint32_t*>(sqBase + params.sq_off.ring_mask);
+	mSqEntries = params.sq_entries;
+	mSqLocalTail = *mSqTail;
+
+	mCqHead = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.head);
+	mCqTail = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.tail);
+	mCqMask = *reinterpret_cast<uint32_t*>(cqBase + params.cq_off.ring_mask);
+	mCqes = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+
+	return true;
+}
+
+bool IoUring::prepareRead(const int aFile, void* aBuffer, const uint32_t aSize, const uint64_t aOffset, const uint64_t aUserData)
+{
+	const uint32_t head = __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+	if (mSqLocalTail - head >= mSqEntries)
+		return false;
+
+	const uint32_t index = mSqLocalTail & mSqMask;
+
+	io_uring_sqe* sqe = &mSqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = aFile;
+	sqe->addr = reinterpret_cast<uint64_t>(aBuffer);
+	sqe->len = aSize;
+	sqe->off = aOffset;
+	sqe->user_data = aUserData;
+
+	mSqArray[index] = index;
+	++mSqLocalTail;
+
+	return true;
+}
+
+bool IoUring::submit(const bool aWaitForRoom)
+{
+	__atomic_store_n(mSqTail, mSqLocalTail, __ATOMIC_RELEASE);
+
+	// The kernel advances the head as it consumes entries, whichever call submitted them
+	while (mSqLocalTail != __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE))
+	{
+		const uint32_t unsubmitted = mSqLocalTail - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+
+		if (detail::sEnter(mRing, unsubmitted, 0, 0) >= 0)
+			continue;
+
+		if (errno == EINTR)
+			continue;
+
+		// EAGAIN/EBUSY: the kernel is short on resources or waits for the completion queue to be reaped.
+		// Entries the kernel did not take stay in the ring for the next submit or waitCompletions.
+		if ((errno == EAGAIN || errno == EBUSY) && aWaitForRoom)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+			continue;
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+void IoUring::waitCompletions(std::vector<IoCompletion>& aCompletions)
+{
+	while (true)
+	{
+		uint32_t head = *mCqHead;
+		const uint32_t tail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+
+		if (head == tail)
+		{
+			// Also hands over entries a submit left behind, otherwise nothing might ever complete
+			const uint32_t unsubmitted = __atomic_load_n(mSqTail, __ATOMIC_ACQUIRE) - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+
+			if (detail::sEnter(mRing, unsubmitted, 1, IORING_ENTER_GETEVENTS) < 0 && (errno == EAGAIN || errno == EBUSY))
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+			}
+
+			continue;
+		}
+
+		for (; head != tail; ++head)
+		{
+			const io_uring_cqe& cqe = mCqes[head & mCqMask];
+			aCompletions.push_back({ cqe.user_data, cqe.res });
+		}
+
+		__atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+		return;
+	}
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "filesystem/MappedFile.h"
+
+#if defined(PRIMAL_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "core/Log.h"
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const Path& aPath)
+{
+	close();
+
+#if defined(PRIMAL_PLATFORM_WINDOWS)
+	HANDLE file = CreateFileW(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		PRIMAL_INTERNAL_ERROR("Could not map file: {0}", aPath.string());
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		PRIMAL_INTERNAL_ERROR("Could not map file: {0}", aPath.string());
+		return false;
+	}
+
+	mFile = file;
+	mMapping = mapping;
+	mData = static_cast<const uint8_t*>(view);
+	mSize = static_cast<size_t>(size.QuadPart);
+#else
+	const int file = ::open(aPath.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	if (view == MAP_FAILED)
+	{
+		::close(file);
+		PRIMAL_INTERNAL_ERROR("Could not map file: {0}", aPath.string());
+		return false;
+	}
+
+	// Cooked data is consumed front to back right after opening, start reading it in now
+	madvise(view, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+
+	mFile = file;
+	mData = static_cast<const uint8_t*>(view);
+	mSize = static_cast<size_t>(info.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData == nullptr)
+		return;
+
+#if defined(PRIMAL_PLATFORM_WINDOWS)
+	UnmapViewOfFile(mData);
+	CloseHandle(mMapping);
+	CloseHandle(mFile);
+
+	mMapping = nullptr;
+	mFile = nullptr;
+#else
+	munmap(const_cast<uint8_t*>(mData), mSize);
+	::close(mFile);
+
+	mFile = -1;
+#endif
+
+	mData = nullptr;
+	mSize = 0;
+}
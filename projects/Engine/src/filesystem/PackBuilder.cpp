@@ -0,0 +1,169 @@
+#include "filesystem/PackBuilder.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "core/Log.h"
+#include "filesystem/Compression.h"
+#include "utils/StringUtils.h"
+
+namespace detail
+{
+	static void sWritePadding(std::ofstream& aStream, uint64_t& aOffset, const uint32_t aAlignment)
+	{
+		static const char zeros[256] = {};
+
+		uint64_t padding = (aAlignment - aOffset % aAlignment) % aAlignment;
+		aOffset += padding;
+
+		while (padding > 0)
+		{
+			const uint64_t chunk = std::min<uint64_t>(padding, sizeof(zeros));
+			aStream.write(zeros, static_cast<std::streamsize>(chunk));
+			padding -= chunk;
+		}
+	}
+}
+
+void PackBuilder::setAlignment(const uint32_t aAlignment)
+{
+	// Alignments are powers of two, round anything else up
+	uint32_t alignment = 1;
+	while (alignment < aAlignment && alignment < 65536)
+	{
+		alignment <<= 1;
+	}
+
+	mAlignment = alignment;
+}
+
+void PackBuilder::setCompression(const EPackCompression aCompression)
+{
+	mCompression = aCompression;
+}
+
+void PackBuilder::addFile(const std::string& aPackPath, const Path& aSource)
+{
+	mSources.push_back({ StringUtils::replace(aPackPath, '\\', '/'), aSource });
+}
+
+void PackBuilder::addDirectory(const Path& aRoot)
+{
+	for (const auto& p : std::filesystem::recursive_directory_iterator(aRoot))
+	{
+		if (!p.is_regular_file())
+			continue;
+
+		addFile(std::filesystem::relative(p.path(), aRoot).generic_string(), p.path());
+	}
+}
+
+bool PackBuilder::write(const Path& aDestination) const
+{
+	std::ofstream stream(aDestination, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		PRIMAL_INTERNAL_ERROR("Could not write pack: {0}", aDestination.string());
+		return false;
+	}
+
+	PackHeader header = {};
+	header.magic = packMagic;
+	header.version = packVersion;
+	header.alignment = mAlignment;
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	uint64_t offset = sizeof(header);
+
+	std::vector<PackEntry> entries;
+	entries.reserve(mSources.size());
+
+	std::string strings;
+
+	std::vector<char> data;
+	std::vector<uint8_t> compressed;
+
+	uint64_t totalSize = 0;
+	uint64_t totalStored = 0;
+
+	for (const Source& source : mSources)
+	{
+		std::ifstream file(source.file, std::ios::ate | std::ios::binary);
+		if (!file.is_open())
+		{
+			PRIMAL_INTERNAL_ERROR("Could not read file for pack: {0}", source.file.string());
+			return false;
+		}
+
+		data.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+		PackEntry entry = {};
+		entry.hash = packHashPath(source.packPath.data(), source.packPath.size());
+		entry.size = data.size();
+		entry.pathOffset = static_cast<uint32_t>(strings.size());
+		entry.pathLength = static_cast<uint32_t>(source.packPath.size());
+		entry.compression = PACK_COMPRESSION_NONE;
+
+		strings += source.packPath;
+
+		const char* stored = data.data();
+		uint64_t storedSize = data.size();
+
+		if (mCompression == PACK_COMPRESSION_LZ4 && !data.empty())
+		{
+			compressed.resize(Compression::lz4CompressBound(data.size()));
+			const size_t compressedSize = Compression::lz4Compress(reinterpret_cast<const uint8_t*>(data.data()), data.size(), compressed.data(), compressed.size());
+
+			// Entries that barely shrink (PNG, already compressed data) stay raw so they can be mapped
+			if (compressedSize > 0 && compressedSize < data.size() - data.size() / 8)
+			{
+				stored = reinterpret_cast<const char*>(compressed.data());
+				storedSize = compressedSize;
+				entry.compression = PACK_COMPRESSION_LZ4;
+			}
+		}
+
+		detail::sWritePadding(stream, offset, mAlignment);
+
+		entry.offset = offset;
+		entry.storedSize = storedSize;
+
+		stream.write(stored, static_cast<std::streamsize>(storedSize));
+		offset += storedSize;
+
+		totalSize += entry.size;
+		totalStored += storedSize;
+
+		entries.push_back(entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const PackEntry& aLeft, const PackEntry& aRight)
+	{
+		return aLeft.hash < aRight.hash;
+	});
+
+	detail::sWritePadding(stream, offset, alignof(PackEntry));
+
+	header.entryCount = static_cast<uint32_t>(entries.size());
+	header.tocOffset = offset;
+
+	stream.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+	offset += entries.size() * sizeof(PackEntry);
+
+	header.stringsOffset = offset;
+	header.stringsSize = strings.size();
+
+	stream.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+	stream.seekp(0);
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	const bool written = stream.good();
+	stream.close();
+
+	PRIMAL_INTERNAL_INFO("Packed {0} files into {1} ({2} -> {3} bytes)", entries.size(), aDestination.string(), totalSize, totalStored);
+
+	return written;
+}
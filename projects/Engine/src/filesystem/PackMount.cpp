@@ -0,0 +1,169 @@
+#include "filesystem/PackMount.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/Log.h"
+#include "filesystem/Compression.h"
+
+PackMount::PackMount(const Path& aPath)
+	: mFile(std::make_shared<MappedFile>())
+{
+	if (!mFile->open(aPath))
+	{
+		PRIMAL_INTERNAL_ERROR("Could not open pack: {0}", aPath.string());
+		return;
+	}
+
+	const uint8_t* base = mFile->data();
+	const size_t size = mFile->size();
+
+	if (size < sizeof(PackHeader))
+	{
+		PRIMAL_INTERNAL_ERROR("Pack is truncated: {0}", aPath.string());
+		mFile->close();
+		return;
+	}
+
+	const PackHeader* header = reinterpret_cast<const PackHeader*>(base);
+
+	if (header->magic != packMagic || header->version != packVersion)
+	{
+		PRIMAL_INTERNAL_ERROR("Pack has an unknown format: {0}", aPath.string());
+		mFile->close();
+		return;
+	}
+
+	if (header->tocOffset + static_cast<uint64_t>(header->entryCount) * sizeof(PackEntry) > size ||
+		header->stringsOffset + header->stringsSize > size)
+	{
+		PRIMAL_INTERNAL_ERROR("Pack is truncated: {0}", aPath.string());
+		mFile->close();
+		return;
+	}
+
+	mEntries = reinterpret_cast<const PackEntry*>(base + header->tocOffset);
+	mStrings = reinterpret_cast<const char*>(base + header->stringsOffset);
+	mEntryCount = header->entryCount;
+
+	for (uint32_t i = 0; i < mEntryCount; ++i)
+	{
+		const PackEntry& entry = mEntries[i];
+
+		// Uncompressed entries are copied and viewed at their full size straight from the mapping
+		if (entry.offset + entry.storedSize > size ||
+			(entry.compression == PACK_COMPRESSION_NONE && entry.size != entry.storedSize) ||
+			static_cast<uint64_t>(entry.pathOffset) + entry.pathLength > header->stringsSize)
+		{
+			PRIMAL_INTERNAL_ERROR("Pack entry {0} is out of range: {1}", i, aPath.string());
+			mEntries = nullptr;
+			mStrings = nullptr;
+			mEntryCount = 0;
+			mFile->close();
+			return;
+		}
+	}
+
+	for (uint32_t i = 0; i < mEntryCount; ++i)
+	{
+		mIndex.addFile(std::string(mStrings + mEntries[i].pathOffset, mEntries[i].pathLength));
+	}
+}
+
+bool PackMount::isOpen() const
+{
+	return mFile->isOpen();
+}
+
+uint32_t PackMount::getEntryCount() const
+{
+	return mEntryCount;
+}
+
+const PackEntry* PackMount::_find(const std::string& aPath) const
+{
+	const uint64_t hash = packHashPath(aPath.data(), aPath.size());
+
+	const PackEntry* end = mEntries + mEntryCount;
+	const PackEntry* entry = std::lower_bound(mEntries, end, hash, [](const PackEntry& aEntry, const uint64_t aHash)
+	{
+		return aEntry.hash < aHash;
+	});
+
+	for (; entry != end && entry->hash == hash; ++entry)
+	{
+		if (entry->pathLength == aPath.size() && memcmp(mStrings + entry->pathOffset, aPath.data(), aPath.size()) == 0)
+			return entry;
+	}
+
+	return nullptr;
+}
+
+bool PackMount::exists(const std::string& aPath) const
+{
+	return _find(aPath) != nullptr;
+}
+
+bool PackMount::isDirectory(const std::string& aPath) const
+{
+	return isOpen() && mIndex.hasDirectory(aPath);
+}
+
+void PackMount::list(const std::string& aDirectory, const bool aRecursive, std::vector<std::string>& aFiles) const
+{
+	mIndex.list(aDirectory, aRecursive, aFiles);
+}
+
+bool PackMount::read(const std::string& aPath, std::vector<char>& aData) const
+{
+	const PackEntry* entry = _find(aPath);
+	if (entry == nullptr)
+		return false;
+
+	const uint8_t* stored = mFile->data() + entry->offset;
+	aData.resize(static_cast<size_t>(entry->size));
+
+	switch (entry->compression)
+	{
+		case PACK_COMPRESSION_NONE:
+			memcpy(aData.data(), stored, aData.size());
+			return true;
+
+		case PACK_COMPRESSION_LZ4:
+			if (Compression::lz4Decompress(stored, static_cast<size_t>(entry->storedSize), reinterpret_cast<uint8_t*>(aData.data()), aData.size()))
+				return true;
+
+			PRIMAL_INTERNAL_ERROR("Pack entry is corrupt: {0}", aPath);
+			return false;
+
+		default:
+			PRIMAL_INTERNAL_ERROR("Pack entry uses an unsupported compression: {0}", aPath);
+			return false;
+	}
+}
+
+FileView PackMount::view(const std::string& aPath) const
+{
+	const PackEntry* entry = _find(aPath);
+	if (entry == nullptr)
+		return FileView();
+
+	if (entry->compression == PACK_COMPRESSION_NONE)
+	{
+		return FileView(mFile->data() + entry->offset, static_cast<size_t>(entry->size), mFile);
+	}
+
+	auto buffer = std::make_shared<std::vector<char>>();
+	if (!read(aPath, *buffer))
+		return FileView();
+
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer->data());
+	const size_t size = buffer->size();
+
+	return FileView(data, size, std::move(buffer));
+}
+
+bool PackMount::getNativePath(const std::string&, Path&) const
+{
+	return false;
+}
@@ -0,0 +1,92 @@
+#include "filesystem/ReadBufferPool.h"
+
+#include <new>
+
+namespace detail
+{
+	static uint8_t* sAllocate(const size_t aSize, const size_t aAlignment)
+	{
+		return static_cast<uint8_t*>(::operator new(aSize, std::align_val_t(aAlignment)));
+	}
+
+	static void sFree(uint8_t* aBuffer, const size_t aAlignment)
+	{
+		::operator delete(aBuffer, std::align_val_t(aAlignment));
+	}
+}
+
+ReadBufferPool::~ReadBufferPool()
+{
+	trim();
+}
+
+std::shared_ptr<uint8_t> ReadBufferPool::acquire(const size_t aSize)
+{
+	uint32_t sizeClass = sMinClass;
+	while (sizeClass <= sMaxClass && (size_t(1) << sizeClass) < aSize)
+	{
+		++sizeClass;
+	}
+
+	// Anything above the largest class is rare enough to allocate directly
+	if (sizeClass > sMaxClass)
+	{
+		return std::shared_ptr<uint8_t>(detail::sAllocate(aSize, sAlignment), [](uint8_t* aBuffer)
+		{
+			detail::sFree(aBuffer, sAlignment);
+		});
+	}
+
+	uint8_t* buffer = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		std::vector<uint8_t*>& free = mFree[sizeClass - sMinClass];
+		if (!free.empty())
+		{
+			buffer = free.back();
+			free.pop_back();
+		}
+	}
+
+	if (buffer == nullptr)
+	{
+		buffer = detail::sAllocate(size_t(1) << sizeClass, sAlignment);
+	}
+
+	return std::shared_ptr<uint8_t>(buffer, [this, sizeClass](uint8_t* aBuffer)
+	{
+		_release(sizeClass, aBuffer);
+	});
+}
+
+void ReadBufferPool::_release(const uint32_t aClass, uint8_t* aBuffer)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		std::vector<uint8_t*>& free = mFree[aClass - sMinClass];
+		if (free.size() < sBuffersPerClass)
+		{
+			free.push_back(aBuffer);
+			return;
+		}
+	}
+
+	detail::sFree(aBuffer, sAlignment);
+}
+
+void ReadBufferPool::trim()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	for (std::vector<uint8_t*>& free : mFree)
+	{
+		for (uint8_t* buffer : free)
+		{
+			detail::sFree(buffer, sAlignment);
+		}
+
+		free.clear();
+	}
+}
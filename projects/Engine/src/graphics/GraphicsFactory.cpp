@@ -12,6 +12,20 @@
 #include "graphics/vk/VulkanFramebuffer.h"
 #include "graphics/vk/VulkanSampler.h"
 #include "graphics/vk/VulkanTexture.h"
+#include "graphics/null/NullDescriptorPool.h"
+#include "graphics/null/NullDescriptorSet.h"
+#include "graphics/null/NullDescriptorSetLayout.h"
+#include "graphics/null/NullFramebuffer.h"
+#include "graphics/null/NullGraphicsPipeline.h"
+#include "graphics/null/NullIndexBuffer.h"
+#include "graphics/null/NullPipelineLayout.h"
+#include "graphics/null/NullRenderPass.h"
+#include "graphics/null/NullSampler.h"
+#include "graphics/null/NullShaderModule.h"
+#include "graphics/null/NullShaderStage.h"
+#include "graphics/null/NullTexture.h"
+#include "graphics/null/NullUniformBuffer.h"
+#include "graphics/null/NullVertexBuffer.h"
 
 GraphicsFactory& GraphicsFactory::instance()
 {
@@ -36,7 +50,8 @@ IDescriptorPool* GraphicsFactory::createDescriptorPool() const
 		}
 		case RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullDescriptorPool* pool = new NullDescriptorPool(mContext);
+			return pool;
 		}
 	}
 	return nullptr;
@@ -53,7 +68,8 @@ IShaderModule* GraphicsFactory::createShaderModule() const
 		}
 		case ERenderAPI::RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullShaderModule* module = new NullShaderModule(mContext);
+			return module;
 		}
 	}
 	return nullptr;
@@ -70,7 +86,8 @@ IShaderStage* GraphicsFactory::createShaderStage() const
 	}
 	case ERenderAPI::RENDERAPI_NONE:
 	{
-		return nullptr;
+		NullShaderStage* stage = new NullShaderStage(mContext);
+		return stage;
 	}
 	}
 	return nullptr;
@@ -88,7 +105,8 @@ ITexture* GraphicsFactory::createTexture() const
 
 		case ERenderAPI::RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullTexture* buffer = new NullTexture(mContext);
+			return buffer;
 		}
 	}
 
@@ -107,7 +125,8 @@ IVertexBuffer* GraphicsFactory::createVertexBuffer() const
 
 		case ERenderAPI::RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullVertexBuffer* buffer = new NullVertexBuffer(mContext);
+			return buffer;
 		}
 	}
 
@@ -126,7 +145,8 @@ IIndexBuffer* GraphicsFactory::createIndexBuffer() const
 
 		case ERenderAPI::RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullIndexBuffer* buffer = new NullIndexBuffer(mContext);
+			return buffer;
 		}
 	}
 
@@ -145,7 +165,8 @@ IPipelineLayout* GraphicsFactory::createPipelineLayout() const
 
 		case ERenderAPI::RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullPipelineLayout* layout = new NullPipelineLayout(mContext);
+			return layout;
 		}
 	}
 
@@ -162,7 +183,7 @@ IUniformBuffer* GraphicsFactory::createUniformBuffer() const
 		}
 		case RENDERAPI_NONE:
 		{
-			return nullptr;
+			return new NullUniformBuffer(mContext);
 		}
 		default:
 		{
@@ -181,7 +202,7 @@ IDescriptorSet* GraphicsFactory::createDescriptorSet() const
 		}
 		case RENDERAPI_NONE:
 		{
-			return nullptr;
+			return new NullDescriptorSet(mContext);
 		}
 		default:
 		{
@@ -201,7 +222,8 @@ IRenderPass* GraphicsFactory::createRenderPass() const
 		}
 		case RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullRenderPass* renderPass = new NullRenderPass(mContext);
+			return renderPass;
 		}
 	}
 	return nullptr;
@@ -218,7 +240,8 @@ ISampler* GraphicsFactory::createSampler() const
 		}
 		case RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullSampler* sampler = new NullSampler(mContext);
+			return sampler;
 		}
 	}
 	return nullptr;
@@ -235,7 +258,8 @@ IDescriptorSetLayout* GraphicsFactory::createDescriptorSetLayout() const
 		}
 		case RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullDescriptorSetLayout* setLayout = new NullDescriptorSetLayout(mContext);
+			return setLayout;
 		}
 	}
 	return nullptr;
@@ -252,7 +276,8 @@ IFramebuffer* GraphicsFactory::createFramebuffer() const
 	}
 	case RENDERAPI_NONE:
 	{
-		return nullptr;
+		NullFramebuffer* fb = new NullFramebuffer(mContext);
+		return fb;
 	}
 	}
 	return nullptr;
@@ -269,7 +294,8 @@ IGraphicsPipeline* GraphicsFactory::createGraphicsPipeline() const
 		}
 		case RENDERAPI_NONE:
 		{
-			return nullptr;
+			NullGraphicsPipeline* pipeline = new NullGraphicsPipeline(mContext);
+			return pipeline;
 		}
 	}
 	return nullptr;
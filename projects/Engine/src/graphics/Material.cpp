@@ -149,6 +149,24 @@ namespace detail
 		}
 	}
 
+	void MarkTextureUsersDirty(MaterialGraphNode* aNode, const ITexture* aTexture)
+	{
+		for (const auto& texture : aNode->materialHandle->mTextures)
+		{
+			if (texture.second == aTexture)
+			{
+				// Descendants inherit the texture, so the whole subtree rebinds
+				MarkMaterialAsDirty(aNode);
+				return;
+			}
+		}
+
+		for (const auto& child : aNode->children)
+		{
+			MarkTextureUsersDirty(child, aTexture);
+		}
+	}
+
 	void ResetNode(MaterialGraphNode* aNode)
 	{
 		auto children = aNode->children;
@@ -249,6 +267,11 @@ void Material::setTexture(const std::string& aName, ITexture* aTexture)
 	detail::MarkMaterialAsDirty(mGraphNode);
 }
 
+std::vector<ITexture*> Material::getTextures() const
+{
+	return _getActiveTextures();
+}
+
 MaterialInstance* Material::createInstance()
 {
 	Material* mat = detail::GetParent(mGraphNode);
@@ -29,6 +29,14 @@ void MaterialManager::reset()
 	mRootMaterials.clear();
 }
 
+void MaterialManager::markTextureDirty(const ITexture* aTexture)
+{
+	for (auto & material : mRootMaterials)
+	{
+		detail::MarkTextureUsersDirty(material->mGraphNode, aTexture);
+	}
+}
+
 Material* MaterialManager::createMaterial(const MaterialCreateInfo& aInfo)
 {
 	return new Material(aInfo);
@@ -1,8 +1,14 @@
 #include "graphics/Mesh.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "graphics/GraphicsFactory.h"
+#include "graphics/MeshGeometry.h"
 
 Mesh::Mesh()
-	: mVertexBuffer(nullptr), mIndexBuffer(nullptr)
+	: mVertexBuffer(nullptr), mIndexBuffer(nullptr), mVertexData(nullptr), mVertexCount(0), mVertexFormat(VERTEX_FORMAT_FLOAT),
+	  mIndexData(nullptr), mIndexCount(0), mIndexType(INDEX_TYPE_UINT32), mSkin(nullptr)
 {
 }
 
@@ -12,15 +18,32 @@ Mesh::~Mesh()
 	delete mIndexBuffer;
 }
 
-void Mesh::build()
+void Mesh::setVertexFormat(const EVertexFormat aFormat)
+{
+	mVertexFormat = aFormat;
+}
+
+void Mesh::interleave()
 {
 	const size_t vertexCount = positions.size();
 
+	std::vector<Vertex> vertices;
+	vertices.reserve(vertexCount);
+
+	mBoundsMin = vertexCount > 0 ? positions[0] : Vector3f(0.0f);
+	mBoundsMax = mBoundsMin;
+
 	for(size_t i = 0; i < vertexCount; i++)
 	{
 		Vertex v = {};
 		v.position = positions[i];
 
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			mBoundsMin.v[axis] = std::min(mBoundsMin.v[axis], v.position.v[axis]);
+			mBoundsMax.v[axis] = std::max(mBoundsMax.v[axis], v.position.v[axis]);
+		}
+
 		if(uvs.size() > i)
 		{
 			v.uv = uvs[i];
@@ -66,33 +89,68 @@ void Mesh::build()
 			v.color = { 1, 1, 1, 1 };
 		}
 
-		mVertices.push_back(v);
+		vertices.push_back(v);
 	}
 
+	mVertices.resize(vertexCount * VertexFormat::getStride(mVertexFormat));
+	VertexFormat::encode(vertices.data(), vertexCount, mVertexFormat, mBoundsMin, mBoundsMax, mVertices.data());
+
+	mVertexData = mVertices.data();
+	mVertexCount = vertexCount;
+	mIndexData = triangles.data();
+	mIndexCount = triangles.size();
+	mIndexType = INDEX_TYPE_UINT32;
+
+	mLods.clear();
+	mClusters.clear();
+}
+
+void Mesh::build()
+{
+	interleave();
+	_createBuffers();
+}
+
+void Mesh::build(const void* aVertices, const size_t aVertexCount, const EVertexFormat aVertexFormat,
+	const void* aIndices, const size_t aIndexCount, const EIndexType aIndexType,
+	const Vector3f& aBoundsMin, const Vector3f& aBoundsMax)
+{
+	mVertices.clear();
+
+	mVertexData = aVertices;
+	mVertexCount = aVertexCount;
+	mVertexFormat = aVertexFormat;
+	mIndexData = aIndices;
+	mIndexCount = aIndexCount;
+	mIndexType = aIndexType;
+	mSkin = nullptr;
+
+	mBoundsMin = aBoundsMin;
+	mBoundsMax = aBoundsMax;
+
+	mLods.clear();
+	mClusters.clear();
+
+	_createBuffers();
+}
+
+void Mesh::_createBuffers()
+{
 	VertexBufferCreateInfo vBufferCreateInfo = {};
 	vBufferCreateInfo.flags = 0;
 	vBufferCreateInfo.sharingMode = SHARING_MODE_EXCLUSIVE;
 	vBufferCreateInfo.usage = EBufferUsageFlagBits::BUFFER_USAGE_VERTEX_BUFFER | EBufferUsageFlagBits::BUFFER_USAGE_TRANSFER_DST;
-	vBufferCreateInfo.size = mVertices.size() * sizeof(Vertex);
+	vBufferCreateInfo.size = getSize();
 
 	mVertexBuffer = GraphicsFactory::instance().createVertexBuffer();
-
-	BufferLayout layout;
-	layout.push<Vector3f>("iPosition");
-	layout.push<Vector2f>("iTexCoord");
-	layout.push<Vector3f>("iNormal");
-	layout.push<Vector3f>("iTangent");
-	layout.push<Vector3f>("iBinormal");
-	layout.push<Vector4f>("iColor");
-	
-	mVertexBuffer->setLayout(layout);
+	mVertexBuffer->setLayout(VertexFormat::getLayout(mVertexFormat));
 	mVertexBuffer->construct(vBufferCreateInfo);
 
 	IndexBufferCreateInfo iBufferCreateInfo = {};
 	iBufferCreateInfo.flags = 0;
 	iBufferCreateInfo.sharingMode = SHARING_MODE_EXCLUSIVE;
 	iBufferCreateInfo.usage = EBufferUsageFlagBits::BUFFER_USAGE_INDEX_BUFFER | EBufferUsageFlagBits::BUFFER_USAGE_TRANSFER_DST;
-	iBufferCreateInfo.size = triangles.size() * sizeof(uint16_t);
+	iBufferCreateInfo.size = getIndicesSize();
 
 	mIndexBuffer = GraphicsFactory::instance().createIndexBuffer();
 	mIndexBuffer->construct(iBufferCreateInfo);
@@ -100,26 +158,73 @@ void Mesh::build()
 
 void Mesh::recalculateTangents()
 {
+	triangulate();
+
+	if (normals.size() != positions.size())
+	{
+		recalculateNormals();
+	}
 
+	// Without uvs every tangent ends up an arbitrary vector perpendicular to its normal
+	uvs.resize(positions.size(), Vector2f(0.0f));
+	tangents.resize(positions.size());
+	binormals.resize(positions.size());
+
+	MeshGeometry::computeTangents(positions.data(), uvs.data(), normals.data(), positions.size(),
+		triangles.data(), triangles.size(), tangents.data(), binormals.data());
 }
 
 void Mesh::recalculateNormals()
 {
+	triangulate();
 
+	normals.resize(positions.size());
+	MeshGeometry::computeNormals(positions.data(), positions.size(), triangles.data(), triangles.size(), normals.data());
 }
 
 void Mesh::calculateBinormals()
 {
-	for (size_t i = 0; i < tangents.size(); i++)
+	const size_t count = std::min(tangents.size(), normals.size());
+
+	// Binormals may hold the tangent handedness in x, anything missing is treated as right handed
+	binormals.resize(count, Vector3f(1.0f));
+
+	for (size_t i = 0; i < count; i++)
 	{
-		const float w = binormals[i].x;
+		const float w = binormals[i].x < 0.0f ? -1.0f : 1.0f;
 		binormals[i] = normals[i].cross(tangents[i]) * w;
 	}
 }
 
 void Mesh::triangulate()
 {
+	// Unindexed meshes are read as a triangle soup
+	if (triangles.empty())
+	{
+		triangles.resize(positions.size() - positions.size() % 3);
+
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			triangles[i] = static_cast<uint32_t>(i);
+		}
+
+		return;
+	}
+
+	// Drops a trailing partial triangle and any triangle referencing a vertex that does not exist
+	size_t count = 0;
 
+	for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+	{
+		if (triangles[i] < positions.size() && triangles[i + 1] < positions.size() && triangles[i + 2] < positions.size())
+		{
+			triangles[count++] = triangles[i];
+			triangles[count++] = triangles[i + 1];
+			triangles[count++] = triangles[i + 2];
+		}
+	}
+
+	triangles.resize(count);
 }
 
 IVertexBuffer* Mesh::getVBO() const
@@ -134,20 +239,242 @@ IIndexBuffer* Mesh::getIBO() const
 
 void* Mesh::getData() const
 {
-	return const_cast<Vertex*>(mVertices.data());
+	return const_cast<void*>(mVertexData);
 }
 
 void* Mesh::getIndices() const
 {
-	return const_cast<uint16_t*>(triangles.data());
+	return const_cast<void*>(mIndexData);
 }
 
 size_t Mesh::getIndicesSize() const
 {
-	return triangles.size() * sizeof(uint16_t);
+	return mIndexCount * (mIndexType == INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t));
 }
 
 size_t Mesh::getSize() const
 {
-	return mVertices.size() * sizeof(Vertex);
+	return mVertexCount * VertexFormat::getStride(mVertexFormat);
+}
+
+size_t Mesh::getVertexCount() const
+{
+	return mVertexCount;
+}
+
+size_t Mesh::getIndexCount() const
+{
+	return mIndexCount;
+}
+
+EIndexType Mesh::getIndexType() const
+{
+	return mIndexType;
+}
+
+EVertexFormat Mesh::getVertexFormat() const
+{
+	return mVertexFormat;
+}
+
+void Mesh::setSkin(const SkinVertex* aSkin)
+{
+	mSkin = aSkin;
+}
+
+const SkinVertex* Mesh::getSkin() const
+{
+	return mSkin;
+}
+
+Vector3f Mesh::getPositionScale() const
+{
+	if (mVertexFormat == VERTEX_FORMAT_UNORM16 || mVertexFormat == VERTEX_FORMAT_UNORM16_COLOR)
+	{
+		return mBoundsMax - mBoundsMin;
+	}
+
+	return Vector3f(1.0f);
+}
+
+Vector3f Mesh::getPositionOffset() const
+{
+	if (mVertexFormat == VERTEX_FORMAT_UNORM16 || mVertexFormat == VERTEX_FORMAT_UNORM16_COLOR)
+	{
+		return mBoundsMin;
+	}
+
+	return Vector3f(0.0f);
+}
+
+size_t Mesh::getMemoryUsage() const
+{
+	size_t bytes = positions.capacity() * sizeof(Vector3f) + uvs.capacity() * sizeof(Vector2f) +
+		normals.capacity() * sizeof(Vector3f) + tangents.capacity() * sizeof(Vector3f) +
+		binormals.capacity() * sizeof(Vector3f) + colors.capacity() * sizeof(Vector4f) +
+		triangles.capacity() * sizeof(uint32_t) + mVertices.capacity() + mLods.capacity() * sizeof(MeshLod) +
+		mClusters.capacity() * sizeof(MeshCluster);
+
+	if (mVertexBuffer != nullptr)
+	{
+		bytes += getSize();
+	}
+
+	if (mIndexBuffer != nullptr)
+	{
+		bytes += getIndicesSize();
+	}
+
+	return bytes;
+}
+
+const Vector3f& Mesh::getBoundsMin() const
+{
+	return mBoundsMin;
+}
+
+const Vector3f& Mesh::getBoundsMax() const
+{
+	return mBoundsMax;
+}
+
+void Mesh::setLods(std::vector<MeshLod> aLods)
+{
+	mLods = std::move(aLods);
+}
+
+size_t Mesh::getLodCount() const
+{
+	return std::max<size_t>(mLods.size(), 1);
+}
+
+MeshLod Mesh::getLod(const size_t aLod) const
+{
+	if (aLod < mLods.size())
+	{
+		return mLods[aLod];
+	}
+
+	return { 0, static_cast<uint32_t>(mIndexCount), 0.0f, 0, 0 };
+}
+
+size_t Mesh::selectLod(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection,
+	const float aViewportHeight, const float aMaxPixelError) const
+{
+	if (mLods.size() < 2)
+	{
+		return 0;
+	}
+
+	float scale;
+	float radius;
+	float pixelsPerUnit;
+
+	if (!_project(aModel, aView, aProjection, aViewportHeight, scale, radius, pixelsPerUnit))
+	{
+		return 0;
+	}
+
+	for (size_t lod = mLods.size() - 1; lod > 0; lod--)
+	{
+		if (mLods[lod].error * scale * pixelsPerUnit <= aMaxPixelError)
+		{
+			return lod;
+		}
+	}
+
+	return 0;
+}
+
+float Mesh::getScreenSize(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection,
+	const float aViewportHeight) const
+{
+	float scale;
+	float radius;
+	float pixelsPerUnit;
+
+	if (!_project(aModel, aView, aProjection, aViewportHeight, scale, radius, pixelsPerUnit))
+	{
+		return std::numeric_limits<float>::max();
+	}
+
+	return 2.0f * radius * pixelsPerUnit;
+}
+
+bool Mesh::_project(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection, const float aViewportHeight,
+	float& aScale, float& aRadius, float& aPixelsPerUnit) const
+{
+	// Bounding sphere of the bounds in world space, scaled by the largest axis scale of the model
+	aScale = std::max(std::max(Vector3f(aModel.m00, aModel.m01, aModel.m02).length(),
+		Vector3f(aModel.m10, aModel.m11, aModel.m12).length()), Vector3f(aModel.m20, aModel.m21, aModel.m22).length());
+
+	const Vector3f center = aModel * ((mBoundsMin + mBoundsMax) * 0.5f);
+	aRadius = (mBoundsMax - mBoundsMin).length() * 0.5f * aScale;
+
+	Matrix4f camera = aView;
+	camera.inverse();
+
+	// m23 is zero for orthographic projections, where the size on screen does not depend on the distance
+	aPixelsPerUnit = aProjection.m11 * aViewportHeight * 0.5f;
+
+	if (aProjection.m23 != 0.0f)
+	{
+		const float distance = center.distance(Vector3f(camera.m30, camera.m31, camera.m32)) - aRadius;
+		if (distance <= 0.0f)
+		{
+			return false;
+		}
+
+		aPixelsPerUnit /= distance;
+	}
+
+	return true;
+}
+
+void Mesh::setClusters(std::vector<MeshCluster> aClusters)
+{
+	mClusters = std::move(aClusters);
+}
+
+const std::vector<MeshCluster>& Mesh::getClusters() const
+{
+	return mClusters;
+}
+
+size_t Mesh::cullClusters(const size_t aLod, const ClusterCullView& aView, std::vector<uint32_t>& aIndices) const
+{
+	const MeshLod lod = getLod(aLod);
+
+	const auto append = [&](const uint32_t aFirst, const uint32_t aCount)
+	{
+		const size_t offset = aIndices.size();
+		aIndices.resize(offset + aCount);
+
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			aIndices[offset + i] = mIndexType == INDEX_TYPE_UINT16 ? static_cast<const uint16_t*>(mIndexData)[aFirst + i] :
+				static_cast<const uint32_t*>(mIndexData)[aFirst + i];
+		}
+	};
+
+	if (lod.clusterCount == 0 || static_cast<size_t>(lod.firstCluster) + lod.clusterCount > mClusters.size())
+	{
+		append(lod.firstIndex, lod.indexCount);
+		return 1;
+	}
+
+	size_t visible = 0;
+
+	for (uint32_t i = lod.firstCluster; i < lod.firstCluster + lod.clusterCount; i++)
+	{
+		const MeshCluster& cluster = mClusters[i];
+
+		if (MeshClusters::isVisible(cluster, aView))
+		{
+			append(cluster.firstIndex, cluster.indexCount);
+			visible++;
+		}
+	}
+
+	return visible;
 }
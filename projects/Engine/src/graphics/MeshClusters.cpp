@@ -0,0 +1,311 @@
+#include "graphics/MeshClusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace detail
+{
+	static constexpr uint32_t sNoCluster = ~0u;
+
+	// Smallest cosine between the cone axis and the widest normal a cluster may keep its cone with. Wider
+	// cones cull too rarely to be worth testing, so they are skipped.
+	static constexpr float sMinConeSpread = 0.1f;
+
+	// Triangles touching each vertex of one index range, as offsets into one flat list
+	struct ClusterAdjacency
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+	};
+
+	static void sBuildClusterAdjacency(const uint32_t* aIndices, const size_t aIndexCount, const size_t aVertexCount,
+		ClusterAdjacency& aAdjacency)
+	{
+		aAdjacency.offsets.assign(aVertexCount + 1, 0);
+		aAdjacency.triangles.resize(aIndexCount);
+
+		for (size_t i = 0; i < aIndexCount; i++)
+		{
+			aAdjacency.offsets[aIndices[i] + 1]++;
+		}
+
+		for (size_t i = 0; i < aVertexCount; i++)
+		{
+			aAdjacency.offsets[i + 1] += aAdjacency.offsets[i];
+		}
+
+		std::vector<uint32_t> cursor(aAdjacency.offsets.begin(), aAdjacency.offsets.end() - 1);
+
+		for (size_t i = 0; i < aIndexCount; i++)
+		{
+			aAdjacency.triangles[cursor[aIndices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	static void sComputeBounds(const std::vector<Vertex>& aVertices, const uint32_t* aIndices, MeshCluster& aCluster)
+	{
+		Vector3f boundsMin(std::numeric_limits<float>::max());
+		Vector3f boundsMax(-std::numeric_limits<float>::max());
+
+		Vector3f normalSum(0.0f);
+
+		for (uint32_t i = 0; i < aCluster.indexCount; i += 3)
+		{
+			const Vector3f& p0 = aVertices[aIndices[i + 0]].position;
+			const Vector3f& p1 = aVertices[aIndices[i + 1]].position;
+			const Vector3f& p2 = aVertices[aIndices[i + 2]].position;
+
+			for (const Vector3f* p : { &p0, &p1, &p2 })
+			{
+				for (size_t axis = 0; axis < 3; axis++)
+				{
+					boundsMin.v[axis] = std::min(boundsMin.v[axis], p->v[axis]);
+					boundsMax.v[axis] = std::max(boundsMax.v[axis], p->v[axis]);
+				}
+			}
+
+			// Area weighted, so slivers barely move the axis
+			normalSum += (p1 - p0).cross(p2 - p0);
+		}
+
+		aCluster.center = (boundsMin + boundsMax) * 0.5f;
+		aCluster.radius = 0.0f;
+
+		for (uint32_t i = 0; i < aCluster.indexCount; i++)
+		{
+			aCluster.radius = std::max(aCluster.radius, aCluster.center.distance(aVertices[aIndices[i]].position));
+		}
+
+		aCluster.coneAxis = Vector3f(0.0f);
+		aCluster.coneCutoff = 1.0f;
+
+		const float sumLength = normalSum.length();
+		if (sumLength <= 0.0f)
+		{
+			return;
+		}
+
+		const Vector3f axis = normalSum * (1.0f / sumLength);
+
+		float minDot = 1.0f;
+
+		for (uint32_t i = 0; i < aCluster.indexCount; i += 3)
+		{
+			const Vector3f& p0 = aVertices[aIndices[i + 0]].position;
+
+			Vector3f normal = (aVertices[aIndices[i + 1]].position - p0).cross(aVertices[aIndices[i + 2]].position - p0);
+
+			const float length = normal.length();
+			if (length > 0.0f)
+			{
+				minDot = std::min(minDot, normal.dot(axis) / length);
+			}
+		}
+
+		if (minDot >= sMinConeSpread)
+		{
+			aCluster.coneAxis = axis;
+			aCluster.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		}
+	}
+}
+
+ClusterCullView ClusterCullView::create(const Matrix4f& aModel, const Matrix4f& aView, const Matrix4f& aProjection)
+{
+	const Matrix4f modelView = aView._internal_value * aModel._internal_value;
+	const Matrix4f clip = aProjection._internal_value * modelView._internal_value;
+
+	// Gribb and Hartmann, rows of the clip matrix. Depth is zero to one, so the near plane is the third row alone.
+	const Vector4f row0(clip.m00, clip.m10, clip.m20, clip.m30);
+	const Vector4f row1(clip.m01, clip.m11, clip.m21, clip.m31);
+	const Vector4f row2(clip.m02, clip.m12, clip.m22, clip.m32);
+	const Vector4f row3(clip.m03, clip.m13, clip.m23, clip.m33);
+
+	ClusterCullView view;
+	view.planes[0] = row3 + row0;
+	view.planes[1] = row3 - row0;
+	view.planes[2] = row3 + row1;
+	view.planes[3] = row3 - row1;
+	view.planes[4] = row2;
+	view.planes[5] = row3 - row2;
+
+	for (Vector4f& plane : view.planes)
+	{
+		const float length = Vector3f(plane.x, plane.y, plane.z).length();
+		if (length > 0.0f)
+		{
+			plane *= 1.0f / length;
+		}
+	}
+
+	Matrix4f camera = modelView;
+	camera.inverse();
+
+	view.cameraPosition = Vector3f(camera.m30, camera.m31, camera.m32);
+	view.perspective = aProjection.m23 != 0.0f;
+
+	return view;
+}
+
+std::vector<MeshCluster> MeshClusters::build(const std::vector<Vertex>& aVertices, uint32_t* aIndices, const size_t aIndexCount)
+{
+	const size_t triangleCount = aIndexCount / 3;
+
+	detail::ClusterAdjacency adjacency;
+	detail::sBuildClusterAdjacency(aIndices, triangleCount * 3, aVertices.size(), adjacency);
+
+	std::vector<uint32_t> vertexCluster(aVertices.size(), detail::sNoCluster);
+	std::vector<bool> used(triangleCount, false);
+
+	std::vector<uint32_t> order;
+	order.reserve(triangleCount);
+
+	std::vector<MeshCluster> clusters;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> members;
+
+	size_t nextSeed = 0;
+
+	while (order.size() < triangleCount)
+	{
+		const uint32_t cluster = static_cast<uint32_t>(clusters.size());
+		uint32_t vertexCount = 0;
+
+		candidates.clear();
+		members.clear();
+
+		while (members.size() < sMaxTriangles)
+		{
+			// Prefer the adjacent triangle adding the fewest vertices, then the one that came first
+			uint32_t best = detail::sNoCluster;
+			uint32_t bestNew = 4;
+
+			for (size_t i = 0; i < candidates.size();)
+			{
+				const uint32_t triangle = candidates[i];
+
+				if (used[triangle])
+				{
+					candidates[i] = candidates.back();
+					candidates.pop_back();
+					continue;
+				}
+
+				uint32_t added = 0;
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					added += vertexCluster[aIndices[triangle * 3 + corner]] != cluster ? 1 : 0;
+				}
+
+				if (added < bestNew || (added == bestNew && triangle < best))
+				{
+					best = triangle;
+					bestNew = added;
+				}
+
+				i++;
+			}
+
+			// Nothing adjacent left, continue with the next triangle in the original order
+			if (best == detail::sNoCluster)
+			{
+				while (nextSeed < triangleCount && used[nextSeed])
+				{
+					nextSeed++;
+				}
+
+				if (nextSeed == triangleCount)
+				{
+					break;
+				}
+
+				best = static_cast<uint32_t>(nextSeed);
+				bestNew = 0;
+
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					bestNew += vertexCluster[aIndices[best * 3 + corner]] != cluster ? 1 : 0;
+				}
+			}
+
+			if (vertexCount + bestNew > sMaxVertices)
+			{
+				break;
+			}
+
+			used[best] = true;
+			members.push_back(best);
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				const uint32_t vertex = aIndices[best * 3 + corner];
+				if (vertexCluster[vertex] == cluster)
+				{
+					continue;
+				}
+
+				vertexCluster[vertex] = cluster;
+				vertexCount++;
+
+				for (uint32_t at = adjacency.offsets[vertex]; at < adjacency.offsets[vertex + 1]; at++)
+				{
+					if (!used[adjacency.triangles[at]])
+					{
+						candidates.push_back(adjacency.triangles[at]);
+					}
+				}
+			}
+		}
+
+		// Keeps whatever order the triangles were optimized in before
+		std::sort(members.begin(), members.end());
+
+		MeshCluster result = {};
+		result.firstIndex = static_cast<uint32_t>(order.size() * 3);
+		result.indexCount = static_cast<uint32_t>(members.size() * 3);
+
+		order.insert(order.end(), members.begin(), members.end());
+		clusters.push_back(result);
+	}
+
+	std::vector<uint32_t> reordered(triangleCount * 3);
+
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		std::copy(aIndices + order[i] * 3, aIndices + order[i] * 3 + 3, reordered.begin() + i * 3);
+	}
+
+	std::copy(reordered.begin(), reordered.end(), aIndices);
+
+	for (MeshCluster& cluster : clusters)
+	{
+		detail::sComputeBounds(aVertices, aIndices + cluster.firstIndex, cluster);
+	}
+
+	return clusters;
+}
+
+bool MeshClusters::isVisible(const MeshCluster& aCluster, const ClusterCullView& aView)
+{
+	for (const Vector4f& plane : aView.planes)
+	{
+		if (plane.x * aCluster.center.x + plane.y * aCluster.center.y + plane.z * aCluster.center.z + plane.w < -aCluster.radius)
+		{
+			return false;
+		}
+	}
+
+	if (aView.perspective && aCluster.coneCutoff < 1.0f)
+	{
+		// Every triangle faces away once the whole sphere sits inside the cone opened behind the cluster
+		const Vector3f toCluster = aCluster.center - aView.cameraPosition;
+
+		if (toCluster.dot(aCluster.coneAxis) >= aCluster.coneCutoff * toCluster.length() + aCluster.radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
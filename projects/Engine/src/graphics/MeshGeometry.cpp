@@ -0,0 +1,198 @@
+#include "graphics/MeshGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace detail
+{
+	static constexpr size_t sTriangleGrainSize = 4096;
+	static constexpr size_t sVertexGrainSize = 4096;
+
+	// Triangles using each vertex, plus the corner the vertex sits in, as offsets into one flat list
+	struct CornerTable
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> corners;
+	};
+
+	static void sBuildCornerTable(const uint32_t* aIndices, const size_t aIndexCount, const size_t aVertexCount, CornerTable& aTable)
+	{
+		aTable.offsets.assign(aVertexCount + 1, 0);
+		aTable.corners.resize(aIndexCount);
+
+		for (size_t i = 0; i < aIndexCount; i++)
+		{
+			aTable.offsets[aIndices[i] + 1]++;
+		}
+
+		for (size_t i = 0; i < aVertexCount; i++)
+		{
+			aTable.offsets[i + 1] += aTable.offsets[i];
+		}
+
+		std::vector<uint32_t> cursor(aTable.offsets.begin(), aTable.offsets.end() - 1);
+
+		for (size_t i = 0; i < aIndexCount; i++)
+		{
+			aTable.corners[cursor[aIndices[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	// Any unit vector perpendicular to aNormal
+	static Vector3f sPerpendicular(const Vector3f& aNormal)
+	{
+		const Vector3f axis = std::abs(aNormal.x) < 0.9f ? Vector3f(1.0f, 0.0f, 0.0f) : Vector3f(0.0f, 1.0f, 0.0f);
+		Vector3f perpendicular = aNormal.cross(axis);
+
+		const float length = perpendicular.length();
+		return length > 0.0f ? perpendicular * (1.0f / length) : Vector3f(1.0f, 0.0f, 0.0f);
+	}
+
+	// aVector with its component along aNormal removed, normalized, or zero when nothing is left
+	static Vector3f sProjectNormalized(const Vector3f& aVector, const Vector3f& aNormal)
+	{
+		Vector3f projected = aVector - aNormal * aNormal.dot(aVector);
+
+		const float length = projected.length();
+		return length > 1e-20f ? projected * (1.0f / length) : Vector3f(0.0f);
+	}
+}
+
+void MeshGeometry::computeNormals(const Vector3f* aPositions, const size_t aVertexCount,
+	const uint32_t* aIndices, const size_t aIndexCount, Vector3f* aNormals)
+{
+	const size_t triangleCount = aIndexCount / 3;
+
+	// Unnormalized face normals are twice the triangle area long, which is the weighting wanted
+	std::vector<Vector3f> faceNormals(triangleCount);
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, triangleCount, detail::sTriangleGrainSize),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t i = aRange.begin(); i != aRange.end(); ++i)
+			{
+				const Vector3f& p0 = aPositions[aIndices[i * 3 + 0]];
+				const Vector3f& p1 = aPositions[aIndices[i * 3 + 1]];
+				const Vector3f& p2 = aPositions[aIndices[i * 3 + 2]];
+
+				faceNormals[i] = (p1 - p0).cross(p2 - p0);
+			}
+		});
+
+	detail::CornerTable table;
+	detail::sBuildCornerTable(aIndices, triangleCount * 3, aVertexCount, table);
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aVertexCount, detail::sVertexGrainSize),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t vertex = aRange.begin(); vertex != aRange.end(); ++vertex)
+			{
+				Vector3f sum(0.0f);
+
+				for (uint32_t at = table.offsets[vertex]; at < table.offsets[vertex + 1]; at++)
+				{
+					sum += faceNormals[table.corners[at] / 3];
+				}
+
+				const float length = sum.length();
+				aNormals[vertex] = length > 0.0f ? sum * (1.0f / length) : Vector3f(0.0f, 1.0f, 0.0f);
+			}
+		});
+}
+
+void MeshGeometry::computeTangents(const Vector3f* aPositions, const Vector2f* aUvs, const Vector3f* aNormals,
+	const size_t aVertexCount, const uint32_t* aIndices, const size_t aIndexCount,
+	Vector3f* aTangents, Vector3f* aBinormals)
+{
+	const size_t triangleCount = aIndexCount / 3;
+
+	// Directions of increasing u and v over each triangle, zero where the uvs are degenerate
+	std::vector<Vector3f> faceTangents(triangleCount);
+	std::vector<Vector3f> faceBitangents(triangleCount);
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, triangleCount, detail::sTriangleGrainSize),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t i = aRange.begin(); i != aRange.end(); ++i)
+			{
+				const uint32_t i0 = aIndices[i * 3 + 0];
+				const uint32_t i1 = aIndices[i * 3 + 1];
+				const uint32_t i2 = aIndices[i * 3 + 2];
+
+				const Vector3f e1 = aPositions[i1] - aPositions[i0];
+				const Vector3f e2 = aPositions[i2] - aPositions[i0];
+
+				const float du1 = aUvs[i1].x - aUvs[i0].x;
+				const float dv1 = aUvs[i1].y - aUvs[i0].y;
+				const float du2 = aUvs[i2].x - aUvs[i0].x;
+				const float dv2 = aUvs[i2].y - aUvs[i0].y;
+
+				const float determinant = du1 * dv2 - du2 * dv1;
+
+				if (std::abs(determinant) <= 1e-20f)
+				{
+					faceTangents[i] = Vector3f(0.0f);
+					faceBitangents[i] = Vector3f(0.0f);
+					continue;
+				}
+
+				// Only the directions matter, the sign of the determinant keeps mirrored triangles mirrored
+				const float sign = determinant > 0.0f ? 1.0f : -1.0f;
+
+				faceTangents[i] = (e1 * dv2 - e2 * dv1) * sign;
+				faceBitangents[i] = (e2 * du1 - e1 * du2) * sign;
+			}
+		});
+
+	detail::CornerTable table;
+	detail::sBuildCornerTable(aIndices, triangleCount * 3, aVertexCount, table);
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aVertexCount, detail::sVertexGrainSize),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t vertex = aRange.begin(); vertex != aRange.end(); ++vertex)
+			{
+				const Vector3f& normal = aNormals[vertex];
+
+				Vector3f tangent(0.0f);
+				Vector3f bitangent(0.0f);
+
+				for (uint32_t at = table.offsets[vertex]; at < table.offsets[vertex + 1]; at++)
+				{
+					const uint32_t corner = table.corners[at];
+					const uint32_t triangle = corner / 3;
+					const uint32_t first = triangle * 3;
+
+					const Vector3f& p = aPositions[vertex];
+					Vector3f toNext = aPositions[aIndices[first + (corner + 1) % 3]] - p;
+					Vector3f toPrevious = aPositions[aIndices[first + (corner + 2) % 3]] - p;
+
+					const float lengths = toNext.length() * toPrevious.length();
+					if (lengths <= 0.0f)
+					{
+						continue;
+					}
+
+					const float angle = std::acos(std::max(-1.0f, std::min(1.0f, toNext.dot(toPrevious) / lengths)));
+
+					tangent += detail::sProjectNormalized(faceTangents[triangle], normal) * angle;
+					bitangent += detail::sProjectNormalized(faceBitangents[triangle], normal) * angle;
+				}
+
+				tangent = detail::sProjectNormalized(tangent, normal);
+				if (tangent.length() == 0.0f)
+				{
+					tangent = detail::sPerpendicular(normal);
+				}
+
+				const Vector3f binormal = normal.cross(tangent);
+
+				aTangents[vertex] = tangent;
+				aBinormals[vertex] = binormal.dot(bitangent) < 0.0f ? binormal * -1.0f : binormal;
+			}
+		});
+}
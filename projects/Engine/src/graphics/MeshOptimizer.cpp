@@ -0,0 +1,309 @@
+#include "graphics/MeshOptimizer.h"
+
+#include <cstring>
+
+#include "utils/Hash.h"
+
+namespace detail
+{
+	static constexpr uint32_t sInvalidIndex = ~0u;
+
+	// Triangles using each vertex, as offsets into one flat list
+	struct VertexAdjacency
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+	};
+
+	static void sBuildAdjacency(const std::vector<uint32_t>& aIndices, const size_t aVertexCount, VertexAdjacency& aAdjacency)
+	{
+		aAdjacency.offsets.assign(aVertexCount + 1, 0);
+		aAdjacency.triangles.resize(aIndices.size());
+
+		for (const uint32_t index : aIndices)
+		{
+			aAdjacency.offsets[index + 1]++;
+		}
+
+		for (size_t i = 0; i < aVertexCount; i++)
+		{
+			aAdjacency.offsets[i + 1] += aAdjacency.offsets[i];
+		}
+
+		std::vector<uint32_t> cursor(aAdjacency.offsets.begin(), aAdjacency.offsets.end() - 1);
+
+		for (size_t i = 0; i < aIndices.size(); i++)
+		{
+			aAdjacency.triangles[cursor[aIndices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	// Picks the next fanning vertex for Tipsify: the candidate that stays in the cache longest while all its
+	// remaining triangles are emitted, otherwise the most recent dead end, otherwise the next vertex in input order
+	static uint32_t sNextVertex(const std::vector<uint32_t>& aCandidates, const std::vector<uint32_t>& aLiveTriangles,
+		const std::vector<uint32_t>& aCacheTime, const uint32_t aTime, const uint32_t aCacheSize,
+		std::vector<uint32_t>& aDeadEnds, size_t& aCursor)
+	{
+		uint32_t best = sInvalidIndex;
+		int64_t bestPriority = -1;
+
+		for (const uint32_t vertex : aCandidates)
+		{
+			if (aLiveTriangles[vertex] == 0)
+			{
+				continue;
+			}
+
+			int64_t priority = 0;
+			const int64_t age = static_cast<int64_t>(aTime) - aCacheTime[vertex];
+
+			if (age + 2 * static_cast<int64_t>(aLiveTriangles[vertex]) <= aCacheSize)
+			{
+				priority = age;
+			}
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				best = vertex;
+			}
+		}
+
+		if (best != sInvalidIndex)
+		{
+			return best;
+		}
+
+		while (!aDeadEnds.empty())
+		{
+			const uint32_t vertex = aDeadEnds.back();
+			aDeadEnds.pop_back();
+
+			if (aLiveTriangles[vertex] > 0)
+			{
+				return vertex;
+			}
+		}
+
+		while (aCursor < aLiveTriangles.size())
+		{
+			const size_t vertex = aCursor++;
+
+			if (aLiveTriangles[vertex] > 0)
+			{
+				return static_cast<uint32_t>(vertex);
+			}
+		}
+
+		return sInvalidIndex;
+	}
+}
+
+std::vector<uint32_t> MeshOptimizer::weldVertices(std::vector<Vertex>& aVertices, std::vector<uint32_t>& aIndices,
+	const void* aAttributes, const size_t aAttributeSize)
+{
+	size_t tableSize = 16;
+	while (tableSize < aVertices.size() * 2)
+	{
+		tableSize *= 2;
+	}
+
+	const uint8_t* attributes = static_cast<const uint8_t*>(aAttributes);
+	const size_t attributeSize = attributes != nullptr ? aAttributeSize : 0;
+
+	// Compares against the input, which stays untouched until every vertex found its slot
+	const auto equal = [&](const uint32_t aLeft, const size_t aRight)
+	{
+		return memcmp(&aVertices[aLeft], &aVertices[aRight], sizeof(Vertex)) == 0 &&
+			(attributeSize == 0 || memcmp(attributes + aLeft * attributeSize, attributes + aRight * attributeSize, attributeSize) == 0);
+	};
+
+	std::vector<uint32_t> table(tableSize, detail::sInvalidIndex);
+	std::vector<uint32_t> remap(aVertices.size());
+	std::vector<uint32_t> origins;
+
+	for (size_t i = 0; i < aVertices.size(); i++)
+	{
+		uint64_t hash = Hash::xxh64(&aVertices[i], sizeof(Vertex));
+		if (attributeSize != 0)
+		{
+			hash = Hash::xxh64(attributes + i * attributeSize, attributeSize, hash);
+		}
+
+		size_t slot = hash & (tableSize - 1);
+
+		// Linear probing, the table is at most half full
+		while (table[slot] != detail::sInvalidIndex && !equal(origins[table[slot]], i))
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		if (table[slot] == detail::sInvalidIndex)
+		{
+			table[slot] = static_cast<uint32_t>(origins.size());
+			origins.push_back(static_cast<uint32_t>(i));
+		}
+
+		remap[i] = table[slot];
+	}
+
+	for (size_t i = 0; i < origins.size(); i++)
+	{
+		aVertices[i] = aVertices[origins[i]];
+	}
+
+	for (uint32_t& index : aIndices)
+	{
+		index = remap[index];
+	}
+
+	aVertices.resize(origins.size());
+
+	return origins;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& aIndices, const size_t aVertexCount, const uint32_t aCacheSize)
+{
+	const size_t triangleCount = aIndices.size() / 3;
+	if (triangleCount == 0 || aVertexCount == 0)
+	{
+		return;
+	}
+
+	detail::VertexAdjacency adjacency;
+	detail::sBuildAdjacency(aIndices, aVertexCount, adjacency);
+
+	std::vector<uint32_t> liveTriangles(aVertexCount);
+	for (size_t i = 0; i < aVertexCount; i++)
+	{
+		liveTriangles[i] = adjacency.offsets[i + 1] - adjacency.offsets[i];
+	}
+
+	std::vector<uint32_t> cacheTime(aVertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> deadEnds;
+	std::vector<uint32_t> candidates;
+
+	std::vector<uint32_t> output;
+	output.reserve(triangleCount * 3);
+
+	uint32_t time = aCacheSize + 1;
+	size_t cursor = 0;
+
+	uint32_t fanning = detail::sNextVertex(candidates, liveTriangles, cacheTime, time, aCacheSize, deadEnds, cursor);
+
+	while (fanning != detail::sInvalidIndex)
+	{
+		candidates.clear();
+
+		for (uint32_t i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; i++)
+		{
+			const uint32_t triangle = adjacency.triangles[i];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+
+			for (size_t corner = 0; corner < 3; corner++)
+			{
+				const uint32_t vertex = aIndices[triangle * 3 + corner];
+
+				output.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+
+				if (time - cacheTime[vertex] > aCacheSize)
+				{
+					cacheTime[vertex] = time;
+					time++;
+				}
+			}
+
+			emitted[triangle] = true;
+		}
+
+		fanning = detail::sNextVertex(candidates, liveTriangles, cacheTime, time, aCacheSize, deadEnds, cursor);
+	}
+
+	// Trailing indices of an incomplete triangle are kept as they were
+	output.insert(output.end(), aIndices.begin() + triangleCount * 3, aIndices.end());
+	aIndices.swap(output);
+}
+
+std::vector<uint32_t> MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& aVertices, std::vector<uint32_t>& aIndices)
+{
+	std::vector<uint32_t> remap(aVertices.size(), detail::sInvalidIndex);
+	std::vector<uint32_t> origins;
+	std::vector<Vertex> vertices;
+	vertices.reserve(aVertices.size());
+
+	for (uint32_t& index : aIndices)
+	{
+		if (remap[index] == detail::sInvalidIndex)
+		{
+			remap[index] = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(aVertices[index]);
+			origins.push_back(index);
+		}
+
+		index = remap[index];
+	}
+
+	aVertices.swap(vertices);
+
+	return origins;
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const uint32_t* aIndices, const size_t aIndexCount, const size_t aVertexCount,
+	const uint32_t aCacheSize)
+{
+	VertexCacheStats stats;
+	stats.triangles = aIndexCount / 3;
+
+	// A vertex is cached while fewer than aCacheSize misses happened since it was inserted
+	std::vector<size_t> insertedAt(aVertexCount, 0);
+	std::vector<bool> referenced(aVertexCount, false);
+
+	for (size_t i = 0; i < aIndexCount; i++)
+	{
+		const uint32_t vertex = aIndices[i];
+
+		if (!referenced[vertex])
+		{
+			referenced[vertex] = true;
+			stats.vertices++;
+		}
+		else if (stats.misses - insertedAt[vertex] < aCacheSize)
+		{
+			continue;
+		}
+
+		insertedAt[vertex] = stats.misses;
+		stats.misses++;
+	}
+
+	return stats;
+}
+
+MeshOptimizeResult MeshOptimizer::optimize(std::vector<Vertex>& aVertices, std::vector<uint32_t>& aIndices,
+	const void* aAttributes, const size_t aAttributeSize)
+{
+	MeshOptimizeResult result;
+	result.verticesBefore = aVertices.size();
+	result.before = analyzeVertexCache(aIndices.data(), aIndices.size(), aVertices.size());
+
+	const std::vector<uint32_t> welded = weldVertices(aVertices, aIndices, aAttributes, aAttributeSize);
+	optimizeVertexCache(aIndices, aVertices.size());
+
+	result.remap = optimizeVertexFetch(aVertices, aIndices);
+	for (uint32_t& index : result.remap)
+	{
+		index = welded[index];
+	}
+
+	result.verticesAfter = aVertices.size();
+	result.after = analyzeVertexCache(aIndices.data(), aIndices.size(), aVertices.size());
+
+	return result;
+}
@@ -0,0 +1,508 @@
+#include "graphics/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace detail
+{
+	// Position, uv and normal. Attributes are weighted against positions normalized to a unit extent.
+	static constexpr size_t sQuadricSize = 8;
+	static constexpr float sUvWeight = 0.25f;
+	static constexpr float sNormalWeight = 0.25f;
+
+	// Below this cosine between a triangle's normal before and after a collapse the collapse is rejected
+	static constexpr float sMaxNormalRotation = 0.25f;
+
+	using AttributeVector = float[sQuadricSize];
+
+	// Symmetric A stored as its upper triangle, Q(v) = (v'Av + 2b'v + c) / w. Every plane is weighted by the
+	// area of its triangle and w is the total area, which keeps Q a squared distance.
+	struct Quadric
+	{
+		float a[sQuadricSize * (sQuadricSize + 1) / 2] = {};
+		float b[sQuadricSize] = {};
+		float c = 0.0f;
+		float w = 0.0f;
+
+		Quadric& operator += (const Quadric& aOther)
+		{
+			for (size_t i = 0; i < sizeof(a) / sizeof(float); i++)
+			{
+				a[i] += aOther.a[i];
+			}
+
+			for (size_t i = 0; i < sQuadricSize; i++)
+			{
+				b[i] += aOther.b[i];
+			}
+
+			c += aOther.c;
+			w += aOther.w;
+			return *this;
+		}
+
+		float evaluate(const AttributeVector& aV) const
+		{
+			float result = c;
+			size_t k = 0;
+
+			for (size_t i = 0; i < sQuadricSize; i++)
+			{
+				result += a[k++] * aV[i] * aV[i];
+
+				for (size_t j = i + 1; j < sQuadricSize; j++)
+				{
+					result += 2.0f * a[k++] * aV[i] * aV[j];
+				}
+
+				result += 2.0f * b[i] * aV[i];
+			}
+
+			return w > 0.0f ? std::max(result / w, 0.0f) : 0.0f;
+		}
+	};
+
+	static float sDot(const float* aA, const float* aB)
+	{
+		float result = 0.0f;
+
+		for (size_t i = 0; i < sQuadricSize; i++)
+		{
+			result += aA[i] * aB[i];
+		}
+
+		return result;
+	}
+
+	// Squared distance to the plane the triangle spans in attribute space, weighted by its area
+	static void sTriangleQuadric(const AttributeVector& aP0, const AttributeVector& aP1, const AttributeVector& aP2, Quadric& aQuadric)
+	{
+		float e1[sQuadricSize];
+		float e2[sQuadricSize];
+
+		for (size_t i = 0; i < sQuadricSize; i++)
+		{
+			e1[i] = aP1[i] - aP0[i];
+			e2[i] = aP2[i] - aP0[i];
+		}
+
+		const float length1 = std::sqrt(sDot(e1, e1));
+		if (length1 <= 0.0f)
+		{
+			return;
+		}
+
+		for (float& value : e1)
+		{
+			value /= length1;
+		}
+
+		const float projection = sDot(e1, e2);
+		for (size_t i = 0; i < sQuadricSize; i++)
+		{
+			e2[i] -= projection * e1[i];
+		}
+
+		const float length2 = std::sqrt(sDot(e2, e2));
+		if (length2 <= 0.0f)
+		{
+			return;
+		}
+
+		for (float& value : e2)
+		{
+			value /= length2;
+		}
+
+		// Parallelogram area over two, the triangle area
+		const float area = 0.5f * length1 * length2;
+
+		const float p0e1 = sDot(aP0, e1);
+		const float p0e2 = sDot(aP0, e2);
+
+		size_t k = 0;
+		for (size_t i = 0; i < sQuadricSize; i++)
+		{
+			for (size_t j = i; j < sQuadricSize; j++)
+			{
+				const float identity = i == j ? 1.0f : 0.0f;
+				aQuadric.a[k++] = area * (identity - e1[i] * e1[j] - e2[i] * e2[j]);
+			}
+
+			aQuadric.b[i] = area * (p0e1 * e1[i] + p0e2 * e2[i] - aP0[i]);
+		}
+
+		aQuadric.c = area * (sDot(aP0, aP0) - p0e1 * p0e1 - p0e2 * p0e2);
+		aQuadric.w = area;
+	}
+
+	static Vector3f sTriangleNormal(const Vector3f& aA, const Vector3f& aB, const Vector3f& aC)
+	{
+		return (aB - aA).cross(aC - aA);
+	}
+
+	struct Collapse
+	{
+		uint32_t from;
+		uint32_t to;
+		float cost;
+	};
+
+	static uint64_t sEdgeKey(const uint32_t aA, const uint32_t aB)
+	{
+		return (static_cast<uint64_t>(aA) << 32) | aB;
+	}
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<Vertex>& aVertices, const std::vector<uint32_t>& aIndices,
+	const size_t aTargetIndexCount, const float aTargetError, float* aResultError)
+{
+	const size_t vertexCount = aVertices.size();
+	std::vector<uint32_t> indices(aIndices.begin(), aIndices.begin() + aIndices.size() / 3 * 3);
+
+	if (aResultError != nullptr)
+	{
+		*aResultError = 0.0f;
+	}
+
+	if (indices.size() <= aTargetIndexCount || vertexCount == 0)
+	{
+		return indices;
+	}
+
+	Vector3f boundsMin = aVertices[0].position;
+	Vector3f boundsMax = boundsMin;
+
+	for (const Vertex& vertex : aVertices)
+	{
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			boundsMin.v[axis] = std::min(boundsMin.v[axis], vertex.position.v[axis]);
+			boundsMax.v[axis] = std::max(boundsMax.v[axis], vertex.position.v[axis]);
+		}
+	}
+
+	const float extent = std::max(std::max(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y), boundsMax.z - boundsMin.z);
+	const float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+	std::vector<float> attributes(vertexCount * detail::sQuadricSize);
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const Vertex& vertex = aVertices[i];
+		float* attribute = &attributes[i * detail::sQuadricSize];
+
+		attribute[0] = (vertex.position.x - boundsMin.x) * scale;
+		attribute[1] = (vertex.position.y - boundsMin.y) * scale;
+		attribute[2] = (vertex.position.z - boundsMin.z) * scale;
+		attribute[3] = vertex.uv.x * detail::sUvWeight;
+		attribute[4] = vertex.uv.y * detail::sUvWeight;
+		attribute[5] = vertex.normal.x * detail::sNormalWeight;
+		attribute[6] = vertex.normal.y * detail::sNormalWeight;
+		attribute[7] = vertex.normal.z * detail::sNormalWeight;
+	}
+
+	// Vertices sharing a position are copies along an attribute seam, they are locked like borders so
+	// seams cannot tear open
+	std::vector<uint32_t> positionRemap(vertexCount);
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::vector<uint32_t> order(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			order[i] = static_cast<uint32_t>(i);
+		}
+
+		std::sort(order.begin(), order.end(), [&aVertices](const uint32_t aA, const uint32_t aB)
+		{
+			return memcmp(&aVertices[aA].position, &aVertices[aB].position, sizeof(Vector3f)) < 0;
+		});
+
+		std::vector<uint32_t> wedges(vertexCount, 0);
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const bool same = i > 0 && memcmp(&aVertices[order[i]].position, &aVertices[order[i - 1]].position, sizeof(Vector3f)) == 0;
+
+			positionRemap[order[i]] = same ? positionRemap[order[i - 1]] : order[i];
+			wedges[positionRemap[order[i]]]++;
+		}
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			locked[i] = wedges[positionRemap[i]] > 1;
+		}
+
+		// An edge without its opposite half edge lies on an open border
+		std::unordered_map<uint64_t, uint32_t> edges;
+		edges.reserve(indices.size());
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (size_t corner = 0; corner < 3; corner++)
+			{
+				const uint32_t a = positionRemap[indices[i + corner]];
+				const uint32_t b = positionRemap[indices[i + (corner + 1) % 3]];
+
+				edges[detail::sEdgeKey(a, b)]++;
+			}
+		}
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (size_t corner = 0; corner < 3; corner++)
+			{
+				const uint32_t a = positionRemap[indices[i + corner]];
+				const uint32_t b = positionRemap[indices[i + (corner + 1) % 3]];
+
+				if (edges.find(detail::sEdgeKey(b, a)) == edges.end())
+				{
+					locked[a] = true;
+					locked[b] = true;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			if (locked[positionRemap[i]])
+			{
+				locked[i] = true;
+			}
+		}
+	}
+
+	std::vector<detail::Quadric> quadrics(vertexCount);
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		detail::Quadric quadric;
+		detail::sTriangleQuadric(
+			*reinterpret_cast<const detail::AttributeVector*>(&attributes[indices[i] * detail::sQuadricSize]),
+			*reinterpret_cast<const detail::AttributeVector*>(&attributes[indices[i + 1] * detail::sQuadricSize]),
+			*reinterpret_cast<const detail::AttributeVector*>(&attributes[indices[i + 2] * detail::sQuadricSize]),
+			quadric);
+
+		for (size_t corner = 0; corner < 3; corner++)
+		{
+			quadrics[indices[i + corner]] += quadric;
+		}
+	}
+
+	const float maxCost = aTargetError * aTargetError;
+	float resultCost = 0.0f;
+
+	std::vector<uint32_t> adjacencyOffsets;
+	std::vector<uint32_t> adjacency;
+	std::vector<detail::Collapse> collapses;
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+
+	// Each pass performs an independent set of the cheapest collapses, then compacts the index list
+	while (indices.size() > aTargetIndexCount)
+	{
+		const size_t triangleCount = indices.size() / 3;
+
+		adjacencyOffsets.assign(vertexCount + 1, 0);
+		for (const uint32_t index : indices)
+		{
+			adjacencyOffsets[index + 1]++;
+		}
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+		}
+
+		adjacency.resize(indices.size());
+		{
+			std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		collapses.clear();
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (size_t corner = 0; corner < 3; corner++)
+			{
+				const uint32_t a = indices[i + corner];
+				const uint32_t b = indices[i + (corner + 1) % 3];
+
+				// Interior edges show up once per direction, only the lower to higher one is evaluated.
+				// Border edges have both ends locked and nothing to evaluate anyway.
+				if (a > b)
+				{
+					continue;
+				}
+
+				const uint32_t candidates[2][2] = { { a, b }, { b, a } };
+
+				for (const auto& candidate : candidates)
+				{
+					const uint32_t from = candidate[0];
+					const uint32_t to = candidate[1];
+
+					if (locked[from])
+					{
+						continue;
+					}
+
+					detail::Quadric combined = quadrics[from];
+					combined += quadrics[to];
+
+					const float cost = combined.evaluate(*reinterpret_cast<const detail::AttributeVector*>(&attributes[to * detail::sQuadricSize]));
+					collapses.push_back({ from, to, cost });
+				}
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](const detail::Collapse& aA, const detail::Collapse& aB)
+		{
+			return aA.cost < aB.cost;
+		});
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			remap[i] = static_cast<uint32_t>(i);
+		}
+
+		std::fill(touched.begin(), touched.end(), false);
+
+		const size_t trianglesToRemove = (indices.size() - aTargetIndexCount + 2) / 3;
+		size_t removed = 0;
+		size_t performed = 0;
+
+		for (const detail::Collapse& collapse : collapses)
+		{
+			if (collapse.cost > maxCost || removed >= trianglesToRemove)
+			{
+				break;
+			}
+
+			if (touched[collapse.from] || touched[collapse.to])
+			{
+				continue;
+			}
+
+			// Reject collapses that flip or strongly rotate a remaining triangle around the removed vertex
+			bool valid = true;
+			size_t shared = 0;
+
+			for (uint32_t t = adjacencyOffsets[collapse.from]; t < adjacencyOffsets[collapse.from + 1] && valid; t++)
+			{
+				const uint32_t* triangle = &indices[adjacency[t] * 3];
+
+				if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+				{
+					shared++;
+					continue;
+				}
+
+				Vector3f before[3];
+				Vector3f after[3];
+
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					before[corner] = aVertices[triangle[corner]].position;
+					after[corner] = triangle[corner] == collapse.from ? aVertices[collapse.to].position : before[corner];
+				}
+
+				const Vector3f normalBefore = detail::sTriangleNormal(before[0], before[1], before[2]);
+				const Vector3f normalAfter = detail::sTriangleNormal(after[0], after[1], after[2]);
+
+				const float lengths = std::sqrt(normalBefore.dot(normalBefore) * normalAfter.dot(normalAfter));
+				valid = lengths > 0.0f && normalBefore.dot(normalAfter) >= detail::sMaxNormalRotation * lengths;
+			}
+
+			if (!valid)
+			{
+				continue;
+			}
+
+			remap[collapse.from] = collapse.to;
+			quadrics[collapse.to] += quadrics[collapse.from];
+
+			// Keeps the collapses of one pass independent, so the adjacency stays valid until the pass ends
+			for (uint32_t t = adjacencyOffsets[collapse.from]; t < adjacencyOffsets[collapse.from + 1]; t++)
+			{
+				const uint32_t* triangle = &indices[adjacency[t] * 3];
+				touched[triangle[0]] = true;
+				touched[triangle[1]] = true;
+				touched[triangle[2]] = true;
+			}
+
+			touched[collapse.to] = true;
+
+			resultCost = std::max(resultCost, collapse.cost);
+			removed += shared;
+			performed++;
+		}
+
+		if (performed == 0)
+		{
+			break;
+		}
+
+		size_t write = 0;
+		for (size_t i = 0; i < triangleCount; i++)
+		{
+			const uint32_t a = remap[indices[i * 3 + 0]];
+			const uint32_t b = remap[indices[i * 3 + 1]];
+			const uint32_t c = remap[indices[i * 3 + 2]];
+
+			if (a != b && b != c && a != c)
+			{
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+		}
+
+		indices.resize(write);
+	}
+
+	if (aResultError != nullptr)
+	{
+		*aResultError = std::sqrt(resultCost) * extent;
+	}
+
+	return indices;
+}
+
+std::vector<SimplifiedLod> MeshSimplifier::generateLods(const std::vector<Vertex>& aVertices, const std::vector<uint32_t>& aIndices,
+	const uint32_t aLodCount, const float aReduction, const float aMaxError)
+{
+	std::vector<SimplifiedLod> lods;
+	lods.reserve(aLodCount);
+
+	const std::vector<uint32_t>* previous = &aIndices;
+	float previousError = 0.0f;
+
+	for (uint32_t level = 0; level < aLodCount; level++)
+	{
+		const size_t target = static_cast<size_t>(static_cast<float>(previous->size() / 3) * aReduction) * 3;
+
+		SimplifiedLod lod;
+		lod.indices = simplify(aVertices, *previous, target, aMaxError, &lod.error);
+
+		// Less than five percent smaller than the previous level is not worth an extra level
+		if (lod.indices.empty() || lod.indices.size() * 20 > previous->size() * 19)
+		{
+			break;
+		}
+
+		lod.error += previousError;
+		previousError = lod.error;
+
+		lods.push_back(std::move(lod));
+		previous = &lods.back().indices;
+	}
+
+	return lods;
+}
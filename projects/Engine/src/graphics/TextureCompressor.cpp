@@ -0,0 +1,857 @@
+#include "graphics/TextureCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace detail
+{
+	static constexpr size_t sRowGrainSize = 8;
+
+	static constexpr float sPi = 3.14159265358979f;
+
+	// Kaiser window radius in destination texels and its shape parameter
+	static constexpr float sKaiserRadius = 2.0f;
+	static constexpr float sKaiserAlpha = 4.0f;
+
+	// Interpolation weights of 4 bit BC7 indices, in 64ths
+	static constexpr uint32_t sBc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	struct SrgbTable
+	{
+		float toLinear[256];
+
+		SrgbTable()
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				const float value = static_cast<float>(i) / 255.0f;
+				toLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+			}
+		}
+	};
+
+	static const SrgbTable& sSrgbTable()
+	{
+		static const SrgbTable table;
+		return table;
+	}
+
+	static uint8_t sToUnorm8(const float aValue)
+	{
+		return static_cast<uint8_t>(std::min(std::max(aValue, 0.0f), 1.0f) * 255.0f + 0.5f);
+	}
+
+	static uint8_t sLinearToSrgb(float aValue)
+	{
+		aValue = std::min(std::max(aValue, 0.0f), 1.0f);
+		return sToUnorm8(aValue <= 0.0031308f ? aValue * 12.92f : 1.055f * std::pow(aValue, 1.0f / 2.4f) - 0.055f);
+	}
+
+	// Weights of a separable 2:1 filter, destination texel x reads from source texel 2x + firstTap on
+	struct DownsampleKernel
+	{
+		int32_t firstTap;
+		std::vector<float> weights;
+	};
+
+	static float sBesselI0(const float aValue)
+	{
+		const float half = aValue * 0.5f;
+
+		float sum = 1.0f;
+		float term = 1.0f;
+
+		for (uint32_t k = 1; term > sum * 1e-8f; k++)
+		{
+			term *= (half / static_cast<float>(k)) * (half / static_cast<float>(k));
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	static DownsampleKernel sMakeKernel(const EMipFilter aFilter)
+	{
+		if (aFilter == EMipFilter::BOX)
+		{
+			return { 0, { 0.5f, 0.5f } };
+		}
+
+		const int32_t reach = static_cast<int32_t>(std::ceil(sKaiserRadius * 2.0f));
+
+		DownsampleKernel kernel;
+		kernel.firstTap = 1 - reach;
+
+		float sum = 0.0f;
+
+		for (int32_t tap = kernel.firstTap; tap <= reach; tap++)
+		{
+			// Source texel centers sit half a source texel off the destination center, which is 2x + 1
+			const float offset = (static_cast<float>(tap) - 0.5f) * 0.5f;
+			const float ratio = offset / sKaiserRadius;
+
+			const float sinc = std::sin(sPi * offset) / (sPi * offset);
+			const float window = ratio * ratio < 1.0f ? sBesselI0(sKaiserAlpha * std::sqrt(1.0f - ratio * ratio)) / sBesselI0(sKaiserAlpha) : 0.0f;
+
+			kernel.weights.push_back(sinc * window);
+			sum += sinc * window;
+		}
+
+		for (float& weight : kernel.weights)
+		{
+			weight /= sum;
+		}
+
+		return kernel;
+	}
+
+	// The 4x4 texels of block (aBlockX, aBlockY), repeating the last row and column past the edges
+	static void sLoadBlock(const uint8_t* aSource, const uint32_t aWidth, const uint32_t aHeight,
+		const uint32_t aBlockX, const uint32_t aBlockY, uint8_t* aBlock)
+	{
+		for (uint32_t y = 0; y < 4; y++)
+		{
+			const uint32_t sourceY = std::min(aBlockY * 4 + y, aHeight - 1);
+
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				const uint32_t sourceX = std::min(aBlockX * 4 + x, aWidth - 1);
+				memcpy(aBlock + (y * 4 + x) * 4, aSource + (static_cast<size_t>(sourceY) * aWidth + sourceX) * 4, 4);
+			}
+		}
+	}
+
+	// Endpoints at the extremes of the points projected onto their principal axis
+	static void sFitEndpoints(const float (*aPoints)[4], const uint32_t aCount, const uint32_t aChannels, float* aLow, float* aHigh)
+	{
+		float mean[4] = {};
+		float boundsMin[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+		float boundsMax[4] = {};
+
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			for (uint32_t c = 0; c < aChannels; c++)
+			{
+				mean[c] += aPoints[i][c];
+				boundsMin[c] = std::min(boundsMin[c], aPoints[i][c]);
+				boundsMax[c] = std::max(boundsMax[c], aPoints[i][c]);
+			}
+		}
+
+		float covariance[4][4] = {};
+
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			mean[c] /= static_cast<float>(aCount);
+		}
+
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			for (uint32_t a = 0; a < aChannels; a++)
+			{
+				for (uint32_t b = 0; b < aChannels; b++)
+				{
+					covariance[a][b] += (aPoints[i][a] - mean[a]) * (aPoints[i][b] - mean[b]);
+				}
+			}
+		}
+
+		// Power iteration, starting along the bounding box diagonal
+		float axis[4] = {};
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			axis[c] = boundsMax[c] - boundsMin[c];
+		}
+
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = {};
+			float length = 0.0f;
+
+			for (uint32_t a = 0; a < aChannels; a++)
+			{
+				for (uint32_t b = 0; b < aChannels; b++)
+				{
+					next[a] += covariance[a][b] * axis[b];
+				}
+
+				length += next[a] * next[a];
+			}
+
+			if (length <= 1e-12f)
+			{
+				break;
+			}
+
+			length = 1.0f / std::sqrt(length);
+			for (uint32_t c = 0; c < aChannels; c++)
+			{
+				axis[c] = next[c] * length;
+			}
+		}
+
+		float lowest = 0.0f;
+		float highest = 0.0f;
+
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			float projection = 0.0f;
+			for (uint32_t c = 0; c < aChannels; c++)
+			{
+				projection += (aPoints[i][c] - mean[c]) * axis[c];
+			}
+
+			lowest = std::min(lowest, projection);
+			highest = std::max(highest, projection);
+		}
+
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			aLow[c] = std::min(std::max(mean[c] + axis[c] * lowest, 0.0f), 255.0f);
+			aHigh[c] = std::min(std::max(mean[c] + axis[c] * highest, 0.0f), 255.0f);
+		}
+	}
+
+	// Least squares endpoints for points that sit at aPositions between aFirst (0) and aSecond (1)
+	static bool sRefineEndpoints(const float (*aPoints)[4], const float* aPositions, const uint32_t aCount,
+		const uint32_t aChannels, float* aFirst, float* aSecond)
+	{
+		float aa = 0.0f;
+		float ab = 0.0f;
+		float bb = 0.0f;
+		float ax[4] = {};
+		float bx[4] = {};
+
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			const float b = aPositions[i];
+			const float a = 1.0f - b;
+
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+
+			for (uint32_t c = 0; c < aChannels; c++)
+			{
+				ax[c] += a * aPoints[i][c];
+				bx[c] += b * aPoints[i][c];
+			}
+		}
+
+		const float determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		const float inverse = 1.0f / determinant;
+
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			aFirst[c] = std::min(std::max((ax[c] * bb - bx[c] * ab) * inverse, 0.0f), 255.0f);
+			aSecond[c] = std::min(std::max((bx[c] * aa - ax[c] * ab) * inverse, 0.0f), 255.0f);
+		}
+
+		return true;
+	}
+
+	static uint16_t sPack565(const float* aColor)
+	{
+		const uint32_t r = static_cast<uint32_t>(aColor[0] * (31.0f / 255.0f) + 0.5f);
+		const uint32_t g = static_cast<uint32_t>(aColor[1] * (63.0f / 255.0f) + 0.5f);
+		const uint32_t b = static_cast<uint32_t>(aColor[2] * (31.0f / 255.0f) + 0.5f);
+
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static void sUnpack565(const uint16_t aColor, float* aOut)
+	{
+		const uint32_t r = aColor >> 11;
+		const uint32_t g = (aColor >> 5) & 63;
+		const uint32_t b = aColor & 31;
+
+		aOut[0] = static_cast<float>((r << 3) | (r >> 2));
+		aOut[1] = static_cast<float>((g << 2) | (g >> 4));
+		aOut[2] = static_cast<float>((b << 3) | (b >> 2));
+	}
+
+	struct Bc1Candidate
+	{
+		uint16_t color0;
+		uint16_t color1;
+		uint32_t indices;
+		float error;
+	};
+
+	// Picks the palette entry of every texel. color0 > color1 selects the four color palette, anything else
+	// three colors plus transparent black, which only transparent texels use.
+	static Bc1Candidate sBc1Indices(const float (*aPoints)[4], const bool* aTransparent,
+		const uint16_t aColor0, const uint16_t aColor1)
+	{
+		float palette[4][3];
+		sUnpack565(aColor0, palette[0]);
+		sUnpack565(aColor1, palette[1]);
+
+		const bool fourColors = aColor0 > aColor1;
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			if (fourColors)
+			{
+				palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+				palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) * 0.5f;
+				palette[3][c] = 0.0f;
+			}
+		}
+
+		Bc1Candidate candidate = { aColor0, aColor1, 0, 0.0f };
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			if (aTransparent[i])
+			{
+				candidate.indices |= 3u << (i * 2);
+				continue;
+			}
+
+			// Equal endpoints decode the same in both palettes as long as the first entry is used
+			const uint32_t options = aColor0 == aColor1 ? 1 : (fourColors ? 4 : 3);
+
+			uint32_t best = 0;
+			float bestError = std::numeric_limits<float>::max();
+
+			for (uint32_t option = 0; option < options; option++)
+			{
+				float error = 0.0f;
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					const float delta = aPoints[i][c] - palette[option][c];
+					error += delta * delta;
+				}
+
+				if (error < bestError)
+				{
+					best = option;
+					bestError = error;
+				}
+			}
+
+			candidate.indices |= best << (i * 2);
+			candidate.error += bestError;
+		}
+
+		return candidate;
+	}
+
+	// BC1 color block. Without aPunchThrough texels are treated as opaque and the four color palette is
+	// always used, as BC3 requires.
+	static void sEncodeBc1Block(const uint8_t* aBlock, const bool aPunchThrough, uint8_t* aOut)
+	{
+		float points[16][4];
+		float opaque[16][4];
+		bool transparent[16];
+		uint32_t opaqueCount = 0;
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				points[i][c] = static_cast<float>(aBlock[i * 4 + c]);
+			}
+
+			transparent[i] = aPunchThrough && aBlock[i * 4 + 3] < 128;
+
+			if (!transparent[i])
+			{
+				memcpy(opaque[opaqueCount++], points[i], sizeof(points[i]));
+			}
+		}
+
+		Bc1Candidate result = { 0, 0, 0xFFFFFFFF, 0.0f };
+
+		if (opaqueCount > 0)
+		{
+			float low[4];
+			float high[4];
+			sFitEndpoints(opaque, opaqueCount, 3, low, high);
+
+			uint16_t packedLow = sPack565(low);
+			uint16_t packedHigh = sPack565(high);
+
+			if (opaqueCount < 16)
+			{
+				result = sBc1Indices(points, transparent, std::min(packedLow, packedHigh), std::max(packedLow, packedHigh));
+			}
+			else
+			{
+				result = sBc1Indices(points, transparent, std::max(packedLow, packedHigh), std::min(packedLow, packedHigh));
+
+				// One least squares pass over the chosen indices, kept only if it lowers the error
+				static constexpr float positions[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+				float texelPositions[16];
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					texelPositions[i] = positions[(result.indices >> (i * 2)) & 3];
+				}
+
+				float first[4];
+				float second[4];
+
+				if (result.color0 != result.color1 && sRefineEndpoints(points, texelPositions, 16, 3, first, second))
+				{
+					packedLow = sPack565(first);
+					packedHigh = sPack565(second);
+
+					const Bc1Candidate refined = sBc1Indices(points, transparent, std::max(packedLow, packedHigh), std::min(packedLow, packedHigh));
+					if (refined.error < result.error)
+					{
+						result = refined;
+					}
+				}
+			}
+		}
+
+		aOut[0] = static_cast<uint8_t>(result.color0);
+		aOut[1] = static_cast<uint8_t>(result.color0 >> 8);
+		aOut[2] = static_cast<uint8_t>(result.color1);
+		aOut[3] = static_cast<uint8_t>(result.color1 >> 8);
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			aOut[4 + i] = static_cast<uint8_t>(result.indices >> (i * 8));
+		}
+	}
+
+	// BC4 block of one channel, the alpha half of BC3 and each half of BC5
+	static void sEncodeBc4Block(const uint8_t* aBlock, const uint32_t aChannel, uint8_t* aOut)
+	{
+		uint8_t lowest = 255;
+		uint8_t highest = 0;
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			lowest = std::min(lowest, aBlock[i * 4 + aChannel]);
+			highest = std::max(highest, aBlock[i * 4 + aChannel]);
+		}
+
+		memset(aOut, 0, 8);
+		aOut[0] = highest;
+		aOut[1] = lowest;
+
+		if (highest == lowest)
+		{
+			return;
+		}
+
+		// The first endpoint being larger selects eight interpolated values
+		float palette[8];
+		palette[0] = highest;
+		palette[1] = lowest;
+
+		for (uint32_t code = 2; code < 8; code++)
+		{
+			palette[code] = (static_cast<float>(8 - code) * highest + static_cast<float>(code - 1) * lowest) / 7.0f;
+		}
+
+		uint64_t indices = 0;
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			const float value = aBlock[i * 4 + aChannel];
+
+			uint64_t best = 0;
+			float bestError = std::numeric_limits<float>::max();
+
+			for (uint32_t code = 0; code < 8; code++)
+			{
+				const float error = std::abs(value - palette[code]);
+				if (error < bestError)
+				{
+					best = code;
+					bestError = error;
+				}
+			}
+
+			indices |= best << (i * 3);
+		}
+
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			aOut[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+		}
+	}
+
+	struct Bc7Endpoint
+	{
+		// 7 bits per channel plus the shared low bit
+		uint32_t value[4];
+		uint32_t pBit;
+	};
+
+	struct Bc7Candidate
+	{
+		Bc7Endpoint endpoints[2];
+		uint8_t indices[16];
+		float error;
+	};
+
+	static Bc7Endpoint sQuantizeBc7(const float* aColor)
+	{
+		Bc7Endpoint best = {};
+		float bestError = std::numeric_limits<float>::max();
+
+		for (uint32_t pBit = 0; pBit < 2; pBit++)
+		{
+			Bc7Endpoint endpoint = {};
+			endpoint.pBit = pBit;
+
+			float error = 0.0f;
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				const float value = (aColor[c] - static_cast<float>(pBit)) * 0.5f + 0.5f;
+				endpoint.value[c] = static_cast<uint32_t>(std::min(std::max(value, 0.0f), 127.0f));
+
+				const float delta = static_cast<float>((endpoint.value[c] << 1) | pBit) - aColor[c];
+				error += delta * delta;
+			}
+
+			if (error < bestError)
+			{
+				best = endpoint;
+				bestError = error;
+			}
+		}
+
+		return best;
+	}
+
+	static Bc7Candidate sBc7Indices(const float (*aPoints)[4], const Bc7Endpoint& aFirst, const Bc7Endpoint& aSecond)
+	{
+		Bc7Candidate candidate = { { aFirst, aSecond }, {}, 0.0f };
+
+		float palette[16][4];
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			const uint32_t first = (aFirst.value[c] << 1) | aFirst.pBit;
+			const uint32_t second = (aSecond.value[c] << 1) | aSecond.pBit;
+
+			for (uint32_t code = 0; code < 16; code++)
+			{
+				palette[code][c] = static_cast<float>(((64 - sBc7Weights[code]) * first + sBc7Weights[code] * second + 32) >> 6);
+			}
+		}
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint8_t best = 0;
+			float bestError = std::numeric_limits<float>::max();
+
+			for (uint8_t code = 0; code < 16; code++)
+			{
+				float error = 0.0f;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					const float delta = aPoints[i][c] - palette[code][c];
+					error += delta * delta;
+				}
+
+				if (error < bestError)
+				{
+					best = code;
+					bestError = error;
+				}
+			}
+
+			candidate.indices[i] = best;
+			candidate.error += bestError;
+		}
+
+		return candidate;
+	}
+
+	struct BitWriter
+	{
+		uint8_t* data;
+		uint32_t position;
+
+		void write(const uint32_t aValue, const uint32_t aBits)
+		{
+			for (uint32_t bit = 0; bit < aBits; bit++, position++)
+			{
+				data[position >> 3] |= static_cast<uint8_t>(((aValue >> bit) & 1) << (position & 7));
+			}
+		}
+	};
+
+	// BC7 block in mode 6 only: one subset, RGBA endpoints of 7 bits plus a p-bit each and 4 bit indices
+	static void sEncodeBc7Block(const uint8_t* aBlock, uint8_t* aOut)
+	{
+		float points[16][4];
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				points[i][c] = static_cast<float>(aBlock[i * 4 + c]);
+			}
+		}
+
+		float low[4];
+		float high[4];
+		sFitEndpoints(points, 16, 4, low, high);
+
+		Bc7Candidate result = sBc7Indices(points, sQuantizeBc7(low), sQuantizeBc7(high));
+
+		float positions[16];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			positions[i] = static_cast<float>(sBc7Weights[result.indices[i]]) / 64.0f;
+		}
+
+		if (sRefineEndpoints(points, positions, 16, 4, low, high))
+		{
+			const Bc7Candidate refined = sBc7Indices(points, sQuantizeBc7(low), sQuantizeBc7(high));
+			if (refined.error < result.error)
+			{
+				result = refined;
+			}
+		}
+
+		// The first texel's index drops its top bit, so it has to be in the lower half of the palette
+		if (result.indices[0] >= 8)
+		{
+			std::swap(result.endpoints[0], result.endpoints[1]);
+
+			for (uint8_t& index : result.indices)
+			{
+				index = static_cast<uint8_t>(15 - index);
+			}
+		}
+
+		memset(aOut, 0, 16);
+		BitWriter writer = { aOut, 0 };
+
+		writer.write(1u << 6, 7);
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			writer.write(result.endpoints[0].value[c], 7);
+			writer.write(result.endpoints[1].value[c], 7);
+		}
+
+		writer.write(result.endpoints[0].pBit, 1);
+		writer.write(result.endpoints[1].pBit, 1);
+
+		writer.write(result.indices[0], 3);
+		for (uint32_t i = 1; i < 16; i++)
+		{
+			writer.write(result.indices[i], 4);
+		}
+	}
+}
+
+uint32_t TextureCompressor::getLevelCount(const uint32_t aWidth, const uint32_t aHeight)
+{
+	uint32_t levels = 1;
+
+	for (uint32_t size = std::max(aWidth, aHeight); size > 1; size >>= 1)
+	{
+		levels++;
+	}
+
+	return levels;
+}
+
+EDataFormat TextureCompressor::getFormat(const ETextureCompression aCompression, const bool aSrgb)
+{
+	switch (aCompression)
+	{
+		case ETextureCompression::BC1:
+			return aSrgb ? EDataFormat::BC1_RGBA_SRGB_BLOCK : EDataFormat::BC1_RGBA_UNORM_BLOCK;
+		case ETextureCompression::BC3:
+			return aSrgb ? EDataFormat::BC3_SRGB_BLOCK : EDataFormat::BC3_UNORM_BLOCK;
+		case ETextureCompression::BC5:
+			return EDataFormat::BC5_UNORM_BLOCK;
+		case ETextureCompression::BC7:
+			return aSrgb ? EDataFormat::BC7_SRGB_BLOCK : EDataFormat::BC7_UNORM_BLOCK;
+		default:
+			return aSrgb ? EDataFormat::R8G8B8A8_SRGB : EDataFormat::R8G8B8A8_UNORM;
+	}
+}
+
+size_t TextureCompressor::getLevelSize(const EDataFormat aFormat, const uint32_t aWidth, const uint32_t aHeight)
+{
+	const size_t blocks = static_cast<size_t>((aWidth + 3) / 4) * ((aHeight + 3) / 4);
+
+	switch (aFormat)
+	{
+		case EDataFormat::R8G8B8A8_UNORM:
+		case EDataFormat::R8G8B8A8_SRGB:
+			return static_cast<size_t>(aWidth) * aHeight * 4;
+		case EDataFormat::BC1_RGBA_UNORM_BLOCK:
+		case EDataFormat::BC1_RGBA_SRGB_BLOCK:
+			return blocks * 8;
+		case EDataFormat::BC3_UNORM_BLOCK:
+		case EDataFormat::BC3_SRGB_BLOCK:
+		case EDataFormat::BC5_UNORM_BLOCK:
+		case EDataFormat::BC7_UNORM_BLOCK:
+		case EDataFormat::BC7_SRGB_BLOCK:
+			return blocks * 16;
+		default:
+			return 0;
+	}
+}
+
+void TextureCompressor::downsample(const uint8_t* aSource, const uint32_t aWidth, const uint32_t aHeight,
+	const bool aSrgb, const EMipFilter aFilter, uint8_t* aDestination)
+{
+	const uint32_t width = std::max(aWidth / 2, 1u);
+	const uint32_t height = std::max(aHeight / 2, 1u);
+
+	const detail::DownsampleKernel kernel = detail::sMakeKernel(aFilter);
+	const int32_t tapCount = static_cast<int32_t>(kernel.weights.size());
+
+	const float* toLinear = detail::sSrgbTable().toLinear;
+
+	// Horizontal pass over every source row into linear floats, then a vertical pass over those
+	std::vector<float> filtered(static_cast<size_t>(width) * aHeight * 4);
+
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, aHeight, detail::sRowGrainSize),
+		[&](const tbb::blocked_range<uint32_t>& aRange)
+		{
+			std::vector<float> row(static_cast<size_t>(aWidth) * 4);
+
+			for (uint32_t y = aRange.begin(); y != aRange.end(); ++y)
+			{
+				const uint8_t* source = aSource + static_cast<size_t>(y) * aWidth * 4;
+
+				for (uint32_t x = 0; x < aWidth; x++)
+				{
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						row[x * 4 + c] = aSrgb ? toLinear[source[x * 4 + c]] : static_cast<float>(source[x * 4 + c]) / 255.0f;
+					}
+
+					row[x * 4 + 3] = static_cast<float>(source[x * 4 + 3]) / 255.0f;
+				}
+
+				float* destination = filtered.data() + static_cast<size_t>(y) * width * 4;
+
+				for (uint32_t x = 0; x < width; x++)
+				{
+					float sum[4] = {};
+
+					for (int32_t tap = 0; tap < tapCount; tap++)
+					{
+						const int32_t sourceX = std::min(std::max(static_cast<int32_t>(x * 2) + kernel.firstTap + tap, 0), static_cast<int32_t>(aWidth) - 1);
+						const float* texel = row.data() + sourceX * 4;
+
+						for (uint32_t c = 0; c < 4; c++)
+						{
+							sum[c] += texel[c] * kernel.weights[tap];
+						}
+					}
+
+					memcpy(destination + x * 4, sum, sizeof(sum));
+				}
+			}
+		});
+
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, height, detail::sRowGrainSize),
+		[&](const tbb::blocked_range<uint32_t>& aRange)
+		{
+			const size_t rowSize = static_cast<size_t>(width) * 4;
+			std::vector<float> sum(rowSize);
+
+			for (uint32_t y = aRange.begin(); y != aRange.end(); ++y)
+			{
+				std::fill(sum.begin(), sum.end(), 0.0f);
+
+				// Whole rows at a time, so the inner loop runs over contiguous floats
+				for (int32_t tap = 0; tap < tapCount; tap++)
+				{
+					const int32_t sourceY = std::min(std::max(static_cast<int32_t>(y * 2) + kernel.firstTap + tap, 0), static_cast<int32_t>(aHeight) - 1);
+					const float* source = filtered.data() + sourceY * rowSize;
+					const float weight = kernel.weights[tap];
+
+					for (size_t i = 0; i < rowSize; i++)
+					{
+						sum[i] += source[i] * weight;
+					}
+				}
+
+				uint8_t* destination = aDestination + y * rowSize;
+
+				for (uint32_t x = 0; x < width; x++)
+				{
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						destination[x * 4 + c] = aSrgb ? detail::sLinearToSrgb(sum[x * 4 + c]) : detail::sToUnorm8(sum[x * 4 + c]);
+					}
+
+					destination[x * 4 + 3] = detail::sToUnorm8(sum[x * 4 + 3]);
+				}
+			}
+		});
+}
+
+void TextureCompressor::compress(const uint8_t* aSource, const uint32_t aWidth, const uint32_t aHeight,
+	const ETextureCompression aCompression, uint8_t* aDestination)
+{
+	if (aCompression == ETextureCompression::NONE)
+	{
+		memcpy(aDestination, aSource, static_cast<size_t>(aWidth) * aHeight * 4);
+		return;
+	}
+
+	const uint32_t blocksX = (aWidth + 3) / 4;
+	const uint32_t blocksY = (aHeight + 3) / 4;
+	const size_t blockSize = aCompression == ETextureCompression::BC1 ? 8 : 16;
+
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, blocksY, 1),
+		[&](const tbb::blocked_range<uint32_t>& aRange)
+		{
+			uint8_t block[16 * 4];
+
+			for (uint32_t blockY = aRange.begin(); blockY != aRange.end(); ++blockY)
+			{
+				for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+				{
+					detail::sLoadBlock(aSource, aWidth, aHeight, blockX, blockY, block);
+
+					uint8_t* out = aDestination + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+
+					switch (aCompression)
+					{
+						case ETextureCompression::BC1:
+							detail::sEncodeBc1Block(block, true, out);
+							break;
+						case ETextureCompression::BC3:
+							detail::sEncodeBc4Block(block, 3, out);
+							detail::sEncodeBc1Block(block, false, out + 8);
+							break;
+						case ETextureCompression::BC5:
+							detail::sEncodeBc4Block(block, 0, out);
+							detail::sEncodeBc4Block(block, 1, out + 8);
+							break;
+						default:
+							detail::sEncodeBc7Block(block, out);
+							break;
+					}
+				}
+			}
+		});
+}
@@ -0,0 +1,286 @@
+#include "graphics/VertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace detail
+{
+	static int16_t sToSnorm16(const float aValue)
+	{
+		return static_cast<int16_t>(std::lround(std::min(std::max(aValue, -1.0f), 1.0f) * 32767.0f));
+	}
+
+	static float sFromSnorm16(const int16_t aValue)
+	{
+		return std::max(static_cast<float>(aValue) / 32767.0f, -1.0f);
+	}
+
+	static float sSignNotZero(const float aValue)
+	{
+		return aValue >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	// Projects the unit sphere onto an octahedron and unfolds it into [-1, 1]^2
+	static void sEncodeOctahedral(const Vector3f& aDirection, int16_t* aOut)
+	{
+		const float length = std::abs(aDirection.x) + std::abs(aDirection.y) + std::abs(aDirection.z);
+		if (length <= 0.0f)
+		{
+			aOut[0] = 0;
+			aOut[1] = 0;
+			return;
+		}
+
+		float x = aDirection.x / length;
+		float y = aDirection.y / length;
+
+		if (aDirection.z < 0.0f)
+		{
+			const float foldedX = (1.0f - std::abs(y)) * sSignNotZero(x);
+			const float foldedY = (1.0f - std::abs(x)) * sSignNotZero(y);
+
+			x = foldedX;
+			y = foldedY;
+		}
+
+		aOut[0] = sToSnorm16(x);
+		aOut[1] = sToSnorm16(y);
+	}
+
+	static Vector3f sDecodeOctahedral(const int16_t* aData)
+	{
+		const float x = sFromSnorm16(aData[0]);
+		const float y = sFromSnorm16(aData[1]);
+		const float z = 1.0f - std::abs(x) - std::abs(y);
+
+		Vector3f direction(x, y, z);
+
+		if (z < 0.0f)
+		{
+			direction.x = (1.0f - std::abs(y)) * sSignNotZero(x);
+			direction.y = (1.0f - std::abs(x)) * sSignNotZero(y);
+		}
+
+		const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+		return length > 0.0f ? direction * (1.0f / length) : direction;
+	}
+
+	static bool sIsHalf(const EVertexFormat aFormat)
+	{
+		return aFormat == VERTEX_FORMAT_HALF || aFormat == VERTEX_FORMAT_HALF_COLOR;
+	}
+}
+
+size_t VertexFormat::getStride(const EVertexFormat aFormat)
+{
+	if (aFormat == VERTEX_FORMAT_FLOAT)
+	{
+		return sizeof(Vertex);
+	}
+
+	return hasColor(aFormat) ? sizeof(CompactVertex) : offsetof(CompactVertex, color);
+}
+
+BufferLayout VertexFormat::getLayout(const EVertexFormat aFormat)
+{
+	BufferLayout layout;
+
+	if (aFormat == VERTEX_FORMAT_FLOAT)
+	{
+		layout.push<Vector3f>("iPosition");
+		layout.push<Vector2f>("iTexCoord");
+		layout.push<Vector3f>("iNormal");
+		layout.push<Vector3f>("iTangent");
+		layout.push<Vector3f>("iBinormal");
+		layout.push<Vector4f>("iColor");
+
+		return layout;
+	}
+
+	if (detail::sIsHalf(aFormat))
+	{
+		layout.push<Half>("iPosition", 4);
+	}
+	else
+	{
+		layout.push<uint16_t>("iPosition", 4, true);
+	}
+
+	layout.push<int16_t>("iNormal", 2, true);
+	layout.push<int16_t>("iTangent", 2, true);
+	layout.push<Half>("iTexCoord", 2);
+
+	if (hasColor(aFormat))
+	{
+		layout.push<uint8_t>("iColor", 4, true);
+	}
+
+	return layout;
+}
+
+bool VertexFormat::isValid(const uint32_t aFormat)
+{
+	return aFormat <= VERTEX_FORMAT_HALF_COLOR;
+}
+
+bool VertexFormat::hasColor(const EVertexFormat aFormat)
+{
+	return aFormat == VERTEX_FORMAT_FLOAT || aFormat == VERTEX_FORMAT_UNORM16_COLOR || aFormat == VERTEX_FORMAT_HALF_COLOR;
+}
+
+EVertexFormat VertexFormat::withColor(const EVertexFormat aFormat, const bool aColor)
+{
+	switch (aFormat)
+	{
+		case VERTEX_FORMAT_UNORM16:
+		case VERTEX_FORMAT_UNORM16_COLOR:
+			return aColor ? VERTEX_FORMAT_UNORM16_COLOR : VERTEX_FORMAT_UNORM16;
+
+		case VERTEX_FORMAT_HALF:
+		case VERTEX_FORMAT_HALF_COLOR:
+			return aColor ? VERTEX_FORMAT_HALF_COLOR : VERTEX_FORMAT_HALF;
+
+		default:
+			return aFormat;
+	}
+}
+
+void VertexFormat::encode(const Vertex* aVertices, const size_t aCount, const EVertexFormat aFormat,
+	const Vector3f& aBoundsMin, const Vector3f& aBoundsMax, void* aOut)
+{
+	if (aFormat == VERTEX_FORMAT_FLOAT)
+	{
+		memcpy(aOut, aVertices, aCount * sizeof(Vertex));
+		return;
+	}
+
+	const size_t stride = getStride(aFormat);
+	const bool half = detail::sIsHalf(aFormat);
+	const bool color = hasColor(aFormat);
+
+	float scale[3];
+	for (size_t axis = 0; axis < 3; axis++)
+	{
+		const float extent = aBoundsMax.v[axis] - aBoundsMin.v[axis];
+		scale[axis] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+	}
+
+	uint8_t* out = static_cast<uint8_t*>(aOut);
+
+	for (size_t i = 0; i < aCount; i++)
+	{
+		const Vertex& vertex = aVertices[i];
+		CompactVertex compact;
+
+		// Tangent space handedness, the binormal itself is rebuilt from the normal and tangent
+		const Vector3f binormal = vertex.normal.cross(vertex.tangent);
+		const bool flipped = binormal.x * vertex.binormal.x + binormal.y * vertex.binormal.y + binormal.z * vertex.binormal.z < 0.0f;
+
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			if (half)
+			{
+				compact.position[axis] = Half(vertex.position.v[axis]).bits;
+			}
+			else
+			{
+				const float quantized = (vertex.position.v[axis] - aBoundsMin.v[axis]) * scale[axis];
+				compact.position[axis] = static_cast<uint16_t>(std::lround(std::min(std::max(quantized, 0.0f), 65535.0f)));
+			}
+		}
+
+		if (half)
+		{
+			compact.position[3] = Half(flipped ? -1.0f : 1.0f).bits;
+		}
+		else
+		{
+			compact.position[3] = flipped ? 0 : 65535;
+		}
+
+		detail::sEncodeOctahedral(vertex.normal, compact.normal);
+		detail::sEncodeOctahedral(vertex.tangent, compact.tangent);
+
+		compact.uv[0] = Half(vertex.uv.x);
+		compact.uv[1] = Half(vertex.uv.y);
+
+		if (color)
+		{
+			for (size_t channel = 0; channel < 4; channel++)
+			{
+				const float value = std::min(std::max(vertex.color.v[channel], 0.0f), 1.0f);
+				compact.color[channel] = static_cast<uint8_t>(std::lround(value * 255.0f));
+			}
+		}
+
+		memcpy(out + i * stride, &compact, stride);
+	}
+}
+
+void VertexFormat::decode(const void* aData, const size_t aCount, const EVertexFormat aFormat,
+	const Vector3f& aBoundsMin, const Vector3f& aBoundsMax, Vertex* aOut)
+{
+	if (aFormat == VERTEX_FORMAT_FLOAT)
+	{
+		const Vertex* vertices = static_cast<const Vertex*>(aData);
+		std::copy(vertices, vertices + aCount, aOut);
+		return;
+	}
+
+	const size_t stride = getStride(aFormat);
+	const bool half = detail::sIsHalf(aFormat);
+	const bool color = hasColor(aFormat);
+
+	const uint8_t* data = static_cast<const uint8_t*>(aData);
+
+	for (size_t i = 0; i < aCount; i++)
+	{
+		CompactVertex compact;
+		memcpy(&compact, data + i * stride, stride);
+
+		Vertex& vertex = aOut[i];
+		float sign;
+
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			if (half)
+			{
+				Half value;
+				value.bits = compact.position[axis];
+				vertex.position.v[axis] = value;
+			}
+			else
+			{
+				const float extent = aBoundsMax.v[axis] - aBoundsMin.v[axis];
+				vertex.position.v[axis] = aBoundsMin.v[axis] + compact.position[axis] / 65535.0f * extent;
+			}
+		}
+
+		if (half)
+		{
+			Half value;
+			value.bits = compact.position[3];
+			sign = value < 0.0f ? -1.0f : 1.0f;
+		}
+		else
+		{
+			sign = compact.position[3] < 32768 ? -1.0f : 1.0f;
+		}
+
+		vertex.normal = detail::sDecodeOctahedral(compact.normal);
+		vertex.tangent = detail::sDecodeOctahedral(compact.tangent);
+		vertex.binormal = vertex.normal.cross(vertex.tangent) * sign;
+
+		vertex.uv = { compact.uv[0], compact.uv[1] };
+
+		if (color)
+		{
+			vertex.color = { compact.color[0] / 255.0f, compact.color[1] / 255.0f, compact.color[2] / 255.0f, compact.color[3] / 255.0f };
+		}
+		else
+		{
+			vertex.color = { 1, 1, 1, 1 };
+		}
+	}
+}
@@ -0,0 +1,206 @@
+#include "graphics/null/NullCommandBuffer.h"
+#include "graphics/null/NullIndexBuffer.h"
+#include "graphics/null/NullVertexBuffer.h"
+#include "core/PrimalAssert.h"
+#include "core/PrimalCast.h"
+
+#include <algorithm>
+
+NullCommandBuffer::NullCommandBuffer(IGraphicsContext* aContext)
+	: ICommandBuffer(aContext), mContext(aContext)
+{
+}
+
+void NullCommandBuffer::addDependency(ICommandBuffer* aDependsOn)
+{
+	mThisDependsOn.push_back(aDependsOn);
+}
+
+void NullCommandBuffer::removeDependency(ICommandBuffer* aDependsOn)
+{
+	mThisDependsOn.erase(std::remove(mThisDependsOn.begin(), mThisDependsOn.end(), aDependsOn), mThisDependsOn.end());
+}
+
+void NullCommandBuffer::construct(const CommandBufferCreateInfo& aInfo)
+{
+	mPrimary = aInfo.primary;
+	mCommands.reserve(256);
+}
+
+void NullCommandBuffer::reconstruct(const CommandBufferCreateInfo& aInfo)
+{
+	destroy();
+	construct(aInfo);
+}
+
+void NullCommandBuffer::destroy()
+{
+	mCommands.clear();
+	mConstants.clear();
+	mThisDependsOn.clear();
+	mRecording = false;
+	mData = nullptr;
+}
+
+void NullCommandBuffer::record(const CommandBufferRecordInfo&)
+{
+	mCommands.clear();
+	mConstants.clear();
+	mRecording = true;
+}
+
+void NullCommandBuffer::end()
+{
+	mRecording = false;
+}
+
+void NullCommandBuffer::recordRenderPass(const RenderPassRecordInfo& aInfo)
+{
+	_push(ENullCommandType::BEGIN_RENDER_PASS, aInfo.renderPass, static_cast<uint32_t>(aInfo.renderArea.z),
+		static_cast<uint32_t>(aInfo.renderArea.w), static_cast<uint32_t>(aInfo.clearValues.size()));
+}
+
+void NullCommandBuffer::endRenderPass()
+{
+	_push(ENullCommandType::END_RENDER_PASS, nullptr);
+}
+
+void NullCommandBuffer::copyBuffers(ISwapChain*, IVertexBuffer* aBuffer, void* aData, const size_t aSize)
+{
+	primal_cast<NullVertexBuffer*>(aBuffer)->setData(aData, aSize);
+	_push(ENullCommandType::COPY_BUFFER, aBuffer, static_cast<uint32_t>(aSize));
+}
+
+void NullCommandBuffer::copyBuffers(ISwapChain*, IIndexBuffer* aBuffer, void* aData, const size_t aSize)
+{
+	primal_cast<NullIndexBuffer*>(aBuffer)->setData(aData, aSize);
+	_push(ENullCommandType::COPY_BUFFER, aBuffer, static_cast<uint32_t>(aSize));
+}
+
+void NullCommandBuffer::bindGraphicsPipeline(IGraphicsPipeline* aPipeline)
+{
+	_push(ENullCommandType::BIND_PIPELINE, aPipeline);
+}
+
+void NullCommandBuffer::bindVertexBuffers(uint32_t aFirstBinding, uint32_t aBindingCount, std::vector<IVertexBuffer*> aBuffers,
+	std::vector<uint64_t> aOffsets)
+{
+	for (uint32_t i = 0; i < aBindingCount && i < aBuffers.size(); i++)
+	{
+		const uint64_t offset = i < aOffsets.size() ? aOffsets[i] : 0;
+		_push(ENullCommandType::BIND_VERTEX_BUFFERS, aBuffers[i], aFirstBinding + i, static_cast<uint32_t>(offset));
+	}
+}
+
+void NullCommandBuffer::bindIndexBuffer(IIndexBuffer* aBuffer, uint64_t aOffset, EIndexType aType)
+{
+	_push(ENullCommandType::BIND_INDEX_BUFFER, aBuffer, static_cast<uint32_t>(aOffset), aType);
+}
+
+// Performs the same CPU-side work as the Vulkan backend (scene and backing buffer uploads, dirty
+// tracking) so headless frame timings stay comparable; only the descriptor writes are skipped.
+void NullCommandBuffer::bindMaterial(Material* aMaterial, uint32_t aFrame)
+{
+	uint32_t count = 1;
+
+	if (mData != nullptr)
+	{
+		mData->mUboPool->getBuffer(0)->setData(mData->mCpuBacking, 0, mData->mBackingSz);
+		mData = nullptr;
+		count = 2;
+	}
+
+	if (aMaterial->mDirtyBit)
+	{
+		--aMaterial->mDirtyBit;
+	}
+
+	for (const auto& ubo : aMaterial->mBackingBuffers)
+	{
+		auto buffers = ubo.first->getBuffers();
+		for (size_t i = 0; i < buffers.size(); i++)
+		{
+			buffers[i]->setData(ubo.second.blocks[i], 0, ubo.second.elementCount * ubo.second.elementSize);
+		}
+	}
+
+	_push(ENullCommandType::BIND_DESCRIPTOR_SETS, aMaterial->mSet.set, aFrame, count, 0);
+}
+
+void NullCommandBuffer::bindMaterialInstance(MaterialInstance* aInstance, uint32_t aFrame)
+{
+	Material* parent = aInstance->mParent->_getRootAncestor();
+
+	mDynamicOffsets.clear();
+	for (const auto& pair : parent->mBackingBuffers)
+	{
+		const auto size = pair.second.elementSize;
+		const auto count = pair.second.elementCount;
+		const auto index = aInstance->mInstanceId / count;
+		const auto offset = (aInstance->mInstanceId - index * count) * size;
+		mDynamicOffsets.push_back(static_cast<uint32_t>(offset));
+	}
+
+	_push(ENullCommandType::BIND_DESCRIPTOR_SETS, aInstance->mParent->mSet.set, aFrame, 1,
+		static_cast<uint32_t>(mDynamicOffsets.size()), mDynamicOffsets.empty() ? 0 : mDynamicOffsets[0]);
+}
+
+void NullCommandBuffer::bindSceneData(SceneData* aData, uint32_t)
+{
+	mData = aData;
+}
+
+void NullCommandBuffer::pushConstants(IGraphicsPipeline* aPipeline, ShaderStageFlags aStages, uint32_t aOffset, uint32_t aSize,
+	const void* aData)
+{
+	const uint32_t first = static_cast<uint32_t>(mConstants.size());
+	const uint8_t* bytes = static_cast<const uint8_t*>(aData);
+	mConstants.insert(mConstants.end(), bytes, bytes + aSize);
+
+	_push(ENullCommandType::PUSH_CONSTANTS, aPipeline, aStages, aOffset, aSize, first);
+}
+
+void NullCommandBuffer::draw(uint32_t aVertexCount, uint32_t aInstanceCount, uint32_t aFirstVertex, uint32_t aFirstInstance)
+{
+	_push(ENullCommandType::DRAW, nullptr, aVertexCount, aInstanceCount, aFirstVertex, aFirstInstance);
+}
+
+void NullCommandBuffer::drawIndexed(uint32_t aIndexCount, uint32_t aInstanceCount, uint32_t aFirstIndex, int32_t aVertexOffset,
+	uint32_t aFirstInstance)
+{
+	_push(ENullCommandType::DRAW_INDEXED, nullptr, aIndexCount, aInstanceCount, aFirstIndex,
+		static_cast<uint32_t>(aVertexOffset), aFirstInstance);
+}
+
+const std::vector<NullCommand>& NullCommandBuffer::getCommands() const
+{
+	return mCommands;
+}
+
+const std::vector<uint8_t>& NullCommandBuffer::getConstants() const
+{
+	return mConstants;
+}
+
+const std::vector<ICommandBuffer*>& NullCommandBuffer::getDependencies() const
+{
+	return mThisDependsOn;
+}
+
+bool NullCommandBuffer::isRecording() const
+{
+	return mRecording;
+}
+
+bool NullCommandBuffer::isPrimary() const
+{
+	return mPrimary;
+}
+
+void NullCommandBuffer::_push(ENullCommandType aType, const void* aObject, uint32_t aArg0, uint32_t aArg1, uint32_t aArg2,
+	uint32_t aArg3, uint32_t aArg4)
+{
+	PRIMAL_INTERNAL_ASSERT(mRecording, "Command recorded outside of record()/end()");
+
+	mCommands.push_back({ aType, aObject, { aArg0, aArg1, aArg2, aArg3, aArg4 } });
+}
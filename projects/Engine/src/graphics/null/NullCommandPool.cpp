@@ -0,0 +1,17 @@
+#include "graphics/null/NullCommandPool.h"
+
+NullCommandPool::NullCommandPool(IGraphicsContext* aContext)
+	: ICommandPool(aContext)
+{
+	mContext = aContext;
+}
+
+void NullCommandPool::construct(const CommandPoolCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+const CommandPoolCreateInfo& NullCommandPool::getCreateInfo() const
+{
+	return mInfo;
+}
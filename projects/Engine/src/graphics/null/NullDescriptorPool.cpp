@@ -0,0 +1,17 @@
+#include "graphics/null/NullDescriptorPool.h"
+
+NullDescriptorPool::NullDescriptorPool(IGraphicsContext* aContext)
+	: IDescriptorPool(aContext)
+{
+	mContext = aContext;
+}
+
+void NullDescriptorPool::construct(const DescriptorPoolCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+const DescriptorPoolCreateInfo& NullDescriptorPool::getCreateInfo() const
+{
+	return mInfo;
+}
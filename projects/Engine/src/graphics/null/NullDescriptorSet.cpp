@@ -0,0 +1,22 @@
+#include "graphics/null/NullDescriptorSet.h"
+
+NullDescriptorSet::NullDescriptorSet(IGraphicsContext* aContext)
+	: IDescriptorSet(aContext)
+{
+	mContext = aContext;
+}
+
+void NullDescriptorSet::construct(const DescriptorSetCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+IDescriptorPool* NullDescriptorSet::getPool() const
+{
+	return mInfo.pool;
+}
+
+const std::vector<IDescriptorSetLayout*>& NullDescriptorSet::getLayouts() const
+{
+	return mInfo.setLayouts;
+}
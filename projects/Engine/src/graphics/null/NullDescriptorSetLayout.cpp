@@ -0,0 +1,21 @@
+#include "graphics/null/NullDescriptorSetLayout.h"
+
+NullDescriptorSetLayout::NullDescriptorSetLayout(IGraphicsContext* aContext)
+	: IDescriptorSetLayout(aContext)
+{
+}
+
+void NullDescriptorSetLayout::construct(const DescriptorSetLayoutCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+void NullDescriptorSetLayout::reconstruct(const DescriptorSetLayoutCreateInfo& aInfo)
+{
+	construct(aInfo);
+}
+
+const std::vector<DescriptorSetLayoutBinding>& NullDescriptorSetLayout::getBindings() const
+{
+	return mInfo.layoutBindings;
+}
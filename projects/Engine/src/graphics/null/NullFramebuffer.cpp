@@ -0,0 +1,27 @@
+#include "graphics/null/NullFramebuffer.h"
+
+NullFramebuffer::NullFramebuffer(IGraphicsContext* aContext)
+	: IFramebuffer(aContext)
+{
+}
+
+void NullFramebuffer::construct(const FramebufferCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+void NullFramebuffer::reconstruct(const FramebufferCreateInfo& aInfo)
+{
+	destroy();
+	construct(aInfo);
+}
+
+void NullFramebuffer::destroy()
+{
+	mInfo = {};
+}
+
+const FramebufferCreateInfo& NullFramebuffer::getCreateInfo() const
+{
+	return mInfo;
+}
@@ -0,0 +1,119 @@
+#include "graphics/null/NullGraphicsContext.h"
+#include "graphics/null/NullCommandBuffer.h"
+#include "graphics/null/NullCommandPool.h"
+#include "graphics/GraphicsFactory.h"
+#include "core/Log.h"
+
+NullGraphicsContext::NullGraphicsContext(const GraphicsContextCreateInfo& aCreateInfo)
+	: IGraphicsContext(aCreateInfo), mSubmissions(0), mCommands(0), mRenderPasses(0), mPipelineBinds(0),
+	  mDescriptorBinds(0), mDrawCalls(0), mVertices(0), mIndices(0), mUploadedBytes(0)
+{
+	mCommandPool = new NullCommandPool(this);
+	mCommandPool->construct({ 0, 0 });
+
+	mTransferCommandPool = new NullCommandPool(this);
+	mTransferCommandPool->construct({ 0, 1 });
+
+	GraphicsFactory::instance().initialize(ERenderAPI::RENDERAPI_NONE, this);
+
+	PRIMAL_INTERNAL_INFO("Created headless graphics context for {0}", aCreateInfo.applicationName);
+}
+
+NullGraphicsContext::~NullGraphicsContext()
+{
+	delete mTransferCommandPool;
+	delete mCommandPool;
+}
+
+void NullGraphicsContext::idle() const
+{
+}
+
+void NullGraphicsContext::submit(const NullCommandBuffer* aBuffer)
+{
+	uint64_t renderPasses = 0;
+	uint64_t pipelineBinds = 0;
+	uint64_t descriptorBinds = 0;
+	uint64_t drawCalls = 0;
+	uint64_t vertices = 0;
+	uint64_t indices = 0;
+	uint64_t uploadedBytes = 0;
+
+	for (const NullCommand& command : aBuffer->getCommands())
+	{
+		switch (command.type)
+		{
+			case ENullCommandType::BEGIN_RENDER_PASS:
+				++renderPasses;
+				break;
+			case ENullCommandType::COPY_BUFFER:
+				uploadedBytes += command.arguments[0];
+				break;
+			case ENullCommandType::BIND_PIPELINE:
+				++pipelineBinds;
+				break;
+			case ENullCommandType::BIND_DESCRIPTOR_SETS:
+				++descriptorBinds;
+				break;
+			case ENullCommandType::DRAW:
+				++drawCalls;
+				vertices += static_cast<uint64_t>(command.arguments[0]) * command.arguments[1];
+				break;
+			case ENullCommandType::DRAW_INDEXED:
+				++drawCalls;
+				indices += static_cast<uint64_t>(command.arguments[0]) * command.arguments[1];
+				break;
+			default:
+				break;
+		}
+	}
+
+	mSubmissions.fetch_add(1, std::memory_order_relaxed);
+	mCommands.fetch_add(aBuffer->getCommands().size(), std::memory_order_relaxed);
+	mRenderPasses.fetch_add(renderPasses, std::memory_order_relaxed);
+	mPipelineBinds.fetch_add(pipelineBinds, std::memory_order_relaxed);
+	mDescriptorBinds.fetch_add(descriptorBinds, std::memory_order_relaxed);
+	mDrawCalls.fetch_add(drawCalls, std::memory_order_relaxed);
+	mVertices.fetch_add(vertices, std::memory_order_relaxed);
+	mIndices.fetch_add(indices, std::memory_order_relaxed);
+	mUploadedBytes.fetch_add(uploadedBytes, std::memory_order_relaxed);
+}
+
+NullCommandPool* NullGraphicsContext::getCommandPool() const
+{
+	return mCommandPool;
+}
+
+NullCommandPool* NullGraphicsContext::getTransferCommandPool() const
+{
+	return mTransferCommandPool;
+}
+
+NullFrameStatistics NullGraphicsContext::getStatistics() const
+{
+	NullFrameStatistics stats;
+	stats.submissions = mSubmissions.load(std::memory_order_relaxed);
+	stats.commands = mCommands.load(std::memory_order_relaxed);
+	stats.renderPasses = mRenderPasses.load(std::memory_order_relaxed);
+	stats.pipelineBinds = mPipelineBinds.load(std::memory_order_relaxed);
+	stats.descriptorBinds = mDescriptorBinds.load(std::memory_order_relaxed);
+	stats.drawCalls = mDrawCalls.load(std::memory_order_relaxed);
+	stats.vertices = mVertices.load(std::memory_order_relaxed);
+	stats.indices = mIndices.load(std::memory_order_relaxed);
+	stats.uploadedBytes = mUploadedBytes.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+void NullGraphicsContext::resetStatistics()
+{
+	mSubmissions.store(0, std::memory_order_relaxed);
+	mCommands.store(0, std::memory_order_relaxed);
+	mRenderPasses.store(0, std::memory_order_relaxed);
+	mPipelineBinds.store(0, std::memory_order_relaxed);
+	mDescriptorBinds.store(0, std::memory_order_relaxed);
+	mDrawCalls.store(0, std::memory_order_relaxed);
+	mVertices.store(0, std::memory_order_relaxed);
+	mIndices.store(0, std::memory_order_relaxed);
+	mUploadedBytes.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,32 @@
+#include "graphics/null/NullGraphicsPipeline.h"
+
+NullGraphicsPipeline::NullGraphicsPipeline(IGraphicsContext* aContext)
+	: IGraphicsPipeline(aContext)
+{
+}
+
+void NullGraphicsPipeline::construct(const GraphicsPipelineCreateInfo& aInfo)
+{
+	mCreateInfo = aInfo;
+}
+
+void NullGraphicsPipeline::reconstruct(const GraphicsPipelineCreateInfo& aInfo)
+{
+	destroy();
+	construct(aInfo);
+}
+
+void NullGraphicsPipeline::destroy()
+{
+	mCreateInfo = {};
+}
+
+GraphicsPipelineCreateInfo& NullGraphicsPipeline::getCreateInfo()
+{
+	return mCreateInfo;
+}
+
+IPipelineLayout* NullGraphicsPipeline::getLayout() const
+{
+	return mCreateInfo.layout;
+}
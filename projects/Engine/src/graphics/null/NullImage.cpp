@@ -0,0 +1,37 @@
+#include "graphics/null/NullImage.h"
+
+#include <cstring>
+
+NullImage::NullImage(IGraphicsContext* aContext)
+	: IImage(aContext)
+{
+}
+
+void NullImage::construct(const ImageCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+void NullImage::reconstruct(const ImageCreateInfo& aInfo)
+{
+	construct(aInfo);
+}
+
+void NullImage::setData(void* aData, const size_t aSize)
+{
+	mData.resize(aSize);
+	if (aData != nullptr && aSize > 0)
+	{
+		memcpy(mData.data(), aData, aSize);
+	}
+}
+
+const ImageCreateInfo& NullImage::getCreateInfo() const
+{
+	return mInfo;
+}
+
+const std::vector<uint8_t>& NullImage::getData() const
+{
+	return mData;
+}
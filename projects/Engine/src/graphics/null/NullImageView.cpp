@@ -0,0 +1,21 @@
+#include "graphics/null/NullImageView.h"
+
+NullImageView::NullImageView(IGraphicsContext* aContext)
+	: IImageView(aContext)
+{
+}
+
+void NullImageView::construct(const ImageViewCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+IImage* NullImageView::getImage() const
+{
+	return mInfo.image;
+}
+
+const ImageViewCreateInfo& NullImageView::getCreateInfo() const
+{
+	return mInfo;
+}
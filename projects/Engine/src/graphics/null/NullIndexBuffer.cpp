@@ -0,0 +1,30 @@
+#include "graphics/null/NullIndexBuffer.h"
+
+#include <cstring>
+
+NullIndexBuffer::NullIndexBuffer(IGraphicsContext* aContext)
+	: IIndexBuffer(aContext)
+{
+}
+
+void NullIndexBuffer::construct(const IndexBufferCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+	mData.resize(aInfo.size);
+}
+
+uint32_t NullIndexBuffer::getCount() const
+{
+	return static_cast<uint32_t>(mInfo.size >> 1);
+}
+
+void NullIndexBuffer::setData(const void* aData, const size_t aSize)
+{
+	const size_t size = aSize < mData.size() ? aSize : mData.size();
+	memcpy(mData.data(), aData, size);
+}
+
+const std::vector<uint8_t>& NullIndexBuffer::getData() const
+{
+	return mData;
+}
@@ -0,0 +1,27 @@
+#include "graphics/null/NullPipelineLayout.h"
+
+NullPipelineLayout::NullPipelineLayout(IGraphicsContext* aContext)
+	: IPipelineLayout(aContext)
+{
+}
+
+void NullPipelineLayout::construct(const PipelineLayoutCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+void NullPipelineLayout::reconstruct(const PipelineLayoutCreateInfo& aInfo)
+{
+	destroy();
+	construct(aInfo);
+}
+
+void NullPipelineLayout::destroy()
+{
+	mInfo = {};
+}
+
+const PipelineLayoutCreateInfo& NullPipelineLayout::getCreateInfo() const
+{
+	return mInfo;
+}
@@ -0,0 +1,27 @@
+#include "graphics/null/NullRenderPass.h"
+
+NullRenderPass::NullRenderPass(IGraphicsContext* aContext)
+	: IRenderPass(aContext)
+{
+}
+
+void NullRenderPass::construct(const RenderPassCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+void NullRenderPass::reconstruct(const RenderPassCreateInfo& aInfo)
+{
+	destroy();
+	construct(aInfo);
+}
+
+void NullRenderPass::destroy()
+{
+	mInfo = {};
+}
+
+RenderPassCreateInfo& NullRenderPass::getCreateInfo()
+{
+	return mInfo;
+}
@@ -0,0 +1,16 @@
+#include "graphics/null/NullSampler.h"
+
+NullSampler::NullSampler(IGraphicsContext* aContext)
+	: ISampler(aContext)
+{
+}
+
+void NullSampler::construct(const SamplerCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+const SamplerCreateInfo& NullSampler::getCreateInfo() const
+{
+	return mInfo;
+}
@@ -0,0 +1,16 @@
+#include "graphics/null/NullShaderModule.h"
+
+NullShaderModule::NullShaderModule(IGraphicsContext* aContext)
+	: IShaderModule(aContext)
+{
+}
+
+void NullShaderModule::construct(const ShaderModuleCreateInfo& aInfo)
+{
+	mCode = aInfo.code;
+}
+
+const std::vector<char>& NullShaderModule::getCode() const
+{
+	return mCode;
+}
@@ -0,0 +1,26 @@
+#include "graphics/null/NullShaderStage.h"
+
+NullShaderStage::NullShaderStage(IGraphicsContext* aContext)
+	: IShaderStage(aContext)
+{
+}
+
+void NullShaderStage::construct(const ShaderStageCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+}
+
+IShaderModule* NullShaderStage::getModule() const
+{
+	return mInfo.module;
+}
+
+EShaderStageFlagBits NullShaderStage::getStage() const
+{
+	return mInfo.stage;
+}
+
+const std::string& NullShaderStage::getEntryPoint() const
+{
+	return mInfo.name;
+}
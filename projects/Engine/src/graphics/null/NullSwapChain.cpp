@@ -0,0 +1,113 @@
+#include "graphics/null/NullSwapChain.h"
+
+NullSwapChain::NullSwapChain(IGraphicsContext* aContext)
+	: ISwapChain(aContext), mContext(aContext)
+{
+}
+
+NullSwapChain::~NullSwapChain()
+{
+	_destroy();
+}
+
+void NullSwapChain::construct(const SwapChainCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+	if (mInfo.format == EDataFormat(0))
+	{
+		mInfo.format = EDataFormat::B8G8R8A8_UNORM;
+	}
+
+	const uint32_t imageCount = aInfo.maxImageCount > 0 ? aInfo.maxImageCount : 2;
+
+	for (uint32_t i = 0; i < imageCount; i++)
+	{
+		NullImage* image = new NullImage(mContext);
+		image->construct({ 0, EImageDimension::IMAGE_2D, mInfo.format, aInfo.width, aInfo.height, 1, 0, 1, 0, 1, 1,
+		IMAGE_ASPECT_COLOR, IMAGE_SAMPLE_1, EImageTiling::IMAGE_TILING_OPTIMAL, IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+		IMAGE_LAYOUT_UNDEFINED, {mContext}, EMemoryPropertyBits::MEMORY_PROPERTY_DEVICE_LOCAL, 0, 0, {} });
+
+		NullImageView* view = new NullImageView(mContext);
+		view->construct({ image, mInfo.format, EImageViewType::IMAGE_VIEW_TYPE_2D, { IMAGE_ASPECT_COLOR, 0, 1, 0, 1 } });
+
+		mImages.push_back(image);
+		mImageViews.push_back(view);
+	}
+
+	mDepthImage = new NullImage(mContext);
+	mDepthImage->construct({ 0, EImageDimension::IMAGE_2D, EDataFormat::D32_SFLOAT, aInfo.width, aInfo.height, 1, 0, 1, 0, 1, 1,
+	IMAGE_ASPECT_DEPTH, IMAGE_SAMPLE_1, EImageTiling::IMAGE_TILING_OPTIMAL, IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+	IMAGE_LAYOUT_UNDEFINED, {mContext}, EMemoryPropertyBits::MEMORY_PROPERTY_DEVICE_LOCAL, 0, 0, {} });
+
+	mDepthView = new NullImageView(mContext);
+	mDepthView->construct({ mDepthImage, EDataFormat::D32_SFLOAT, EImageViewType::IMAGE_VIEW_TYPE_2D, { IMAGE_ASPECT_DEPTH, 0, 1, 0, 1 } });
+
+	mCurrentImage = 0;
+}
+
+void NullSwapChain::reconstruct(const SwapChainCreateInfo& aInfo)
+{
+	_destroy();
+	construct(aInfo);
+}
+
+void NullSwapChain::destroy()
+{
+	_destroy();
+}
+
+uint32_t NullSwapChain::getImageCount()
+{
+	return static_cast<uint32_t>(mImages.size());
+}
+
+void NullSwapChain::beginFrame()
+{
+}
+
+void NullSwapChain::endFrame()
+{
+	mCurrentImage = (mCurrentImage + 1) % static_cast<uint32_t>(mImages.size());
+}
+
+uint32_t NullSwapChain::getCurrentImage() const
+{
+	return mCurrentImage;
+}
+
+EDataFormat NullSwapChain::getSwapchainFormat() const
+{
+	return mInfo.format;
+}
+
+std::vector<IImageView*> NullSwapChain::getImageViews() const
+{
+	return std::vector<IImageView*>(mImageViews.begin(), mImageViews.end());
+}
+
+IImageView* NullSwapChain::getDepthView() const
+{
+	return mDepthView;
+}
+
+void NullSwapChain::_destroy()
+{
+	for (NullImageView* view : mImageViews)
+	{
+		delete view;
+	}
+
+	for (NullImage* image : mImages)
+	{
+		delete image;
+	}
+
+	mImageViews.clear();
+	mImages.clear();
+
+	delete mDepthView;
+	delete mDepthImage;
+
+	mDepthView = nullptr;
+	mDepthImage = nullptr;
+}
@@ -0,0 +1,68 @@
+#include "graphics/null/NullTexture.h"
+
+#include "assets/TextureAsset.h"
+
+NullTexture::NullTexture(IGraphicsContext* aContext)
+	: ITexture(aContext)
+{
+}
+
+NullTexture::~NullTexture()
+{
+	delete mImageView;
+	delete mImage;
+}
+
+void NullTexture::construct(const TextureCreateInfo& aInfo)
+{
+	mBindingPoint = aInfo.binding;
+	mStages = aInfo.shaderStageAccess;
+	mSampler = aInfo.sampler;
+
+	const ImageFile& data = aInfo.textureAsset->getData();
+	const uint32_t levelCount = static_cast<uint32_t>(data.levelOffsets.size());
+
+	mImage = new NullImage(mContext);
+	mImage->setData(const_cast<uint8_t*>(data.payload), data.size);
+	mImage->construct({ 0, EImageDimension::IMAGE_2D, data.format, data.width,
+	data.height, 1, 0, levelCount, 0, levelCount, 1, IMAGE_ASPECT_COLOR,
+	IMAGE_SAMPLE_1, EImageTiling::IMAGE_TILING_OPTIMAL, IMAGE_USAGE_TRANSFER_DST_BIT | IMAGE_USAGE_SAMPLED_BIT,
+	IMAGE_LAYOUT_UNDEFINED, {mContext}, EMemoryPropertyBits::MEMORY_PROPERTY_DEVICE_LOCAL, 0, 0, data.levelOffsets });
+
+	mImageView = new NullImageView(mContext);
+	mImageView->construct({ mImage, data.format, EImageViewType::IMAGE_VIEW_TYPE_2D, {EImageAspectFlagBits::IMAGE_ASPECT_COLOR,
+	0, levelCount, 0, 1} });
+}
+
+void NullTexture::reconstruct(const TextureCreateInfo& aInfo)
+{
+	delete mImageView;
+	delete mImage;
+
+	construct(aInfo);
+}
+
+ShaderStageFlags NullTexture::getStageFlags() const
+{
+	return mStages;
+}
+
+uint32_t NullTexture::getBindingPoint() const
+{
+	return mBindingPoint;
+}
+
+ISampler* NullTexture::getSampler() const
+{
+	return mSampler;
+}
+
+NullImage* NullTexture::getImage() const
+{
+	return mImage;
+}
+
+NullImageView* NullTexture::getImageView() const
+{
+	return mImageView;
+}
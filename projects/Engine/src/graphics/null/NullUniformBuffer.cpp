@@ -0,0 +1,35 @@
+#include "graphics/null/NullUniformBuffer.h"
+
+#include <cstring>
+
+NullUniformBuffer::NullUniformBuffer(IGraphicsContext* aContext)
+	: IUniformBuffer(aContext)
+{
+}
+
+void NullUniformBuffer::construct(const UniformBufferCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+	mData.resize(aInfo.size);
+}
+
+void NullUniformBuffer::reconstruct(const UniformBufferCreateInfo& aInfo)
+{
+	construct(aInfo);
+}
+
+void NullUniformBuffer::setData(void* aData, const size_t aOffset, const size_t aSize)
+{
+	if (aOffset >= mData.size())
+	{
+		return;
+	}
+
+	const size_t size = aSize < mData.size() - aOffset ? aSize : mData.size() - aOffset;
+	memcpy(mData.data() + aOffset, aData, size);
+}
+
+const std::vector<uint8_t>& NullUniformBuffer::getData() const
+{
+	return mData;
+}
@@ -0,0 +1,40 @@
+#include "graphics/null/NullVertexBuffer.h"
+
+#include <cstring>
+
+NullVertexBuffer::NullVertexBuffer(IGraphicsContext* aContext)
+	: IVertexBuffer(aContext)
+{
+	mSize = 0;
+	mData = nullptr;
+}
+
+void NullVertexBuffer::construct(const VertexBufferCreateInfo& aInfo)
+{
+	mInfo = aInfo;
+	mStorage.resize(aInfo.size);
+
+	mSize = aInfo.size;
+	mData = mStorage.data();
+}
+
+void NullVertexBuffer::setLayout(const BufferLayout& aLayout)
+{
+	mLayout = aLayout;
+}
+
+void NullVertexBuffer::setData(const void* aData, const size_t aSize)
+{
+	const size_t size = aSize < mStorage.size() ? aSize : mStorage.size();
+	memcpy(mStorage.data(), aData, size);
+}
+
+const std::vector<uint8_t>& NullVertexBuffer::getData() const
+{
+	return mStorage;
+}
+
+const BufferLayout& NullVertexBuffer::getLayout() const
+{
+	return mLayout;
+}
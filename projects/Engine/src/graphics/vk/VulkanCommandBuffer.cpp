@@ -438,6 +438,13 @@ void VulkanCommandBuffer::bindSceneData(SceneData* aData, const uint32_t aFrame)
 	mData = aData;
 }
 
+void VulkanCommandBuffer::pushConstants(IGraphicsPipeline* aPipeline, const ShaderStageFlags aStages, const uint32_t aOffset,
+	const uint32_t aSize, const void* aData)
+{
+	VulkanPipelineLayout* layout = primal_cast<VulkanGraphicsPipeline*>(aPipeline)->getLayout();
+	vkCmdPushConstants(mBuffer, layout->getHandle(), aStages, aOffset, aSize, aData);
+}
+
 void VulkanCommandBuffer::draw(const uint32_t aVertexCount, const uint32_t aInstanceCount, const uint32_t aFirstVertex,
                                const uint32_t aFirstInstance)
 {
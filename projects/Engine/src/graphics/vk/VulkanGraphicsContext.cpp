@@ -3,7 +3,9 @@
 #include "core/Log.h"
 #include "core/PrimalAssert.h"
 #include "graphics/vk/VulkanGraphicsContext.h"
+#include "graphics/vk/VulkanUploadManager.h"
 
+#include <algorithm>
 #include <map>
 #include <unordered_set>
 
@@ -86,7 +88,7 @@ namespace detail
 }
 
 VulkanGraphicsContext::VulkanGraphicsContext(const GraphicsContextCreateInfo& aCreateInfo)
-	: IGraphicsContext(aCreateInfo), mCreateInfo(aCreateInfo)
+	: IGraphicsContext(aCreateInfo), mCreateInfo(aCreateInfo), mPool(nullptr), mTransferPool(nullptr), mUploadManager(nullptr)
 {
 	_initializeVulkan();
 	_initializeDebugMessenger();
@@ -129,11 +131,21 @@ VulkanGraphicsContext::VulkanGraphicsContext(const GraphicsContextCreateInfo& aC
 	mTransferPool = new VulkanCommandPool(this);
 	mTransferPool->construct(transferCommandPoolInfo);
 
+	mUploadManager = new VulkanUploadManager(this);
+
 	GraphicsFactory::instance().initialize(ERenderAPI::RENDERAPI_VULKAN, this);
 }
 
 VulkanGraphicsContext::~VulkanGraphicsContext()
 {
+	if (!mRetired.empty())
+	{
+		idle();
+		_advanceFrame(UINT64_MAX);
+	}
+
+	delete mUploadManager;
+
 	vmaDestroyAllocator(mImageAllocator);
 	vmaDestroyAllocator(mBufferAllocator);
 	
@@ -159,6 +171,8 @@ VulkanGraphicsContext::~VulkanGraphicsContext()
 
 void VulkanGraphicsContext::idle() const
 {
+	std::lock_guard<std::mutex> lock(mQueueMutex);
+
 	vkDeviceWaitIdle(mDevice);
 
 	VkQueue graphicsQueue;
@@ -221,6 +235,46 @@ VulkanCommandPool* VulkanGraphicsContext::getTransferCommandPool() const
 	return mTransferPool;
 }
 
+VulkanUploadManager* VulkanGraphicsContext::getUploadManager() const
+{
+	return mUploadManager;
+}
+
+std::mutex& VulkanGraphicsContext::getQueueMutex() const
+{
+	return mQueueMutex;
+}
+
+void VulkanGraphicsContext::retire(std::function<void()> aDestroy)
+{
+	std::lock_guard<std::mutex> lock(mRetireMutex);
+	mRetired.push_back({ mFrame, std::move(aDestroy) });
+}
+
+void VulkanGraphicsContext::_advanceFrame(const uint64_t aCompletedFrames)
+{
+	std::vector<RetiredObject> released;
+	{
+		std::lock_guard<std::mutex> lock(mRetireMutex);
+
+		mFrame++;
+
+		// Retired in order, so everything still in use is at the back
+		const auto end = std::find_if(mRetired.begin(), mRetired.end(), [aCompletedFrames](const RetiredObject& aObject)
+		{
+			return aObject.frame >= aCompletedFrames;
+		});
+
+		released.assign(std::make_move_iterator(mRetired.begin()), std::make_move_iterator(end));
+		mRetired.erase(mRetired.begin(), end);
+	}
+
+	for (RetiredObject& object : released)
+	{
+		object.destroy();
+	}
+}
+
 void VulkanGraphicsContext::_initializeVulkan()
 {
 	using namespace std;
@@ -4,8 +4,11 @@
 #include "core/PrimalAssert.h"
 #include "graphics/api/ICommandBuffer.h"
 #include "graphics/vk/VulkanCommandBuffer.h"
+#include "graphics/vk/VulkanUploadManager.h"
 #include "core/PrimalCast.h"
 
+#include <cstring>
+
 VulkanImage::VulkanImage(IGraphicsContext* aContext)
 	: IImage(aContext), mContext(aContext)
 {
@@ -15,6 +18,12 @@ VulkanImage::VulkanImage(IGraphicsContext* aContext)
 
 VulkanImage::~VulkanImage()
 {
+	// Data set for an image that was never constructed
+	if (mStaging.data != nullptr)
+	{
+		reinterpret_cast<VulkanGraphicsContext*>(mContext)->getUploadManager()->release(mStaging);
+	}
+
 	_destroy();
 }
 
@@ -22,26 +31,6 @@ void VulkanImage::construct(const ImageCreateInfo& aInfo)
 {
 	using namespace std;
 
-	if (mStagingMemory)
-	{
-		VkBufferCreateInfo stagingBufferInfo = {};
-		stagingBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		stagingBufferInfo.size = mStagingSize;
-		stagingBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-		stagingBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-		VulkanGraphicsContext* ctx = reinterpret_cast<VulkanGraphicsContext*>(mContext);
-
-		VmaAllocationCreateInfo stagingAllocInfo = {};
-		stagingAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-		vmaCreateBuffer(ctx->getBufferAllocator(), &stagingBufferInfo, &stagingAllocInfo, &mStagingBuffer, &mStagingAllocation, nullptr);
-		void* data;
-		vmaMapMemory(ctx->getBufferAllocator(), mStagingAllocation, &data);
-		memcpy(data, mStagingMemory, mStagingSize);
-		vmaUnmapMemory(ctx->getBufferAllocator(), mStagingAllocation);
-	}
-
 	VkImageCreateInfo createInfo;
 	createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 	createInfo.pNext = nullptr;
@@ -93,15 +82,13 @@ void VulkanImage::construct(const ImageCreateInfo& aInfo)
 		PRIMAL_INTERNAL_INFO("Successfully created Vulkan image.");
 	}
 
-	if (mStagingMemory != nullptr)
+	// The copy and the transition for sampling are recorded with the next batch of uploads
+	if (mStaging.data != nullptr || mCopySource != VK_NULL_HANDLE)
 	{
-		transitionToLayout(aInfo, aInfo.format, IMAGE_LAYOUT_UNDEFINED, IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-		_copyBufferToImage(aInfo);
-		transitionToLayout(aInfo, aInfo.format, IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-		
 		VulkanGraphicsContext* ctx = reinterpret_cast<VulkanGraphicsContext*>(mContext);
-		vmaDestroyBuffer(ctx->getBufferAllocator(), mStagingBuffer, mStagingAllocation);
-		free(mStagingMemory);
+		ctx->getUploadManager()->upload(mImage, aInfo, mStaging, mCopySource, mCopyLevel);
+		mStaging = {};
+		mCopySource = VK_NULL_HANDLE;
 	}
 }
 
@@ -124,17 +111,20 @@ void VulkanImage::setHandle(const VkImage aImage)
 
 void VulkanImage::setData(void* aData, const size_t aSize)
 {
-	if (mStagingMemory)
-	{
-		free(mStagingMemory);
-		mStagingMemory = nullptr;
-	}
+	VulkanUploadManager* uploads = reinterpret_cast<VulkanGraphicsContext*>(mContext)->getUploadManager();
 
-	mStagingSize = aSize;
-	mStagingMemory = malloc(aSize);
-	PRIMAL_ASSERT(mStagingMemory != nullptr, "Failed to allocate staging memory.");
+	uploads->release(mStaging);
 
-	memcpy(mStagingMemory, aData, mStagingSize);
+	mStaging = uploads->allocate(aSize);
+	PRIMAL_ASSERT(mStaging.data != nullptr, "Failed to allocate staging memory.");
+
+	memcpy(mStaging.data, aData, aSize);
+}
+
+void VulkanImage::setCopySource(const VulkanImage* aSource, const uint32_t aLevel)
+{
+	mCopySource = aSource->getHandle();
+	mCopyLevel = aLevel;
 }
 
 void VulkanImage::transitionToLayout(const ImageCreateInfo& aInfo, EDataFormat aFormat, EImageLayout aOldLayout, EImageLayout aNewLayout) const
@@ -216,53 +206,7 @@ void VulkanImage::transitionToLayout(const ImageCreateInfo& aInfo, EDataFormat a
 
 	vkGetDeviceQueue(ctx->getDevice(), queueIdx, 0, &queue);
 
-	vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-	vkQueueWaitIdle(queue);
-}
-
-void VulkanImage::_copyBufferToImage(const ImageCreateInfo& aInfo) const
-{
-	VulkanGraphicsContext* ctx = reinterpret_cast<VulkanGraphicsContext*>(mContext);
-	VulkanCommandPool* pool = ctx->getCommandPool();
-
-	const CommandBufferCreateInfo commandBufferInfo = {
-		pool,
-		true
-	};
-
-	VulkanCommandBuffer buf(ctx);
-	buf.construct(commandBufferInfo);
-	const VkCommandBuffer bufHandle = buf.getHandle();
-
-	VkCommandBufferBeginInfo beginInfo = {};
-	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-	VkBufferImageCopy region;
-	region.bufferOffset = 0;
-	region.bufferRowLength = 0;
-	region.bufferImageHeight = 0;
-	region.imageSubresource.aspectMask = aInfo.imageAspect;
-	region.imageSubresource.mipLevel = aInfo.baseMipLevel;
-	region.imageSubresource.baseArrayLayer = aInfo.baseArrayLayer;
-	region.imageSubresource.layerCount = aInfo.layerCount;
-	region.imageOffset = { 0, 0, 0 };
-	region.imageExtent = { aInfo.width, aInfo.height, aInfo.depth };
-
-	vkBeginCommandBuffer(bufHandle, &beginInfo);
-	vkCmdCopyBufferToImage(bufHandle, mStagingBuffer, mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-	vkEndCommandBuffer(bufHandle);
-
-	VkSubmitInfo submitInfo = {};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &bufHandle;
-
-	const uint32_t queueIdx = ctx->getGraphicsQueueIndex();
-	VkQueue queue;
-
-	vkGetDeviceQueue(ctx->getDevice(), queueIdx, 0, &queue);
-
+	std::lock_guard<std::mutex> lock(ctx->getQueueMutex());
 	vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
 	vkQueueWaitIdle(queue);
 }
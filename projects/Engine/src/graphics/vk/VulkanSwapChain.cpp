@@ -5,6 +5,7 @@
 #include "graphics/vk/VulkanImage.h"
 #include "graphics/vk/VulkanImageView.h"
 #include "graphics/vk/VulkanSwapChain.h"
+#include "graphics/vk/VulkanUploadManager.h"
 
 namespace detail
 {
@@ -348,7 +349,10 @@ void VulkanSwapChain::submitToTransferQueue(ICommandBuffer* aBuffer, bool aWaitF
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &buf;
 	
-	vkQueueSubmit(mTransferQueue, 1, &submitInfo, fence);
+	{
+		std::lock_guard<std::mutex> lock(context->getQueueMutex());
+		vkQueueSubmit(mTransferQueue, 1, &submitInfo, fence);
+	}
 
 	if (aWaitForFinish)
 	{
@@ -395,6 +399,11 @@ void VulkanSwapChain::submit(ICommandBuffer* aBuffer, bool aIsLastSubmission) co
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &buf;
 
+	// Images uploaded before this point may be sampled by aBuffer, their copies have to be ahead of it in the queue
+	VulkanGraphicsContext* context = primal_cast<VulkanGraphicsContext*>(mContext);
+	context->getUploadManager()->flush();
+
+	std::lock_guard<std::mutex> lock(context->getQueueMutex());
 	vkQueueSubmit(mGraphicsQueue, 1, &submitInfo, aIsLastSubmission ? mFences[mCurrentImage] : VK_NULL_HANDLE);
 }
 
@@ -414,7 +423,12 @@ bool VulkanSwapChain::swap()
 
 	presentInfo.pImageIndices = &mCurrentImageInChain;
 
-	const VkResult res = vkQueuePresentKHR(mPresentQueue, &presentInfo);
+	VkResult res;
+	{
+		std::lock_guard<std::mutex> lock(context->getQueueMutex());
+		res = vkQueuePresentKHR(mPresentQueue, &presentInfo);
+	}
+
 	PRIMAL_ASSERT(res == VK_SUCCESS, "Failed to swap Vulkan swap chain");
 
 	mCurrentImage = (mCurrentImage + 1) % mFlightSize;
@@ -422,6 +436,10 @@ bool VulkanSwapChain::swap()
 	vkWaitForFences(context->getDevice(), 1, &mFences[mCurrentImage], VK_TRUE, 0xFFFFFFFFFFFFFFFF);
 	vkResetFences(context->getDevice(), 1, &mFences[mCurrentImage]);
 
+	// The fence just waited for was signaled by the frame presented mFlightSize - 1 frames ago
+	mPresentedFrames++;
+	context->_advanceFrame(mPresentedFrames + 1 >= mFlightSize ? mPresentedFrames + 1 - mFlightSize : 0);
+
 	return res == VK_SUCCESS;
 }
 
@@ -517,7 +535,7 @@ void VulkanSwapChain::_createDepthResources()
 void VulkanSwapChain::_destroy()
 {
 	VulkanGraphicsContext* context = reinterpret_cast<VulkanGraphicsContext*>(mContext);
-	vkDeviceWaitIdle(context->getDevice());
+	mContext->idle();
 
 	for (IImageView* view : mImageViews)
 	{
@@ -529,7 +547,7 @@ void VulkanSwapChain::_destroy()
 	delete mDepthView;
 	delete mDepthImage;
 
-	vkDeviceWaitIdle(context->getDevice());
+	mContext->idle();
 	vkDestroySwapchainKHR(context->getDevice(), mSwapchain, nullptr);
 
 	for (auto sem : mImageAvailable)
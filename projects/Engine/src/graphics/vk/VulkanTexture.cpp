@@ -7,6 +7,9 @@
 
 #include "assets/TextureAsset.h"
 
+#include <algorithm>
+#include <vector>
+
 VulkanTexture::VulkanTexture(IGraphicsContext* aContext)
 	: ITexture(aContext), mSampler(nullptr)
 {
@@ -21,23 +24,83 @@ VulkanTexture::~VulkanTexture()
 }
 
 void VulkanTexture::construct(const TextureCreateInfo& aInfo)
+{
+	_construct(aInfo, nullptr);
+}
+
+void VulkanTexture::reconstruct(const TextureCreateInfo& aInfo)
+{
+	VulkanImage* image = mImage;
+	VulkanImageView* imageView = mImageView;
+
+	_construct(aInfo, image);
+
+	// Frames in flight may still sample the old image, and the new one is copied from it
+	primal_cast<VulkanGraphicsContext*>(mContext)->retire([image, imageView]
+	{
+		delete imageView;
+		delete image;
+	});
+}
+
+void VulkanTexture::_construct(const TextureCreateInfo& aInfo, const VulkanImage* aPrevious)
 {
 	mBindingPoint = aInfo.binding;
 	mStages = aInfo.shaderStageAccess;
 
+	const ImageFile& data = aInfo.textureAsset->getData();
+	const uint32_t levelCount = static_cast<uint32_t>(data.levelOffsets.size());
+
+	// The coarser levels of a chain are the same in both images, so a resident level moving by one mip
+	// uploads at most that mip
+	uint32_t uploadCount = levelCount;
+	uint32_t sourceLevel = 0;
+
+	if (aPrevious != nullptr && data.format == mFormat)
+	{
+		if (levelCount >= mLevelCount && std::max(data.width >> (levelCount - mLevelCount), 1u) == mWidth &&
+			std::max(data.height >> (levelCount - mLevelCount), 1u) == mHeight)
+		{
+			uploadCount = levelCount - mLevelCount;
+		}
+		else if (levelCount < mLevelCount && std::max(mWidth >> (mLevelCount - levelCount), 1u) == data.width &&
+			std::max(mHeight >> (mLevelCount - levelCount), 1u) == data.height)
+		{
+			uploadCount = 0;
+			sourceLevel = mLevelCount - levelCount;
+		}
+	}
+
+	// Finer levels come first in the data, so the uploaded ones are its start
 	mImage = new VulkanImage(mContext);
-	const uint32_t size = aInfo.textureAsset->getData().channels * (aInfo.textureAsset->getData().height * aInfo.textureAsset->getData().width);
-	mImage->setData(&aInfo.textureAsset->getData().payload[0], size);
-	mImage->construct({ 0, EImageDimension::IMAGE_2D, EDataFormat::R8G8B8A8_UNORM, aInfo.textureAsset->getData().width,
-	aInfo.textureAsset->getData().height, 1, 0, 1, 0, 1, 1, IMAGE_ASPECT_COLOR,
-	IMAGE_SAMPLE_1, EImageTiling::IMAGE_TILING_OPTIMAL, IMAGE_USAGE_TRANSFER_DST_BIT | IMAGE_USAGE_SAMPLED_BIT,
-	IMAGE_LAYOUT_UNDEFINED, {mContext}, EMemoryPropertyBits::MEMORY_PROPERTY_DEVICE_LOCAL, 0, 0 });
+	if (uploadCount > 0)
+	{
+		const size_t uploadSize = uploadCount < levelCount ? static_cast<size_t>(data.levelOffsets[uploadCount]) : data.size;
+		mImage->setData(const_cast<uint8_t*>(data.payload), uploadSize);
+	}
+
+	if (uploadCount < levelCount)
+	{
+		mImage->setCopySource(aPrevious, sourceLevel);
+	}
+
+	std::vector<uint64_t> levelOffsets(data.levelOffsets.begin(), data.levelOffsets.begin() + uploadCount);
+
+	mImage->construct({ 0, EImageDimension::IMAGE_2D, data.format, data.width,
+	data.height, 1, 0, levelCount, 0, levelCount, 1, IMAGE_ASPECT_COLOR,
+	IMAGE_SAMPLE_1, EImageTiling::IMAGE_TILING_OPTIMAL, IMAGE_USAGE_TRANSFER_SRC_BIT | IMAGE_USAGE_TRANSFER_DST_BIT | IMAGE_USAGE_SAMPLED_BIT,
+	IMAGE_LAYOUT_UNDEFINED, {mContext}, EMemoryPropertyBits::MEMORY_PROPERTY_DEVICE_LOCAL, 0, 0, levelOffsets });
 
 	mSampler = primal_cast<VulkanSampler*>(aInfo.sampler);
 
 	mImageView = new VulkanImageView(mContext);
-	mImageView->construct({ mImage, EDataFormat::R8G8B8A8_UNORM, EImageViewType::IMAGE_VIEW_TYPE_2D, {EImageAspectFlagBits::IMAGE_ASPECT_COLOR,
-	0, 1, 0, 1} });
+	mImageView->construct({ mImage, data.format, EImageViewType::IMAGE_VIEW_TYPE_2D, {EImageAspectFlagBits::IMAGE_ASPECT_COLOR,
+	0, levelCount, 0, 1} });
+
+	mFormat = data.format;
+	mWidth = data.width;
+	mHeight = data.height;
+	mLevelCount = levelCount;
 }
 
 DescriptorSetLayoutBinding VulkanTexture::getDescriptorSetLayout(const uint32_t aBinding,
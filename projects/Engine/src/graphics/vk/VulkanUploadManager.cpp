@@ -0,0 +1,536 @@
+#include "graphics/vk/VulkanUploadManager.h"
+
+#include <algorithm>
+
+#include "core/Log.h"
+#include "graphics/vk/VulkanGraphicsContext.h"
+
+namespace detail
+{
+	static VkDeviceSize sAlign(const VkDeviceSize aSize, const VkDeviceSize aAlignment)
+	{
+		return (aSize + aAlignment - 1) / aAlignment * aAlignment;
+	}
+}
+
+VulkanUploadManager::VulkanUploadManager(VulkanGraphicsContext* aContext)
+	: mContext(aContext), mAllocator(aContext->getBufferAllocator())
+{
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolInfo.queueFamilyIndex = aContext->getGraphicsQueueIndex();
+
+	if (vkCreateCommandPool(aContext->getDevice(), &poolInfo, nullptr, &mCommandPool) != VK_SUCCESS)
+	{
+		PRIMAL_INTERNAL_CRITICAL("Failed to create the upload command pool.");
+	}
+}
+
+VulkanUploadManager::~VulkanUploadManager()
+{
+	wait();
+
+	const VkDevice device = mContext->getDevice();
+
+	for (Page& page : mPages)
+	{
+		_destroyPage(page);
+	}
+
+	for (const Batch& batch : mFreeBatches)
+	{
+		vkDestroyFence(device, batch.fence, nullptr);
+	}
+
+	vkDestroyCommandPool(device, mCommandPool, nullptr);
+}
+
+VulkanStagingAllocation VulkanUploadManager::allocate(const size_t aSize)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	const VkDeviceSize size = detail::sAlign(std::max<VkDeviceSize>(aSize, 1), sAlignment);
+
+	VulkanStagingAllocation allocation;
+	allocation.size = aSize;
+
+	if (size > sPageSize)
+	{
+		if (!_createPage(size, true, allocation.page))
+		{
+			return {};
+		}
+
+		Page& page = mPages[allocation.page];
+		page.cursor = size;
+		page.uses = 1;
+
+		allocation.data = page.mapped;
+		return allocation;
+	}
+
+	if (mCurrentPage != sNoPage && mPages[mCurrentPage].cursor + size > mPages[mCurrentPage].size)
+	{
+		mCurrentPage = sNoPage;
+	}
+
+	if (mCurrentPage == sNoPage)
+	{
+		uint32_t next;
+		bool stalled = false;
+
+		while (!_acquirePage(next))
+		{
+			stalled = true;
+			_submit();
+
+			// Only allocations still being written hold pages, which the GPU cannot release. Grow instead.
+			if (mInFlight.empty())
+			{
+				if (!_createPage(sPageSize, false, next))
+				{
+					return {};
+				}
+
+				break;
+			}
+
+			_retire(true);
+		}
+
+		mStats.stalls += stalled ? 1 : 0;
+		mCurrentPage = next;
+	}
+
+	Page& page = mPages[mCurrentPage];
+
+	allocation.page = mCurrentPage;
+	allocation.offset = page.cursor;
+	allocation.data = page.mapped + page.cursor;
+
+	page.cursor += size;
+	page.uses++;
+
+	return allocation;
+}
+
+void VulkanUploadManager::release(const VulkanStagingAllocation& aAllocation)
+{
+	if (aAllocation.data == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	Page& page = mPages[aAllocation.page];
+	page.uses--;
+
+	if (page.dedicated && page.uses == 0 && page.lastBatch <= mCompletedBatch)
+	{
+		_destroyPage(page);
+	}
+}
+
+void VulkanUploadManager::upload(const VkImage aImage, const ImageCreateInfo& aInfo, const VulkanStagingAllocation& aAllocation)
+{
+	upload(aImage, aInfo, aAllocation, VK_NULL_HANDLE, 0);
+}
+
+void VulkanUploadManager::upload(const VkImage aImage, const ImageCreateInfo& aInfo, const VulkanStagingAllocation& aAllocation,
+	const VkImage aSource, const uint32_t aSourceLevel)
+{
+	if (aAllocation.data == nullptr && aSource == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	PendingUpload upload;
+	upload.image = aImage;
+	upload.page = aAllocation.data != nullptr ? aAllocation.page : sNoPage;
+	upload.bytes = aAllocation.size;
+
+	upload.range.aspectMask = aInfo.imageAspect;
+	upload.range.baseMipLevel = aInfo.baseMipLevel;
+	upload.range.levelCount = aInfo.levelCount;
+	upload.range.baseArrayLayer = aInfo.baseArrayLayer;
+	upload.range.layerCount = aInfo.layerCount;
+
+	size_t levelCount = aInfo.levelOffsets.empty() ? 1 : aInfo.levelOffsets.size();
+	if (aAllocation.data == nullptr)
+	{
+		levelCount = 0;
+	}
+
+	upload.regions.resize(levelCount);
+
+	for (size_t i = 0; i < levelCount; i++)
+	{
+		const uint32_t level = aInfo.baseMipLevel + static_cast<uint32_t>(i);
+
+		VkBufferImageCopy& region = upload.regions[i];
+		region.bufferOffset = aAllocation.offset + (aInfo.levelOffsets.empty() ? 0 : aInfo.levelOffsets[i]);
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = aInfo.imageAspect;
+		region.imageSubresource.mipLevel = level;
+		region.imageSubresource.baseArrayLayer = aInfo.baseArrayLayer;
+		region.imageSubresource.layerCount = aInfo.layerCount;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { std::max(aInfo.width >> level, 1u), std::max(aInfo.height >> level, 1u), std::max(aInfo.depth >> level, 1u) };
+	}
+
+	if (aSource != VK_NULL_HANDLE && levelCount < aInfo.levelCount)
+	{
+		const uint32_t copyCount = aInfo.levelCount - static_cast<uint32_t>(levelCount);
+
+		upload.source = aSource;
+		upload.sourceRange = upload.range;
+		upload.sourceRange.baseMipLevel = aSourceLevel;
+		upload.sourceRange.levelCount = copyCount;
+		upload.copies.resize(copyCount);
+
+		for (uint32_t i = 0; i < copyCount; i++)
+		{
+			const uint32_t level = aInfo.baseMipLevel + static_cast<uint32_t>(levelCount) + i;
+
+			VkImageCopy& copy = upload.copies[i];
+			copy.srcSubresource.aspectMask = aInfo.imageAspect;
+			copy.srcSubresource.mipLevel = aSourceLevel + i;
+			copy.srcSubresource.baseArrayLayer = aInfo.baseArrayLayer;
+			copy.srcSubresource.layerCount = aInfo.layerCount;
+			copy.srcOffset = { 0, 0, 0 };
+			copy.dstSubresource = copy.srcSubresource;
+			copy.dstSubresource.mipLevel = level;
+			copy.dstOffset = { 0, 0, 0 };
+			copy.extent = { std::max(aInfo.width >> level, 1u), std::max(aInfo.height >> level, 1u), std::max(aInfo.depth >> level, 1u) };
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// The source has to be filled before it is read, which a batch of its own guarantees
+	const bool sourcePending = std::any_of(mPending.begin(), mPending.end(), [aSource](const PendingUpload& aUpload)
+	{
+		return aUpload.image == aSource;
+	});
+
+	if (aSource != VK_NULL_HANDLE && sourcePending)
+	{
+		_submit();
+	}
+
+	mPendingBytes += upload.bytes;
+	mPending.push_back(std::move(upload));
+
+	if (mPendingBytes >= sBatchSize)
+	{
+		_submit();
+	}
+}
+
+void VulkanUploadManager::flush()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	_submit();
+	_retire(false);
+}
+
+void VulkanUploadManager::wait()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	_submit();
+
+	while (!mInFlight.empty())
+	{
+		_retire(true);
+	}
+}
+
+VulkanUploadStats VulkanUploadManager::getStats() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+bool VulkanUploadManager::_createPage(const VkDeviceSize aSize, const bool aDedicated, uint32_t& aPage)
+{
+	VkBufferCreateInfo bufferInfo = {};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = aSize;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VmaAllocationCreateInfo allocInfo = {};
+	allocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	Page page;
+	page.size = aSize;
+	page.dedicated = aDedicated;
+
+	VmaAllocationInfo info = {};
+	if (vmaCreateBuffer(mAllocator, &bufferInfo, &allocInfo, &page.buffer, &page.allocation, &info) != VK_SUCCESS)
+	{
+		PRIMAL_INTERNAL_ERROR("Failed to create a {0} byte staging page.", aSize);
+		return false;
+	}
+
+	page.mapped = static_cast<uint8_t*>(info.pMappedData);
+
+	// Slots of destroyed dedicated pages are reused so page indices stay valid
+	const auto slot = std::find_if(mPages.begin(), mPages.end(), [](const Page& aPage) { return aPage.buffer == VK_NULL_HANDLE; });
+	if (slot != mPages.end())
+	{
+		*slot = page;
+		aPage = static_cast<uint32_t>(slot - mPages.begin());
+	}
+	else
+	{
+		aPage = static_cast<uint32_t>(mPages.size());
+		mPages.push_back(page);
+	}
+
+	mStats.pages++;
+
+	return true;
+}
+
+void VulkanUploadManager::_destroyPage(Page& aPage)
+{
+	if (aPage.buffer == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	vmaDestroyBuffer(mAllocator, aPage.buffer, aPage.allocation);
+	aPage = {};
+
+	mStats.pages--;
+}
+
+bool VulkanUploadManager::_acquirePage(uint32_t& aPage)
+{
+	_retire(false);
+
+	uint32_t pageCount = 0;
+
+	for (uint32_t i = 0; i < mPages.size(); i++)
+	{
+		Page& page = mPages[i];
+		if (page.buffer == VK_NULL_HANDLE || page.dedicated)
+		{
+			continue;
+		}
+
+		pageCount++;
+
+		if (page.uses == 0 && page.lastBatch <= mCompletedBatch)
+		{
+			page.cursor = 0;
+			aPage = i;
+			return true;
+		}
+	}
+
+	return pageCount < sMaxPages && _createPage(sPageSize, false, aPage);
+}
+
+void VulkanUploadManager::_submit()
+{
+	if (mPending.empty())
+	{
+		return;
+	}
+
+	const VkDevice device = mContext->getDevice();
+
+	Batch batch;
+
+	if (!mFreeBatches.empty())
+	{
+		batch = mFreeBatches.back();
+		mFreeBatches.pop_back();
+	}
+	else
+	{
+		VkCommandBufferAllocateInfo bufferInfo = {};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		bufferInfo.commandPool = mCommandPool;
+		bufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		bufferInfo.commandBufferCount = 1;
+
+		VkFenceCreateInfo fenceInfo = {};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		vkAllocateCommandBuffers(device, &bufferInfo, &batch.commandBuffer);
+		vkCreateFence(device, &fenceInfo, nullptr, &batch.fence);
+	}
+
+	batch.id = mNextBatch++;
+
+	// All images move to TRANSFER_DST together, are filled, and move to SHADER_READ_ONLY together
+	std::vector<VkImageMemoryBarrier> barriers(mPending.size());
+
+	for (size_t i = 0; i < mPending.size(); i++)
+	{
+		VkImageMemoryBarrier& barrier = barriers[i];
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = mPending[i].image;
+		barrier.subresourceRange = mPending[i].range;
+	}
+
+	// Images copied from are only read, once frames already submitted are done sampling them
+	std::vector<VkImageMemoryBarrier> sourceBarriers;
+
+	for (const PendingUpload& upload : mPending)
+	{
+		if (upload.source == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = upload.source;
+		barrier.subresourceRange = upload.sourceRange;
+
+		sourceBarriers.push_back(barrier);
+	}
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+
+	vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+		static_cast<uint32_t>(barriers.size()), barriers.data());
+
+	if (!sourceBarriers.empty())
+	{
+		vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+			static_cast<uint32_t>(sourceBarriers.size()), sourceBarriers.data());
+	}
+
+	for (const PendingUpload& upload : mPending)
+	{
+		if (!upload.regions.empty())
+		{
+			vkCmdCopyBufferToImage(batch.commandBuffer, mPages[upload.page].buffer, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(upload.regions.size()), upload.regions.data());
+		}
+
+		if (!upload.copies.empty())
+		{
+			vkCmdCopyImage(batch.commandBuffer, upload.source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(upload.copies.size()), upload.copies.data());
+		}
+	}
+
+	for (VkImageMemoryBarrier& barrier : barriers)
+	{
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
+
+	for (VkImageMemoryBarrier& barrier : sourceBarriers)
+	{
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		barriers.push_back(barrier);
+	}
+
+	vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr,
+		static_cast<uint32_t>(barriers.size()), barriers.data());
+
+	vkEndCommandBuffer(batch.commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &batch.commandBuffer;
+
+	VkQueue queue;
+	vkGetDeviceQueue(device, mContext->getGraphicsQueueIndex(), 0, &queue);
+
+	{
+		std::lock_guard<std::mutex> queueLock(mContext->getQueueMutex());
+		vkQueueSubmit(queue, 1, &submitInfo, batch.fence);
+	}
+
+	for (const PendingUpload& upload : mPending)
+	{
+		if (upload.page == sNoPage)
+		{
+			continue;
+		}
+
+		Page& page = mPages[upload.page];
+		page.uses--;
+		page.lastBatch = batch.id;
+	}
+
+	mStats.batches++;
+	mStats.images += mPending.size();
+	mStats.bytes += mPendingBytes;
+
+	mPending.clear();
+	mPendingBytes = 0;
+
+	mInFlight.push_back(batch);
+}
+
+void VulkanUploadManager::_retire(const bool aWait)
+{
+	const VkDevice device = mContext->getDevice();
+	bool wait = aWait;
+
+	while (!mInFlight.empty())
+	{
+		Batch& batch = mInFlight.front();
+
+		const VkResult status = wait ? vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX) : vkGetFenceStatus(device, batch.fence);
+		if (status != VK_SUCCESS)
+		{
+			break;
+		}
+
+		wait = false;
+
+		vkResetFences(device, 1, &batch.fence);
+		vkResetCommandBuffer(batch.commandBuffer, 0);
+
+		mCompletedBatch = batch.id;
+		mFreeBatches.push_back(batch);
+		mInFlight.pop_front();
+	}
+
+	for (Page& page : mPages)
+	{
+		if (page.dedicated && page.buffer != VK_NULL_HANDLE && page.uses == 0 && page.lastBatch <= mCompletedBatch)
+		{
+			_destroyPage(page);
+		}
+	}
+}
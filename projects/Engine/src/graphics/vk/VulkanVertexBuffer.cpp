@@ -2,20 +2,53 @@
 #include "graphics/vk/VulkanVertexBuffer.h"
 #include "core/PrimalCast.h"
 
-static constexpr VkFormat sVertexAttributeFormat(const EBufferLayoutElementTypes& aType)
+// Scalar element types with a count of 2 to 4 describe a single vector attribute
+static VkFormat sVertexAttributeFormat(const BufferLayoutElement& aElement)
 {
-	switch(aType)
+	static const VkFormat ubyteFormats[2][4] = {
+		{ VK_FORMAT_R8_UINT, VK_FORMAT_R8G8_UINT, VK_FORMAT_R8G8B8_UINT, VK_FORMAT_R8G8B8A8_UINT },
+		{ VK_FORMAT_R8_UNORM, VK_FORMAT_R8G8_UNORM, VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_R8G8B8A8_UNORM }
+	};
+
+	static const VkFormat byteFormats[2][4] = {
+		{ VK_FORMAT_R8_SINT, VK_FORMAT_R8G8_SINT, VK_FORMAT_R8G8B8_SINT, VK_FORMAT_R8G8B8A8_SINT },
+		{ VK_FORMAT_R8_SNORM, VK_FORMAT_R8G8_SNORM, VK_FORMAT_R8G8B8_SNORM, VK_FORMAT_R8G8B8A8_SNORM }
+	};
+
+	static const VkFormat ushortFormats[2][4] = {
+		{ VK_FORMAT_R16_UINT, VK_FORMAT_R16G16_UINT, VK_FORMAT_R16G16B16_UINT, VK_FORMAT_R16G16B16A16_UINT },
+		{ VK_FORMAT_R16_UNORM, VK_FORMAT_R16G16_UNORM, VK_FORMAT_R16G16B16_UNORM, VK_FORMAT_R16G16B16A16_UNORM }
+	};
+
+	static const VkFormat shortFormats[2][4] = {
+		{ VK_FORMAT_R16_SINT, VK_FORMAT_R16G16_SINT, VK_FORMAT_R16G16B16_SINT, VK_FORMAT_R16G16B16A16_SINT },
+		{ VK_FORMAT_R16_SNORM, VK_FORMAT_R16G16_SNORM, VK_FORMAT_R16G16B16_SNORM, VK_FORMAT_R16G16B16A16_SNORM }
+	};
+
+	static const VkFormat halfFormats[4] = {
+		VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT
+	};
+
+	static const VkFormat floatFormats[4] = {
+		VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT
+	};
+
+	const uint32_t component = aElement.count >= 1 && aElement.count <= 4 ? aElement.count - 1 : 0;
+	const uint32_t normalized = aElement.normalized ? 1 : 0;
+
+	switch(aElement.type)
 	{
-		case EBufferLayoutElementTypes::UBYTE: return VK_FORMAT_R8_UINT;
-		case EBufferLayoutElementTypes::BYTE: return VK_FORMAT_R8_SINT;
-		case EBufferLayoutElementTypes::USHORT: return VK_FORMAT_R16_UINT;
-		case EBufferLayoutElementTypes::SHORT: return VK_FORMAT_R16_SINT;
+		case EBufferLayoutElementTypes::UBYTE: return ubyteFormats[normalized][component];
+		case EBufferLayoutElementTypes::BYTE: return byteFormats[normalized][component];
+		case EBufferLayoutElementTypes::USHORT: return ushortFormats[normalized][component];
+		case EBufferLayoutElementTypes::SHORT: return shortFormats[normalized][component];
 		case EBufferLayoutElementTypes::UINT: return VK_FORMAT_R32_UINT;
 		case EBufferLayoutElementTypes::INT: return VK_FORMAT_R32_SINT;
 		case EBufferLayoutElementTypes::ULONG: return VK_FORMAT_R64_UINT;
 		case EBufferLayoutElementTypes::LONG: return VK_FORMAT_R64_SINT;
-		case EBufferLayoutElementTypes::FLOAT: return VK_FORMAT_R32_SFLOAT;
+		case EBufferLayoutElementTypes::FLOAT: return floatFormats[component];
 		case EBufferLayoutElementTypes::DOUBLE: return VK_FORMAT_R64_SFLOAT;
+		case EBufferLayoutElementTypes::HALF: return halfFormats[component];
 		case EBufferLayoutElementTypes::VEC2: return VK_FORMAT_R32G32_SFLOAT;
 		case EBufferLayoutElementTypes::VEC3: return VK_FORMAT_R32G32B32_SFLOAT;
 		case EBufferLayoutElementTypes::VEC4: return VK_FORMAT_R32G32B32A32_SFLOAT;
@@ -80,6 +113,7 @@ void VulkanVertexBuffer::construct(const VertexBufferCreateInfo& aInfo)
 void VulkanVertexBuffer::setLayout(const BufferLayout& aLayout)
 {
 	mLayout = aLayout;
+	mAttributeDescriptions.clear();
 
 	mBindingDescription.binding = 0;
 	mBindingDescription.stride = static_cast<uint32_t>(aLayout.getStride());
@@ -90,7 +124,7 @@ void VulkanVertexBuffer::setLayout(const BufferLayout& aLayout)
 		VkVertexInputAttributeDescription desc = {};
 		desc.binding = 0;
 		desc.location = static_cast<uint32_t>(i);
-		desc.format = sVertexAttributeFormat(aLayout.getLayout()[i].type);
+		desc.format = sVertexAttributeFormat(aLayout.getLayout()[i]);
 		desc.offset = static_cast<uint32_t>(aLayout.getLayout()[i].offset);
 
 		mAttributeDescriptions.push_back(desc);
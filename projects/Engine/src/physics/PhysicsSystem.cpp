@@ -74,16 +74,22 @@ void PhysicsSystem::initialize()
 	PRIMAL_ASSERT(sceneDesc.isValid(), "Physx SceneDesc is not valid!");
 
 	mScene = mPhysics->createScene(sceneDesc);
-	mScene->simulate(0.02f);
 }
 
-void PhysicsSystem::fixedUpdate()
+void PhysicsSystem::fixedUpdate(const float aFixedDeltaTime)
 {
-	
+	mScene->simulate(aFixedDeltaTime);
+	mScene->fetchResults(true);
 }
 
 void PhysicsSystem::dispose()
 {
+	if (mScene)
+	{
+		mScene->release();
+		mScene = nullptr;
+	}
+
 	if (mPhysics)
 	{
 		mPhysics->release();
@@ -0,0 +1,227 @@
+#include "systems/HeadlessRenderSystem.h"
+
+#include "graphics/Mesh.h"
+#include "graphics/null/NullCommandPool.h"
+
+#include "assets/AssetManager.h"
+
+HeadlessRenderSystem::HeadlessRenderSystem(const uint32_t aWidth, const uint32_t aHeight)
+	: mWidth(aWidth), mHeight(aHeight)
+{
+	GraphicsContextCreateInfo info;
+	info.applicationName = "Sandbox";
+	info.versionMajor = 0;
+	info.versionMinor = 0;
+	info.window = nullptr;
+
+	mContext = new NullGraphicsContext(info);
+
+	mSwapChain = new NullSwapChain(mContext);
+
+	SwapChainCreateInfo swapChainInfo = {};
+	swapChainInfo.width = mWidth;
+	swapChainInfo.height = mHeight;
+	swapChainInfo.maxImageCount = mFlightSize;
+
+	mSwapChain->construct(swapChainInfo);
+
+	mScene = new SandboxScene();
+}
+
+HeadlessRenderSystem::~HeadlessRenderSystem()
+{
+	AssetManager::instance().unloadAll();
+
+	_destroyFramebuffers();
+
+	for (uint32_t i = 0; i < mFlightSize && mPrimaryBuffer != nullptr; i++)
+	{
+		delete mPrimaryBuffer[i];
+	}
+
+	delete[] mPrimaryBuffer;
+
+	delete mCpyBuffer;
+	delete mScene;
+
+	mRenderPassAsset = nullptr;
+
+	delete mSwapChain;
+	delete mContext;
+}
+
+void HeadlessRenderSystem::initialize()
+{
+	mRenderPassAsset = AssetManager::instance().load<RenderPassAsset>("defaultRenderpass", "data/renderpasses/default.json");
+	mRenderPass = mRenderPassAsset->getRenderPass();
+
+	_constructFramebuffers();
+
+	mPrimaryBuffer = new NullCommandBuffer * [mFlightSize];
+	for (uint32_t i = 0; i < mFlightSize; i++)
+	{
+		mPrimaryBuffer[i] = new NullCommandBuffer(mContext);
+		mPrimaryBuffer[i]->construct({ mContext->getCommandPool(), true });
+	}
+
+	mScene->initialize();
+	Mesh* mesh = mScene->getMesh();
+
+	mCpyBuffer = new NullCommandBuffer(mContext);
+	mCpyBuffer->construct({ mContext->getTransferCommandPool(), true });
+
+	CommandBufferRecordInfo recordInfo = {};
+	recordInfo.flags = COMMAND_BUFFER_USAGE_SIMULATANEOUS_USE;
+	mCpyBuffer->record(recordInfo);
+	mCpyBuffer->copyBuffers(mSwapChain, mesh->getVBO(), mesh->getData(), mesh->getSize());
+	mCpyBuffer->copyBuffers(mSwapChain, mesh->getIBO(), mesh->getIndices(), mesh->getIndicesSize());
+	mCpyBuffer->end();
+}
+
+void HeadlessRenderSystem::update(const float aDeltaTime)
+{
+	mScene->update(aDeltaTime);
+}
+
+void HeadlessRenderSystem::extract(FramePacket& aPacket)
+{
+	aPacket.width = mWidth;
+	aPacket.height = mHeight;
+
+	mScene->extract(aPacket);
+}
+
+void HeadlessRenderSystem::render(const FramePacket& aPacket)
+{
+	NullCommandBuffer* handle = mPrimaryBuffer[mCurrentFrame];
+
+	mSwapChain->beginFrame();
+
+	if (mCpyPending)
+	{
+		mContext->submit(mCpyBuffer);
+		mCpyPending = false;
+	}
+
+	CommandBufferRecordInfo primaryRecordInfo = {};
+	primaryRecordInfo.flags = COMMAND_BUFFER_USAGE_SIMULATANEOUS_USE;
+	handle->record(primaryRecordInfo);
+
+	RenderPassRecordInfo recordInfo = {};
+	recordInfo.renderPass = mRenderPass;
+	recordInfo.frameBuffer = mFramebuffers[mSwapChain->getCurrentImage()];
+	recordInfo.renderArea = { 0, 0, static_cast<int32_t>(aPacket.width), static_cast<int32_t>(aPacket.height) };
+
+	ClearValue clear = {};
+	ClearValue depth = {};
+	depth.depthStencil = { 1.0f, 0 };
+	recordInfo.clearValues.push_back(clear);
+	recordInfo.clearValues.push_back(depth);
+
+	handle->recordRenderPass(recordInfo);
+	IGraphicsPipeline* pipeline = mScene->getPipeline();
+	handle->bindGraphicsPipeline(pipeline);
+
+	SceneData* sceneData = mScene->getSceneData();
+	sceneData->setValue("proj", aPacket.projection);
+	sceneData->setValue("view", aPacket.view);
+
+	handle->bindSceneData(sceneData, mCurrentFrame);
+
+	Mesh* boundMesh = nullptr;
+	Material* boundMaterial = nullptr;
+
+	for (const DrawItem& draw : aPacket.draws)
+	{
+		if (draw.mesh != boundMesh)
+		{
+			boundMesh = draw.mesh;
+			handle->bindVertexBuffers(0, 1, { boundMesh->getVBO() }, { 0 });
+			handle->bindIndexBuffer(boundMesh->getIBO(), 0, boundMesh->getIndexType());
+		}
+
+		if (draw.material->getParentMaterial() != boundMaterial)
+		{
+			boundMaterial = draw.material->getParentMaterial();
+			handle->bindMaterial(boundMaterial, mCurrentFrame);
+		}
+
+		handle->bindMaterialInstance(draw.material, mCurrentFrame);
+		handle->pushConstants(pipeline, SHADER_STAGE_VERTEX, 0, sizeof(Matrix4f), &draw.model);
+		const MeshLod lod = boundMesh->getLod(draw.lod);
+		handle->drawIndexed(lod.indexCount, 1, lod.firstIndex, 0, 0);
+	}
+
+	handle->endRenderPass();
+	handle->end();
+
+	mContext->submit(handle);
+	mSwapChain->endFrame();
+
+	mCurrentFrame = (mCurrentFrame + 1) % mFlightSize;
+}
+
+void HeadlessRenderSystem::onEvent(Event& aEvent)
+{
+	EventDispatcher dispatcher(aEvent);
+	dispatcher.dispatch<WindowResizeEvent>(BIND_EVENT_FUNCTION(HeadlessRenderSystem::_onResize));
+}
+
+void HeadlessRenderSystem::_constructFramebuffers()
+{
+	const auto views = mSwapChain->getImageViews();
+
+	mFramebuffers = new NullFramebuffer * [views.size()];
+	for (size_t i = 0; i < views.size(); i++)
+	{
+		FramebufferCreateInfo frameBufferInfo = {};
+		frameBufferInfo.attachments.push_back(views[i]);
+		frameBufferInfo.attachments.push_back(mSwapChain->getDepthView());
+		frameBufferInfo.renderPass = mRenderPass;
+		frameBufferInfo.width = mWidth;
+		frameBufferInfo.height = mHeight;
+		frameBufferInfo.layers = 1;
+
+		mFramebuffers[i] = new NullFramebuffer(mContext);
+		mFramebuffers[i]->construct(frameBufferInfo);
+	}
+}
+
+void HeadlessRenderSystem::_destroyFramebuffers()
+{
+	if (mFramebuffers == nullptr)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < mSwapChain->getImageCount(); i++)
+	{
+		delete mFramebuffers[i];
+	}
+
+	delete[] mFramebuffers;
+	mFramebuffers = nullptr;
+}
+
+bool HeadlessRenderSystem::_onResize(WindowResizeEvent& aEvent)
+{
+	if (aEvent.width() == 0 || aEvent.height() == 0)
+	{
+		return false;
+	}
+
+	_destroyFramebuffers();
+
+	mWidth = aEvent.width();
+	mHeight = aEvent.height();
+
+	SwapChainCreateInfo swapChainInfo = {};
+	swapChainInfo.width = mWidth;
+	swapChainInfo.height = mHeight;
+	swapChainInfo.maxImageCount = mFlightSize;
+	mSwapChain->reconstruct(swapChainInfo);
+
+	_constructFramebuffers();
+
+	return false;
+}
@@ -3,7 +3,7 @@
 #include "core/PrimalCast.h"
 #include "ecs/EntityManager.h"
 #include "filesystem/FileSystem.h"
-#include "graphics/MaterialManager.h"
+#include "graphics/Mesh.h"
 #include "graphics/vk/VulkanShaderModule.h"
 #include "graphics/vk/VulkanGraphicsPipeline.h"
 #include "graphics/vk/VulkanPipelineLayout.h"
@@ -12,17 +12,10 @@
 #include "graphics/vk/VulkanUniformBuffer.h"
 #include "graphics/vk/VulkanDescriptorPool.h"
 
-#include <stb/stb_image.h>
-
 #include "assets/AssetManager.h"
-#include "assets/MeshAsset.h"
-#include "assets/ShaderAsset.h"
-#include "assets/TextureAsset.h"
 
 RenderSystem::RenderSystem(Window* aWindow)
-	: mRenderPass(nullptr), mGraphicsPipeline(nullptr), mVertexBuffer(nullptr), mIndexBuffer(nullptr),
-	  mUboObject0(nullptr), mUboPool(nullptr),
-	  mTexture(nullptr), mTexture2(nullptr), mSampler(nullptr), mWindow(aWindow)
+	: mRenderPass(nullptr), mWindow(aWindow)
 {
 	GraphicsContextCreateInfo info;
 	info.applicationName = "Sandbox";
@@ -43,29 +36,13 @@ RenderSystem::RenderSystem(Window* aWindow)
 
 	mSwapChain->construct(swapChainInfo);
 
-	std::vector<DescriptorPoolSize> poolSizes;
-	DescriptorPoolSize uniformBufferSize{};
-	uniformBufferSize.type = EDescriptorType::UNIFORM_BUFFER_DYNAMIC;
-	uniformBufferSize.count = 4;
-
-	DescriptorPoolSize combinedSamplerSize{};
-	combinedSamplerSize.type = EDescriptorType::COMBINED_IMAGE_SAMPLER;
-	combinedSamplerSize.count = 2;
-
-	poolSizes.push_back(combinedSamplerSize);
-
-	DescriptorPoolCreateInfo createInfo;
-	createInfo.flags = 0;
-	createInfo.maxSets = 4;
-	createInfo.poolSizes = poolSizes;
-
-	mDescPool = new DescriptorSetPool(2, createInfo);
+	mScene = new SandboxScene();
 }
 
 RenderSystem::~RenderSystem()
 {
-	vkDeviceWaitIdle(primal_cast<VulkanGraphicsContext*>(mContext)->getDevice());
-	
+	mContext->idle();
+
 	AssetManager::instance().unloadAll();
 
 	delete mSwapChain;
@@ -79,38 +56,14 @@ RenderSystem::~RenderSystem()
 	delete[] mFramebuffers;
 	delete[] mPrimaryBuffer;
 
-	for (auto instance : mInstances)
-	{
-		delete instance;
-	}
-
 	delete mCpyBuffer;
-	delete mSceneData;
-	delete mUboObject0;
-	delete mUboPool;
-	delete mMaterialInstance;
-	delete mMaterialInstance2;
-
-	MaterialManager::instance().reset();
+	delete mScene;
 
-	delete mDescPool;
-
-	{
-		mShaderAsset = nullptr;
-		mRenderPassAsset = nullptr;
-	}
+	mRenderPassAsset = nullptr;
 
 	delete mContext;
 }
 
-struct UBO
-{
-	Matrix4f model;
-	Matrix4f view;
-	Matrix4f proj;
-	Matrix4f mvp;
-};
-
 void RenderSystem::initialize()
 {
 	mPrimaryBuffer = new VulkanCommandBuffer * [mFlightSize];
@@ -214,15 +167,8 @@ void RenderSystem::initialize()
 		mPrimaryBuffer[i]->construct(commandBufferInfo);
 	}
 
-	mShaderAsset = AssetManager::instance().load<ShaderAsset>("testShader", "data/effects/default.json");
-	mGraphicsPipeline = mShaderAsset->getPipeline();
-	mLayout = primal_cast<VulkanPipelineLayout*>(mGraphicsPipeline->getCreateInfo().layout);
-
-	auto meshAsset = AssetManager::instance().load<MeshAsset>("mesh", "data/models/cube.glb");
-	auto mesh = meshAsset->getMesh(0);
-
-	mVertexBuffer = primal_cast<VulkanVertexBuffer*>(mesh->getVBO());
-	mIndexBuffer = primal_cast<VulkanIndexBuffer*>(mesh->getIBO());
+	mScene->initialize();
+	Mesh* mesh = mScene->getMesh();
 
 	mCpyBuffer = new VulkanCommandBuffer(mContext);
 	mCpyBuffer->construct(transferBufferInfo);
@@ -231,72 +177,30 @@ void RenderSystem::initialize()
 	CommandBufferRecordInfo recordInfo = {};
 	recordInfo.flags = COMMAND_BUFFER_USAGE_SIMULATANEOUS_USE;
 	mCpyBuffer->record(recordInfo);
-	mCpyBuffer->copyBuffers(mSwapChain, mVertexBuffer, mesh->getData(), mesh->getSize());
-	mCpyBuffer->copyBuffers(mSwapChain, mIndexBuffer, mesh->getIndices(), mesh->getIndicesSize());
+	mCpyBuffer->copyBuffers(mSwapChain, mesh->getVBO(), mesh->getData(), mesh->getSize());
+	mCpyBuffer->copyBuffers(mSwapChain, mesh->getIBO(), mesh->getIndices(), mesh->getIndicesSize());
 	mCpyBuffer->end();
+}
 
-	UniformBufferCreateInfo uniformBufferCreateInfo = {};
-	uniformBufferCreateInfo.flags = 0;
-	uniformBufferCreateInfo.sharingMode = SHARING_MODE_EXCLUSIVE;
-	uniformBufferCreateInfo.size = 65536;
-	uniformBufferCreateInfo.usage = EBufferUsageFlagBits::BUFFER_USAGE_UNIFORM_BUFFER;
-	
-	UniformBufferObjectElement* modl = new UniformBufferObjectElement{
-		"model",
-		EUniformBufferObjectElementType::UBO_TYPE_MAT4,
-		0,
-		sizeof(UBO::model)
-	};
-
-	UniformBufferObjectElement* view = new UniformBufferObjectElement{
-		"view",
-		EUniformBufferObjectElementType::UBO_TYPE_MAT4,
-		0,
-		sizeof(UBO::view)
-	};
-
-	UniformBufferObjectElement* proj = new UniformBufferObjectElement{
-		"proj",
-		EUniformBufferObjectElementType::UBO_TYPE_MAT4,
-		64,
-		sizeof(UBO::proj)
-	};
-
-	std::vector<UniformBufferObjectElement*> elements = { modl };
-
-	mUboPool = new UniformBufferPool(65536 / sizeof(UBO), sizeof(UBO), 0, uniformBufferCreateInfo, elements);
-	mUboObject0 = mUboPool->acquire();
-
-	auto texAsset = AssetManager::instance().load<TextureAsset>("test", "data/textures/Shawn.json", STBI_rgb_alpha);
-	mTexture = primal_cast<VulkanTexture*>(texAsset->getTexture());
-
-	auto tex2 = AssetManager::instance().load<TextureAsset>("test2", "data/textures/Test.json", STBI_rgb_alpha);
+void RenderSystem::update(const float aDeltaTime)
+{
+	mScene->update(aDeltaTime);
+}
 
-	mGraphicsPipeline = mShaderAsset->getPipeline();
-	mSceneData = new SceneData({ {view, proj}, mShaderAsset->getLayout() });
-	MaterialCreateInfo materialCreateInfo;
-	materialCreateInfo.layouts = { mUboPool };
-	materialCreateInfo.pipeline = mGraphicsPipeline;
-	materialCreateInfo.pool = mDescPool;
-	materialCreateInfo.textures = { { "albedo", mTexture } };
-	mMaterialInstance = MaterialManager::instance().createMaterial(materialCreateInfo)->createInstance();
-	mMaterialInstance2 = mMaterialInstance->getParentMaterial()->createInstance();
-	mMaterialInstance2->setTexture("albedo", tex2->getTexture());
+void RenderSystem::extract(FramePacket& aPacket)
+{
+	aPacket.width = mWindow->width();
+	aPacket.height = mWindow->height();
 
-	for (uint32_t i = 0; i < 8; i++)
-	{
-		mInstances.push_back(mMaterialInstance->getParentMaterial()->createInstance());
-	}
+	mScene->extract(aPacket);
 }
 
-void RenderSystem::preRender()
+void RenderSystem::preRender(const FramePacket& aPacket)
 {
 
 }
 
-float angle = 0.0f;
-
-void RenderSystem::render()
+void RenderSystem::render(const FramePacket& aPacket)
 {
 	const auto handle = *(mPrimaryBuffer + mCurrentFrame);
 	const auto prevHandle = *(mPrimaryBuffer + ((mCurrentFrame - 1) % mFlightSize));
@@ -328,7 +232,7 @@ void RenderSystem::render()
 	RenderPassRecordInfo recordInfo = {};
 	recordInfo.renderPass = mRenderPass;
 	recordInfo.frameBuffer = mFramebuffers[mCurrentFrame];
-	recordInfo.renderArea = { 0, 0, static_cast<int32_t>(mWindow->width()), static_cast<int32_t>(mWindow->height()) };
+	recordInfo.renderArea = { 0, 0, static_cast<int32_t>(aPacket.width), static_cast<int32_t>(aPacket.height) };
 	
 	ClearValue clear = {};
 	clear.color.float32[0] = 0.0f;
@@ -343,46 +247,37 @@ void RenderSystem::render()
 
 	handle->recordRenderPass(recordInfo);
 
-	handle->bindGraphicsPipeline(mGraphicsPipeline);
-
-	handle->bindVertexBuffers(0, 1, { mVertexBuffer }, { 0 });
-	handle->bindIndexBuffer(mIndexBuffer, 0, INDEX_TYPE_UINT16);
-
-	UBO u = {};
-	u.proj = Matrix4f::perspective(glm::radians(60.0f), (static_cast<float>(mWindow->width()) / static_cast<float>(mWindow->height())), 0.001f, 1000.0f);
-	u.view = Matrix4f::lookAt(Vector3f(40, 0, 40), Vector3f(0, 0, 0), Vector3f(0, 0, -1));
-	u.model = Matrix4f::identity();
-	u.model = Matrix4f::rotate(u.model, Vector3f(1, 1, 0), angle);
-
-	angle += 0.0001f;
-
-	mMaterialInstance->setVariable<Matrix4f>("model", u.model);
-
-	u.model = Matrix4f::identity();
-	u.model = Matrix4f::translate(u.model, Vector3f(0, 20, 0));
-	mMaterialInstance2->setVariable<Matrix4f>("model", u.model);
-
-	mSceneData->setValue("proj", u.proj);
-	mSceneData->setValue("view", u.view);
+	IGraphicsPipeline* pipeline = mScene->getPipeline();
+	handle->bindGraphicsPipeline(pipeline);
 
-	handle->bindSceneData(mSceneData, mCurrentFrame); // bind once per pipeline layout. More than once is invalid
+	SceneData* sceneData = mScene->getSceneData();
+	sceneData->setValue("proj", aPacket.projection);
+	sceneData->setValue("view", aPacket.view);
 
-	handle->bindMaterial(mMaterialInstance->getParentMaterial(), mCurrentFrame);
-	handle->bindMaterialInstance(mMaterialInstance, mCurrentFrame);
-	handle->drawIndexed(mIndexBuffer->getCount(), 1, 0, 0, 0);
+	handle->bindSceneData(sceneData, mCurrentFrame); // bind once per pipeline layout. More than once is invalid
 
-	handle->bindMaterial(mMaterialInstance2->getParentMaterial(), mCurrentFrame);
-	handle->bindMaterialInstance(mMaterialInstance2, mCurrentFrame);
-	handle->drawIndexed(mIndexBuffer->getCount(), 1, 0, 0, 0);
+	Mesh* boundMesh = nullptr;
+	Material* boundMaterial = nullptr;
 
-	for (uint32_t i = 0; i < mInstances.size(); i++)
+	for (const DrawItem& draw : aPacket.draws)
 	{
-		uint32_t x = i - static_cast<float>(mInstances.size()) / 2.0f;
-		Matrix4f modl = Matrix4f::identity();
-		modl = Matrix4f::translate(modl, Vector3f(-5, static_cast<float>(i) * 10, 5));
-		mInstances[i]->setVariable("model", modl);
-		handle->bindMaterialInstance(mInstances[i], mCurrentFrame);
-		handle->drawIndexed(mIndexBuffer->getCount(), 1, 0, 0, 0);
+		if (draw.mesh != boundMesh)
+		{
+			boundMesh = draw.mesh;
+			handle->bindVertexBuffers(0, 1, { boundMesh->getVBO() }, { 0 });
+			handle->bindIndexBuffer(boundMesh->getIBO(), 0, boundMesh->getIndexType());
+		}
+
+		if (draw.material->getParentMaterial() != boundMaterial)
+		{
+			boundMaterial = draw.material->getParentMaterial();
+			handle->bindMaterial(boundMaterial, mCurrentFrame);
+		}
+
+		handle->bindMaterialInstance(draw.material, mCurrentFrame);
+		handle->pushConstants(pipeline, SHADER_STAGE_VERTEX, 0, sizeof(Matrix4f), &draw.model);
+		const MeshLod lod = boundMesh->getLod(draw.lod);
+		handle->drawIndexed(lod.indexCount, 1, lod.firstIndex, 0, 0);
 	}
 
 	handle->endRenderPass();
@@ -395,7 +290,7 @@ void RenderSystem::render()
 	mCurrentFrame = (mCurrentFrame + 1) % mFlightSize;
 }
 
-void RenderSystem::postRender()
+void RenderSystem::postRender(const FramePacket& aPacket)
 {
 
 }
@@ -0,0 +1,130 @@
+#include "systems/SandboxScene.h"
+
+#include "graphics/MaterialManager.h"
+#include "graphics/Mesh.h"
+
+#include <stb/stb_image.h>
+
+#include "assets/AssetManager.h"
+#include "assets/MeshAsset.h"
+#include "assets/TextureAsset.h"
+
+SandboxScene::SandboxScene()
+{
+	std::vector<DescriptorPoolSize> poolSizes;
+	DescriptorPoolSize combinedSamplerSize{};
+	combinedSamplerSize.type = EDescriptorType::COMBINED_IMAGE_SAMPLER;
+	combinedSamplerSize.count = 2;
+
+	poolSizes.push_back(combinedSamplerSize);
+
+	DescriptorPoolCreateInfo createInfo;
+	createInfo.flags = 0;
+	createInfo.maxSets = 4;
+	createInfo.poolSizes = poolSizes;
+
+	mDescPool = new DescriptorSetPool(2, createInfo);
+}
+
+SandboxScene::~SandboxScene()
+{
+	for (auto instance : mInstances)
+	{
+		delete instance;
+	}
+
+	delete mSceneData;
+	delete mUboPool;
+	delete mMaterialInstance;
+	delete mMaterialInstance2;
+
+	MaterialManager::instance().reset();
+
+	delete mDescPool;
+
+	mShaderAsset = nullptr;
+}
+
+void SandboxScene::initialize()
+{
+	mShaderAsset = AssetManager::instance().load<ShaderAsset>("testShader", "data/effects/default.json");
+
+	auto meshAsset = AssetManager::instance().load<MeshAsset>("mesh", "data/models/cube.glb");
+	mMesh = meshAsset->getMesh(0);
+
+	UniformBufferCreateInfo uniformBufferCreateInfo = {};
+	uniformBufferCreateInfo.flags = 0;
+	uniformBufferCreateInfo.sharingMode = SHARING_MODE_EXCLUSIVE;
+	uniformBufferCreateInfo.size = 65536;
+	uniformBufferCreateInfo.usage = EBufferUsageFlagBits::BUFFER_USAGE_UNIFORM_BUFFER;
+
+	UniformBufferObjectElement* view = new UniformBufferObjectElement{
+		"view",
+		EUniformBufferObjectElementType::UBO_TYPE_MAT4,
+		0,
+		sizeof(Matrix4f)
+	};
+
+	UniformBufferObjectElement* proj = new UniformBufferObjectElement{
+		"proj",
+		EUniformBufferObjectElementType::UBO_TYPE_MAT4,
+		64,
+		sizeof(Matrix4f)
+	};
+
+	// Per instance material data. The model matrix is pushed per draw, so the sandbox shader reads
+	// nothing from it, but its pipeline layout still binds the buffer.
+	const uint32_t stride = 4 * sizeof(Matrix4f);
+	mUboPool = new UniformBufferPool(65536 / stride, stride, 0, uniformBufferCreateInfo, {});
+
+	auto texAsset = AssetManager::instance().load<TextureAsset>("test", "data/textures/Shawn.json", STBI_rgb_alpha);
+	auto tex2 = AssetManager::instance().load<TextureAsset>("test2", "data/textures/Test.json", STBI_rgb_alpha);
+
+	mSceneData = new SceneData({ {view, proj}, mShaderAsset->getLayout() });
+
+	MaterialCreateInfo materialCreateInfo;
+	materialCreateInfo.layouts = { mUboPool };
+	materialCreateInfo.pipeline = mShaderAsset->getPipeline();
+	materialCreateInfo.pool = mDescPool;
+	materialCreateInfo.textures = { { "albedo", texAsset->getTexture() } };
+	mMaterialInstance = MaterialManager::instance().createMaterial(materialCreateInfo)->createInstance();
+	mMaterialInstance2 = mMaterialInstance->getParentMaterial()->createInstance();
+	mMaterialInstance2->setTexture("albedo", tex2->getTexture());
+
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		mInstances.push_back(mMaterialInstance->getParentMaterial()->createInstance());
+	}
+}
+
+void SandboxScene::update(const float aDeltaTime)
+{
+	mAngle += 0.1f * aDeltaTime;
+}
+
+void SandboxScene::extract(FramePacket& aPacket) const
+{
+	aPacket.projection = Matrix4f::perspective(glm::radians(60.0f), static_cast<float>(aPacket.width) / static_cast<float>(aPacket.height), 0.001f, 1000.0f);
+	aPacket.view = Matrix4f::lookAt(Vector3f(40, 0, 40), Vector3f(0, 0, 0), Vector3f(0, 0, -1));
+
+	Matrix4f model = Matrix4f::identity();
+	model = Matrix4f::rotate(model, Vector3f(1, 1, 0), mAngle);
+	aPacket.draws.push_back({ mMesh, mMaterialInstance, model });
+
+	model = Matrix4f::identity();
+	model = Matrix4f::translate(model, Vector3f(0, 20, 0));
+	aPacket.draws.push_back({ mMesh, mMaterialInstance2, model });
+
+	for (uint32_t i = 0; i < mInstances.size(); i++)
+	{
+		model = Matrix4f::identity();
+		model = Matrix4f::translate(model, Vector3f(-5, static_cast<float>(i) * 10, 5));
+		aPacket.draws.push_back({ mMesh, mInstances[i], model });
+	}
+
+	for (DrawItem& draw : aPacket.draws)
+	{
+		draw.lod = static_cast<uint32_t>(draw.mesh->selectLod(draw.model, aPacket.view, aPacket.projection, static_cast<float>(aPacket.height)));
+		draw.screenSize = draw.mesh->getScreenSize(draw.model, aPacket.view, aPacket.projection, static_cast<float>(aPacket.height));
+	}
+}
@@ -134,12 +134,12 @@ void VulkanRenderSystem::initialize()
 	}
 }
 
-void VulkanRenderSystem::preRender()
+void VulkanRenderSystem::preRender(const FramePacket& aPacket)
 {
 	
 }
 
-void VulkanRenderSystem::render()
+void VulkanRenderSystem::render(const FramePacket& aPacket)
 {
 	const auto handle = mCommandBuffers[mCurrentFrame];
 
@@ -187,7 +187,7 @@ void VulkanRenderSystem::render()
 	mCurrentFrame = (mCurrentFrame + 1) % mFlightSize;
 }
 
-void VulkanRenderSystem::postRender()
+void VulkanRenderSystem::postRender(const FramePacket& aPacket)
 {
 	
 }
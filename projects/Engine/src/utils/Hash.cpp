@@ -0,0 +1,111 @@
+#include "utils/Hash.h"
+
+#include <cstring>
+
+namespace detail
+{
+	static constexpr uint64_t sPrime1 = 0x9E3779B185EBCA87ull;
+	static constexpr uint64_t sPrime2 = 0xC2B2AE3D27D4EB4Full;
+	static constexpr uint64_t sPrime3 = 0x165667B19E3779F9ull;
+	static constexpr uint64_t sPrime4 = 0x85EBCA77C2B2AE63ull;
+	static constexpr uint64_t sPrime5 = 0x27D4EB2F165667C5ull;
+
+	static uint64_t sRotate(const uint64_t aValue, const int aBits)
+	{
+		return (aValue << aBits) | (aValue >> (64 - aBits));
+	}
+
+	static uint64_t sRead64(const uint8_t* aData)
+	{
+		uint64_t value;
+		memcpy(&value, aData, sizeof(value));
+		return value;
+	}
+
+	static uint32_t sRead32(const uint8_t* aData)
+	{
+		uint32_t value;
+		memcpy(&value, aData, sizeof(value));
+		return value;
+	}
+
+	static uint64_t sRound(uint64_t aAccumulator, const uint64_t aInput)
+	{
+		aAccumulator += aInput * sPrime2;
+		aAccumulator = sRotate(aAccumulator, 31);
+		return aAccumulator * sPrime1;
+	}
+
+	static uint64_t sMerge(uint64_t aAccumulator, const uint64_t aValue)
+	{
+		aAccumulator ^= sRound(0, aValue);
+		return aAccumulator * sPrime1 + sPrime4;
+	}
+}
+
+uint64_t Hash::xxh64(const void* aData, const size_t aSize, const uint64_t aSeed)
+{
+	using namespace detail;
+
+	const uint8_t* data = static_cast<const uint8_t*>(aData);
+	const uint8_t* const end = data + aSize;
+
+	uint64_t hash;
+
+	if (aSize >= 32)
+	{
+		uint64_t v1 = aSeed + sPrime1 + sPrime2;
+		uint64_t v2 = aSeed + sPrime2;
+		uint64_t v3 = aSeed;
+		uint64_t v4 = aSeed - sPrime1;
+
+		const uint8_t* const limit = end - 32;
+		do
+		{
+			v1 = sRound(v1, sRead64(data));
+			v2 = sRound(v2, sRead64(data + 8));
+			v3 = sRound(v3, sRead64(data + 16));
+			v4 = sRound(v4, sRead64(data + 24));
+			data += 32;
+		} while (data <= limit);
+
+		hash = sRotate(v1, 1) + sRotate(v2, 7) + sRotate(v3, 12) + sRotate(v4, 18);
+		hash = sMerge(hash, v1);
+		hash = sMerge(hash, v2);
+		hash = sMerge(hash, v3);
+		hash = sMerge(hash, v4);
+	}
+	else
+	{
+		hash = aSeed + sPrime5;
+	}
+
+	hash += static_cast<uint64_t>(aSize);
+
+	for (; data + 8 <= end; data += 8)
+	{
+		hash ^= sRound(0, sRead64(data));
+		hash = sRotate(hash, 27) * sPrime1 + sPrime4;
+	}
+
+	if (data + 4 <= end)
+	{
+		hash ^= static_cast<uint64_t>(sRead32(data)) * sPrime1;
+		hash = sRotate(hash, 23) * sPrime2 + sPrime3;
+		data += 4;
+	}
+
+	for (; data < end; ++data)
+	{
+		hash ^= (*data) * sPrime5;
+		hash = sRotate(hash, 11) * sPrime1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= sPrime2;
+	hash ^= hash >> 29;
+	hash *= sPrime3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
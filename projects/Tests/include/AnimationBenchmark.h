@@ -0,0 +1,12 @@
+#ifndef animationbenchmark_h__
+#define animationbenchmark_h__
+
+// Compresses a set of generated clips and reports how their size, error and sampling speed compare to the
+// raw float tracks
+class AnimationBenchmark
+{
+	public:
+		static void run();
+};
+
+#endif // animationbenchmark_h__
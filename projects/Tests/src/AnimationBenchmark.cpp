@@ -0,0 +1,154 @@
+#include "AnimationBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <animation/AnimationCompression.h>
+#include <animation/Pose.h>
+#include <core/Log.h>
+#include <core/Timer.h>
+
+namespace detail
+{
+	static constexpr size_t sJointCount = 80;
+	static constexpr size_t sClipCount = 40;
+	static constexpr float sFrameRate = 30.0f;
+	static constexpr size_t sSampleTimes = 500;
+
+	// A chain of joints a tenth apart, like a spine of bones
+	static Pose sCreateRestPose()
+	{
+		Pose pose;
+		pose.resize(sJointCount);
+
+		for (size_t joint = 1; joint < sJointCount; joint++)
+		{
+			pose.translationY[joint] = 0.1f;
+		}
+
+		return pose;
+	}
+
+	// Keys on every frame like exported clips have: every joint swings around its own axis, the root also
+	// moves, and translations and scales of the other joints are baked at their rest values
+	static AnimationClip sCreateClip(const Pose& aRestPose, std::mt19937& aRandom)
+	{
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		const float duration = 2.0f + 6.0f * unit(aRandom);
+		const size_t keyCount = static_cast<size_t>(duration * sFrameRate) + 1;
+
+		std::vector<AnimationTrack> tracks;
+
+		for (size_t joint = 0; joint < sJointCount; joint++)
+		{
+			const float axis[3] = { unit(aRandom) - 0.5f, unit(aRandom) - 0.5f, unit(aRandom) - 0.5f };
+			const float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			const float amplitude = 0.2f + unit(aRandom);
+			const float frequency = 0.25f + 2.0f * unit(aRandom);
+			const float phase = 6.28318f * unit(aRandom);
+
+			AnimationTrack rotation = { static_cast<uint32_t>(joint), ANIMATION_CHANNEL_ROTATION, ANIMATION_INTERPOLATION_LINEAR, {}, {} };
+			AnimationTrack translation = { static_cast<uint32_t>(joint), ANIMATION_CHANNEL_TRANSLATION, ANIMATION_INTERPOLATION_LINEAR, {}, {} };
+			AnimationTrack scale = { static_cast<uint32_t>(joint), ANIMATION_CHANNEL_SCALE, ANIMATION_INTERPOLATION_LINEAR, {}, {} };
+
+			for (size_t key = 0; key < keyCount; key++)
+			{
+				const float time = std::min(static_cast<float>(key) / sFrameRate, duration);
+				const float angle = amplitude * std::sin(6.28318f * frequency * time + phase);
+				const float sine = std::sin(angle * 0.5f) / axisLength;
+
+				rotation.times.push_back(time);
+				rotation.values.insert(rotation.values.end(), { axis[0] * sine, axis[1] * sine, axis[2] * sine, std::cos(angle * 0.5f) });
+
+				translation.times.push_back(time);
+				if (joint == 0)
+				{
+					translation.values.insert(translation.values.end(), { 0.5f * time, 0.05f * std::sin(12.0f * time), 0.0f });
+				}
+				else
+				{
+					translation.values.insert(translation.values.end(), { aRestPose.translationX[joint], aRestPose.translationY[joint],
+						aRestPose.translationZ[joint] });
+				}
+
+				scale.times.push_back(time);
+				scale.values.insert(scale.values.end(), { 1.0f, 1.0f, 1.0f });
+			}
+
+			tracks.push_back(std::move(rotation));
+			tracks.push_back(std::move(translation));
+			tracks.push_back(std::move(scale));
+		}
+
+		return AnimationClip("generated", std::move(tracks));
+	}
+
+	// Joints sampled per second when sampling every clip at aTimes in turn
+	template<typename Clip>
+	static double sMeasureSampling(const std::vector<Clip>& aClips, const std::vector<float>& aTimes, const Pose& aRestPose)
+	{
+		Pose pose = aRestPose;
+		Timer timer;
+
+		for (const float time : aTimes)
+		{
+			for (const Clip& clip : aClips)
+			{
+				clip.sample(std::fmod(time, clip.getDuration()), pose);
+			}
+		}
+
+		const double seconds = std::max(static_cast<double>(timer.elapsed()), 1e-9);
+		return static_cast<double>(aTimes.size() * aClips.size() * sJointCount) / seconds;
+	}
+}
+
+void AnimationBenchmark::run()
+{
+	std::mt19937 random(1234);
+	const Pose restPose = detail::sCreateRestPose();
+
+	std::vector<AnimationClip> clips;
+	std::vector<CompressedClip> compressed;
+
+	size_t rawBytes = 0;
+	size_t compressedBytes = 0;
+	AnimationCompressionError error;
+
+	Timer compressTimer;
+
+	for (size_t i = 0; i < detail::sClipCount; i++)
+	{
+		clips.push_back(detail::sCreateClip(restPose, random));
+		compressed.push_back(AnimationCompression::compress(clips.back(), restPose, {}));
+
+		const AnimationCompressionError clipError = AnimationCompression::measure(clips.back(), compressed.back(), restPose);
+		error.translation = std::max(error.translation, clipError.translation);
+		error.rotation = std::max(error.rotation, clipError.rotation);
+		error.scale = std::max(error.scale, clipError.scale);
+
+		rawBytes += AnimationCompression::getRawBytes(clips.back());
+		compressedBytes += compressed.back().getMemoryUsage();
+	}
+
+	const float compressSeconds = compressTimer.elapsed();
+
+	std::uniform_real_distribution<float> times(0.0f, 8.0f);
+	std::vector<float> sampleTimes(detail::sSampleTimes);
+	for (float& time : sampleTimes)
+	{
+		time = times(random);
+	}
+
+	const double rawRate = detail::sMeasureSampling(clips, sampleTimes, restPose);
+	const double compressedRate = detail::sMeasureSampling(compressed, sampleTimes, restPose);
+
+	PRIMAL_INFO("Animation compression: {0} clips of {1} joints, {2} -> {3} bytes ({4:.1f}x) in {5:.2f} s", detail::sClipCount,
+		detail::sJointCount, rawBytes, compressedBytes, static_cast<double>(rawBytes) / std::max<size_t>(compressedBytes, 1), compressSeconds);
+	PRIMAL_INFO("Animation compression error: {0} translation, {1} radians rotation, {2} scale", error.translation, error.rotation,
+		error.scale);
+	PRIMAL_INFO("Animation sampling: raw {0:.1f}M joints/s, compressed {1:.1f}M joints/s", rawRate / 1e6, compressedRate / 1e6);
+}
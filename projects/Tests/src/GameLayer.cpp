@@ -1,5 +1,7 @@
 #include "GameLayer.h"
 
+#include "AnimationBenchmark.h"
+
 #include <core/PrimalCast.h>
 
 #include <math/Quaternion.h>
@@ -28,6 +30,11 @@ GameLayer::~GameLayer()
 
 void GameLayer::onAttach()
 {
+	if (Application::hasArgument("--animation-benchmark"))
+	{
+		AnimationBenchmark::run();
+	}
+
 	//AssetManager::instance().load<MeshAsset>("building", "data/models/building.glb");
 
 	//SystemManager::instance().addSystem<RenderSystem>();